@@ -13,6 +13,7 @@
 #include "external/json/prettywriter.h"
 #include "network/CCDownloader.h"
 #include "IContentSystem.hpp"
+#include "TextureAtlas.hpp"
 #include <functional>
 #include "CryptoLibrary.hpp"
 #include "gzip/decompress.hpp"
@@ -539,6 +540,10 @@ void ContentManager::Internal_OnComplete( bool bSuccess, uint64 TotalBytes /* =
     TotalProgress       = 0;
     bUpdateInProgress   = false;
     
+    // New card art has to be packed before anything draws from the atlas again
+    if( bSuccess && !TextureAtlas::BuildCardAtlas() )
+        cocos2d::log( "[CMS] Failed to rebuild the card atlas after updating!" );
+    
     // Call bound callback
     if( CompleteCallback )
     {
@@ -76,6 +76,11 @@ void ContentStorage::Init()
     {
         file->createDirectory( ContentRoot + "/download" );
     }
+    
+    if( !file->isDirectoryExist( ContentRoot + "/atlas" ) )
+    {
+        file->createDirectory( ContentRoot + "/atlas" );
+    }
 }
 
 bool ContentStorage::ReadLocalBlocks( std::vector< LocalBlock >& Output )
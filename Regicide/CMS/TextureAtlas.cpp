@@ -0,0 +1,573 @@
+//
+//    TextureAtlas.cpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "TextureAtlas.hpp"
+#include "IContentSystem.hpp"
+#include "../Classes/Utils.hpp"
+#include "external/json/document.h"
+#include "external/json/stringbuffer.h"
+#include "external/json/writer.h"
+#include <algorithm>
+#include <map>
+
+using namespace Regicide;
+using namespace cocos2d;
+using namespace rapidjson;
+
+
+// Bundled images that are drawn on and around cards
+static const char* s_CardImages[] =
+{
+    "CardBack.png",
+    "CardFront.png",
+    "CardHighlight.png",
+    "SmallOverlay.png",
+    "icon_attack.png",
+    "ManaIcon.png",
+    "StaminaIcon.png",
+    "king_player.png",
+    "king_opponent.png"
+};
+
+// Frames from every loaded atlas by source name, along with the sources each atlas added
+// Never freed, the frames hold on to the page textures, which cant be released once the renderer is gone
+struct AtlasRegistry
+{
+    cocos2d::Map< std::string, SpriteFrame* > Frames;
+    std::map< std::string, std::vector< std::string > > Sources;
+};
+
+static AtlasRegistry* s_Registry = nullptr;
+static AtlasRegistry& GetRegistry()
+{
+    if( !s_Registry )
+        s_Registry = new AtlasRegistry();
+    
+    return *s_Registry;
+}
+
+
+static std::string GetPagePath( const std::string& Name, size_t Page )
+{
+    return std::string( ATLAS_DIRECTORY ) + "/" + Name + "_" + std::to_string( Page ) + ".png";
+}
+
+static std::string GetIndexPath( const std::string& Name )
+{
+    return std::string( ATLAS_DIRECTORY ) + "/" + Name + ".json";
+}
+
+static uint32 NextPowerOfTwo( uint32 In )
+{
+    uint32 Output = 1;
+    while( Output < In )
+        Output <<= 1;
+    
+    return Output;
+}
+
+
+/*=====================================================================================================
+        Packing
+=====================================================================================================*/
+
+// Shelf packing. Images go left to right along a shelf as tall as the tallest image on it, and when a row
+// is full, a new shelf starts under it. Tallest images go first, so each shelf wastes little height
+// Returns the height used on each page
+static std::vector< uint32 > PackFrames( std::vector< AtlasFrame >& Frames )
+{
+    std::vector< uint32 > PageHeights;
+    if( Frames.empty() )
+        return PageHeights;
+    
+    std::vector< size_t > Order( Frames.size() );
+    for( size_t i = 0; i < Order.size(); i++ )
+        Order[ i ] = i;
+    
+    std::stable_sort( Order.begin(), Order.end(), [ &Frames ]( size_t A, size_t B )
+    {
+        if( Frames[ A ].Height != Frames[ B ].Height )
+            return Frames[ A ].Height > Frames[ B ].Height;
+        
+        return Frames[ A ].Width > Frames[ B ].Width;
+    } );
+    
+    uint32 ShelfX       = 0;
+    uint32 ShelfY       = 0;
+    uint32 ShelfHeight  = 0;
+    
+    PageHeights.push_back( 0 );
+    
+    for( auto It = Order.begin(); It != Order.end(); It++ )
+    {
+        auto& Frame = Frames[ *It ];
+        
+        uint32 Width    = Frame.Width + ATLAS_PADDING * 2;
+        uint32 Height   = Frame.Height + ATLAS_PADDING * 2;
+        
+        // Row is full, start a new shelf under this one
+        if( ShelfX + Width > ATLAS_PAGE_SIZE )
+        {
+            ShelfY      += ShelfHeight;
+            ShelfX      = 0;
+            ShelfHeight = 0;
+        }
+        
+        // Page is full, start a new page
+        if( ShelfY + Height > ATLAS_PAGE_SIZE )
+        {
+            PageHeights.push_back( 0 );
+            
+            ShelfX      = 0;
+            ShelfY      = 0;
+            ShelfHeight = 0;
+        }
+        
+        Frame.Page  = (uint32) PageHeights.size() - 1;
+        Frame.X     = ShelfX + ATLAS_PADDING;
+        Frame.Y     = ShelfY + ATLAS_PADDING;
+        
+        ShelfX      += Width;
+        ShelfHeight = std::max( ShelfHeight, Height );
+        
+        PageHeights.back() = std::max( PageHeights.back(), ShelfY + ShelfHeight );
+    }
+    
+    return PageHeights;
+}
+
+// Copies an image into a page, and repeats its edge pixels out into the padding around it
+// Pages are premultiplied when theyre loaded, like any other png, so sources that were already premultiplied
+// when they were loaded are put back to straight alpha here, instead of switching premultiplication off for everyone
+static void BlitFrame( std::vector< uint8 >& Page, uint32 PageWidth, const AtlasFrame& Frame, Image* Source )
+{
+    const uint8* Pixels = Source->getData();
+    bool bAlpha         = Source->getRenderFormat() == Texture2D::PixelFormat::RGBA8888;
+    bool bPremultiplied = bAlpha && Source->hasPremultipliedAlpha();
+    int Stride          = bAlpha ? 4 : 3;
+    int Width           = (int) Frame.Width;
+    int Height          = (int) Frame.Height;
+    
+    for( int y = -ATLAS_PADDING; y < Height + ATLAS_PADDING; y++ )
+    {
+        int SourceY = std::min( std::max( y, 0 ), Height - 1 );
+        uint8* Out  = Page.data() + ( (size_t)( (int) Frame.Y + y ) * PageWidth + Frame.X - ATLAS_PADDING ) * 4;
+        
+        for( int x = -ATLAS_PADDING; x < Width + ATLAS_PADDING; x++ )
+        {
+            int SourceX     = std::min( std::max( x, 0 ), Width - 1 );
+            const uint8* In = Pixels + ( (size_t) SourceY * Width + SourceX ) * Stride;
+            
+            uint8 Alpha = bAlpha ? In[ 3 ] : 255;
+            
+            if( bPremultiplied && Alpha > 0 && Alpha < 255 )
+            {
+                for( int c = 0; c < 3; c++ )
+                    Out[ c ] = (uint8) std::min( 255, ( In[ c ] * 255 + Alpha / 2 ) / Alpha );
+            }
+            else
+            {
+                Out[ 0 ] = In[ 0 ];
+                Out[ 1 ] = In[ 1 ];
+                Out[ 2 ] = In[ 2 ];
+            }
+            
+            Out[ 3 ] = Alpha;
+            
+            Out += 4;
+        }
+    }
+}
+
+
+/*=====================================================================================================
+        Texture Atlas
+=====================================================================================================*/
+bool TextureAtlas::Build( const std::string& Name, const std::vector< std::string >& Sources )
+{
+    auto Storage        = IContentSystem::GetStorage();
+    auto file           = FileUtils::getInstance();
+    std::string Root    = Utils::GetContentDir();
+    
+    if( !file->isDirectoryExist( Root + "/" + ATLAS_DIRECTORY ) )
+        file->createDirectory( Root + "/" + ATLAS_DIRECTORY );
+    
+    std::vector< AtlasFrame > Frames;
+    std::vector< Image* > Images;
+    
+    for( auto It = Sources.begin(); It != Sources.end(); It++ )
+    {
+        bool bDuplicate = false;
+        for( auto& F : Frames )
+        {
+            if( F.Source == *It )
+            {
+                bDuplicate = true;
+                break;
+            }
+        }
+        
+        if( bDuplicate )
+            continue;
+        
+        auto Path   = GetSourcePath( *It );
+        auto Source = new (std::nothrow) Image();
+        
+        if( !Source || Path.empty() || !Source->initWithImageFile( Path ) )
+        {
+            cocos2d::log( "[Atlas] Couldnt load '%s' for atlas '%s'", It->c_str(), Name.c_str() );
+            CC_SAFE_RELEASE( Source );
+            continue;
+        }
+        
+        auto Format = Source->getRenderFormat();
+        if( Format != Texture2D::PixelFormat::RGBA8888 && Format != Texture2D::PixelFormat::RGB888 )
+        {
+            cocos2d::log( "[Atlas] Left '%s' out of atlas '%s', only 8 bit rgb and rgba images can be packed", It->c_str(), Name.c_str() );
+            Source->release();
+            continue;
+        }
+        
+        if( Source->getWidth() > ATLAS_MAX_SOURCE_SIZE || Source->getHeight() > ATLAS_MAX_SOURCE_SIZE )
+        {
+            Source->release();
+            continue;
+        }
+        
+        AtlasFrame Frame;
+        Frame.Source    = *It;
+        Frame.Page      = 0;
+        Frame.X         = 0;
+        Frame.Y         = 0;
+        Frame.Width     = (uint32) Source->getWidth();
+        Frame.Height    = (uint32) Source->getHeight();
+        
+        Frames.push_back( Frame );
+        Images.push_back( Source );
+    }
+    
+    auto PageHeights = PackFrames( Frames );
+    bool bSuccess = true;
+    
+    std::vector< std::string > Pages;
+    for( size_t Page = 0; Page < PageHeights.size() && bSuccess; Page++ )
+    {
+        uint32 Height = NextPowerOfTwo( PageHeights[ Page ] );
+        std::vector< uint8 > Pixels( (size_t) ATLAS_PAGE_SIZE * Height * 4, 0 );
+        
+        for( size_t i = 0; i < Frames.size(); i++ )
+        {
+            if( Frames[ i ].Page == Page )
+                BlitFrame( Pixels, ATLAS_PAGE_SIZE, Frames[ i ], Images[ i ] );
+        }
+        
+        auto PagePath   = GetPagePath( Name, Page );
+        auto Output     = new (std::nothrow) Image();
+        
+        if( !Output || !Output->initWithRawData( Pixels.data(), (ssize_t) Pixels.size(), ATLAS_PAGE_SIZE, Height, 8, false ) ||
+            !Output->saveToFile( Root + "/" + PagePath, false ) )
+        {
+            cocos2d::log( "[Atlas] Failed to write page %lu of atlas '%s'", Page, Name.c_str() );
+            bSuccess = false;
+        }
+        
+        CC_SAFE_RELEASE( Output );
+        Pages.push_back( PagePath );
+    }
+    
+    for( auto It = Images.begin(); It != Images.end(); It++ )
+        (*It)->release();
+    
+    if( !bSuccess )
+        return false;
+    
+    // Write the index, pages go first so an index never points at pages that dont exist yet
+    Document Doc;
+    Doc.SetObject();
+    
+    auto& Allocator = Doc.GetAllocator();
+    auto Key        = GetSourceKey( Sources );
+    
+    Doc.AddMember( "Version", ATLAS_INDEX_VERSION, Allocator );
+    Doc.AddMember( "Key", StringRef( Key ), Allocator );
+    
+    rapidjson::Value PageList( kArrayType );
+    for( auto& P : Pages )
+        PageList.PushBack( StringRef( P ), Allocator );
+    
+    rapidjson::Value FrameList( kArrayType );
+    for( auto& F : Frames )
+    {
+        rapidjson::Value Entry( kObjectType );
+        Entry.AddMember( "Source", StringRef( F.Source ), Allocator );
+        Entry.AddMember( "Page", F.Page, Allocator );
+        Entry.AddMember( "X", F.X, Allocator );
+        Entry.AddMember( "Y", F.Y, Allocator );
+        Entry.AddMember( "Width", F.Width, Allocator );
+        Entry.AddMember( "Height", F.Height, Allocator );
+        
+        FrameList.PushBack( Entry, Allocator );
+    }
+    
+    Doc.AddMember( "Pages", PageList, Allocator );
+    Doc.AddMember( "Frames", FrameList, Allocator );
+    
+    StringBuffer Buffer;
+    Writer< StringBuffer > writer( Buffer );
+    Doc.Accept( writer );
+    
+    if( !Storage->WriteFile( GetIndexPath( Name ), std::string( Buffer.GetString() ) ) )
+    {
+        cocos2d::log( "[Atlas] Failed to write the index for atlas '%s'", Name.c_str() );
+        return false;
+    }
+    
+    // Pages left over from an earlier build that needed more of them
+    for( size_t Page = Pages.size(); Storage->FileExists( GetPagePath( Name, Page ) ); Page++ )
+        Storage->DeleteFile( GetPagePath( Name, Page ) );
+    
+    cocos2d::log( "[Atlas] Built atlas '%s', %lu images on %lu pages", Name.c_str(), Frames.size(), Pages.size() );
+    return true;
+}
+
+
+bool TextureAtlas::Load( const std::string& Name, const std::vector< std::string >& Sources )
+{
+    auto Storage = IContentSystem::GetStorage();
+    if( !Storage->FileExists( GetIndexPath( Name ) ) )
+        return false;
+    
+    Document Doc;
+    std::string Index = Storage->ReadFileStr( GetIndexPath( Name ) );
+    
+    if( Doc.Parse( Index ).HasParseError() || !Doc.IsObject() || !Doc.HasMember( "Version" ) || !Doc[ "Version" ].IsUint() ||
+        !Doc.HasMember( "Key" ) || !Doc[ "Key" ].IsString() || !Doc.HasMember( "Pages" ) || !Doc[ "Pages" ].IsArray() ||
+        !Doc.HasMember( "Frames" ) || !Doc[ "Frames" ].IsArray() )
+    {
+        cocos2d::log( "[Atlas] Index for atlas '%s' is invalid", Name.c_str() );
+        return false;
+    }
+    
+    if( Doc[ "Version" ].GetUint() != ATLAS_INDEX_VERSION || GetSourceKey( Sources ) != Doc[ "Key" ].GetString() )
+    {
+        cocos2d::log( "[Atlas] Index for atlas '%s' is out of date", Name.c_str() );
+        return false;
+    }
+    
+    // Everything is checked before anything is loaded, so a bad index gets rebuilt instead of half loaded
+    for( auto It = Doc[ "Pages" ].Begin(); It != Doc[ "Pages" ].End(); It++ )
+    {
+        if( !It->IsString() )
+        {
+            cocos2d::log( "[Atlas] Index for atlas '%s' has an invalid page", Name.c_str() );
+            return false;
+        }
+    }
+    
+    static const char* FrameFields[] = { "Page", "X", "Y", "Width", "Height" };
+    for( auto It = Doc[ "Frames" ].Begin(); It != Doc[ "Frames" ].End(); It++ )
+    {
+        bool bValid = It->IsObject() && It->HasMember( "Source" ) && (*It)[ "Source" ].IsString();
+        for( auto Field : FrameFields )
+            bValid = bValid && It->HasMember( Field ) && (*It)[ Field ].IsUint();
+        
+        if( !bValid || (*It)[ "Page" ].GetUint() >= Doc[ "Pages" ].Size() )
+        {
+            cocos2d::log( "[Atlas] Index for atlas '%s' contains an invalid frame", Name.c_str() );
+            return false;
+        }
+        
+        // Pages are never built wider or taller than this, so a frame past it cant be right whatever the page holds
+        uint64 Right    = (uint64)(*It)[ "X" ].GetUint() + (*It)[ "Width" ].GetUint();
+        uint64 Bottom   = (uint64)(*It)[ "Y" ].GetUint() + (*It)[ "Height" ].GetUint();
+        
+        if( Right > ATLAS_PAGE_SIZE || Bottom > ATLAS_PAGE_SIZE )
+        {
+            cocos2d::log( "[Atlas] Index for atlas '%s' has frame '%s' outside of its page", Name.c_str(), (*It)[ "Source" ].GetString() );
+            return false;
+        }
+    }
+    
+    Unload( Name );
+    
+    auto Cache = Director::getInstance()->getTextureCache();
+    std::vector< Texture2D* > Pages;
+    
+    for( auto It = Doc[ "Pages" ].Begin(); It != Doc[ "Pages" ].End(); It++ )
+    {
+        // The page could have been rebuilt since it was last cached
+        std::string Path = Utils::GetContentDir() + "/" + It->GetString();
+        Cache->removeTextureForKey( Path );
+        
+        auto Texture = Cache->addImage( Path );
+        if( !Texture )
+        {
+            cocos2d::log( "[Atlas] Failed to load page '%s' of atlas '%s'", It->GetString(), Name.c_str() );
+            return false;
+        }
+        
+        Pages.push_back( Texture );
+    }
+    
+    // The last page is cut down to the height it uses, so frames are checked against the pages that were loaded too
+    for( auto It = Doc[ "Frames" ].Begin(); It != Doc[ "Frames" ].End(); It++ )
+    {
+        auto Page       = Pages[ (*It)[ "Page" ].GetUint() ];
+        uint64 Right    = (uint64)(*It)[ "X" ].GetUint() + (*It)[ "Width" ].GetUint();
+        uint64 Bottom   = (uint64)(*It)[ "Y" ].GetUint() + (*It)[ "Height" ].GetUint();
+        
+        if( Right > (uint64) Page->getPixelsWide() || Bottom > (uint64) Page->getPixelsHigh() )
+        {
+            cocos2d::log( "[Atlas] Index for atlas '%s' has frame '%s' outside of its page", Name.c_str(), (*It)[ "Source" ].GetString() );
+            return false;
+        }
+    }
+    
+    auto& Registry  = GetRegistry();
+    auto& Loaded    = Registry.Sources[ Name ];
+    
+    for( auto It = Doc[ "Frames" ].Begin(); It != Doc[ "Frames" ].End(); It++ )
+    {
+        uint32 Page = (*It)[ "Page" ].GetUint();
+        cocos2d::Rect Area( (float)(*It)[ "X" ].GetUint(), (float)(*It)[ "Y" ].GetUint(), (float)(*It)[ "Width" ].GetUint(), (float)(*It)[ "Height" ].GetUint() );
+        
+        auto Frame = SpriteFrame::createWithTexture( Pages[ Page ], CC_RECT_PIXELS_TO_POINTS( Area ) );
+        if( !Frame )
+            continue;
+        
+        std::string Source = (*It)[ "Source" ].GetString();
+        Registry.Frames.insert( Source, Frame );
+        Loaded.push_back( Source );
+    }
+    
+    cocos2d::log( "[Atlas] Loaded atlas '%s', %lu frames on %lu pages", Name.c_str(), Loaded.size(), Pages.size() );
+    return true;
+}
+
+
+void TextureAtlas::Unload( const std::string& Name )
+{
+    auto& Registry = GetRegistry();
+    
+    auto Loaded = Registry.Sources.find( Name );
+    if( Loaded == Registry.Sources.end() )
+        return;
+    
+    // Sprites still using these frames keep the pages alive until theyre gone
+    for( auto& S : Loaded->second )
+        Registry.Frames.erase( S );
+    
+    Registry.Sources.erase( Loaded );
+}
+
+
+SpriteFrame* TextureAtlas::GetFrame( const std::string& Source )
+{
+    return GetRegistry().Frames.at( Source );
+}
+
+
+Sprite* TextureAtlas::CreateSprite( const std::string& Source )
+{
+    auto Frame = GetFrame( Source );
+    return Frame ? Sprite::createWithSpriteFrame( Frame ) : Sprite::create( Source );
+}
+
+
+bool TextureAtlas::BuildCardAtlas()
+{
+    auto Sources = GetCardSources();
+    if( !Build( CARD_ATLAS_NAME, Sources ) )
+        return false;
+    
+    return Load( CARD_ATLAS_NAME, Sources );
+}
+
+
+bool TextureAtlas::LoadCardAtlas()
+{
+    return Load( CARD_ATLAS_NAME, GetCardSources() ) || BuildCardAtlas();
+}
+
+
+std::vector< std::string > TextureAtlas::GetCardSources()
+{
+    std::vector< std::string > Output( std::begin( s_CardImages ), std::end( s_CardImages ) );
+    
+    // Card art from content updates is installed under img/
+    std::vector< LocalBlock > Blocks;
+    IContentSystem::GetStorage()->ReadLocalBlocks( Blocks );
+    
+    auto file = FileUtils::getInstance();
+    for( auto& B : Blocks )
+    {
+        for( auto& F : B.Files )
+        {
+            if( F.compare( 0, 4, "img/" ) == 0 && file->getFileExtension( F ) == ".png" )
+                Output.push_back( F );
+        }
+    }
+    
+    return Output;
+}
+
+
+std::string TextureAtlas::GetSourcePath( const std::string& Source )
+{
+    // Installed content isnt in the search paths, so it has to be checked for first
+    if( IContentSystem::GetStorage()->FileExists( Source ) )
+        return Utils::GetContentDir() + "/" + Source;
+    
+    return FileUtils::getInstance()->fullPathForFilename( Source );
+}
+
+
+std::string TextureAtlas::GetSourceKey( const std::vector< std::string >& Sources )
+{
+    // FNV-1a, its only used to tell one set of sources from another
+    uint64 Hash = 14695981039346656037ULL;
+    auto Mix = [ &Hash ]( const std::string& In )
+    {
+        for( auto C : In )
+        {
+            Hash ^= (uint8) C;
+            Hash *= 1099511628211ULL;
+        }
+        
+        // Seperator, so 'ab' + 'c' and 'a' + 'bc' dont hash the same
+        Hash ^= 0xFF;
+        Hash *= 1099511628211ULL;
+    };
+    
+    // Bundled images only change with the app, and the size is enough to tell when they did
+    auto file = FileUtils::getInstance();
+    for( auto& S : Sources )
+    {
+        auto Path = GetSourcePath( S );
+        
+        Mix( S );
+        Mix( std::to_string( Path.empty() ? -1L : (long) file->getFileSize( Path ) ) );
+    }
+    
+    // Installed art is covered by the hash of the block it came in
+    std::vector< LocalBlock > Blocks;
+    IContentSystem::GetStorage()->ReadLocalBlocks( Blocks );
+    
+    for( auto& B : Blocks )
+    {
+        Mix( B.Identifier );
+        Mix( B.Hash );
+    }
+    
+    char Buffer[ 17 ];
+    snprintf( Buffer, sizeof( Buffer ), "%016llx", (unsigned long long) Hash );
+    
+    return std::string( Buffer );
+}
@@ -0,0 +1,93 @@
+//
+//    TextureAtlas.hpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Numeric.hpp"
+#include "cocos2d.h"
+#include <string>
+#include <vector>
+
+// Atlas Layout
+// Pages are square, the last page is cut down to the height it uses. Every image gets padding on all sides,
+// filled with its own edge pixels, so filtering at the edge of a frame doesnt pull in its neighbours
+#define ATLAS_PAGE_SIZE 2048
+#define ATLAS_PADDING 2
+#define ATLAS_INDEX_VERSION 2
+#define ATLAS_DIRECTORY "atlas"
+
+// Images bigger than this on either side stay separate textures, like the full sized card art
+#define ATLAS_MAX_SOURCE_SIZE 512
+
+// Card Atlas
+// Card backs and overlays bundled with the app, and card art installed with content updates
+#define CARD_ATLAS_NAME "cards"
+
+namespace Regicide
+{
+    /*====================================================
+        Atlas Index Entry
+     ====================================================*/
+    struct AtlasFrame
+    {
+        std::string Source;
+        uint32 Page;
+        
+        // In pixels, from the top left of the page, not including padding
+        uint32 X;
+        uint32 Y;
+        uint32 Width;
+        uint32 Height;
+    };
+    
+    // Packs images that are drawn together into a few large pages, so sprites using them batch into
+    // a handful of draw calls instead of switching textures for every card
+    //
+    // Atlases are built when content is installed, and written to the content directory, along with an
+    // index of which page and rect each source image ended up in. Loading an atlas registers a sprite
+    // frame for each source under its file name, so code that would load a texture by name can ask for
+    // the frame first, and falls back to the texture for anything that wasnt packed
+    //
+    // The index keeps a key made from the sources it was built from, so an atlas is only loaded when the
+    // art it was built from hasnt changed since
+    class TextureAtlas
+    {
+    public:
+    
+        // Packs the sources and writes the pages and index, sources are looked up in the content directory
+        // first and in the search paths after that
+        static bool Build( const std::string& Name, const std::vector< std::string >& Sources );
+        
+        // Loads the pages and registers a frame for every source, false if the atlas hasnt been built, its
+        // index is invalid, or it was built from different sources
+        static bool Load( const std::string& Name, const std::vector< std::string >& Sources );
+        static void Unload( const std::string& Name );
+        
+        // Frame for a packed image, null if it wasnt packed
+        static cocos2d::SpriteFrame* GetFrame( const std::string& Source );
+        
+        // Sprite drawn from the atlas when the image was packed, or from its own texture when it wasnt
+        static cocos2d::Sprite* CreateSprite( const std::string& Source );
+        
+        // Builds and loads the card atlas, run after content updates are installed
+        static bool BuildCardAtlas();
+        
+        // Loads the card atlas, building it first if its missing
+        static bool LoadCardAtlas();
+    
+    private:
+    
+        static std::vector< std::string > GetCardSources();
+        static std::string GetSourcePath( const std::string& Source );
+        
+        // Hash of each source name and file size, and the hash of every installed content block
+        static std::string GetSourceKey( const std::vector< std::string >& Sources );
+    };
+}
@@ -36,6 +36,7 @@
 #include "Scenes/MainMenuScene.hpp"
 #include "Scenes/IntroScene.hpp"
 #include "CMS/IContentSystem.hpp"
+#include "CMS/TextureAtlas.hpp"
 #include "Scenes/UpdateScene.hpp"
 #include <chrono>
 #include "RegicideAPI/API.hpp"
@@ -51,6 +52,7 @@
 #include "Game/SingleplayerAuthority.hpp"
 #include <future>
 #include "UI/ExitOverlay.hpp"
+#include "Game/BlitzBook.hpp"
 
 using namespace Regicide;
 
@@ -92,6 +94,9 @@ AppDelegate::AppDelegate()
 
 AppDelegate::~AppDelegate() 
 {
+    // Pooled cards hold on to sprites, so they go while cocos is still around
+    Game::CardManager::GetInstance().ClearPool();
+    
 #if USE_AUDIO_ENGINE
     AudioEngine::end();
 #elif USE_SIMPLE_AUDIO_ENGINE
@@ -150,10 +155,17 @@ bool AppDelegate::applicationDidFinishLaunching() {
     paths.push_back( "LuaScripts" );
     file->setSearchPaths( paths );
     
+    // Load AI opening book
+    Game::BlitzBook::GetInstance().Load( BLITZ_BOOK_FILE );
+    
     
     // Initialize Content System
     Regicide::IContentSystem::Init();
     
+    // Card art is drawn from the atlas built when content was installed, first launch builds it from whats bundled
+    if( !Regicide::TextureAtlas::LoadCardAtlas() )
+        cocos2d::log( "[App] Failed to load the card atlas, cards will use separate textures" );
+    
     // Check if theres an account stored locally
     auto ActManager = Regicide::IContentSystem::GetAccounts();
     
@@ -203,6 +215,9 @@ bool AppDelegate::applicationDidFinishLaunching() {
     // Initialize Lua Engine
     LuaEngine::GetInstance()->Init();
     
+    // Keep cards built between matches, so starting the next one doesnt rebuild every sprite
+    Game::CardManager::GetInstance().SetPoolLimit( CARD_POOL_LIMIT );
+    
     // turn on display FPS
     director->setDisplayStats(true);
 
@@ -462,13 +477,10 @@ void AppDelegate::SingleplayerLaunchSuccess()
     
     CC_ASSERT( CardLayer );
     
-    for( auto It = Ent.Begin(); It != Ent.End(); It++ )
+    Ent.ForEachEntity( [ CardLayer ]( Game::EntityBase* Entity )
     {
-        if( It->second )
-        {
-            It->second->AddToScene( CardLayer );
-        }
-    }
+        Entity->AddToScene( CardLayer );
+    } );
     
     Game::World::GetWorld()->PostInit();
     
@@ -17,13 +17,30 @@
 #include "CryptoLibrary.hpp"
 #include "CMS/LuaBindings_CMS.hpp"
 #include "Game/Game_LuaBindings.hpp"
+#include "Game/MatchContext.hpp"
+#include <mutex>
 
 
 using namespace Regicide;
 
+// Files already required, kept per Lua state, since every match context has its own
+static std::map< lua_State*, std::vector< std::string > > LoadedFiles;
+static std::mutex LoadedFilesLock;
+
+static void ForgetRequired( lua_State* L )
+{
+    std::lock_guard< std::mutex > Guard( LoadedFilesLock );
+    LoadedFiles.erase( L );
+}
+
 static LuaEngine* lua_s_Singleton = nullptr;
 LuaEngine* LuaEngine::GetInstance()
 {
+    // Each match context has its own Lua state
+    auto Context = Game::MatchContext::GetCurrent();
+    if( Context )
+        return Context->GetLua();
+    
     if( lua_s_Singleton == nullptr )
     {
         lua_s_Singleton = new (std::nothrow) LuaEngine();
@@ -34,13 +51,20 @@ LuaEngine* LuaEngine::GetInstance()
 
 LuaEngine::LuaEngine()
 {
+    luaState = nullptr;
     _bIsInit = false;
 }
 
 LuaEngine::~LuaEngine()
 {
-    lua_close( luaState );
-    s_Singleton = nullptr;
+    if( luaState )
+    {
+        ForgetRequired( luaState );
+        lua_close( luaState );
+    }
+    
+    if( lua_s_Singleton == this )
+        lua_s_Singleton = nullptr;
 }
 
 static void lua_Print( const char *Str )
@@ -76,7 +100,6 @@ void lua_Include( const std::string& Path, lua_State* L )
     
 }
 
-std::vector< std::string > LoadedFiles;
 void lua_Require( const std::string& File, lua_State* L )
 {
     // To implement the 'require' feature, we need to ensure were not loading the same file twice
@@ -131,14 +154,20 @@ void lua_Require( const std::string& File, lua_State* L )
     }
     
     // Check if this was loaded already
-    for( auto It = LoadedFiles.begin(); It != LoadedFiles.end(); It++ )
     {
-        if( It->compare( FoundFile ) == 0 )
-            return;
+        std::lock_guard< std::mutex > Guard( LoadedFilesLock );
+        auto& Loaded = LoadedFiles[ L ];
+        
+        for( auto It = Loaded.begin(); It != Loaded.end(); It++ )
+        {
+            if( It->compare( FoundFile ) == 0 )
+                return;
+        }
+        
+        // Add file to loaded list, and load it!
+        Loaded.push_back( FoundFile );
     }
     
-    // Add file to loaded list, and load it!
-    LoadedFiles.push_back( FoundFile );
     if( luaL_dofile( L, FoundFile.c_str() ) != 0 )
     {
             cocos2d::log( "Failed to require '%s'! An error occured while loading the file.\nError: %s", FoundFile.c_str(), lua_tostring( L, -1 ) );
@@ -0,0 +1,22 @@
+//
+//    Numeric.cpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "Numeric.hpp"
+#include <atomic>
+#include <random>
+#include <chrono>
+
+
+uint64_t Math::Random::NewSeed()
+{
+    static std::atomic< uint64_t > Counter( ( (uint64_t) std::random_device()() << 32 ) ^
+                                           (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count() );
+    return Counter.fetch_add( 0x632BE59BD9B4E019ULL );
+}
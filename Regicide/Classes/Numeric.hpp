@@ -76,5 +76,37 @@ namespace Math
         return In < (T)0 ? -In : In;
     }
     
+    // Small and fast random number generator (splitmix64) for anything that needs its own random
+    // stream, cocos2d::random shares one generator between every thread
+    class Random
+    {
+    public:
+        
+        Random() : State( NewSeed() ) {}
+        explicit Random( uint64_t Seed ) : State( Seed ) {}
+        
+        inline uint64_t Next()
+        {
+            uint64_t Z = ( State += 0x9E3779B97F4A7C15ULL );
+            Z = ( Z ^ ( Z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+            Z = ( Z ^ ( Z >> 27 ) ) * 0x94D049BB133111EBULL;
+            return Z ^ ( Z >> 31 );
+        }
+        
+        // Inclusive, same as cocos2d::random( Min, Max )
+        inline int Range( int Min, int Max )
+        {
+            return Max > Min ? Min + (int)( Next() % (uint64_t)( Max - Min + 1 ) ) : Min;
+        }
+        
+        inline void Seed( uint64_t In ) { State = In; }
+        
+        // Every generator gets a different seed, even when created at the same time on different threads
+        static uint64_t NewSeed();
+        
+    private:
+        
+        uint64_t State;
+    };
     
 }
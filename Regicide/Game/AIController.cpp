@@ -53,6 +53,11 @@
 #include "SingleplayerAuthority.hpp"
 #include "DeckEntity.hpp"
 #include "Numeric.hpp"
+#include "BlitzBook.hpp"
+#include "AITelemetry.hpp"
+#include "MatchContext.hpp"
+#include <set>
+#include <algorithm>
 
 using namespace Game;
 
@@ -68,12 +73,20 @@ AIController::AIController()
 : EntityBase( "AIController" )
 {
     State = AIState::Init;
+    bBatchSimulate = false;
+    Context = nullptr;
 }
 
 void AIController::Initialize()
 {
     EntityBase::Initialize();
     
+    // Headless matches run inside their own context, the think thread has to search in that one too
+    // Its seeded here, on the match thread, so a context with a fixed seed still replays the same searches
+    Context = MatchContext::GetCurrent();
+    if( Context )
+        SearchRng.Seed( Context->GetRandom().Next() );
+    
     Thread = std::make_shared< std::thread >( std::thread( &AIController::StartThink, this ) );
 }
 
@@ -95,6 +108,10 @@ void AIController::Cleanup()
     }
     
     cocos2d::log( "[AI] Thread Shutdown!" );
+    
+#ifdef AI_TELEMETRY_FILE
+    Telemetry.SaveChromeTrace( cocos2d::FileUtils::getInstance()->getWritablePath() + AI_TELEMETRY_FILE );
+#endif
 }
 
 
@@ -112,6 +129,11 @@ void AIController::StartThink()
     cocos2d::log( "[AI] Thread Initializing..." );
     State = AIState::Idle;
     
+    // Everything this thread searches is recorded by this controller
+    AITelemetry::Scope Record( std::addressof( Telemetry ) );
+    MatchContext::Scope Enter( Context );
+    GameStateBase::SeedScope Seeds( std::addressof( SearchRng ) );
+    
     std::chrono::steady_clock::time_point NextTick = std::chrono::steady_clock::now() + std::chrono::milliseconds( 50 );
     while( State != AIState::Exit )
     {
@@ -167,16 +189,14 @@ void AIController::Push( std::function< void() > Task )
 {
     if( Task )
     {
-        auto dir = cocos2d::Director::getInstance();
-        auto sch = dir ? dir->getScheduler() : nullptr;
-        
-        if( !sch )
+        auto Auth = GetAuthority();
+        if( !Auth )
         {
-            cocos2d::log( "[AI] Failed to push work back to cocos2d! Couldnt get scheduler!" );
+            cocos2d::log( "[AI] Failed to push work back to the game thread! Couldnt get authority!" );
             return;
         }
         
-        sch->performFunctionInCocosThread( Task );
+        Auth->GetScheduler().Dispatch( Task );
     }
 }
 
@@ -272,7 +292,10 @@ void AIController::DoBuildPlay( Decision& Base )
                 Node.Move = Cards;
                 
                 // Copy over existing statee
-                Node.State.CopyFrom( Base.State );
+                {
+                    AIPhaseScope CopyScope( AIPhase::Copy );
+                    Node.State.CopyFrom( Base.State );
+                }
                 
                 // Attempt to play new card
                 if( !Node.State.PlayCard( Node.State.GetOpponent(), It->EntId ) )
@@ -291,19 +314,24 @@ void AIController::DoBuildPlay( Decision& Base )
 }
 
 
-void AIController::BuildPlayOptions( MoveType inType )
+void AIController::BuildPlayOptions( MoveType inType, GameStateBase* Source )
 {
     CC_ASSERT( inType == MoveType::Blitz || inType == MoveType::Play );
+    AIPhaseScope Scope( AIPhase::Enumerate );
     
     DecisionList.clear();
+    PendingMoves.clear();
     SimulationCount = 0;
     
     auto Node = Decision();
     Node.Type = inType;
     
-    // Sync state to base reality
-    auto Auth = GetAuthority();
-    Node.State.CopyFrom( Auth->GetState() );
+    // Sync state to base reality, unless were searching a state built by the caller
+    // The offline book generator has no authority, so its only looked up when needed
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        Node.State.CopyFrom( Source ? *Source : GetAuthority()->GetState() );
+    }
 
     // This is the base option (no cards played)
     // So were going to add it to the decision list, then start adding play options
@@ -313,57 +341,118 @@ void AIController::BuildPlayOptions( MoveType inType )
 }
 
 
-void AIController::DoBuildAttack( Decision& Base )
+static bool QueueMove( std::vector< std::pair< uint32_t, uint32_t > > Move, std::set< std::vector< std::pair< uint32_t, uint32_t > > >& Seen,
+                       std::deque< std::vector< std::pair< uint32_t, uint32_t > > >& Out )
+{
+    // Moves are stored in a canonical order, so duplicate checks are a single set lookup
+    // instead of comparing against every option we already built
+    if( Out.size() >= AI_WIDEN_MAX )
+        return false;
+    
+    std::sort( Move.begin(), Move.end() );
+    if( !Seen.insert( Move ).second )
+        return false;
+    
+    Out.push_back( Move );
+    return true;
+}
+
+
+void AIController::DoBuildAttack( Decision& Base, const std::vector< uint32_t >& Exclude /* = std::vector< uint32_t >() */ )
 {
     auto& Sim = Base.State;
     auto Player = Sim.GetOpponent();
-    CCASSERT( Player, "[AI] Opponent object is null!" );
+    auto Enemy = Sim.GetPlayer();
+    CCASSERT( Player && Enemy, "[AI] Opponent object is null!" );
     
+    if( Player->Field.empty() )
+        return;
+    
+    // Instead of building every possible attacker combination (2^n), were going to order the options
+    // so the most likely good attacks come first, and let the search widen into the rest as it needs them
+    // First, rank our cards by how safely they can attack, cards that cant be blocked profitably go first
+    int EnemyMaxPower = 0;
+    for( auto It = Enemy->Field.begin(); It != Enemy->Field.end(); It++ )
+        EnemyMaxPower = It->Power > EnemyMaxPower ? It->Power : EnemyMaxPower;
+    
+    std::vector< std::pair< int, uint32_t > > Ranked;
     for( auto It = Player->Field.begin(); It != Player->Field.end(); It++ )
     {
-        // If card isnt already attacking, build a node with it
-        bool bAttacking = false;
-        for( auto j = Sim.BattleMatrix.begin(); j != Sim.BattleMatrix.end(); j++ )
+        // Same check the authority runs on attackers, and cards played this turn arent able to attack yet
+        if( It->Power <= 0 || It->Stamina <= 0 )
+            continue;
+        
+        if( std::find( Exclude.begin(), Exclude.end(), It->EntId ) != Exclude.end() )
+            continue;
+        
+        int Rank = It->Power * 2 + It->Stamina;
+        if( It->Power > EnemyMaxPower )
+            Rank += 100;
+        
+        Ranked.push_back( std::make_pair( Rank, It->EntId ) );
+    }
+    
+    std::sort( Ranked.begin(), Ranked.end(),
+              []( const std::pair< int, uint32_t >& A, const std::pair< int, uint32_t >& B ) { return A.first > B.first; } );
+    
+    // The 'do nothing' option is always in the decision list already
+    std::set< std::vector< std::pair< uint32_t, uint32_t > > > Seen;
+    Seen.insert( std::vector< std::pair< uint32_t, uint32_t > >() );
+    
+    int Count = (int) Ranked.size();
+    
+    // Best 'n' cards, for each n
+    for( int i = 1; i <= Count; i++ )
+    {
+        std::vector< std::pair< uint32_t, uint32_t > > Move;
+        for( int j = 0; j < i; j++ )
+            Move.push_back( std::make_pair( Ranked[ j ].second, 0 ) );
+        
+        QueueMove( Move, Seen, PendingMoves );
+    }
+    
+    // Everything except one card
+    for( int i = Count - 1; i >= 0 && Count > 2; i-- )
+    {
+        std::vector< std::pair< uint32_t, uint32_t > > Move;
+        for( int j = 0; j < Count; j++ )
         {
-            if( It->EntId == j->first )
-            {
-                bAttacking = true;
-                break;
-            }
+            if( j != i )
+                Move.push_back( std::make_pair( Ranked[ j ].second, 0 ) );
         }
         
-        if( !bAttacking )
+        QueueMove( Move, Seen, PendingMoves );
+    }
+    
+    // Single attackers
+    for( int i = 1; i < Count; i++ )
+    {
+        QueueMove( { std::make_pair( Ranked[ i ].second, 0 ) }, Seen, PendingMoves );
+    }
+    
+    // Fill the rest with random subsets, these are only reached once the search is deep enough
+    int Attempts = AI_WIDEN_MAX * 2;
+    while( Count > 3 && PendingMoves.size() < AI_WIDEN_MAX && Attempts-- > 0 )
+    {
+        std::vector< std::pair< uint32_t, uint32_t > > Move;
+        for( int i = 0; i < Count; i++ )
         {
-            // TODO: Check if this card can actually attack
-            std::vector< std::pair< uint32_t, uint32_t > > Cards( Base.Move.begin(), Base.Move.end() );
-            Cards.push_back( std::make_pair( It->EntId, 0 ) );
-            
-            // Check if this combination exists
-            if( !DecisionExists( Cards, false ) )
-            {
-                auto Node = Decision();
-                Node.Move = Cards;
-                
-                // Copy over state
-                Node.State.CopyFrom( Sim );
-                Node.State.BattleMatrix = Sim.BattleMatrix;
-                
-                // Add card to battle matrix
-                Node.State.BattleMatrix[ It->EntId ] = std::vector< uint32_t >();
-                Node.Type = MoveType::Attack;
-                
-                // Add to list, and continue building
-                DecisionList.push_back( Node );
-                DoBuildAttack( Node );
-            }
+            if( cocos2d::random( 0, 1 ) == 1 )
+                Move.push_back( std::make_pair( Ranked[ i ].second, 0 ) );
         }
+        
+        if( !Move.empty() )
+            QueueMove( Move, Seen, PendingMoves );
     }
 }
 
 
-void AIController::BuildAttackOptions()
+void AIController::BuildAttackOptions( const std::vector< uint32_t >& Exclude /* = std::vector< uint32_t >() */ )
 {
+    AIPhaseScope Scope( AIPhase::Enumerate );
+    
     DecisionList.clear();
+    PendingMoves.clear();
     SimulationCount = 0;
     
     // Add 'no attack' option
@@ -373,59 +462,28 @@ void AIController::BuildAttackOptions()
     auto Auth = GetAuthority();
     CC_ASSERT( Auth );
     
-    Node.State.CopyFrom( Auth->GetState() );
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        Node.State.CopyFrom( Auth->GetState() );
+    }
     
     DecisionList.push_back( Node );
-    DoBuildAttack( Node );
-}
-
-bool CheckOptions( std::map< uint32_t, std::vector< uint32_t > > First, std::map< uint32_t, std::vector< uint32_t > > Second )
-{
-    // If the number of attakcers are different, then theyre not the same
-    if( First.size() != Second.size() )
-        return false;
     
-    // Loop through each attacker
-    for( auto It = First.begin(); It != First.end(); It++ )
-    {
-        // Check if the other list has this attacker
-        if( Second.count( It->first ) == 0 )
-        {
-            // They dont have the same attackers
-            return false;
-        }
-        else
-        {
-            // Check if the elements in the vectors are the same
-            for( auto j = It->second.begin(); j != It->second.end(); j++ ) // Loop through first vector
-            {
-                // Check for element in second vector
-                bool bFound = false;
-                for( auto k = Second[ It->first ].begin(); k != Second[ It->first ].end(); k++ )
-                {
-                    if( *j == *k )
-                    {
-                        bFound = true;
-                        break;
-                    }
-                }
-                
-                // If the element wasnt in the second vector, then the two are different
-                if( !bFound )
-                    return false;
-            }
-        }
-    }
+    WidenBase = Node;
+    DoBuildAttack( WidenBase, Exclude );
     
-    return true;
+    // Start off with the best few options, the rest are added while simulating
+    while( DecisionList.size() < AI_WIDEN_INITIAL && WidenSearch() ) {}
 }
 
+
 void AIController::DoBuildBlock( Decision &Base )
 {
     auto& Sim = Base.State;
     auto Player = Sim.GetOpponent();
+    auto Enemy = Sim.GetPlayer();
 
-    CCASSERT( Player && Attacker, "[AI] Opponent object is null!" );
+    CCASSERT( Player && Enemy, "[AI] Opponent object is null!" );
     
     int FieldSize = (int) Player->Field.size();
     int AttackerSize = (int) Sim.BattleMatrix.size();
@@ -433,117 +491,362 @@ void AIController::DoBuildBlock( Decision &Base )
     if( AttackerSize == 0 || FieldSize == 0 )
         return;
     
-    // Were going to come up with 100 random, non-repeating blocking deicisions
-    // In the future, we can improve this by trying to suggest slightly better decisions
-    // Basically, using some basic rules to manipulate the initial options available to the AI
-    
-    // We can create some tuned options.. try and select some 1:1 blocker options
+    // Instead of generating 100 random blocking options, were going to build a short list of
+    // rule based options first (good blocks, trades, full 1:1 blocks, gang blocks) and then pad the
+    // list with random options. Only the first few get simulated, and the search widens as needed
+    std::vector< CardState* > Attackers;
+    for( auto It = Sim.BattleMatrix.begin(); It != Sim.BattleMatrix.end(); It++ )
+    {
+        CardState* Card = nullptr;
+        if( Sim.FindCard( It->first, Enemy, Card, true ) && Card )
+            Attackers.push_back( Card );
+    }
     
-    int NeededOptions = 100;
-    int CreatedOptions = 0;
-    int Repeats = 0;
+    std::vector< CardState* > Blockers;
+    for( auto It = Player->Field.begin(); It != Player->Field.end(); It++ )
+        Blockers.push_back( std::addressof( *It ) );
     
-    std::vector< std::map< uint32_t, std::vector< uint32_t > > > Output;
+    if( Attackers.empty() )
+        return;
     
-    std::vector< uint32_t > AllAttackers;
-    for( auto It = Sim.BattleMatrix.begin(); It != Sim.BattleMatrix.end(); It++ )
-        AllAttackers.push_back( It->first );
+    // Deal with the strongest attackers first, and try to use our weakest cards that get the job done
+    std::sort( Attackers.begin(), Attackers.end(), []( CardState* A, CardState* B ) { return A->Power > B->Power; } );
+    std::sort( Blockers.begin(), Blockers.end(), []( CardState* A, CardState* B ) { return A->Power < B->Power; } );
     
-    std::vector< uint32_t > AllBlockers;
-    for( auto It = Player->Field.begin(); It != Player->Field.end(); It++ )
-        AllBlockers.push_back( It->EntId );
+    // The 'do nothing' option is always in the decision list already
+    std::set< std::vector< std::pair< uint32_t, uint32_t > > > Seen;
+    Seen.insert( std::vector< std::pair< uint32_t, uint32_t > >() );
     
-    while( CreatedOptions < NeededOptions && Repeats < 10 )
+    // Builds a 1:1 block, where a blocker is allowed if the check passes
+    auto BuildOneToOne = [ & ]( std::function< bool( CardState*, CardState* ) > Check )
     {
-        std::map< uint32_t, std::vector< uint32_t > > Option;
-        for( auto It = AllAttackers.begin(); It != AllAttackers.end(); It++ )
-            Option[ *It ] = std::vector< uint32_t >();
+        std::vector< std::pair< uint32_t, uint32_t > > Move;
+        std::vector< CardState* > Available( Blockers.begin(), Blockers.end() );
         
-        std::vector< uint32_t > AvailableBlockers( AllBlockers.begin(), AllBlockers.end() );
+        for( auto It = Attackers.begin(); It != Attackers.end(); It++ )
+        {
+            for( auto j = Available.begin(); j != Available.end(); j++ )
+            {
+                if( Check( *It, *j ) )
+                {
+                    Move.push_back( std::make_pair( (*j)->EntId, (*It)->EntId ) );
+                    Available.erase( j );
+                    break;
+                }
+            }
+        }
         
-        // Create a totally random block/attack matchup
-        int BlockerCount = FieldSize > 1 ? cocos2d::random( 1, FieldSize ) : 1;
+        if( !Move.empty() )
+            QueueMove( Move, Seen, PendingMoves );
+    };
+    
+    // Blocks where our card kills the attacker and survives
+    BuildOneToOne( []( CardState* A, CardState* B ) { return B->Power > A->Power && B->Stamina > 1; } );
+    
+    // Blocks where we at least trade
+    BuildOneToOne( []( CardState* A, CardState* B ) { return B->Power >= A->Power; } );
+    
+    // Block everything we can
+    BuildOneToOne( []( CardState*, CardState* ) { return true; } );
+    
+    // Gang block the strongest attacker with our two strongest cards
+    if( Blockers.size() > 1 )
+    {
+        auto Strongest = Attackers.front();
+        QueueMove( { std::make_pair( Blockers[ Blockers.size() - 1 ]->EntId, Strongest->EntId ),
+                     std::make_pair( Blockers[ Blockers.size() - 2 ]->EntId, Strongest->EntId ) }, Seen, PendingMoves );
+    }
+    
+    // Single blocks on each attacker, using the first blocker that doesnt lose
+    for( auto It = Attackers.begin(); It != Attackers.end(); It++ )
+    {
+        for( auto j = Blockers.begin(); j != Blockers.end(); j++ )
+        {
+            if( (*j)->Power >= (*It)->Power || j + 1 == Blockers.end() )
+            {
+                QueueMove( { std::make_pair( (*j)->EntId, (*It)->EntId ) }, Seen, PendingMoves );
+                break;
+            }
+        }
+    }
+    
+    // Pad with random options, until we hit the cap or keep generating repeats
+    int Repeats = 0;
+    while( PendingMoves.size() < AI_WIDEN_MAX && Repeats < 10 )
+    {
+        std::vector< std::pair< uint32_t, uint32_t > > Move;
+        std::vector< CardState* > Available( Blockers.begin(), Blockers.end() );
         
+        int BlockerCount = FieldSize > 1 ? cocos2d::random( 1, FieldSize ) : 1;
         for( int i = 0; i < BlockerCount; i++ )
         {
-            // Pick random attacker to match blocker with
-            int AttackerIndex = AllAttackers.size() > 1 ? cocos2d::random( 0, (int)AllAttackers.size() - 1 ) : 0;
-            uint32_t Attacker = AllAttackers.at( AttackerIndex );
+            int AttackerIndex = Attackers.size() > 1 ? cocos2d::random( 0, (int) Attackers.size() - 1 ) : 0;
+            int BlockerIndex = Available.size() > 1 ? cocos2d::random( 0, (int) Available.size() - 1 ) : 0;
             
-            // Now pick random blocker
-            int BlockerIndex = AvailableBlockers.size() > 1 ? cocos2d::random( 0, (int) AvailableBlockers.size() - 1 ) : 0;
-            auto It = AvailableBlockers.begin();
+            auto It = Available.begin();
             std::advance( It, BlockerIndex );
             
-            uint32_t Blocker = *It;
-            AvailableBlockers.erase( It );
-            
-            Option[ Attacker ].push_back( Blocker );
+            Move.push_back( std::make_pair( (*It)->EntId, Attackers[ AttackerIndex ]->EntId ) );
+            Available.erase( It );
         }
         
-        // Check if this option already exists
-        bool bExists = false;
-        for( auto It = Output.begin(); It != Output.end(); It++ )
+        if( !QueueMove( Move, Seen, PendingMoves ) )
+            Repeats++;
+    }
+}
+
+
+void AIController::BuildBlockOptions()
+{
+    AIPhaseScope Scope( AIPhase::Enumerate );
+    
+    DecisionList.clear();
+    PendingMoves.clear();
+    SimulationCount = 0;
+    
+    auto Node = Decision();
+    Node.Type = MoveType::Block;
+    
+    auto Auth = GetAuthority();
+    CC_ASSERT( Auth );
+    
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        Node.State.CopyFrom( Auth->GetState() );
+        Node.State.BattleMatrix = Auth->BattleMatrix;
+    }
+    
+    DecisionList.push_back( Node );
+    
+    WidenBase = Node;
+    DoBuildBlock( WidenBase );
+    
+    while( DecisionList.size() < AI_WIDEN_INITIAL && WidenSearch() ) {}
+}
+
+
+void AIController::DoBuildAbility( Decision& Base, std::vector< Decision >& Out )
+{
+    // Builds an option for each ability the AI could trigger once the plays in the base option are done
+    // Only one ability is triggered per option, chaining them would multiply the options for every play
+    auto Player = Base.State.GetOpponent();
+    CCASSERT( Player, "[AI] Opponent object null!" );
+    
+    auto& CM = CardManager::GetInstance();
+    
+    for( auto It = Player->Field.begin(); It != Player->Field.end(); It++ )
+    {
+        auto Info = CM.GetInfoAddress( It->Id );
+        if( !Info )
+            continue;
+        
+        for( auto j = Info->Abilities.begin(); j != Info->Abilities.end(); j++ )
         {
-            if( CheckOptions( *It, Option ) )
+            // Skip the copy when we cant pay for it, the simulated trigger checks everything else
+            if( j->second.ManaCost > Player->Mana || j->second.StaminaCost > It->Stamina )
+                continue;
+            
+            auto Node = Decision();
+            Node.Type = Base.Type;
+            Node.Move = Base.Move;
+            Node.Move.push_back( std::make_pair( It->EntId, (uint32_t)( AI_TURN_ABILITY | j->first ) ) );
+            
             {
-                bExists = true;
-                break;
+                AIPhaseScope CopyScope( AIPhase::Copy );
+                Node.State.CopyFrom( Base.State );
             }
+            
+            if( !Node.State.TriggerAbility( Node.State.GetOpponent(), It->EntId, (uint8_t) j->first ) )
+                continue;
+            
+            Out.push_back( Node );
         }
-        
-        // If it doesnt exist, then add to output
-        if( !bExists )
+    }
+}
+
+
+void AIController::BuildTurnOptions()
+{
+    AIPhaseScope Scope( AIPhase::Enumerate );
+    
+    // Build every play option first, each play node holds the state after its cards were played
+    BuildPlayOptions( MoveType::Play );
+    
+    std::vector< Decision > PlayNodes;
+    PlayNodes.swap( DecisionList );
+    
+    DecisionList.clear();
+    PendingMoves.clear();
+    SimulationCount = 0;
+    
+    // Now, for each play option, build the abilities that could follow it, and the ordered attack options on top
+    // of each of those. This way the search can find plays and abilities that set up a good attack, instead of
+    // deciding each phase on its own
+    std::vector< std::deque< std::vector< std::pair< uint32_t, uint32_t > > > > Branches;
+    for( auto It = PlayNodes.begin(); It != PlayNodes.end(); It++ )
+    {
+        std::vector< uint32_t > Played;
+        for( auto j = It->Move.begin(); j != It->Move.end(); j++ )
         {
-            cocos2d::log( "[DEBUG] GENERATED NEW RANDOM CHOICE" );
-            Output.push_back( Option );
-            CreatedOptions++;
+            j->second = AI_TURN_PLAY;
+            Played.push_back( j->first );
         }
-        else
+        
+        std::vector< Decision > Variants;
+        Variants.push_back( *It );
+        DoBuildAbility( *It, Variants );
+        
+        for( auto v = Variants.begin(); v != Variants.end(); v++ )
         {
-            Repeats++;
-            cocos2d::log( "[DEBUG] REPEAT OPTION" );
+            PendingMoves.clear();
+            DoBuildAttack( *v, Played );
+            
+            std::deque< std::vector< std::pair< uint32_t, uint32_t > > > Branch;
+            Branch.push_back( v->Move );
+            
+            for( auto j = PendingMoves.begin(); j != PendingMoves.end(); j++ )
+            {
+                std::vector< std::pair< uint32_t, uint32_t > > Move( v->Move.begin(), v->Move.end() );
+                for( auto k = j->begin(); k != j->end(); k++ )
+                    Move.push_back( std::make_pair( k->first, AI_TURN_ATTACK ) );
+                
+                Branch.push_back( Move );
+            }
+            
+            Branches.push_back( Branch );
         }
     }
     
-    // Now we built a list of completley random blocking actions, we need to validate these options
-    for( auto It = Output.begin(); It != Output.end(); It++ )
+    // Interleave the branches, so the first options we expand cover every play and ability option with its
+    // best looking attack, before going deeper into the attack options of any single one
+    PendingMoves.clear();
+    bool bAdded = true;
+    while( bAdded && PendingMoves.size() < AI_PLAN_MAX )
     {
-        auto Node = Decision();
-        Node.Type = MoveType::Block;
-        Node.State.CopyFrom( Base.State );
-        Node.State.BattleMatrix = Base.State.BattleMatrix;
-        
-        for( auto j = It->begin(); j != It->end(); j++ )
+        bAdded = false;
+        for( auto It = Branches.begin(); It != Branches.end() && PendingMoves.size() < AI_PLAN_MAX; It++ )
         {
-            for( auto i = j->second.begin(); i != j->second.end(); i++ )
+            if( !It->empty() )
             {
-                Node.State.BattleMatrix[ j->first ].push_back( *i );
-                Node.Move.push_back( std::make_pair( *i, j->first ) );
+                PendingMoves.push_back( It->front() );
+                It->pop_front();
+                bAdded = true;
             }
         }
-        
-        DecisionList.push_back( Node );
     }
+    
+    // Every turn option is rebuilt from the state before any cards were played
+    WidenBase = PlayNodes.front();
+    WidenBase.Type = MoveType::Turn;
+    WidenBase.Move.clear();
+    WidenBase.State.BattleMatrix.clear();
+    
+    while( DecisionList.size() < AI_WIDEN_INITIAL && WidenSearch() ) {}
 }
 
 
-void AIController::BuildBlockOptions()
+bool AIController::IsPlanValid( GameStateBase& Current ) const
 {
-    DecisionList.clear();
-    SimulationCount = 0;
+    if( !Plan.bValid || Plan.TurnNumber != Current.TurnNumber || Plan.AttackerStats.size() != Plan.Attackers.size() )
+        return false;
+    
+    if( Current.pState != PlayerTurn::Opponent || Current.tState != TurnState::Attack )
+        return false;
     
+    auto Opponent = Current.GetOpponent();
+    if( !Opponent )
+        return false;
+    
+    // The plan expects the stats left after its own plays and abilities, so any attacker that doesnt match
+    // was changed by something the search never saw, and has to be looked at again
+    for( size_t i = 0; i < Plan.Attackers.size(); i++ )
+    {
+        CardState* Card = nullptr;
+        if( !Current.FindCard( Plan.Attackers[ i ], Opponent, Card, true ) || !Card )
+            return false;
+        
+        if( Card->Power <= 0 || Card->Stamina <= 0 )
+            return false;
+        
+        if( Card->Power != Plan.AttackerStats[ i ].first || Card->Stamina != Plan.AttackerStats[ i ].second )
+            return false;
+    }
+    
+    return true;
+}
+
+
+void AIController::AddDecision( const std::vector< std::pair< uint32_t, uint32_t > >& Move )
+{
+    // Build a decision node from the base state and a generated move
     auto Node = Decision();
-    Node.Type = MoveType::Block;
+    Node.Type = WidenBase.Type;
+    Node.Move = Move;
     
-    auto Auth = GetAuthority();
-    CC_ASSERT( Auth );
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        Node.State.CopyFrom( WidenBase.State );
+        Node.State.BattleMatrix = WidenBase.State.BattleMatrix;
+    }
+    
+    for( auto It = Move.begin(); It != Move.end(); It++ )
+    {
+        if( Node.Type == MoveType::Attack )
+        {
+            // Attack: (Attacker, 0)
+            Node.State.BattleMatrix[ It->first ] = std::vector< uint32_t >();
+        }
+        else if( Node.Type == MoveType::Block )
+        {
+            // Block: (Blocker, Attacker)
+            Node.State.BattleMatrix[ It->second ].push_back( It->first );
+        }
+        else if( Node.Type == MoveType::Turn )
+        {
+            // Turn: Plays are listed before abilities, and abilities before attacks
+            if( It->second & AI_TURN_ABILITY )
+            {
+                if( !Node.State.TriggerAbility( Node.State.GetOpponent(), It->first, (uint8_t)( It->second & 0xFF ) ) )
+                    cocos2d::log( "[AI] WARNING: Planned ability failed upon simulation!" );
+            }
+            else if( It->second == AI_TURN_PLAY )
+            {
+                if( !Node.State.PlayCard( Node.State.GetOpponent(), It->first ) )
+                    cocos2d::log( "[AI] WARNING: Planned play failed upon simulation!" );
+            }
+            else
+            {
+                Node.State.BattleMatrix[ It->first ] = std::vector< uint32_t >();
+            }
+        }
+    }
     
-    Node.State.CopyFrom( Auth->GetState() );
-    Node.State.BattleMatrix = Auth->BattleMatrix;
+    // Every turn option is committed with its attack, even when its empty, so the rollout
+    // continues from the block phase instead of picking random attackers for us
+    if( Node.Type == MoveType::Turn )
+        Node.State.tState = TurnState::Attack;
     
     DecisionList.push_back( Node );
-    DoBuildBlock( Node );
+}
+
+
+bool AIController::WidenSearch()
+{
+    if( PendingMoves.empty() )
+        return false;
+    
+    AIPhaseScope Scope( AIPhase::Enumerate );
+    AddDecision( PendingMoves.front() );
+    PendingMoves.pop_front();
+    
+    return true;
+}
+
+
+int AIController::GetWidenLimit() const
+{
+    int Limit = (int)( AI_WIDEN_COEFF * pow( (float) SimulationCount, AI_WIDEN_ALPHA ) );
+    return Math::Clamp( Limit, AI_WIDEN_INITIAL, AI_WIDEN_MAX );
 }
 
 
@@ -555,6 +858,14 @@ void AIController::SimulateAll()
     //int SimulatedTurns = Math::Clamp( (int)( 64.0 / sqrt( (double) DecisionList.size() ) ), 5, 15 );
     cocos2d::log( "[AI] Starting initial simulation round.. simulating %d turns", SimulatedTurns );
     
+    // Every option in this search has the same cards, so we only need to check for hooks once
+    bBatchSimulate = !DecisionList.empty() && BatchSimulator::IsHookFree( DecisionList.front().State );
+    
+#ifdef SIM_BATCH_SELF_TEST
+    if( bBatchSimulate && DecisionList.front().Type != MoveType::Blitz )
+        BatchSimulator::SelfTest( DecisionList.front().State, SimulatedTurns, SIM_BATCH_SELF_TEST );
+#endif
+    
     for( auto It = DecisionList.begin(); It != DecisionList.end(); It++ )
     {
         //cocos2d::log( "[DEBUG] Starting a simulation..." );
@@ -563,7 +874,7 @@ void AIController::SimulateAll()
     }
 }
 
-void AIController::CalculateReward( Decision& Target )
+void AIController::CalculateReward( Decision& Target, const SimulationSummary& Result )
 {
     // Some factors for calculating the reward
     // How mnay turns were simulated
@@ -573,42 +884,34 @@ void AIController::CalculateReward( Decision& Target )
     // How many cards are in hand
     // Mana
     // Health
-    int SimulatedTurns = Simulation.GetSimulatedTurns();
-    auto Winner = Simulation.GetWinner();
-    
-    auto& LocalPlayer = Simulation.LocalPlayer;
-    auto& AIPlayer = Simulation.Opponent;
-    
-    int PlayerDeckSize = (int) LocalPlayer.Deck.size();
-    int AIDeckSize = (int) AIPlayer.Deck.size();
+    int SimulatedTurns = Result.SimulatedTurns;
+    auto Winner = Result.Winner;
     
-    int PlayerFieldSize = (int) LocalPlayer.Field.size();
-    int AIFieldSize = (int) AIPlayer.Field.size();
+    int PlayerDeckSize = Result.LocalDeck;
+    int AIDeckSize = Result.OpponentDeck;
     
-    int PlayerFieldPower = 0;
-    for( auto It = LocalPlayer.Field.begin(); It != LocalPlayer.Field.end(); It++ )
-        PlayerFieldPower += It->Power;
+    int PlayerFieldSize = Result.LocalField;
+    int AIFieldSize = Result.OpponentField;
     
-    int AIFieldPower = 0;
-    for( auto It = AIPlayer.Field.begin(); It != AIPlayer.Field.end(); It++ )
-        AIFieldPower += It->Power;
+    int PlayerFieldPower = Result.LocalPower;
+    int AIFieldPower = Result.OpponentPower;
     
-    int PlayerHealth = LocalPlayer.Health;
-    int AIHealth = AIPlayer.Health;
+    int PlayerHealth = Result.LocalHealth;
+    int AIHealth = Result.OpponentHealth;
     
-    int PlayerMana = LocalPlayer.Mana;
-    int AIMana = AIPlayer.Mana;
+    int PlayerMana = Result.LocalMana;
+    int AIMana = Result.OpponentMana;
 
     // Now that we have all the variables needed to calculate reward, lets create a formula
     // First, we should look at who won, because if the player or opponent won in one or this turn,
     // then the rating should be a full 1 or 0
     float WinRating = 0.f;
     
-    if( Winner )
+    if( Winner != PlayerTurn::None )
     {
-        if( Winner == std::addressof( LocalPlayer ) )
+        if( Winner == PlayerTurn::LocalPlayer )
             WinRating = -1.f;
-        else if( Winner == std::addressof( AIPlayer ) )
+        else if( Winner == PlayerTurn::Opponent )
             WinRating = 1.f;
         
         WinRating *= Math::Clamp( (float)( 16 - SimulatedTurns ) / 15.f, 0.f, 1.f );
@@ -685,11 +988,40 @@ void AIController::CalculateReward( Decision& Target )
     Target.Scores.push_back( FinalRating );
 }
 
-void AIController::Simulate( Decision& Target, int Turns )
+int AIController::Simulate( Decision& Target, int Turns )
 {
+    AIPhaseScope Scope( AIPhase::Evaluate );
+    
+    // If none of the cards in this game have hooks, we can run a whole batch of rollouts
+    // in lockstep, which is a lot faster than running them one by one
+    bool bBatchLoaded = false;
+    if( bBatchSimulate && Target.Type != MoveType::Blitz )
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        bBatchLoaded = Batch.Load( Target.State );
+    }
+    
+    if( bBatchLoaded )
+    {
+        Batch.Run( Turns );
+        
+        SimulationSummary Result;
+        for( int i = 0; i < Batch.GetLaneCount(); i++ )
+        {
+            Batch.GetSummary( i, Result );
+            CalculateReward( Target, Result );
+            Telemetry.AddRollout( Result.SimulatedTurns );
+        }
+        
+        return Batch.GetLaneCount();
+    }
+    
     // Copy decision state into simulator
-    Simulation.CopyFrom( Target.State );
-    Simulation.BattleMatrix = Target.State.BattleMatrix;
+    {
+        AIPhaseScope CopyScope( AIPhase::Copy );
+        Simulation.CopyFrom( Target.State );
+        Simulation.BattleMatrix = Target.State.BattleMatrix;
+    }
     
     // Run simulation on this target
     // We need a way to 'rate' each simulation, on how prefferable it is
@@ -705,19 +1037,18 @@ void AIController::Simulate( Decision& Target, int Turns )
         Simulation.SimulatePlayerBlitz();
     }
     
-    // If were in the play card phase, we need to simulate the ability phase before running the simulation
-    if( Target.Type == MoveType::Play )
-    {
-        // TODO: Simulate Abilities
-    }
-    
     // Calculate the number of turns to simulate
     // The more possible decisions, the less turns we will simulate
     // Were going to clamp the turns to simulate between 5 and 20
     Simulation.RunSimulation( Turns );
     
     // Now we need to calculate the 'rating' of the resulting game state
-    CalculateReward( Target );
+    SimulationSummary Result;
+    Simulation.Summarize( Result );
+    CalculateReward( Target, Result );
+    Telemetry.AddRollout( Result.SimulatedTurns );
+    
+    return 1;
 }
 
 Decision* AIController::GetOptionToSimulate()
@@ -759,7 +1090,7 @@ Decision* AIController::GetOptionToSimulate()
     return BestDecision;
 }
 
-void AIController::FirstRunComplete()
+void AIController::FirstRunComplete( int MaxSimulations /* = 300 */, int TimeBudget /* = 0 */ )
 {
     // Now that the first run of simulations are complete, we need to start running a
     // limited number of additional simulations to determine the best decision
@@ -769,55 +1100,96 @@ void AIController::FirstRunComplete()
     //int SimulatedTurns = Math::Clamp( (int)( 64.0 / sqrt( (double) DecisionList.size() ) ), 5, 15 );
     cocos2d::log( "[AI] Initial simulation round complete.. running %d turns", SimulatedTurns );
     
+    // If we were given a time budget, we stop simulating once its used up
+    auto EndBy = std::chrono::steady_clock::now() + std::chrono::milliseconds( TimeBudget );
+    
     // Now we need to loop through and continue simulating the best options
-    for( SimulationCount = 1; SimulationCount <= 300; SimulationCount++ )
+    SimulationCount = 1;
+    while( SimulationCount <= MaxSimulations )
     {
+        if( TimeBudget > 0 && std::chrono::steady_clock::now() > EndBy )
+        {
+            cocos2d::log( "[AI] Out of time, stopping search early" );
+            break;
+        }
+        
+        // Widen the search as the number of simulations grows, new options get one
+        // simulation right away so they have a score to compare against
+        // These count towards the total, otherwise the exploration term would undervalue every other option
+        while( (int) DecisionList.size() < GetWidenLimit() && WidenSearch() )
+        {
+            SimulationCount += Simulate( DecisionList.back(), SimulatedTurns );
+        }
+        
         // Pick best option to simulate
         auto Target = GetOptionToSimulate();
         if( !Target )
         {
             cocos2d::log( "[AI] Couldnt find best option to simulate!" );
+            SimulationCount++;
             continue;
         }
         
-        // Run simulation
-        Simulate( *Target, SimulatedTurns );
+        // Run simulation, batched simulations count each game they ran
+        SimulationCount += Simulate( *Target, SimulatedTurns );
     }
     
     SimulationCount--;
 }
 
-Decision* AIController::GetMostSimulated()
+void AIController::FinishSearch( Decision* Best )
 {
-    Decision* Output = nullptr;
-    float HighestScore = 0.f;
-    /*
-    for( auto It = DecisionList.begin(); It != DecisionList.end(); It++ )
+    // Confidence is the share of all simulations that went into the chosen option
+    float Confidence = 0.f;
+    float Score = 0.f;
+    
+    if( Best && !Best->Scores.empty() )
     {
-        if( !Output || It->Scores.size() > Output->Scores.size() )
-            Output = std::addressof( *It );
+        int Total = 0;
+        for( auto It = DecisionList.begin(); It != DecisionList.end(); It++ )
+            Total += (int) It->Scores.size();
+        
+        for( auto It = Best->Scores.begin(); It != Best->Scores.end(); It++ )
+            Score += *It;
+        
+        Score /= (float) Best->Scores.size();
+        Confidence = Math::SDiv< float >( (float) Best->Scores.size(), (float) Total );
     }
-    */
+    
+    Telemetry.EndSearch( (int) DecisionList.size(), (int) PendingMoves.size(), Confidence, Score );
+}
+
+
+Decision* AIController::GetMostSimulated()
+{
+    // The final move is the option the search spent the most simulations on, not the best average
+    // Options added late by widening can have a high average from only one or two samples
+    // Ties go to the option with the better average score
+    Decision* Output = nullptr;
+    float OutputScore = 0.f;
+    
     for( auto It = DecisionList.begin(); It != DecisionList.end(); It++ )
     {
-        if( !Output )
+        if( It->Scores.empty() )
+            continue;
+        
+        float Score = 0.f;
+        for( auto j = It->Scores.begin(); j != It->Scores.end(); j++ )
+            Score += *j;
+        Score /= (float) It->Scores.size();
+        
+        if( !Output || It->Scores.size() > Output->Scores.size() ||
+           ( It->Scores.size() == Output->Scores.size() && Score > OutputScore ) )
         {
             Output = std::addressof( *It );
-        }
-        else
-        {
-            float Score = 0.f;
-            for( auto j = It->Scores.begin(); j != It->Scores.end(); j++ )
-                Score += *j;
-            Score /= (float) It->Scores.size();
-            
-            if( Score > HighestScore )
-            {
-                HighestScore = Score;
-                Output = std::addressof( *It );
-            }
+            OutputScore = Score;
         }
     }
+    
+    // Nothing was simulated, so fall back to the first option
+    if( !Output && !DecisionList.empty() )
+        Output = std::addressof( DecisionList.front() );
+    
     return Output;
 }
 
@@ -826,6 +1198,7 @@ void AIController::Clear()
 {
     cocos2d::log( "[AI] Clearing Data..." );
     DecisionList.clear();
+    PendingMoves.clear();
     SimulationCount = 0;
     
     State = AIState::Idle;
@@ -837,71 +1210,203 @@ void AIController::ChooseBlitz()
     State = AIState::Blitz;
     cocos2d::log( "[AI] Making Blitz Decision..." );
     
-    // Build a new decision list, basically identical to PlayCards
     Post(
     [ = ]()
     {
-        BuildPlayOptions( MoveType::Blitz );
-        
-        cocos2d::log( "[AI] There are %d blitz options", (int) DecisionList.size() );
-        SimulateAll();
-        FirstRunComplete();
-        
         auto Auth = GetAuthority();
         CC_ASSERT( Auth );
         
-        // Now we need to find the most simulated option
-        auto Best = GetMostSimulated();
-        if( !Best )
+        // Hands the generator has seen are played from the book, anything else (or every hand, when
+        // no book was generated into Resource with the BlitzBook target) falls back to the search
+        std::vector< uint32_t > TargetCards;
+        if( LookupBlitz( Auth->GetState(), TargetCards ) )
         {
-            cocos2d::log( "[AI] Failed to find good blitz decision.. passing!" );
-            Auth->AI_SetBlitz( std::vector< uint32_t >() );
+            cocos2d::log( "[AI] Made blitz decision from book.. Playing %d cards", (int) TargetCards.size() );
         }
-        else
+        else if( !SearchBlitz( nullptr, TargetCards ) )
         {
-            float AvgScore = 0.f;
-            for( auto It = Best->Scores.begin(); It != Best->Scores.end(); It++ )
-                AvgScore += *It;
-            
-            float FinalScore = AvgScore / (float) Best->Scores.size();
-            
-            cocos2d::log( "[AI] Made blitz decision.. Score: %f  Total Simulations: %d  Decision Simulations: %d", FinalScore, SimulationCount, (int) Best->Scores.size() );
-            
-            // Inform authority that we finished deciding on what to play
-            std::vector< uint32_t > TargetCards;
-            for( auto It = Best->Move.begin(); It != Best->Move.end(); It++ )
-                TargetCards.push_back( It->first );
-            
-            Auth->AI_SetBlitz( TargetCards );
-            
+            cocos2d::log( "[AI] Failed to find good blitz decision.. passing!" );
         }
         
-        // Now we can clear out all of the members we accumulated while deciding
-        Clear();
+        // Inform authority that we finished deciding on what to play, back on the game thread like every other decision
+        Push( [=]() { Auth->AI_SetBlitz( TargetCards ); } );
         
+        // Book hits never start a search, but still need to put the AI back to idle
+        Clear();
     } );
     
 }
 
 
+bool AIController::LookupBlitz( GameStateBase& Source, std::vector< uint32_t >& Out )
+{
+    Out.clear();
+    
+    auto Player = Source.GetOpponent();
+    CCASSERT( Player, "[AI] Opponent object null!" );
+    
+    bool bGoingFirst = Source.GetStartingPlayer() == PlayerTurn::Opponent;
+    auto Key = BlitzBook::HashHand( Player->Hand, Player->Mana, bGoingFirst );
+    
+    std::vector< uint16_t > Cards;
+    if( !BlitzBook::GetInstance().Lookup( Key, Cards ) )
+        return false;
+    
+    // The book stores card ids, so map each one to a card in our hand that hasnt been picked yet
+    for( auto It = Cards.begin(); It != Cards.end(); It++ )
+    {
+        bool bFound = false;
+        for( auto i = Player->Hand.begin(); i != Player->Hand.end(); i++ )
+        {
+            if( i->Id == *It && std::find( Out.begin(), Out.end(), i->EntId ) == Out.end() )
+            {
+                Out.push_back( i->EntId );
+                bFound = true;
+                break;
+            }
+        }
+        
+        // Hash collision, this entry was built for a different hand
+        if( !bFound )
+        {
+            cocos2d::log( "[AI] Blitz book entry doesnt match hand! Falling back to search" );
+            Out.clear();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+bool AIController::SearchBlitz( GameStateBase* Source, std::vector< uint32_t >& Out )
+{
+    Out.clear();
+    
+    Telemetry.BeginSearch( "Blitz" );
+    BuildPlayOptions( MoveType::Blitz, Source );
+    
+    cocos2d::log( "[AI] There are %d blitz options", (int) DecisionList.size() );
+    SimulateAll();
+    FirstRunComplete();
+    
+    // Now we need to find the most simulated option
+    auto Best = GetMostSimulated();
+    if( Best )
+    {
+        float AvgScore = 0.f;
+        for( auto It = Best->Scores.begin(); It != Best->Scores.end(); It++ )
+            AvgScore += *It;
+        
+        float FinalScore = AvgScore / (float) Best->Scores.size();
+        
+        cocos2d::log( "[AI] Made blitz decision.. Score: %f  Total Simulations: %d  Decision Simulations: %d", FinalScore, SimulationCount, (int) Best->Scores.size() );
+        
+        for( auto It = Best->Move.begin(); It != Best->Move.end(); It++ )
+            Out.push_back( It->first );
+    }
+    
+    // The caller clears out the members we accumulated while deciding, once its done with the result
+    FinishSearch( Best );
+    
+    return Best != nullptr;
+}
+
+
+#ifdef AI_GENERATE_BLITZ_BOOK
+void AIController::RecordBlitz( GameStateBase& Source, const std::vector< uint32_t >& Cards )
+{
+    auto Player = Source.GetOpponent();
+    CCASSERT( Player, "[AI] Opponent object null!" );
+    
+    std::vector< uint16_t > Ids;
+    for( auto It = Cards.begin(); It != Cards.end(); It++ )
+    {
+        for( auto i = Player->Hand.begin(); i != Player->Hand.end(); i++ )
+        {
+            if( i->EntId == *It )
+            {
+                Ids.push_back( i->Id );
+                break;
+            }
+        }
+    }
+    
+    bool bGoingFirst = Source.GetStartingPlayer() == PlayerTurn::Opponent;
+    BlitzBook::GetInstance().Record( BlitzBook::HashHand( Player->Hand, Player->Mana, bGoingFirst ), Ids );
+}
+
+
+void AIController::GenerateBlitzBook( GameStateBase& Source, int Hands, const std::string& Path )
+{
+    // Deals new opening hands from the AI deck in the source state and searches each one
+    // Sampling real deals means the common hands are the ones that end up in the book
+    auto& Book = BlitzBook::GetInstance();
+    SimulatedState Base;
+    int Added = 0;
+    
+    AITelemetry::Scope Record( std::addressof( Telemetry ) );
+    
+    for( int i = 0; i < Hands; i++ )
+    {
+        Base.CopyFrom( Source );
+        
+        auto Player = Base.GetOpponent();
+        CCASSERT( Player, "[AI] Opponent object null!" );
+        
+        // Put the hand back, shuffle and deal a new one of the same size
+        size_t HandSize = Player->Hand.size();
+        while( !Player->Hand.empty() )
+            Base.MoveCard( Player, CardPos::HAND, Player->Hand.size() - 1, CardPos::DECK );
+        
+        Base.ShuffleDeck( Player );
+        
+        while( Player->Hand.size() < HandSize && !Player->Deck.empty() )
+            Base.MoveCard( Player, CardPos::DECK, Player->Deck.size() - 1, CardPos::HAND );
+        
+        bool bGoingFirst = Base.GetStartingPlayer() == PlayerTurn::Opponent;
+        if( Book.Contains( BlitzBook::HashHand( Player->Hand, Player->Mana, bGoingFirst ) ) )
+            continue;
+        
+        std::vector< uint32_t > Cards;
+        if( SearchBlitz( &Base, Cards ) )
+        {
+            RecordBlitz( Base, Cards );
+            Added++;
+        }
+        
+        Clear();
+    }
+    
+    cocos2d::log( "[AI] Added %d hands to the blitz book (%d total).. Writing to '%s'", Added, (int) Book.GetSize(), Path.c_str() );
+    
+    Book.Save( Path );
+}
+#endif
+
+
 void AIController::PlayCards()
 {
     State = AIState::Marshal;
     cocos2d::log( "[AI] Making Play Decision..." );
     
-    // We need to first build a list of all possible play actions
+    // Instead of only deciding what to play, were going to plan out the whole turn (plays, abilities and attacks)
+    // The rest of the plan is cached, and used once the authority is done playing the cards
     Post(
          [ = ]()
          {
-             BuildPlayOptions( MoveType::Play );
+             Telemetry.BeginSearch( "Turn" );
+             BuildTurnOptions();
              
-             cocos2d::log( "[AI] There are %d play options", (int) DecisionList.size() );
+             cocos2d::log( "[AI] There are %d turn options (%d pending)", (int) DecisionList.size(), (int) PendingMoves.size() );
              SimulateAll();
-             FirstRunComplete();
+             FirstRunComplete( AI_PLAN_SIMULATIONS, AI_PLAN_BUDGET_MS );
              
              auto Auth = GetAuthority();
              CC_ASSERT( Auth );
              
+             Plan = TurnPlan();
+             
              // Now we need to find the most simulated option
              auto Best = GetMostSimulated();
              if( !Best )
@@ -916,15 +1421,39 @@ void AIController::PlayCards()
                      AvgScore += *It;
                  AvgScore /= (float) Best->Scores.size();
                  
-                 cocos2d::log( "[AI] Made play decision.. Score: %f  Total Simulations: %d  Decision Simulations: %d", AvgScore, SimulationCount, (int) Best->Scores.size() );
+                 cocos2d::log( "[AI] Made turn plan.. Score: %f  Total Simulations: %d  Decision Simulations: %d", AvgScore, SimulationCount, (int) Best->Scores.size() );
                  
-                 std::vector< uint32_t > Cards;
                  for( auto It = Best->Move.begin(); It != Best->Move.end(); It++ )
-                     Cards.push_back( It->first );
+                 {
+                     if( It->second & AI_TURN_ABILITY )
+                     {
+                         Plan.Abilities.push_back( std::make_pair( It->first, (uint8_t)( It->second & 0xFF ) ) );
+                         continue;
+                     }
+                     
+                     if( It->second == AI_TURN_PLAY )
+                     {
+                         Plan.Plays.push_back( It->first );
+                         continue;
+                     }
+                     
+                     // The decision state has the plays and abilities applied, so this is what the attacker should look like
+                     CardState* Card = nullptr;
+                     if( !Best->State.FindCard( It->first, Best->State.GetOpponent(), Card, true ) || !Card )
+                         continue;
+                     
+                     Plan.Attackers.push_back( It->first );
+                     Plan.AttackerStats.push_back( std::make_pair( Card->Power, Card->Stamina ) );
+                 }
                  
+                 Plan.TurnNumber = Auth->GetState().TurnNumber;
+                 Plan.bValid = true;
+                 
+                 std::vector< uint32_t > Cards = Plan.Plays;
                  Push( [=]() { Auth->AI_PlayCards( Cards ); } );
              }
              
+             FinishSearch( Best );
              Clear();
          } );
 }
@@ -935,7 +1464,22 @@ void AIController::TriggerAbilities()
     State = AIState::Ability;
     cocos2d::log( "[AI] Making Ability Decision..." );
     
-    // TODO
+    // Abilities are searched along with the rest of the turn during marshal, so this only has to hand over the plan
+    Post(
+         [ = ]()
+         {
+             auto Auth = GetAuthority();
+             CC_ASSERT( Auth );
+             
+             std::vector< std::pair< uint32_t, uint8_t > > Abilities;
+             if( Plan.bValid && Plan.TurnNumber == Auth->GetState().TurnNumber )
+                 Abilities = Plan.Abilities;
+             
+             cocos2d::log( "[AI] Using planned abilities.. triggering %d", (int) Abilities.size() );
+             Push( [=]() { Auth->AI_TriggerAbilities( Abilities ); } );
+             
+             Clear();
+         } );
 }
 
 
@@ -947,15 +1491,42 @@ void AIController::ChooseAttackers()
     Post(
          [ = ]()
          {
-             BuildAttackOptions();
+             auto Auth = GetAuthority();
+             CC_ASSERT( Auth );
+             
+             // Check if we planned out this attack already during the marshal phase
+             // If the board changed in a way the plan didnt expect, were going to run a new search
+             if( Plan.bValid )
+             {
+                 bool bPlanValid = IsPlanValid( Auth->GetState() );
+                 Plan.bValid = false;
+                 
+                 if( bPlanValid )
+                 {
+                     cocos2d::log( "[AI] Using planned attack.. %d attackers", (int) Plan.Attackers.size() );
+                     
+                     std::vector< uint32_t > Cards = Plan.Attackers;
+                     Push( [=]() { Auth->AI_SetAttackers( Cards ); } );
+                     
+                     Clear();
+                     return;
+                 }
+                 
+                 cocos2d::log( "[AI] Planned attack is no longer valid.. searching again" );
+             }
+             
+             // Same as the turn search, cards played this turn cant attack. The plays are kept even when the plan isnt valid
+             std::vector< uint32_t > Played;
+             if( Plan.TurnNumber == Auth->GetState().TurnNumber )
+                 Played = Plan.Plays;
+             
+             Telemetry.BeginSearch( "Attack" );
+             BuildAttackOptions( Played );
              
              cocos2d::log( "[AI] There are %d attack options", (int) DecisionList.size() );
              SimulateAll();
              FirstRunComplete();
              
-             auto Auth = GetAuthority();
-             CC_ASSERT( Auth );
-             
              // Now we need to find the most simulated option
              auto Best = GetMostSimulated();
              if( !Best )
@@ -979,6 +1550,7 @@ void AIController::ChooseAttackers()
                  Push( [=]() { Auth->AI_SetAttackers( Cards ); } );
              }
              
+             FinishSearch( Best );
              Clear();
          } );
 }
@@ -992,6 +1564,7 @@ void AIController::ChooseBlockers( std::vector< uint32_t > Attackers )
     Post(
          [ = ]()
          {
+             Telemetry.BeginSearch( "Block" );
              BuildBlockOptions();
              
              cocos2d::log( "[AI] There are %d block options", (int) DecisionList.size() );
@@ -1019,16 +1592,12 @@ void AIController::ChooseBlockers( std::vector< uint32_t > Attackers )
                  
                  std::map< uint32_t, uint32_t > Cards;
                  for( auto It = Best->Move.begin(); It != Best->Move.end(); It++ )
-                 {
-                     cocos2d::log( "=== BLOCKER ===> %d (%d)", It->first, It->second );
                      Cards[ It->first ] = It->second;
-                 }
                  
-                 cocos2d::log( "[DEBUG] THERE WERE %d BLOCKERS SELECTED", (int)Cards.size() );
-
                  Push( [=]() { Auth->AI_SetBlockers( Cards ); } );
              }
              
+             FinishSearch( Best );
              Clear();
          } );
     
@@ -18,13 +18,37 @@
 #include "AppDelegate.hpp"
 #include "Player.hpp"
 #include "SimulatedState.hpp"
+#include "BatchSimulator.hpp"
+#include "AITelemetry.hpp"
+#include <deque>
 
 
+// Progressive widening, the number of options we allow in the search grows with the
+// total number of simulations, Limit = Max( INITIAL, COEFF * Sims ^ ALPHA ), and never passes MAX
+#define AI_WIDEN_INITIAL 4
+#define AI_WIDEN_COEFF 2.f
+#define AI_WIDEN_ALPHA 0.5f
+#define AI_WIDEN_MAX 40
+
+// Turn planning, plays, abilities and attacks for the AI's turn are searched together under a single budget
+// Turn moves are encoded as (EntId, AI_TURN_PLAY), (EntId, AI_TURN_ABILITY | AbilityId) or (EntId, AI_TURN_ATTACK)
+#define AI_TURN_PLAY 0
+#define AI_TURN_ATTACK 1
+#define AI_TURN_ABILITY 0x100
+#define AI_PLAN_MAX 96
+#define AI_PLAN_SIMULATIONS 600
+#define AI_PLAN_BUDGET_MS 2000
+
+// Blitz book generation, only defined when building the offline generator (Server/BlitzBookMain.cpp)
+// The game itself only ever reads the book that ships in Resources
+// #define AI_GENERATE_BLITZ_BOOK
+
 // Note: Most of this is currently DEPRECATED and requires a rewrite!
 
 namespace Game
 {
     class SingleplayerAuthority;
+    class MatchContext;
     
     enum class AIState
     {
@@ -55,7 +79,8 @@ namespace Game
         Play,
         Ability,
         Attack,
-        Block
+        Block,
+        Turn
     };
     
     struct Decision
@@ -66,6 +91,18 @@ namespace Game
         SimulatedState State;
         int SimulationCount;
     };
+    
+    struct TurnPlan
+    {
+        std::vector< uint32_t > Plays;
+        std::vector< std::pair< uint32_t, uint8_t > > Abilities;
+        std::vector< uint32_t > Attackers;
+        
+        // Power and stamina each attacker is expected to have once the plays and abilities are done
+        std::vector< std::pair< int, int > > AttackerStats;
+        int TurnNumber = -1;
+        bool bValid = false;
+    };
 
     class AIController : public EntityBase
     {
@@ -85,6 +122,11 @@ namespace Game
         void ChooseAttackers();
         void ChooseBlockers( std::vector< uint32_t > Attackers );
         
+#ifdef AI_GENERATE_BLITZ_BOOK
+        // Deals this many opening hands from the source state, searches each one, and writes the results to the path
+        void GenerateBlitzBook( GameStateBase& Source, int Hands, const std::string& Path );
+#endif
+        
     protected:
         
         std::shared_ptr< std::thread > Thread;
@@ -92,10 +134,24 @@ namespace Game
         AIState State;
         AIDifficulty Difficulty;
         SimulatedState Simulation;
+        BatchSimulator Batch;
+        bool bBatchSimulate;
+        AITelemetry Telemetry;
+        MatchContext* Context;
+        
+        // Seeds for the states the search creates, the contexts own stream belongs to the match thread
+        Math::Random SearchRng;
         
         std::vector< Decision > DecisionList;
         int SimulationCount;
         
+        // Options that have been generated (best first) but not yet added to the search
+        std::deque< std::vector< std::pair< uint32_t, uint32_t > > > PendingMoves;
+        Decision WidenBase;
+        
+        // The plan for the current turn, built during marshal and used through the attack phase
+        TurnPlan Plan;
+        
         void StartThink();
         void ExitThink();
         void DoThink();
@@ -106,19 +162,33 @@ namespace Game
         
         bool DecisionExists( const std::vector< std::pair< uint32_t, uint32_t > >& In, bool bMatchOrder );
         void DoBuildPlay( Decision& Base );
-        void BuildPlayOptions( MoveType inType );
-        void DoBuildAttack( Decision& Base );
-        void BuildAttackOptions();
+        void BuildPlayOptions( MoveType inType, GameStateBase* Source = nullptr );
+        void DoBuildAttack( Decision& Base, const std::vector< uint32_t >& Exclude = std::vector< uint32_t >() );
+        void BuildAttackOptions( const std::vector< uint32_t >& Exclude = std::vector< uint32_t >() );
         void DoBuildBlock( Decision& Base );
         void BuildBlockOptions();
+        void DoBuildAbility( Decision& Base, std::vector< Decision >& Out );
+        void BuildTurnOptions();
+        bool IsPlanValid( GameStateBase& Current ) const;
+        void AddDecision( const std::vector< std::pair< uint32_t, uint32_t > >& Move );
+        bool WidenSearch();
+        int GetWidenLimit() const;
         void SimulateAll();
-        void Simulate( Decision& Target, int Turns );
-        void FirstRunComplete();
-        void CalculateReward( Decision& Target );
+        int Simulate( Decision& Target, int Turns );
+        void FirstRunComplete( int MaxSimulations = 300, int TimeBudget = 0 );
+        void CalculateReward( Decision& Target, const SimulationSummary& Result );
         Decision* GetOptionToSimulate();
         Decision* GetMostSimulated();
+        void FinishSearch( Decision* Best );
         void Clear();
         
+        bool LookupBlitz( GameStateBase& Source, std::vector< uint32_t >& Out );
+        bool SearchBlitz( GameStateBase* Source, std::vector< uint32_t >& Out );
+        
+#ifdef AI_GENERATE_BLITZ_BOOK
+        void RecordBlitz( GameStateBase& Source, const std::vector< uint32_t >& Cards );
+#endif
+        
         
         friend class SingleplayerLauncher;
         
@@ -0,0 +1,228 @@
+//
+//	AITelemetry.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "AITelemetry.hpp"
+#include "cocos2d.h"
+#include "Numeric.hpp"
+#include <algorithm>
+#include <cstring>
+
+using namespace Game;
+
+
+static thread_local AITelemetry* CurrentTelemetry = nullptr;
+
+
+AITelemetry* AITelemetry::GetCurrent()
+{
+    return CurrentTelemetry;
+}
+
+
+AITelemetry::Scope::Scope( AITelemetry* In )
+: Previous( CurrentTelemetry )
+{
+    CurrentTelemetry = In;
+}
+
+
+AITelemetry::Scope::~Scope()
+{
+    CurrentTelemetry = Previous;
+}
+
+
+AITelemetry::AITelemetry()
+{
+    Epoch = std::chrono::steady_clock::now();
+    bActive = false;
+    PhaseDepth = 0;
+    LastSwitch = 0;
+    Head = 0;
+    RecordCount = 0;
+    
+    memset( &Current, 0, sizeof( Current ) );
+}
+
+
+int64_t AITelemetry::Now() const
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - Epoch ).count();
+}
+
+
+void AITelemetry::Charge( int64_t Time )
+{
+    // Time since the last phase change belongs to whatever phase is on top of the stack
+    if( PhaseDepth > 0 )
+    {
+        int Top = std::min( PhaseDepth, 16 ) - 1;
+        Current.PhaseTime[ (int) PhaseStack[ Top ] ] += Time - LastSwitch;
+    }
+    
+    LastSwitch = Time;
+}
+
+
+void AITelemetry::BeginSearch( const char* Name )
+{
+    memset( &Current, 0, sizeof( Current ) );
+    Current.Name = Name;
+    Current.Start = Now();
+    
+    LastSwitch = Current.Start;
+    PhaseDepth = 0;
+    bActive = true;
+}
+
+
+void AITelemetry::EndSearch( int Options, int Pending, float Confidence, float Score )
+{
+    if( !bActive )
+        return;
+    
+    Current.Duration = Now() - Current.Start;
+    Current.Options = Options;
+    Current.Pending = Pending;
+    Current.Confidence = Confidence;
+    Current.Score = Score;
+    bActive = false;
+    
+    std::lock_guard< std::mutex > Guard( Lock );
+    
+    Records[ Head ] = Current;
+    Head = ( Head + 1 ) % AI_TELEMETRY_CAPACITY;
+    RecordCount = std::min( RecordCount + 1, AI_TELEMETRY_CAPACITY );
+}
+
+
+void AITelemetry::BeginPhase( AIPhase In )
+{
+    if( !bActive )
+        return;
+    
+    Charge( Now() );
+    
+    // Phases nested deeper than the stack are charged to the deepest one we track
+    if( PhaseDepth < 16 )
+        PhaseStack[ PhaseDepth ] = In;
+    
+    PhaseDepth++;
+}
+
+
+void AITelemetry::EndPhase()
+{
+    if( !bActive || PhaseDepth <= 0 )
+        return;
+    
+    Charge( Now() );
+    PhaseDepth--;
+}
+
+
+void AITelemetry::AddRollout( int Depth )
+{
+    if( !bActive )
+        return;
+    
+    Current.Simulations++;
+    Current.Depth[ Math::Clamp( Depth, 0, AI_TELEMETRY_DEPTH_BUCKETS - 1 ) ]++;
+}
+
+
+void AITelemetry::GetRecords( std::vector< AISearchRecord >& Out )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    
+    // Oldest first
+    Out.clear();
+    for( int i = 0; i < RecordCount; i++ )
+        Out.push_back( Records[ ( Head - RecordCount + i + AI_TELEMETRY_CAPACITY ) % AI_TELEMETRY_CAPACITY ] );
+}
+
+
+std::string AITelemetry::ExportChromeTrace()
+{
+    std::vector< AISearchRecord > List;
+    GetRecords( List );
+    
+    static const char* PhaseNames[] = { "Enumerate", "Copy", "Hooks", "Evaluate" };
+    
+    // Each search is a complete event with its stats in the args, and the time split is written
+    // as a counter, so the trace viewer draws it as a stacked graph under the searches
+    std::string Output = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    char Buffer[ 512 ];
+    bool bFirst = true;
+    
+    for( auto It = List.begin(); It != List.end(); It++ )
+    {
+        snprintf( Buffer, sizeof( Buffer ),
+                 "%s{\"name\":\"%s\",\"cat\":\"AI\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%lld,\"dur\":%lld,\"args\":{"
+                 "\"options\":%d,\"pending\":%d,\"simulations\":%d,\"confidence\":%.4f,\"score\":%.4f,\"depth\":[",
+                 bFirst ? "" : ",", It->Name ? It->Name : "Search", (long long) It->Start, (long long) It->Duration,
+                 It->Options, It->Pending, It->Simulations, It->Confidence, It->Score );
+        Output += Buffer;
+        bFirst = false;
+        
+        for( int i = 0; i < AI_TELEMETRY_DEPTH_BUCKETS; i++ )
+        {
+            snprintf( Buffer, sizeof( Buffer ), "%s%u", i > 0 ? "," : "", It->Depth[ i ] );
+            Output += Buffer;
+        }
+        
+        Output += "]";
+        for( int i = 0; i < (int) AIPhase::Count; i++ )
+        {
+            snprintf( Buffer, sizeof( Buffer ), ",\"%s_us\":%lld", PhaseNames[ i ], (long long) It->PhaseTime[ i ] );
+            Output += Buffer;
+        }
+        
+        Output += "}}";
+        
+        // Counter at the start of the search with the split (ms), and back to zero at the end
+        snprintf( Buffer, sizeof( Buffer ), ",{\"name\":\"AI Time Split\",\"ph\":\"C\",\"pid\":1,\"ts\":%lld,\"args\":{", (long long) It->Start );
+        Output += Buffer;
+        
+        for( int i = 0; i < (int) AIPhase::Count; i++ )
+        {
+            snprintf( Buffer, sizeof( Buffer ), "%s\"%s\":%.3f", i > 0 ? "," : "", PhaseNames[ i ], (double) It->PhaseTime[ i ] / 1000.0 );
+            Output += Buffer;
+        }
+        
+        snprintf( Buffer, sizeof( Buffer ), "}},{\"name\":\"AI Time Split\",\"ph\":\"C\",\"pid\":1,\"ts\":%lld,\"args\":{", (long long)( It->Start + It->Duration ) );
+        Output += Buffer;
+        
+        for( int i = 0; i < (int) AIPhase::Count; i++ )
+        {
+            snprintf( Buffer, sizeof( Buffer ), "%s\"%s\":0", i > 0 ? "," : "", PhaseNames[ i ] );
+            Output += Buffer;
+        }
+        
+        Output += "}}";
+    }
+    
+    Output += "]}";
+    return Output;
+}
+
+
+bool AITelemetry::SaveChromeTrace( const std::string& FullPath )
+{
+    auto file = cocos2d::FileUtils::getInstance();
+    if( !file || !file->writeStringToFile( ExportChromeTrace(), FullPath ) )
+    {
+        cocos2d::log( "[AI] Failed to write telemetry to '%s'", FullPath.c_str() );
+        return false;
+    }
+    
+    cocos2d::log( "[AI] Wrote telemetry to '%s'", FullPath.c_str() );
+    return true;
+}
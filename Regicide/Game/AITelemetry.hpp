@@ -0,0 +1,128 @@
+//
+//	AITelemetry.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <array>
+
+
+// Number of searches kept in the ring buffer, and rollout depths tracked in the histogram (last bucket is 'or more')
+#define AI_TELEMETRY_CAPACITY 64
+#define AI_TELEMETRY_DEPTH_BUCKETS 16
+
+// When defined, each AI writes its telemetry as a chrome trace (chrome://tracing) to the writable path on cleanup
+// Only meant for profiling builds, so it stays off by default
+// #define AI_TELEMETRY_FILE "AITrace.json"
+
+namespace Game
+{
+    enum class AIPhase
+    {
+        Enumerate,
+        Copy,
+        Hooks,
+        Evaluate,
+        Count
+    };
+    
+    struct AISearchRecord
+    {
+        const char* Name;
+        int64_t Start;
+        int64_t Duration;
+        
+        int Options;
+        int Pending;
+        int Simulations;
+        uint32_t Depth[ AI_TELEMETRY_DEPTH_BUCKETS ];
+        
+        // Exclusive time in each phase (microseconds), nested phases dont count towards their parent
+        int64_t PhaseTime[ (int) AIPhase::Count ];
+        
+        // Share of simulations that went to the chosen option, and its average score
+        float Confidence;
+        float Score;
+    };
+    
+    // Records per-search stats for the AI, so budgets can be tuned from real devices
+    // Each AI controller owns its own recorder, and binds it to its think thread with a Scope, so simulations
+    // running on other threads never record into it. The record being built isnt locked, the lock is only
+    // taken when a finished record is pushed into the ring buffer, or when the buffer is exported
+    class AITelemetry
+    {
+    public:
+    
+        AITelemetry();
+        
+        // The recorder bound to the calling thread, or null if searches on this thread arent recorded
+        static AITelemetry* GetCurrent();
+        
+        class Scope
+        {
+        public:
+            
+            explicit Scope( AITelemetry* In );
+            ~Scope();
+            
+            Scope( const Scope& Other ) = delete;
+            Scope& operator= ( const Scope& Other ) = delete;
+            
+        private:
+            
+            AITelemetry* Previous;
+        };
+        
+        void BeginSearch( const char* Name );
+        void EndSearch( int Options, int Pending, float Confidence, float Score );
+        
+        void BeginPhase( AIPhase In );
+        void EndPhase();
+        void AddRollout( int Depth );
+        
+        void GetRecords( std::vector< AISearchRecord >& Out );
+        std::string ExportChromeTrace();
+        bool SaveChromeTrace( const std::string& FullPath );
+    
+    protected:
+    
+        int64_t Now() const;
+        void Charge( int64_t Time );
+        
+        std::chrono::steady_clock::time_point Epoch;
+        
+        AISearchRecord Current;
+        bool bActive;
+        AIPhase PhaseStack[ 16 ];
+        int PhaseDepth;
+        int64_t LastSwitch;
+        
+        std::array< AISearchRecord, AI_TELEMETRY_CAPACITY > Records;
+        int Head;
+        int RecordCount;
+        std::mutex Lock;
+    };
+    
+    // Times everything in its scope towards a phase of the current search, if this thread has a recorder bound
+    class AIPhaseScope
+    {
+    public:
+    
+        AIPhaseScope( AIPhase In ) : Target( AITelemetry::GetCurrent() ) { if( Target ) Target->BeginPhase( In ); }
+        ~AIPhaseScope() { if( Target ) Target->EndPhase(); }
+        
+    private:
+        
+        AITelemetry* Target;
+    };
+}
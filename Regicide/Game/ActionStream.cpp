@@ -0,0 +1,765 @@
+//
+//	ActionStream.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "ActionStream.hpp"
+#include "WireSchema.hpp"
+#include "GameStateBase.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+/*=========================================================================================
+    Streams
+ =========================================================================================*/
+void StreamWriter::WriteByte( uint8_t In )
+{
+    Buffer.push_back( In );
+}
+
+
+void StreamWriter::WriteFixed( uint64_t In, int Bytes )
+{
+    for( int i = 0; i < Bytes; i++ )
+        Buffer.push_back( (uint8_t)( ( In >> ( i * 8 ) ) & 0xFF ) );
+}
+
+
+void StreamWriter::WriteVarint( uint64_t In )
+{
+    while( In >= 0x80 )
+    {
+        Buffer.push_back( (uint8_t)( In | 0x80 ) );
+        In >>= 7;
+    }
+    
+    Buffer.push_back( (uint8_t) In );
+}
+
+
+void StreamWriter::WriteSigned( int64_t In )
+{
+    WriteVarint( ( (uint64_t) In << 1 ) ^ (uint64_t)( In >> 63 ) );
+}
+
+
+void StreamWriter::WriteString( const std::string& In )
+{
+    WriteVarint( In.size() );
+    Buffer.insert( Buffer.end(), In.begin(), In.end() );
+}
+
+
+void StreamWriter::WriteBytes( const uint8_t* In, size_t Count )
+{
+    Buffer.insert( Buffer.end(), In, In + Count );
+}
+
+
+StreamReader::StreamReader( const uint8_t* InData, size_t InSize )
+: Data( InData ), Size( InSize ), Position( 0 ), bError( false )
+{
+}
+
+
+uint8_t StreamReader::ReadByte()
+{
+    if( bError || Position >= Size )
+    {
+        bError = true;
+        return 0;
+    }
+    
+    return Data[ Position++ ];
+}
+
+
+uint64_t StreamReader::ReadFixed( int Bytes )
+{
+    uint64_t Output = 0;
+    for( int i = 0; i < Bytes; i++ )
+        Output |= (uint64_t) ReadByte() << ( i * 8 );
+    
+    return bError ? 0 : Output;
+}
+
+
+uint64_t StreamReader::ReadVarint()
+{
+    uint64_t Output = 0;
+    for( int Shift = 0; Shift < 64; Shift += 7 )
+    {
+        uint8_t Byte = ReadByte();
+        Output |= (uint64_t)( Byte & 0x7F ) << Shift;
+        
+        if( !( Byte & 0x80 ) )
+            return bError ? 0 : Output;
+    }
+    
+    // More than 10 bytes, this isnt a varint we wrote
+    bError = true;
+    return 0;
+}
+
+
+int64_t StreamReader::ReadSigned()
+{
+    uint64_t Value = ReadVarint();
+    return (int64_t)( Value >> 1 ) ^ -(int64_t)( Value & 1 );
+}
+
+
+std::string StreamReader::ReadString()
+{
+    uint64_t Length = ReadVarint();
+    if( bError || Length > Size - Position )
+    {
+        bError = true;
+        return std::string();
+    }
+    
+    std::string Output( (const char*) Data + Position, (size_t) Length );
+    Position += (size_t) Length;
+    
+    return Output;
+}
+
+
+bool StreamReader::Skip( size_t Count )
+{
+    if( bError || Count > Size - Position )
+    {
+        bError = true;
+        return false;
+    }
+    
+    Position += Count;
+    return true;
+}
+
+
+const uint8_t* StreamReader::ReadView( size_t Count )
+{
+    size_t Start = Position;
+    return Skip( Count ) ? Data + Start : nullptr;
+}
+
+
+/*=========================================================================================
+    Encoding
+ =========================================================================================*/
+static void WriteAction( SchemaWriter& Out, Game::Action* In )
+{
+    uint8_t Type    = (uint8_t) In->Type;
+    uint8_t Id      = (uint8_t) In->Id;
+    
+    // Most actions keep the id theyre created with, so the id only follows the type when it doesnt
+    if( Out.Version < 2 )
+    {
+        Out.Byte( Type );
+        Out.Byte( Id );
+    }
+    else if( In->Id != GetDefaultActionId( In->Type ) )
+    {
+        uint8_t Header = Type | 0x80;
+        Out.Byte( Header );
+        Out.Byte( Id );
+    }
+    else
+    {
+        Out.Byte( Type );
+    }
+    
+    if( In->Type == ActionType::Parallel )
+    {
+        auto Parallel = static_cast< ParallelAction* >( In );
+        size_t Count = Parallel->Actions.size();
+        Out.Unsigned( Count );
+        
+        for( auto It = Parallel->Actions.begin(); It != Parallel->Actions.end(); It++ )
+            WriteAction( Out, *It );
+        
+        return;
+    }
+    
+    VisitAction( Out, In );
+}
+
+
+// Owner is either the queue, or the parallel action the new action is part of
+template< typename T >
+static Game::Action* CreateOfType( T& Owner, ActionType Type )
+{
+    switch( Type )
+    {
+        case ActionType::Parallel:      return Owner.template CreateAction< ParallelAction >();
+        case ActionType::PlayCard:      return Owner.template CreateAction< PlayCardAction >();
+        case ActionType::UpdateMana:    return Owner.template CreateAction< UpdateManaAction >();
+        case ActionType::DrawCard:      return Owner.template CreateAction< DrawCardAction >();
+        case ActionType::LoadCard:      return Owner.template CreateAction< LoadCardAction >();
+        case ActionType::CoinFlip:      return Owner.template CreateAction< CoinFlipAction >();
+        case ActionType::TimedQuery:    return Owner.template CreateAction< TimedQueryAction >();
+        case ActionType::Event:         return Owner.template CreateAction< EventAction >();
+        case ActionType::CardError:     return Owner.template CreateAction< CardErrorAction >();
+        case ActionType::TurnStart:     return Owner.template CreateAction< TurnStartAction >();
+        case ActionType::Damage:        return Owner.template CreateAction< DamageAction >();
+        case ActionType::UpdateStamina: return Owner.template CreateAction< UpdateStaminaAction >();
+        case ActionType::Win:           return Owner.template CreateAction< WinAction >();
+        case ActionType::Combat:        return Owner.template CreateAction< CombatAction >();
+        case ActionType::PlayerEvent:   return Owner.template CreateAction< PlayerEventAction >();
+        case ActionType::CardList:      return Owner.template CreateAction< CardListEvent >();
+        case ActionType::BattleMatrix:  return Owner.template CreateAction< BattleMatrixAction >();
+        default:                        return nullptr;
+    }
+}
+
+
+template< typename T >
+static bool ReadAction( SchemaReader& In, T& Owner, uint32_t Depth = 0 )
+{
+    if( Depth >= ACTION_STREAM_MAX_DEPTH )
+    {
+        In.Invalidate();
+        return false;
+    }
+    
+    uint8_t Type    = 0;
+    uint8_t Id      = 0;
+    In.Byte( Type );
+    
+    if( In.Version < 2 )
+    {
+        In.Byte( Id );
+    }
+    else if( Type & 0x80 )
+    {
+        Type &= 0x7F;
+        In.Byte( Id );
+    }
+    else
+    {
+        Id = (uint8_t) GetDefaultActionId( (ActionType) Type );
+    }
+    
+    if( !In.IsValid() || Id >= (uint8_t) ActionId::Count )
+        return false;
+    
+    Game::Action* Output = CreateOfType( Owner, (ActionType) Type );
+    if( !Output )
+        return false;
+    
+    Output->Id = (ActionId) Id;
+    
+    if( Output->Type == ActionType::Parallel )
+    {
+        auto Parallel = static_cast< ParallelAction* >( Output );
+        size_t Count = 0;
+        In.Unsigned( Count );
+        
+        for( size_t i = 0; i < Count; i++ )
+        {
+            if( !ReadAction( In, *Parallel, Depth + 1 ) )
+                return false;
+        }
+        
+        return In.IsValid();
+    }
+    
+    return VisitAction( In, Output );
+}
+
+
+static bool HasTurnStart( const std::vector< Game::Action* >& In )
+{
+    for( auto It = In.begin(); It != In.end(); It++ )
+    {
+        if( ( *It )->Type == ActionType::TurnStart )
+            return true;
+        
+        if( ( *It )->Type == ActionType::Parallel && HasTurnStart( static_cast< ParallelAction* >( *It )->Actions ) )
+            return true;
+    }
+    
+    return false;
+}
+
+
+void Game::WriteActionQueue( StreamWriter& Out, const ActionQueue& In )
+{
+    SchemaWriter Schema( Out );
+    size_t Count = In.Actions.size();
+    Schema.Unsigned( Count );
+    
+    for( auto It = In.Actions.begin(); It != In.Actions.end(); It++ )
+        WriteAction( Schema, *It );
+}
+
+
+bool Game::ReadActionQueue( StreamReader& In, ActionQueue& Out, uint32_t Version )
+{
+    SchemaReader Schema( In, Version );
+    size_t Count = 0;
+    Schema.Unsigned( Count );
+    
+    for( size_t i = 0; i < Count; i++ )
+    {
+        if( !ReadAction( Schema, Out ) )
+            return false;
+    }
+    
+    return Schema.IsValid();
+}
+
+
+void Game::WriteStateFrame( StreamWriter& Out, GameStateBase& In )
+{
+    Out.WriteByte( (uint8_t) In.mState );
+    Out.WriteByte( (uint8_t) In.pState );
+    Out.WriteByte( (uint8_t) In.tState );
+    Out.WriteByte( (uint8_t) In.GetStartingPlayer() );
+    Out.WriteSigned( In.TurnNumber );
+    
+    SchemaWriter Schema( Out );
+    PlayerSchema( Schema, *In.GetPlayer() );
+    PlayerSchema( Schema, *In.GetOpponent() );
+}
+
+
+bool Game::ReadStateFrame( StreamReader& In, GameStateBase& Out, uint32_t Version )
+{
+    MatchState Match        = (MatchState) In.ReadByte();
+    PlayerTurn Turn         = (PlayerTurn) In.ReadByte();
+    TurnState Phase         = (TurnState) In.ReadByte();
+    PlayerTurn Starting     = (PlayerTurn) In.ReadByte();
+    int TurnNumber          = (int) In.ReadSigned();
+    
+    SchemaReader Schema( In, Version );
+    PlayerSchema( Schema, *Out.GetPlayer() );
+    PlayerSchema( Schema, *Out.GetOpponent() );
+    
+    if( !Schema.IsValid() )
+        return false;
+    
+    // Starting player resets the turn state, so it goes first
+    Out.SetStartingPlayer( Starting );
+    Out.mState      = Match;
+    Out.pState      = Turn;
+    Out.tState      = Phase;
+    Out.TurnNumber  = TurnNumber;
+    
+    Out.RebuildIndex();
+    return true;
+}
+
+
+/*=========================================================================================
+    Action Recorder
+ =========================================================================================*/
+ActionRecorder::ActionRecorder()
+{
+    Reset();
+}
+
+
+void ActionRecorder::Reset()
+{
+    Output.Buffer.clear();
+    Output.WriteFixed( ACTION_STREAM_MAGIC, 4 );
+    Output.WriteFixed( ACTION_STREAM_VERSION, 2 );
+    Output.WriteFixed( 0, 2 );
+    
+    RecordCount     = 0;
+    Turn            = 0;
+    LastKeyframe    = -1;
+}
+
+
+void ActionRecorder::WriteRecord( StreamRecord Kind, const StreamWriter& Payload )
+{
+    Output.WriteByte( (uint8_t) Kind );
+    Output.WriteVarint( (uint64_t) Turn );
+    Output.WriteVarint( Payload.Buffer.size() );
+    Output.WriteBytes( Payload.Buffer.data(), Payload.Buffer.size() );
+    
+    RecordCount++;
+}
+
+
+void ActionRecorder::RecordQueue( const ActionQueue& In, GameStateBase* State )
+{
+    bool bTurnStart = HasTurnStart( In.Actions );
+    if( bTurnStart )
+        Turn++;
+    
+    StreamWriter Payload;
+    WriteActionQueue( Payload, In );
+    
+    WriteRecord( StreamRecord::Queue, Payload );
+    
+    // The first keyframe goes right after the first queue, so a replay always has a state to start from
+    if( State && ( LastKeyframe < 0 || ( bTurnStart && Turn - LastKeyframe >= ACTION_STREAM_KEYFRAME_INTERVAL ) ) )
+    {
+        StreamWriter Keyframe;
+        WriteStateFrame( Keyframe, *State );
+        
+        WriteRecord( StreamRecord::Keyframe, Keyframe );
+        LastKeyframe = Turn;
+    }
+}
+
+
+bool ActionRecorder::Save( const std::string& FullPath )
+{
+    cocos2d::Data FileData;
+    FileData.copy( Output.Buffer.data(), (ssize_t) Output.Buffer.size() );
+    
+    if( !cocos2d::FileUtils::getInstance()->writeDataToFile( FileData, FullPath ) )
+    {
+        cocos2d::log( "[ActionStream] Failed to write action stream to '%s'", FullPath.c_str() );
+        return false;
+    }
+    
+    cocos2d::log( "[ActionStream] Wrote %d records to '%s'", RecordCount, FullPath.c_str() );
+    return true;
+}
+
+
+/*=========================================================================================
+    Action Replay
+ =========================================================================================*/
+ActionReplay::ActionReplay()
+: Cursor( 0 ), LastTurn( 0 ), Version( 0 )
+{
+}
+
+
+bool ActionReplay::Load( const std::string& FileName )
+{
+    auto file = cocos2d::FileUtils::getInstance();
+    if( !file || !file->isFileExist( FileName ) )
+    {
+        cocos2d::log( "[ActionStream] Couldnt find action stream '%s'", FileName.c_str() );
+        return false;
+    }
+    
+    auto data = file->getDataFromFile( FileName );
+    if( data.isNull() )
+    {
+        cocos2d::log( "[ActionStream] Failed to read action stream '%s'", FileName.c_str() );
+        return false;
+    }
+    
+    return Open( std::vector< uint8_t >( data.getBytes(), data.getBytes() + data.getSize() ) );
+}
+
+
+bool ActionReplay::Open( std::vector< uint8_t >&& In )
+{
+    Data = std::move( In );
+    Records.clear();
+    Keyframes.clear();
+    Cursor = 0;
+    LastTurn = 0;
+    
+    StreamReader Reader( Data.data(), Data.size() );
+    uint32_t Magic  = (uint32_t) Reader.ReadFixed( 4 );
+    Version         = (uint32_t) Reader.ReadFixed( 2 );
+    
+    if( !Reader.Skip( 2 ) || Magic != ACTION_STREAM_MAGIC )
+    {
+        cocos2d::log( "[ActionStream] Action stream has an invalid header!" );
+        return false;
+    }
+    
+    if( Version < WIRE_SCHEMA_MIN_VERSION || Version > WIRE_SCHEMA_VERSION )
+    {
+        cocos2d::log( "[ActionStream] Action stream version %d isnt supported!", (int) Version );
+        return false;
+    }
+    
+    // Only the record headers are read here, payloads are decoded as the replay reaches them
+    while( !Reader.AtEnd() )
+    {
+        RecordInfo Info;
+        Info.Kind   = (StreamRecord) Reader.ReadByte();
+        Info.Turn   = (int) Reader.ReadVarint();
+        Info.Size   = (size_t) Reader.ReadVarint();
+        Info.Offset = Reader.GetPosition();
+        
+        if( !Reader.Skip( Info.Size ) || ( Info.Kind != StreamRecord::Queue && Info.Kind != StreamRecord::Keyframe ) )
+        {
+            // Keep what we have, a match that crashed mid write is still worth replaying up to that point
+            cocos2d::log( "[ActionStream] Action stream is truncated after %d records", (int) Records.size() );
+            break;
+        }
+        
+        if( Info.Kind == StreamRecord::Keyframe )
+            Keyframes.push_back( Records.size() );
+        
+        Records.push_back( Info );
+        LastTurn = std::max( LastTurn, Info.Turn );
+    }
+    
+    return !Records.empty();
+}
+
+
+bool ActionReplay::ReadQueue( const RecordInfo& Info, ActionQueue& Out )
+{
+    StreamReader Reader( Data.data() + Info.Offset, Info.Size );
+    if( !ReadActionQueue( Reader, Out, Version ) )
+    {
+        cocos2d::log( "[ActionStream] Invalid action in queue record!" );
+        return false;
+    }
+    
+    return true;
+}
+
+
+bool ActionReplay::ReadKeyframe( const RecordInfo& Info, GameStateBase& Out )
+{
+    StreamReader Reader( Data.data() + Info.Offset, Info.Size );
+    if( !ReadStateFrame( Reader, Out, Version ) )
+    {
+        cocos2d::log( "[ActionStream] Invalid keyframe record!" );
+        return false;
+    }
+    
+    return true;
+}
+
+
+bool ActionReplay::Seek( int Turn, GameStateBase& Out )
+{
+    // Find the last keyframe at or before the requested turn
+    auto Keyframe = std::upper_bound( Keyframes.begin(), Keyframes.end(), Turn,
+                                     [ this ]( int Value, size_t Index ) { return Value < Records[ Index ].Turn; } );
+    
+    if( Keyframe == Keyframes.begin() )
+        return false;
+    
+    size_t Start = *( Keyframe - 1 );
+    if( !ReadKeyframe( Records[ Start ], Out ) )
+        return false;
+    
+    // Apply queues until the one that starts the requested turn, the keyframe for a turn is
+    // written after its first queue, so if we landed on one there is nothing to apply
+    bool bReachedTurn = Records[ Start ].Turn == Turn;
+    Cursor = Start + 1;
+    
+    while( Cursor < Records.size() )
+    {
+        auto& Info = Records[ Cursor ];
+        if( Info.Turn > Turn || ( Info.Turn == Turn && bReachedTurn ) )
+            break;
+        
+        if( Info.Kind == StreamRecord::Queue )
+        {
+            ActionQueue Queue;
+            if( !ReadQueue( Info, Queue ) )
+                return false;
+            
+            ApplyQueue( Queue, Out );
+            bReachedTurn = Info.Turn == Turn;
+        }
+        
+        Cursor++;
+    }
+    
+    return true;
+}
+
+
+bool ActionReplay::Next( ActionQueue& Out, int* OutTurn /* = nullptr */ )
+{
+    while( Cursor < Records.size() && Records[ Cursor ].Kind != StreamRecord::Queue )
+        Cursor++;
+    
+    if( Cursor >= Records.size() )
+        return false;
+    
+    auto& Info = Records[ Cursor++ ];
+    if( OutTurn )
+        *OutTurn = Info.Turn;
+    
+    return ReadQueue( Info, Out );
+}
+
+
+int ActionReplay::RunToEnd( GameStateBase& Out )
+{
+    // Start from the first keyframe, and apply everything after it
+    if( Keyframes.empty() || !ReadKeyframe( Records[ Keyframes.front() ], Out ) )
+        return -1;
+    
+    Cursor = Keyframes.front() + 1;
+    
+    int Count = 0;
+    ActionQueue Queue;
+    while( Next( Queue ) )
+    {
+        ApplyQueue( Queue, Out );
+        Count++;
+        
+        Queue = ActionQueue();
+    }
+    
+    return Count;
+}
+
+
+/*=========================================================================================
+    Headless Playback
+ =========================================================================================*/
+static CardState* MoveById( GameStateBase& Target, uint32_t EntId, CardPos From, CardPos To )
+{
+    CardState* Card = nullptr;
+    PlayerState* Owner = nullptr;
+    
+    if( !Target.FindCard( EntId, Card ) || !Card || Card->Position != From || !Target.FindPlayer( Card->Owner, Owner ) || !Owner )
+        return nullptr;
+    
+    auto Zone = Target.GetZone( Owner, From );
+    if( !Zone || Zone->empty() )
+        return nullptr;
+    
+    return Target.MoveCard( Owner, From, (size_t)( Card - Zone->data() ), To );
+}
+
+
+static void CheckKilled( GameStateBase& Target, uint32_t EntId )
+{
+    CardState* Card = nullptr;
+    if( Target.FindCard( EntId, Card ) && Card && Card->Position == CardPos::FIELD && ( Card->Power <= 0 || Card->Stamina <= 0 ) )
+        Target.OnCardKilled( Card );
+}
+
+
+static PlayerTurn GetTurnFor( GameStateBase& Target, uint32_t Player )
+{
+    return Target.GetPlayer()->EntId == Player ? PlayerTurn::LocalPlayer : PlayerTurn::Opponent;
+}
+
+
+void ActionReplay::ApplyQueue( const ActionQueue& In, GameStateBase& Target )
+{
+    for( auto It = In.Actions.begin(); It != In.Actions.end(); It++ )
+        ApplyAction( *It, Target );
+}
+
+
+void ActionReplay::ApplyAction( Game::Action* In, GameStateBase& Target )
+{
+    if( !In )
+        return;
+    
+    // Mirrors what the game mode handlers do to the entities, minus anything visual
+    switch( In->Type )
+    {
+        case ActionType::Parallel:
+        {
+            auto Parallel = static_cast< ParallelAction* >( In );
+            for( auto It = Parallel->Actions.begin(); It != Parallel->Actions.end(); It++ )
+                ApplyAction( *It, Target );
+            break;
+        }
+        case ActionType::PlayCard:
+        {
+            auto Play = static_cast< PlayCardAction* >( In );
+            if( Play->bWasSuccessful && Play->bNeedsMove )
+                MoveById( Target, Play->TargetCard, CardPos::HAND, CardPos::FIELD );
+            break;
+        }
+        case ActionType::DrawCard:
+            MoveById( Target, static_cast< DrawCardAction* >( In )->TargetCard, CardPos::DECK, CardPos::HAND );
+            break;
+        case ActionType::UpdateMana:
+        {
+            auto Update = static_cast< UpdateManaAction* >( In );
+            PlayerState* Player = nullptr;
+            
+            if( Target.FindPlayer( Update->TargetPlayer, Player ) && Player )
+                Player->Mana = Update->Amount;
+            break;
+        }
+        case ActionType::CoinFlip:
+            Target.pState = GetTurnFor( Target, static_cast< CoinFlipAction* >( In )->Player );
+            break;
+        case ActionType::TurnStart:
+            Target.mState = MatchState::Main;
+            Target.tState = TurnState::PreTurn;
+            Target.pState = GetTurnFor( Target, static_cast< TurnStartAction* >( In )->Player );
+            break;
+        case ActionType::Event:
+        {
+            switch( In->Id )
+            {
+                case ActionId::BlitzStart:      Target.mState = MatchState::Blitz;  break;
+                case ActionId::MarshalStart:    Target.tState = TurnState::Marshal; break;
+                case ActionId::AttackStart:     Target.tState = TurnState::Attack;  break;
+                case ActionId::BlockStart:      Target.tState = TurnState::Block;   break;
+                case ActionId::DamageStart:     Target.tState = TurnState::Damage;  break;
+                case ActionId::TurnFinish:      Target.tState = TurnState::PostTurn; break;
+                default: break;
+            }
+            break;
+        }
+        case ActionType::Damage:
+        {
+            auto Damage = static_cast< DamageAction* >( In );
+            PlayerState* Player = nullptr;
+            CardState* Card = nullptr;
+            
+            if( Target.FindPlayer( Damage->Target, Player ) && Player )
+            {
+                Player->Health = Damage->UpdatedPower;
+            }
+            else if( Target.FindCard( Damage->Target, Card ) && Card )
+            {
+                Card->Power = Damage->UpdatedPower;
+                CheckKilled( Target, Damage->Target );
+            }
+            break;
+        }
+        case ActionType::Combat:
+        {
+            auto Combat = static_cast< CombatAction* >( In );
+            CardState* Card = nullptr;
+            
+            if( Target.FindCard( Combat->Attacker, Card ) && Card )
+                Card->Power = Combat->AttackerPower;
+            if( Target.FindCard( Combat->Blocker, Card ) && Card )
+                Card->Power = Combat->BlockerPower;
+            
+            CheckKilled( Target, Combat->Attacker );
+            CheckKilled( Target, Combat->Blocker );
+            break;
+        }
+        case ActionType::UpdateStamina:
+        {
+            auto Update = static_cast< UpdateStaminaAction* >( In );
+            CardState* Card = nullptr;
+            
+            if( Target.FindCard( Update->Target, Card ) && Card )
+            {
+                Card->Stamina = Update->UpdatedAmount;
+                CheckKilled( Target, Update->Target );
+            }
+            break;
+        }
+        case ActionType::Win:
+            Target.mState = MatchState::PostMatch;
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,181 @@
+//
+//	ActionStream.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Actions.hpp"
+#include "ObjectStates.hpp"
+#include <string>
+#include <vector>
+
+
+// Version of the action and state encoding in WireSchema.hpp. Replays store the version they were written with,
+// and anything from WIRE_SCHEMA_MIN_VERSION up can still be read
+// v2: Action headers are one byte, unless the action id isnt the default for its type
+#define WIRE_SCHEMA_VERSION 2
+#define WIRE_SCHEMA_MIN_VERSION 1
+
+#define ACTION_STREAM_MAGIC 0x53415252 // 'RRAS'
+#define ACTION_STREAM_VERSION WIRE_SCHEMA_VERSION
+
+// A state keyframe is written every this many turns, so a seek never replays more than this many turns of actions
+#define ACTION_STREAM_KEYFRAME_INTERVAL 4
+
+// The game never nests parallel actions more than a couple deep, anything past this is a malformed frame
+// and invalidates the reader, instead of recursing until the stack runs out
+#define ACTION_STREAM_MAX_DEPTH 8
+
+// When defined, the game mode records every match, and writes it to the writable path on cleanup
+// Only meant for debugging matches, so it stays off by default
+// #define ACTION_STREAM_FILE "LastMatch.actions"
+
+namespace Game
+{
+    class GameStateBase;
+    
+    // Little endian byte writer, integers are written as LEB128 varints and signed values are zigzag encoded first
+    class StreamWriter
+    {
+    public:
+    
+        void WriteByte( uint8_t In );
+        void WriteFixed( uint64_t In, int Bytes );
+        void WriteVarint( uint64_t In );
+        void WriteSigned( int64_t In );
+        void WriteString( const std::string& In );
+        void WriteBytes( const uint8_t* In, size_t Count );
+        
+        std::vector< uint8_t > Buffer;
+    };
+    
+    // Reads what StreamWriter wrote. Reading past the end, or a malformed varint, sets the error flag
+    // and returns zeros from then on, so callers can read a whole record and check IsValid once
+    class StreamReader
+    {
+    public:
+    
+        StreamReader( const uint8_t* InData, size_t InSize );
+        
+        uint8_t ReadByte();
+        uint64_t ReadFixed( int Bytes );
+        uint64_t ReadVarint();
+        int64_t ReadSigned();
+        std::string ReadString();
+        bool Skip( size_t Count );
+        
+        // Points into the buffer instead of copying, null when there arent Count bytes left
+        const uint8_t* ReadView( size_t Count );
+        
+        inline bool IsValid() const { return !bError; }
+        inline bool AtEnd() const { return Position >= Size; }
+        inline size_t GetPosition() const { return Position; }
+        inline size_t GetRemaining() const { return bError ? 0 : Size - Position; }
+        inline void Invalidate() { bError = true; }
+    
+    protected:
+    
+        const uint8_t* Data;
+        size_t Size;
+        size_t Position;
+        bool bError;
+    };
+    
+    // Encodings shared by the recorder and the network protocol, the fields of each type are listed in WireSchema.hpp
+    // Queues are written as varint Count, then each action. State frames hold the match state, followed by both players
+    // Always written with the current schema version, and read with the version of whoever wrote them
+    void WriteActionQueue( StreamWriter& Out, const ActionQueue& In );
+    bool ReadActionQueue( StreamReader& In, ActionQueue& Out, uint32_t Version = WIRE_SCHEMA_VERSION );
+    void WriteStateFrame( StreamWriter& Out, GameStateBase& In );
+    bool ReadStateFrame( StreamReader& In, GameStateBase& Out, uint32_t Version = WIRE_SCHEMA_VERSION );
+    
+    enum class StreamRecord : uint8_t
+    {
+        Queue       = 1,
+        Keyframe    = 2
+    };
+    
+    // Records every action queue in a match, along with periodic keyframes of the authoritative state
+    // Turns are counted by TurnStart actions, so each players turn counts as one. Keyframes are written right
+    // after the queue that started the turn, since the authority has already applied that queue to its state
+    //
+    // File Format (little endian)
+    //  uint32 Magic, uint16 Version, uint16 Reserved
+    //  Records: uint8 Kind, varint Turn, varint PayloadSize, Payload
+    //  Queue Payload: varint Count, Count x Action { uint8 Header, [uint8 Id], fields of that action class }
+    //                 Header is the type, with the high bit set when the id isnt the default for the type
+    //  Keyframe Payload: match state, followed by both players and each of their zones
+    class ActionRecorder
+    {
+    public:
+    
+        ActionRecorder();
+        
+        void Reset();
+        void RecordQueue( const ActionQueue& In, GameStateBase* State );
+        bool Save( const std::string& FullPath );
+        
+        inline bool IsEmpty() const { return RecordCount == 0; }
+        inline int GetTurn() const { return Turn; }
+        inline const std::vector< uint8_t >& GetBuffer() const { return Output.Buffer; }
+    
+    protected:
+    
+        void WriteRecord( StreamRecord Kind, const StreamWriter& Payload );
+        
+        StreamWriter Output;
+        int RecordCount;
+        int Turn;
+        int LastKeyframe;
+    };
+    
+    // Plays back a recorded stream. Seek restores the closest keyframe and applies the queues after it,
+    // the queues are applied to the state directly without any visuals, so replays run as fast as they can be decoded.
+    // Queues can also be pulled out one by one and handed to the game mode for spectating, although the entity ids
+    // only line up when the match was loaded the same way as the recording
+    class ActionReplay
+    {
+    public:
+    
+        ActionReplay();
+        
+        bool Load( const std::string& FileName );
+        bool Open( std::vector< uint8_t >&& In );
+        
+        bool Seek( int Turn, GameStateBase& Out );
+        bool Next( ActionQueue& Out, int* OutTurn = nullptr );
+        int RunToEnd( GameStateBase& Out );
+        
+        inline int GetTurnCount() const { return LastTurn; }
+        inline bool IsOpen() const { return !Records.empty(); }
+        
+        static void ApplyQueue( const ActionQueue& In, GameStateBase& Target );
+        static void ApplyAction( Action* In, GameStateBase& Target );
+    
+    protected:
+    
+        struct RecordInfo
+        {
+            StreamRecord Kind;
+            int Turn;
+            size_t Offset;
+            size_t Size;
+        };
+        
+        bool ReadQueue( const RecordInfo& Info, ActionQueue& Out );
+        bool ReadKeyframe( const RecordInfo& Info, GameStateBase& Out );
+        
+        std::vector< uint8_t > Data;
+        std::vector< RecordInfo > Records;
+        std::vector< size_t > Keyframes;
+        size_t Cursor;
+        int LastTurn;
+        uint32_t Version;
+    };
+}
@@ -12,6 +12,11 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <functional>
+#include <map>
+#include <cstddef>
+#include <new>
 #include "EntityBase.hpp"
 
 namespace Game
@@ -43,39 +48,201 @@ namespace Game
         None
     };
     
+    // Class of an action, so handlers can cast without RTTI
+    enum class ActionType : uint8_t
+    {
+        Parallel,
+        PlayCard,
+        UpdateMana,
+        DrawCard,
+        LoadCard,
+        CoinFlip,
+        TimedQuery,
+        Event,
+        CardError,
+        TurnStart,
+        Damage,
+        UpdateStamina,
+        Win,
+        Combat,
+        PlayerEvent,
+        CardList,
+        BattleMatrix,
+        Count
+    };
+    
+    // Selects the game mode handler that runs an action. Generic actions (events, queries, errors) share
+    // a class, so the authority picks the id after creating them
+    enum class ActionId : uint8_t
+    {
+        None,
+        PlayCard,
+        UpdateMana,
+        DrawCard,
+        LoadCard,
+        CoinFlip,
+        TimedQuery,
+        Event,
+        BlitzStart,
+        BlitzQuery,
+        BlitzError,
+        BlitzSuccess,
+        AttackError,
+        MatchStart,
+        TurnStart,
+        MarshalStart,
+        AttackStart,
+        BlockStart,
+        TurnFinish,
+        DamageStart,
+        Damage,
+        Combat,
+        UpdateStamina,
+        CleanupBoard,
+        BattleMatrix,
+        Win,
+        PlayerEvent,
+        CardList,
+        Count
+    };
+    
+    inline const char* GetActionName( ActionId In )
+    {
+        static const char* Names[] =
+        {
+            "None", "PlayCard", "UpdateMana", "DrawCard", "LoadCard", "CoinFlip", "TimedQuery", "Event",
+            "BlitzStart", "BlitzQuery", "BlitzError", "BlitzSuccess", "AttackError", "MatchStart", "TurnStart",
+            "MarshalStart", "AttackStart", "BlockStart", "TurnFinish", "DamageStart", "Damage", "Combat",
+            "UpdateStamina", "CleanupBoard", "BattleMatrix", "Win", "PlayerEvent", "CardList"
+        };
+        
+        static_assert( sizeof( Names ) / sizeof( Names[ 0 ] ) == (size_t) ActionId::Count, "Action name table is out of date" );
+        return In < ActionId::Count ? Names[ (size_t) In ] : "Invalid";
+    }
+    
+    // The id each action class is created with, only actions that were given a different id need to encode it
+    inline ActionId GetDefaultActionId( ActionType In )
+    {
+        static const ActionId Ids[] =
+        {
+            ActionId::None, ActionId::PlayCard, ActionId::UpdateMana, ActionId::DrawCard, ActionId::LoadCard,
+            ActionId::CoinFlip, ActionId::TimedQuery, ActionId::Event, ActionId::BlitzError, ActionId::TurnStart,
+            ActionId::Damage, ActionId::UpdateStamina, ActionId::Win, ActionId::Combat, ActionId::PlayerEvent,
+            ActionId::CardList, ActionId::BattleMatrix
+        };
+        
+        static_assert( sizeof( Ids ) / sizeof( Ids[ 0 ] ) == (size_t) ActionType::Count, "Default action id table is out of date" );
+        return In < ActionType::Count ? Ids[ (size_t) In ] : ActionId::None;
+    }
+    
     class Action
     {
     public:
+    
+        const ActionType Type;
+        ActionId Id;
         
-        std::string Name;
-        
-        Action( const std::string& In )
-        : Name( In )
+        Action( ActionType InType, ActionId InId )
+        : Type( InType ), Id( InId )
         {}
         
         virtual ~Action()
         {}
         
+        const char* GetName() const { return GetActionName( Id ); }
+        
+    };
+    
+    // Checked downcast, returns null if the action isnt of the requested class
+    template< typename T >
+    inline T* ActionCast( Action* In )
+    {
+        static_assert( std::is_base_of< Game::Action, T >::value, "Template argument must be derived from Action" );
+        return ( In && In->Type == T::StaticType ) ? static_cast< T* >( In ) : nullptr;
+    }
+    
+    // Size of each block in an action arena, actions larger than this get a block of their own
+    #define ACTION_ARENA_BLOCK 2048
+    
+    // Storage for all actions in a queue (including the children of parallel actions)
+    // Actions are placed into blocks back to back, and all destroyed together along with the queue
+    class ActionArena
+    {
+    public:
+    
+        ActionArena()
+        : Current( nullptr ), Used( 0 ), Capacity( 0 )
+        {}
+        
+        ~ActionArena()
+        {
+            for( auto It = Created.rbegin(); It != Created.rend(); It++ )
+                ( *It )->~Action();
+        }
+        
+        ActionArena( const ActionArena& ) = delete;
+        ActionArena& operator=( const ActionArena& ) = delete;
+        
+        template< typename T >
+        T* Create()
+        {
+            static_assert( std::is_base_of< Game::Action, T >::value, "Template argument must be derived from Action" );
+            static_assert( alignof( T ) <= alignof( std::max_align_t ), "Action alignment not supported by the arena" );
+            
+            const size_t Align = alignof( std::max_align_t );
+            size_t Size = ( sizeof( T ) + Align - 1 ) & ~( Align - 1 );
+            
+            if( !Current || Used + Size > Capacity )
+            {
+                Capacity = Size > ACTION_ARENA_BLOCK ? Size : ACTION_ARENA_BLOCK;
+                Blocks.push_back( std::unique_ptr< uint8_t[] >( new uint8_t[ Capacity ] ) );
+                Current = Blocks.back().get();
+                Used = 0;
+            }
+            
+            T* Output = new( Current + Used ) T();
+            Used += Size;
+            Created.push_back( Output );
+            
+            return Output;
+        }
+    
+    private:
+    
+        std::vector< std::unique_ptr< uint8_t[] > > Blocks;
+        std::vector< Game::Action* > Created;
+        uint8_t* Current;
+        size_t Used;
+        size_t Capacity;
     };
     
     class ParallelAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::Parallel;
         
-        std::vector< std::unique_ptr< Game::Action > > Actions;
+        // Owned by the arena of the queue this action belongs to
+        std::vector< Game::Action* > Actions;
+        ActionArena* Arena;
         int Counter;
         
         ParallelAction()
-        : Action( "Parallel" ), Counter( 0 )
+        : Action( StaticType, ActionId::None ), Arena( nullptr ), Counter( 0 )
         {}
         
         template< typename T >
         T* CreateAction()
         {
-            static_assert( std::is_base_of< Game::Action, T >::value, "Template argument must be derived from Action!" );
+            if( !Arena )
+                return nullptr;
+            
+            T* Output = Arena->Create< T >();
+            if( Output->Type == ActionType::Parallel )
+                static_cast< ParallelAction* >( (Action*) Output )->Arena = Arena;
             
-            Actions.push_back( std::move( std::unique_ptr< T >( new (std::nothrow) T() ) ) );
-            return dynamic_cast< T* >( Actions.back().get() );
+            Actions.push_back( Output );
+            return Output;
         }
     };
     
@@ -83,42 +250,49 @@ namespace Game
     class ActionQueue
     {
     public:
-        
+    
         uint32_t Identifier;
         uint32_t Position;
         std::function< void() > Callback;
-        std::vector< std::unique_ptr< Game::Action > > Actions;
+        
+        // Actions are owned by the arena, which stays put when the queue is moved into the game mode
+        std::vector< Game::Action* > Actions;
+        std::unique_ptr< ActionArena > Arena;
         
         ActionQueue()
-        : Callback( nullptr ), Identifier( ++_nextQueueId ), Position( 0 )
+        : Callback( nullptr ), Identifier( ++_nextQueueId ), Position( 0 ), Arena( new ActionArena() )
         {}
         
         ActionQueue( std::function< void() > InCallback )
-        : Callback( InCallback ), Identifier( ++_nextQueueId ), Position( 0 )
+        : Callback( InCallback ), Identifier( ++_nextQueueId ), Position( 0 ), Arena( new ActionArena() )
         {}
         
         template< typename T >
         T* CreateAction()
         {
-            // Check type, create new action, move into vector, return reference
-            static_assert( std::is_base_of< Game::Action, T >::value, "Template argument must be derived from Action" );
+            // A queue thats been moved from gave its arena away, so it gets a new one if its used again
+            if( !Arena )
+                Arena.reset( new ActionArena() );
             
-            Actions.push_back( std::move( std::unique_ptr< T >( new (std::nothrow) T() ) ) );
+            T* Output = Arena->Create< T >();
+            if( Output->Type == ActionType::Parallel )
+                static_cast< ParallelAction* >( (Action*) Output )->Arena = Arena.get();
             
-            // We need to get the new unique_ptr we added, get the raw pointer and cast back to desired type
-            auto& newEntry = Actions.back();
-            return dynamic_cast< T* >( newEntry.get() );
+            Actions.push_back( Output );
+            return Output;
         }
-    
+        
     };
     
     // Targets players
     class PlayCardAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::PlayCard;
         
         PlayCardAction()
-        : Action( "PlayCard" ), bNeedsMove( true ), bWasSuccessful( true ),
+        : Action( StaticType, ActionId::PlayCard ), bNeedsMove( true ), bWasSuccessful( true ),
         TargetCard( 0 ), TargetIndex( -1 ), TargetPlayer( 0 )
         {}
         
@@ -135,9 +309,11 @@ namespace Game
     class UpdateManaAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::UpdateMana;
         
         UpdateManaAction()
-        : Action( "UpdateMana" )
+        : Action( StaticType, ActionId::UpdateMana )
         {}
         
         uint32_t TargetPlayer;
@@ -148,9 +324,11 @@ namespace Game
     class DrawCardAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::DrawCard;
         
         DrawCardAction()
-        : Action( "DrawCard" )
+        : Action( StaticType, ActionId::DrawCard )
         {}
         
         uint32_t TargetPlayer;
@@ -161,9 +339,11 @@ namespace Game
     class LoadCardAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::LoadCard;
         
         LoadCardAction()
-        : Action( "LoadCard" )
+        : Action( StaticType, ActionId::LoadCard )
         {}
         
         // TODO: Decide if we should send json or a c-struct
@@ -178,9 +358,11 @@ namespace Game
     class CoinFlipAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::CoinFlip;
         
         CoinFlipAction()
-        : Action( "CoinFlip" )
+        : Action( StaticType, ActionId::CoinFlip )
         {}
         
         uint32_t Player;
@@ -190,9 +372,11 @@ namespace Game
     class TimedQueryAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::TimedQuery;
         
         TimedQueryAction()
-        : Action( "TimedQuery" )
+        : Action( StaticType, ActionId::TimedQuery )
         {}
         
         std::chrono::steady_clock::time_point Deadline;
@@ -202,18 +386,22 @@ namespace Game
     class EventAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::Event;
         
         EventAction()
-        : Action( "Event" )
+        : Action( StaticType, ActionId::Event )
         {}
     };
     
     class CardErrorAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::CardError;
         
         CardErrorAction()
-        : Action( "BlitzError" )
+        : Action( StaticType, ActionId::BlitzError )
         {}
         
         std::map< uint32_t, uint8_t > Errors;
@@ -222,9 +410,11 @@ namespace Game
     class TurnStartAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::TurnStart;
         
         TurnStartAction()
-        : Action( "TurnStart" )
+        : Action( StaticType, ActionId::TurnStart )
         {}
         
         uint32_t Player;
@@ -234,9 +424,11 @@ namespace Game
     class DamageAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::Damage;
         
         DamageAction()
-        : Action( "Damage" )
+        : Action( StaticType, ActionId::Damage )
         {}
         
         uint32_t Target;
@@ -248,9 +440,11 @@ namespace Game
     class UpdateStaminaAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::UpdateStamina;
         
         UpdateStaminaAction()
-        : Action( "UpdateStamina" )
+        : Action( StaticType, ActionId::UpdateStamina )
         {}
         
         uint32_t Target;
@@ -262,9 +456,11 @@ namespace Game
     class WinAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::Win;
         
         WinAction()
-        : Action( "Win" )
+        : Action( StaticType, ActionId::Win )
         {}
         
         uint32_t Player;
@@ -273,9 +469,11 @@ namespace Game
     class CombatAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::Combat;
         
         CombatAction()
-        : Action( "Combat" )
+        : Action( StaticType, ActionId::Combat )
         {}
         
         uint32_t Attacker;
@@ -288,9 +486,11 @@ namespace Game
     class PlayerEventAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::PlayerEvent;
         
         PlayerEventAction()
-        : Action( "PlayerEvent" )
+        : Action( StaticType, ActionId::PlayerEvent )
         {}
         
         uint32_t Player;
@@ -299,9 +499,11 @@ namespace Game
     class CardListEvent : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::CardList;
         
         CardListEvent()
-        : Action( "CardList" )
+        : Action( StaticType, ActionId::CardList )
         {}
         
         std::vector< uint32_t > Cards;
@@ -310,9 +512,11 @@ namespace Game
     class BattleMatrixAction : public Action
     {
     public:
+    
+        static constexpr ActionType StaticType = ActionType::BattleMatrix;
         
         BattleMatrixAction()
-        : Action( "BattleMatrix" )
+        : Action( StaticType, ActionId::BattleMatrix )
         {}
         
         std::map< uint32_t, std::vector< uint32_t > > Matrix;
@@ -34,12 +34,9 @@ void AuthState::RunActiveQueue()
 {
     if( ActiveQueue )
     {
-        auto World = World::GetWorld();
-        auto GM = World ? World->GetGameMode() : nullptr;
+        CC_ASSERT( QueueHandler );
         
-        CC_ASSERT( GM );
-        
-        GM->RunActionQueue( std::move( *ActiveQueue ) );
+        QueueHandler( std::move( *ActiveQueue ) );
         ActiveQueue = nullptr;
     }
 }
@@ -89,22 +86,12 @@ void AuthState::DrawCard( PlayerState* Target, uint32_t Count )
             return;
         }
         
-        auto It = Target->Deck.begin();
-        
-        It->Position    = CardPos::HAND;
-        It->FaceUp      = false;
+        auto Card = MoveCard( Target, CardPos::DECK, Target->Deck.size() - 1, CardPos::HAND );
+        Card->FaceUp = false;
         
         auto Draw = ActiveQueue->CreateAction< DrawCardAction >();
-        Draw->TargetCard = It->EntId;
+        Draw->TargetCard = Card->EntId;
         Draw->TargetPlayer = Target->EntId;
-        
-        cocos2d::log( "AUTH CARD: %d", It->EntId );
-        
-        Target->Hand.push_back( *It );
-        Target->Deck.erase( It );
-        
-        auto Next = Target->Deck.begin();
-        cocos2d::log( "NEXT CARD: %d", Next->EntId );
     }
 }
 
@@ -41,9 +41,13 @@ namespace Game
         void RunActiveQueue();
         void ClearActiveQueue();
         
+        // Where finished queues are sent, set by the authority that owns this state
+        inline void SetQueueHandler( std::function< void( ActionQueue&& ) > In ) { QueueHandler = In; }
+        
     protected:
         
         ActionQueue* ActiveQueue;
+        std::function< void( ActionQueue&& ) > QueueHandler;
         virtual bool PreHook();
         
     };
@@ -15,9 +15,16 @@
 using namespace Game;
 
 AuthorityBase::AuthorityBase()
-: EntityBase( "Authority" )
+: EntityBase( "Authority" ), Scheduler( std::make_shared< CocosScheduler >( this ) )
 {
-    
+    State.SetQueueHandler( [ this ]( ActionQueue&& In ) { RunQueue( std::move( In ) ); } );
+}
+
+AuthorityBase::AuthorityBase( std::shared_ptr< MatchScheduler > InScheduler )
+: EntityBase( "Authority" ), Scheduler( InScheduler )
+{
+    CC_ASSERT( Scheduler );
+    State.SetQueueHandler( [ this ]( ActionQueue&& In ) { RunQueue( std::move( In ) ); } );
 }
 
 AuthorityBase::~AuthorityBase()
@@ -29,4 +36,67 @@ AuthorityBase::~AuthorityBase()
 void AuthorityBase::Cleanup()
 {
     EntityBase::Cleanup();
+    
+    if( Scheduler )
+        Scheduler->UnscheduleAll();
+}
+
+
+void AuthorityBase::SetScheduler( std::shared_ptr< MatchScheduler > In )
+{
+    if( !In )
+        return;
+    
+    if( Scheduler )
+        Scheduler->UnscheduleAll();
+    
+    Scheduler = In;
+}
+
+
+void AuthorityBase::RunQueue( ActionQueue&& In )
+{
+    if( Scheduler->IsHeadless() )
+    {
+        if( In.Callback )
+            Scheduler->Dispatch( In.Callback );
+        
+        return;
+    }
+    
+    auto GM = GetGameMode< GameModeBase >();
+    CC_ASSERT( GM );
+    
+    GM->RunActionQueue( std::move( In ) );
+}
+
+
+bool AuthorityBase::LoadKing( uint16_t KingId, uint32_t Owner, KingState& Out )
+{
+    // Load lua file into the specified king state
+    auto Lua = Regicide::LuaEngine::GetInstance();
+    auto L = Lua ? Lua->State() : nullptr;
+    CC_ASSERT( L );
+    
+    auto Table = luabridge::newTable( L );
+    luabridge::setGlobal( L, Table, "KING" );
+    
+    if( Lua->RunScript( "kings/" + std::to_string( KingId ) + ".lua" ) )
+    {
+        // Validate King Table
+        if( Table.isTable() && Table[ "Name" ].isString() && Table[ "PlayerTexture" ].isString() &&
+           Table[ "OpponentTexture" ].isString() && Table[ "Hooks" ].isTable() )
+        {
+            Out.DisplayName = Table[ "Name" ].tostring();
+            Out.PlayerTexture = Table[ "PlayerTexture" ].tostring();
+            Out.OpponentTexture = Table[ "OpponentTexture" ].tostring();
+            Out.Id = KingId;
+            Out.Owner = Owner;
+            Out.Hooks = std::make_shared< luabridge::LuaRef >( Table[ "Hooks" ] );
+            
+            return true;
+        }
+    }
+    
+    return false;
 }
@@ -16,6 +16,7 @@
 #include "Actions.hpp"
 #include "World.hpp"
 #include "AuthState.hpp"
+#include "MatchScheduler.hpp"
 
 
 namespace Game
@@ -28,6 +29,7 @@ namespace Game
     public:
         
         AuthorityBase();
+        AuthorityBase( std::shared_ptr< MatchScheduler > InScheduler );
         ~AuthorityBase();
         
         virtual void Cleanup();
@@ -48,13 +50,24 @@ namespace Game
         
         inline AuthState& GetState() { return State; }
         
+        // Timing for the match, this is the cocos scheduler unless a headless one is set before PostInit
+        void SetScheduler( std::shared_ptr< MatchScheduler > In );
+        inline MatchScheduler& GetScheduler() { return *Scheduler; }
+        
+        // Hands a queue to the game mode. When headless, theres no game mode to play it, so
+        // the queue callback is dispatched right away to keep the match moving
+        virtual void RunQueue( ActionQueue&& In );
+        
     protected:
         
         AuthState State;
+        std::shared_ptr< MatchScheduler > Scheduler;
         
         template< typename T >
         T* GetGameMode();
         
+        // Runs the king script, and fills out the state with its display info and hooks
+        static bool LoadKing( uint16_t KingId, uint32_t Owner, KingState& Out );
         
     };
     
@@ -0,0 +1,709 @@
+//
+//	BatchSimulator.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "BatchSimulator.hpp"
+#include "CardEntity.hpp"
+#include <algorithm>
+#include <set>
+#include <cstring>
+#include <cmath>
+#include <memory>
+
+using namespace Game;
+
+
+BatchSimulator::BatchSimulator()
+{
+    CardCount       = 0;
+    pState          = PlayerTurn::None;
+    StartingPlayer  = PlayerTurn::None;
+    tState          = TurnState::None;
+    TurnNumber      = 0;
+    FinalTurn       = 0;
+    SimulationStart = 0;
+    RunningLanes    = 0;
+}
+
+
+bool BatchSimulator::IsHookFree( GameStateBase& Source )
+{
+    // Hooks are called on every card in the game, no matter what zone its in
+    // so if any card has hooks, we cant run this state as a batch
+    auto& CM = CardManager::GetInstance();
+    std::set< uint16_t > Checked;
+    
+    auto CheckCards = [ & ]( std::vector< CardState >& Cards ) -> bool
+    {
+        for( auto It = Cards.begin(); It != Cards.end(); It++ )
+        {
+            if( !Checked.insert( It->Id ).second )
+                continue;
+            
+            // Every card script declares a hook table, only ones with something in them matter
+            auto Info = CM.GetInfoAddress( It->Id );
+            if( !Info || ( Info->Hooks && Info->Hooks->isTable() && !luabridge::Iterator( *Info->Hooks ).isNil() ) )
+                return false;
+        }
+        
+        return true;
+    };
+    
+    auto Player     = Source.GetPlayer();
+    auto Opponent   = Source.GetOpponent();
+    
+    return( CheckCards( Player->Deck ) && CheckCards( Player->Hand ) && CheckCards( Player->Field ) && CheckCards( Player->Graveyard ) &&
+            CheckCards( Opponent->Deck ) && CheckCards( Opponent->Hand ) && CheckCards( Opponent->Field ) && CheckCards( Opponent->Graveyard ) );
+}
+
+
+bool BatchSimulator::Load( SimulatedState& Source )
+{
+    // We can only pick up from the points the AI makes decisions at during the main game
+    if( Source.mState != MatchState::Main || Source.StartingPlayer == PlayerTurn::None ||
+       ( Source.tState != TurnState::Marshal && Source.tState != TurnState::Attack && Source.tState != TurnState::Block ) )
+    {
+        return false;
+    }
+    
+    // Build a list of every card in the game, sorted by entity id. This way, walking the cards
+    // in order gives the same attacker order as the battle matrix in the scalar simulator
+    struct CardSource
+    {
+        CardState* Card;
+        uint8_t Side;
+        uint8_t Zone;
+    };
+    
+    std::vector< CardSource > Cards;
+    auto Gather = [ & ]( std::vector< CardState >& In, uint8_t Side, uint8_t Zone )
+    {
+        for( auto It = In.begin(); It != In.end(); It++ )
+            Cards.push_back( { std::addressof( *It ), Side, Zone } );
+    };
+    
+    PlayerState* Players[ 2 ] = { Source.GetPlayer(), Source.GetOpponent() };
+    for( uint8_t i = 0; i < 2; i++ )
+    {
+        Gather( Players[ i ]->Deck, i, ZONE_DECK );
+        Gather( Players[ i ]->Hand, i, ZONE_HAND );
+        Gather( Players[ i ]->Field, i, ZONE_FIELD );
+        Gather( Players[ i ]->Graveyard, i, ZONE_GRAVEYARD );
+    }
+    
+    if( Cards.size() > SIM_BATCH_MAX_CARDS )
+        return false;
+    
+    std::sort( Cards.begin(), Cards.end(), []( const CardSource& A, const CardSource& B ) { return A.Card->EntId < B.Card->EntId; } );
+    
+    CardCount = (int) Cards.size();
+    
+    for( int i = 0; i < 2; i++ )
+    {
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            DeckCount[ i ][ Lane ]  = 0;
+            Health[ i ][ Lane ]     = (int16_t) Players[ i ]->Health;
+            Mana[ i ][ Lane ]       = (int16_t) Players[ i ]->Mana;
+        }
+    }
+    
+    int LocalHandSize = 0;
+    for( int c = 0; c < CardCount; c++ )
+    {
+        auto Card   = Cards[ c ].Card;
+        EntIds[ c ]     = Card->EntId;
+        Owner[ c ]      = Cards[ c ].Side;
+        ManaCost[ c ]   = (int16_t) Card->ManaCost;
+        
+        // The local players hand is hidden from the AI, so like PrepareSimulation, we put those
+        // cards back into the deck, and redraw a random hand after shuffling
+        uint8_t StartZone = Cards[ c ].Zone;
+        if( StartZone == ZONE_HAND && Cards[ c ].Side == 0 )
+        {
+            StartZone = ZONE_DECK;
+            LocalHandSize++;
+        }
+        
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            Power[ c ][ Lane ]          = (int16_t) Card->Power;
+            Stamina[ c ][ Lane ]        = (int16_t) Card->Stamina;
+            Zone[ c ][ Lane ]           = StartZone;
+            Attacking[ c ][ Lane ]      = 0;
+            BlockerCount[ c ][ Lane ]   = 0;
+            
+            if( StartZone == ZONE_DECK )
+            {
+                auto Side = Cards[ c ].Side;
+                Deck[ Side ][ Lane ][ DeckCount[ Side ][ Lane ]++ ] = (uint8_t) c;
+            }
+        }
+    }
+    
+    // Copy in the battle matrix
+    for( auto It = Source.BattleMatrix.begin(); It != Source.BattleMatrix.end(); It++ )
+    {
+        auto Find = [ & ]( uint32_t Id ) -> int
+        {
+            auto Result = std::lower_bound( EntIds, EntIds + CardCount, Id );
+            return( Result != EntIds + CardCount && *Result == Id ) ? (int)( Result - EntIds ) : -1;
+        };
+        
+        int Attacker = Find( It->first );
+        if( Attacker < 0 || It->second.size() > SIM_BATCH_MAX_BLOCKERS )
+            return false;
+        
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+            Attacking[ Attacker ][ Lane ] = 1;
+        
+        for( auto j = It->second.begin(); j != It->second.end(); j++ )
+        {
+            int Blocker = Find( *j );
+            if( Blocker < 0 )
+                return false;
+            
+            for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+                Blockers[ Attacker ][ BlockerCount[ Attacker ][ Lane ]++ ][ Lane ] = (uint8_t) Blocker;
+        }
+    }
+    
+    // Each lane gets its own shuffle and its own random hand for the local player
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        Shuffle( 0, Lane );
+        Shuffle( 1, Lane );
+        
+        for( int i = 0; i < LocalHandSize && DeckCount[ 0 ][ Lane ] > 0; i++ )
+        {
+            auto Card = Deck[ 0 ][ Lane ][ --DeckCount[ 0 ][ Lane ] ];
+            Zone[ Card ][ Lane ] = ZONE_HAND;
+        }
+        
+        bRunning[ Lane ]        = 1;
+        Winner[ Lane ]          = PlayerTurn::None;
+        FinishedTurn[ Lane ]    = Source.TurnNumber;
+    }
+    
+    pState          = Source.pState;
+    StartingPlayer  = Source.StartingPlayer;
+    tState          = Source.tState;
+    TurnNumber      = Source.TurnNumber;
+    RunningLanes    = SIM_BATCH_LANES;
+    
+    return true;
+}
+
+
+void BatchSimulator::Shuffle( int Side, int Lane )
+{
+    auto Cards = Deck[ Side ][ Lane ];
+    for( int i = (int) DeckCount[ Side ][ Lane ] - 1; i > 0; i-- )
+    {
+        int j = Rng[ Lane ].Range( 0, i );
+        std::swap( Cards[ i ], Cards[ j ] );
+    }
+}
+
+
+void BatchSimulator::Run( int MaxTurns )
+{
+    FinalTurn       = TurnNumber + MaxTurns;
+    SimulationStart = TurnNumber;
+    
+    if( MaxTurns <= 0 )
+    {
+        FinishLanes( bRunning, PlayerTurn::None );
+        return;
+    }
+    
+    // Pick up from the phase after the decision that was made, then keep stepping through
+    // turns until every lane has finished. Unlike SimulatedState, the phases dont call into
+    // each other, so all lanes move through the turn together
+    TurnState Phase = TurnState::Damage;
+    if( tState == TurnState::Marshal )
+        Phase = TurnState::Attack;
+    else if( tState == TurnState::Attack )
+        Phase = TurnState::Block;
+    
+    while( RunningLanes > 0 )
+    {
+        switch( Phase )
+        {
+            case TurnState::PreTurn:
+                PreTurn( pState );
+                Phase = TurnState::Marshal;
+                break;
+            case TurnState::Marshal:
+                Marshal();
+                Phase = TurnState::Attack;
+                break;
+            case TurnState::Attack:
+                Attack();
+                Phase = TurnState::Block;
+                break;
+            case TurnState::Block:
+                Block();
+                Phase = TurnState::Damage;
+                break;
+            default:
+                Damage();
+                PostTurn();
+                Phase = TurnState::PreTurn;
+                break;
+        }
+    }
+}
+
+
+void BatchSimulator::FinishLanes( const uint8_t* Mask, PlayerTurn InWinner )
+{
+    // Lanes that already finished keep their results
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        uint8_t bFinish = Mask[ Lane ] & bRunning[ Lane ];
+        
+        Winner[ Lane ]          = bFinish ? InWinner : Winner[ Lane ];
+        FinishedTurn[ Lane ]    = bFinish ? TurnNumber : FinishedTurn[ Lane ];
+        bRunning[ Lane ]        ^= bFinish;
+        RunningLanes            -= bFinish;
+    }
+}
+
+
+void BatchSimulator::PreTurn( PlayerTurn InState )
+{
+    pState = InState;
+    tState = TurnState::PreTurn;
+    
+    // The turn number is shared, so every lane runs out of turns at the same time
+    if( StartingPlayer == pState )
+    {
+        if( TurnNumber >= FinalTurn )
+        {
+            FinishLanes( bRunning, PlayerTurn::None );
+            return;
+        }
+        
+        TurnNumber++;
+    }
+    
+    int Side = GetActiveSide();
+    PlayerTurn OtherPlayer = Side == 0 ? PlayerTurn::Opponent : PlayerTurn::LocalPlayer;
+    
+    // Lanes that dont draw read card zero and write its zone back unchanged, so no lane branches
+    uint8_t Empty[ SIM_BATCH_LANES ];
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        uint8_t Count   = DeckCount[ Side ][ Lane ];
+        uint8_t bDraw   = bRunning[ Lane ] & (uint8_t)( Count > 0 );
+        Empty[ Lane ]   = bRunning[ Lane ] & (uint8_t)( Count == 0 );
+        
+        uint8_t Card = Deck[ Side ][ Lane ][ ( Count - 1 ) * bDraw ] * bDraw;
+        Zone[ Card ][ Lane ] = bDraw ? (uint8_t) ZONE_HAND : Zone[ Card ][ Lane ];
+        
+        DeckCount[ Side ][ Lane ] = Count - bDraw;
+        
+        // Give 2 Mana
+        Mana[ Side ][ Lane ] += 2 * bDraw;
+    }
+    
+    // Win by empty deck
+    FinishLanes( Empty, OtherPlayer );
+}
+
+
+void BatchSimulator::Marshal()
+{
+    tState = TurnState::Marshal;
+    int Side = GetActiveSide();
+    
+    // Gather every lanes hand at once, each card is written to the end of the list and the size
+    // only moves forward when the card is in that lanes hand
+    uint8_t HandCopy[ SIM_BATCH_LANES ][ SIM_BATCH_MAX_CARDS ];
+    uint8_t HandSize[ SIM_BATCH_LANES ] = { 0 };
+    uint8_t bCanPlay[ SIM_BATCH_LANES ] = { 0 };
+    uint8_t Targets[ SIM_BATCH_MAX_CARDS ];
+    
+    for( int c = 0; c < CardCount; c++ )
+    {
+        uint8_t bOwned = Owner[ c ] == Side;
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            uint8_t bInHand = bOwned & bRunning[ Lane ] & (uint8_t)( Zone[ c ][ Lane ] == ZONE_HAND );
+            HandCopy[ Lane ][ HandSize[ Lane ] ] = (uint8_t) c;
+            HandSize[ Lane ] += bInHand;
+            bCanPlay[ Lane ] |= bInHand & (uint8_t)( ManaCost[ c ] <= Mana[ Side ][ Lane ] );
+        }
+    }
+    
+    // The choices come from each lanes own generator, so this part runs lane by lane
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        if( !bCanPlay[ Lane ] )
+            continue;
+        
+        // Same rules as SimulatedState::Marshal, pick random cards until we run out of mana
+        // then play a random number of them
+        auto Hand = HandCopy[ Lane ];
+        int Size = HandSize[ Lane ];
+        int TotalMana = Mana[ Side ][ Lane ];
+        int TargetCount = 0;
+        int UsedMana = 0;
+        
+        for( int i = 0; i < Size; i++ )
+        {
+            int Index = Size > 1 ? Rng[ Lane ].Range( 0, Size - 1 ) : 0;
+            auto Card = Hand[ Index ];
+            
+            if( UsedMana + ManaCost[ Card ] <= TotalMana )
+            {
+                Targets[ TargetCount++ ] = Card;
+                UsedMana += ManaCost[ Card ];
+                Hand[ Index ] = Hand[ --Size ];
+            }
+        }
+        
+        if( TargetCount > 0 )
+        {
+            int Count = Rng[ Lane ].Range( 0, TargetCount );
+            if( TargetCount > 2 && Count < 1 )
+                Count = 1;
+            
+            for( int i = 0; i < Count; i++ )
+            {
+                Zone[ Targets[ i ] ][ Lane ] = ZONE_FIELD;
+                Mana[ Side ][ Lane ] -= ManaCost[ Targets[ i ] ];
+            }
+        }
+    }
+}
+
+
+void BatchSimulator::Attack()
+{
+    tState = TurnState::Attack;
+    
+    int Side = GetActiveSide();
+    int Other = GetInactiveSide();
+    
+    // Sum up field counts and power for both players, and gather the active players field, across all lanes at once
+    int16_t FieldCount[ SIM_BATCH_LANES ] = { 0 };
+    int16_t FieldPower[ SIM_BATCH_LANES ] = { 0 };
+    int16_t OtherCount[ SIM_BATCH_LANES ] = { 0 };
+    int16_t OtherPower[ SIM_BATCH_LANES ] = { 0 };
+    uint8_t Field[ SIM_BATCH_LANES ][ SIM_BATCH_MAX_CARDS ];
+    
+    for( int c = 0; c < CardCount; c++ )
+    {
+        int16_t bActive = Owner[ c ] == Side;
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            int16_t bOnField    = Zone[ c ][ Lane ] == ZONE_FIELD;
+            int16_t bMine       = bOnField & bActive;
+            int16_t bTheirs     = bOnField & ( bActive ^ 1 );
+            
+            Field[ Lane ][ FieldCount[ Lane ] ] = (uint8_t) c;
+            FieldCount[ Lane ] += bMine;
+            FieldPower[ Lane ] += bMine * Power[ c ][ Lane ];
+            OtherCount[ Lane ] += bTheirs;
+            OtherPower[ Lane ] += bTheirs * Power[ c ][ Lane ];
+            
+            // Clear out the battle matrix from last turn
+            Attacking[ c ][ Lane ]      = 0;
+            BlockerCount[ c ][ Lane ]   = 0;
+        }
+    }
+    
+    // The choices come from each lanes own generator, so this part runs lane by lane
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        if( !bRunning[ Lane ] )
+            continue;
+        
+        int Count = FieldCount[ Lane ];
+        int AttackCount = 0;
+        
+        // Same rules as SimulatedState::Attack
+        if( OtherCount[ Lane ] == 0 )
+            AttackCount = Count;
+        else if( FieldPower[ Lane ] > OtherPower[ Lane ] + Health[ Other ][ Lane ] )
+            AttackCount = Count;
+        else if( FieldPower[ Lane ] > OtherPower[ Lane ] )
+            AttackCount = Rng[ Lane ].Range( Count / 2, Count );
+        else
+            AttackCount = Count > 0 ? Rng[ Lane ].Range( 0, Count ) : 0;
+        
+        // Pick random attackers
+        auto Cards = Field[ Lane ];
+        int Size = Count;
+        for( int i = 0; i < AttackCount && Size > 0; i++ )
+        {
+            int Index = Size > 1 ? Rng[ Lane ].Range( 0, Size - 1 ) : 0;
+            Attacking[ Cards[ Index ] ][ Lane ] = 1;
+            Cards[ Index ] = Cards[ --Size ];
+        }
+    }
+}
+
+
+void BatchSimulator::Block()
+{
+    tState = TurnState::Block;
+    int Side = GetInactiveSide();
+    
+    // Gather every lanes blockers at once, same as the hand in Marshal
+    uint8_t Available[ SIM_BATCH_LANES ][ SIM_BATCH_MAX_CARDS ];
+    uint8_t Size[ SIM_BATCH_LANES ] = { 0 };
+    
+    for( int c = 0; c < CardCount; c++ )
+    {
+        uint8_t bOwned = Owner[ c ] == Side;
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            Available[ Lane ][ Size[ Lane ] ] = (uint8_t) c;
+            Size[ Lane ] += bOwned & bRunning[ Lane ] & (uint8_t)( Zone[ c ][ Lane ] == ZONE_FIELD );
+        }
+    }
+    
+    // The choices come from each lanes own generator, so this part runs lane by lane
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+    {
+        auto Cards = Available[ Lane ];
+        int Count = Size[ Lane ];
+        
+        // Pick a random blocker for each attacker
+        for( int c = 0; c < CardCount && Count > 0; c++ )
+        {
+            if( !Attacking[ c ][ Lane ] || BlockerCount[ c ][ Lane ] >= SIM_BATCH_MAX_BLOCKERS )
+                continue;
+            
+            int Index = Count > 1 ? Rng[ Lane ].Range( 0, Count - 1 ) : 0;
+            Blockers[ c ][ BlockerCount[ c ][ Lane ]++ ][ Lane ] = Cards[ Index ];
+            Cards[ Index ] = Cards[ --Count ];
+        }
+    }
+}
+
+
+void BatchSimulator::Damage()
+{
+    tState = TurnState::Damage;
+    
+    int AttackingSide = GetActiveSide();
+    int BlockingSide = GetInactiveSide();
+    
+    // Attackers are walked in entity id order, same as the battle matrix in the scalar version, and like the
+    // scalar version, the battle matrix is trusted to only hold cards that were on the field when it was built
+    // Theres no randomness in here, so every lane runs each step of the fight together. Instead of skipping
+    // lanes, each step is masked, a lane thats not fighting at that step applies zero damage to card zero
+    int16_t Remaining[ SIM_BATCH_LANES ];
+    int16_t bFighting[ SIM_BATCH_LANES ];
+    int16_t bAttackerDead[ SIM_BATCH_LANES ];
+    
+    for( int c = 0; c < CardCount; c++ )
+    {
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            int16_t bAttacking  = bRunning[ Lane ] & Attacking[ c ][ Lane ];
+            int16_t bBlocked    = BlockerCount[ c ][ Lane ] > 0;
+            
+            // Damage Player
+            Health[ BlockingSide ][ Lane ] -= bAttacking * ( bBlocked ^ 1 ) * Power[ c ][ Lane ];
+            
+            Remaining[ Lane ]       = Power[ c ][ Lane ];
+            bFighting[ Lane ]       = bAttacking & bBlocked;
+            bAttackerDead[ Lane ]   = 0;
+        }
+        
+        // Damage Cards, one blocker at a time
+        for( int i = 0; i < SIM_BATCH_MAX_BLOCKERS; i++ )
+        {
+            for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+            {
+                int16_t bStep = bFighting[ Lane ] & (int16_t)( i < BlockerCount[ c ][ Lane ] );
+                int b = Blockers[ c ][ i ][ Lane ] * bStep;
+                
+                int16_t ThisDamage = bStep * std::min( Remaining[ Lane ], Power[ b ][ Lane ] );
+                Power[ b ][ Lane ]      -= ThisDamage;
+                Power[ c ][ Lane ]      -= ThisDamage;
+                Stamina[ b ][ Lane ]    -= bStep;
+                
+                int16_t bBlockerDead = bStep & (int16_t)( ( Power[ b ][ Lane ] <= 0 ) | ( Stamina[ b ][ Lane ] <= 0 ) );
+                Zone[ b ][ Lane ] = bBlockerDead ? (uint8_t) ZONE_GRAVEYARD : Zone[ b ][ Lane ];
+                
+                int16_t bKilled = bStep & (int16_t)( ( Power[ c ][ Lane ] <= 0 ) | ( Stamina[ c ][ Lane ] <= 0 ) );
+                Zone[ c ][ Lane ] = bKilled ? (uint8_t) ZONE_GRAVEYARD : Zone[ c ][ Lane ];
+                bAttackerDead[ Lane ] |= bKilled;
+                
+                Remaining[ Lane ] -= ThisDamage;
+                bFighting[ Lane ] = bStep & ( bKilled ^ 1 ) & (int16_t)( Remaining[ Lane ] > 0 );
+            }
+        }
+        
+        // Attackers that survived lose a point of stamina
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            int16_t bTired = bRunning[ Lane ] & Attacking[ c ][ Lane ] & ( bAttackerDead[ Lane ] ^ 1 );
+            Stamina[ c ][ Lane ] -= bTired;
+            Zone[ c ][ Lane ] = ( bTired & (int16_t)( Stamina[ c ][ Lane ] <= 0 ) ) ? (uint8_t) ZONE_GRAVEYARD : Zone[ c ][ Lane ];
+        }
+    }
+    
+    uint8_t Dead[ SIM_BATCH_LANES ];
+    for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        Dead[ Lane ] = Health[ BlockingSide ][ Lane ] <= 0;
+    
+    FinishLanes( Dead, AttackingSide == 0 ? PlayerTurn::LocalPlayer : PlayerTurn::Opponent );
+}
+
+
+void BatchSimulator::PostTurn()
+{
+    tState = TurnState::PostTurn;
+    
+    memset( Attacking, 0, sizeof( Attacking ) );
+    memset( BlockerCount, 0, sizeof( BlockerCount ) );
+    
+    pState = pState == PlayerTurn::LocalPlayer ? PlayerTurn::Opponent : PlayerTurn::LocalPlayer;
+}
+
+
+void BatchSimulator::GetSummary( int Lane, SimulationSummary& Out ) const
+{
+    CC_ASSERT( Lane >= 0 && Lane < SIM_BATCH_LANES );
+    
+    Out.SimulatedTurns  = FinishedTurn[ Lane ] - SimulationStart;
+    Out.Winner          = Winner[ Lane ];
+    
+    Out.LocalDeck       = DeckCount[ 0 ][ Lane ];
+    Out.LocalHealth     = Health[ 0 ][ Lane ];
+    Out.LocalMana       = Mana[ 0 ][ Lane ];
+    Out.LocalField      = 0;
+    Out.LocalPower      = 0;
+    
+    Out.OpponentDeck    = DeckCount[ 1 ][ Lane ];
+    Out.OpponentHealth  = Health[ 1 ][ Lane ];
+    Out.OpponentMana    = Mana[ 1 ][ Lane ];
+    Out.OpponentField   = 0;
+    Out.OpponentPower   = 0;
+    
+    for( int c = 0; c < CardCount; c++ )
+    {
+        int bOnField    = Zone[ c ][ Lane ] == ZONE_FIELD;
+        int bLocal      = bOnField & (int)( Owner[ c ] == 0 );
+        int bOpponent   = bOnField ^ bLocal;
+        
+        Out.LocalField      += bLocal;
+        Out.LocalPower      += bLocal * Power[ c ][ Lane ];
+        Out.OpponentField   += bOpponent;
+        Out.OpponentPower   += bOpponent * Power[ c ][ Lane ];
+    }
+}
+
+
+bool BatchSimulator::SelfTest( SimulatedState& Source, int Turns, int Runs )
+{
+    // Both simulators make their random choices in a different order, so single games cant be compared
+    // Instead, the averages over a lot of games have to agree, within a few standard errors
+    const int StatCount = 7;
+    const char* StatNames[ StatCount ] = { "LocalWins", "OpponentWins", "Turns", "LocalHealth", "OpponentHealth", "LocalField", "OpponentField" };
+    
+    auto GetStats = []( const SimulationSummary& In, double* Out )
+    {
+        Out[ 0 ] = In.Winner == PlayerTurn::LocalPlayer ? 1.0 : 0.0;
+        Out[ 1 ] = In.Winner == PlayerTurn::Opponent ? 1.0 : 0.0;
+        Out[ 2 ] = (double) In.SimulatedTurns;
+        Out[ 3 ] = (double) In.LocalHealth;
+        Out[ 4 ] = (double) In.OpponentHealth;
+        Out[ 5 ] = (double) In.LocalField;
+        Out[ 6 ] = (double) In.OpponentField;
+    };
+    
+    double BatchSum[ StatCount ] = { 0.0 };
+    double BatchSquares[ StatCount ] = { 0.0 };
+    double ScalarSum[ StatCount ] = { 0.0 };
+    double ScalarSquares[ StatCount ] = { 0.0 };
+    double Stats[ StatCount ];
+    int BatchCount = 0;
+    int ScalarCount = 0;
+    
+    // The lane arrays are too big for the stack of the AI thread
+    std::unique_ptr< BatchSimulator > Batch( new BatchSimulator() );
+    std::unique_ptr< SimulatedState > Scalar( new SimulatedState() );
+    
+    while( BatchCount < Runs )
+    {
+        if( !Batch->Load( Source ) )
+        {
+            cocos2d::log( "[Sim] Batch self test skipped, state cant be run as a batch" );
+            return true;
+        }
+        
+        Batch->Run( Turns );
+        
+        SimulationSummary Result;
+        for( int Lane = 0; Lane < SIM_BATCH_LANES; Lane++ )
+        {
+            Batch->GetSummary( Lane, Result );
+            GetStats( Result, Stats );
+            
+            for( int i = 0; i < StatCount; i++ )
+            {
+                BatchSum[ i ] += Stats[ i ];
+                BatchSquares[ i ] += Stats[ i ] * Stats[ i ];
+            }
+            
+            BatchCount++;
+        }
+    }
+    
+    while( ScalarCount < Runs )
+    {
+        Scalar->CopyFrom( Source );
+        Scalar->BattleMatrix = Source.BattleMatrix;
+        Scalar->PrepareSimulation();
+        Scalar->RunSimulation( Turns );
+        
+        SimulationSummary Result;
+        Scalar->Summarize( Result );
+        GetStats( Result, Stats );
+        
+        for( int i = 0; i < StatCount; i++ )
+        {
+            ScalarSum[ i ] += Stats[ i ];
+            ScalarSquares[ i ] += Stats[ i ] * Stats[ i ];
+        }
+        
+        ScalarCount++;
+    }
+    
+    bool bPassed = true;
+    for( int i = 0; i < StatCount; i++ )
+    {
+        double BatchMean    = BatchSum[ i ] / (double) BatchCount;
+        double ScalarMean   = ScalarSum[ i ] / (double) ScalarCount;
+        double BatchVar     = std::max( BatchSquares[ i ] / (double) BatchCount - BatchMean * BatchMean, 0.0 );
+        double ScalarVar    = std::max( ScalarSquares[ i ] / (double) ScalarCount - ScalarMean * ScalarMean, 0.0 );
+        
+        // Four standard errors, plus a little extra so stats that never change dont fail on rounding
+        double Limit = 4.0 * sqrt( BatchVar / (double) BatchCount + ScalarVar / (double) ScalarCount ) + 0.01;
+        
+        if( fabs( BatchMean - ScalarMean ) > Limit )
+        {
+            cocos2d::log( "[Sim] Batch self test failed! %s: Batch %f  Scalar %f  Limit %f", StatNames[ i ], BatchMean, ScalarMean, Limit );
+            bPassed = false;
+        }
+    }
+    
+    if( bPassed )
+        cocos2d::log( "[Sim] Batch self test passed with %d batch and %d scalar rollouts", BatchCount, ScalarCount );
+    
+    return bPassed;
+}
@@ -0,0 +1,118 @@
+//
+//	BatchSimulator.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "SimulatedState.hpp"
+
+
+// Number of games simulated together, and the fixed sizes of the batch arrays
+#define SIM_BATCH_LANES 8
+#define SIM_BATCH_MAX_CARDS 160
+#define SIM_BATCH_MAX_BLOCKERS 8
+
+// Batch self test, when defined, every search that can batch first runs this many rollouts through both the batch
+// and the scalar simulator, and logs any result that doesnt agree between the two
+// The same test runs on fixed boards in Tests/BatchSimulatorTest.cpp
+// #define SIM_BATCH_SELF_TEST 512
+
+namespace Game
+{
+    // Runs a group of independent rollouts from the same starting state in lockstep
+    // Every game is in the same turn and phase at the same time, only the random choices differ, and each
+    // game draws them from its own generator. The rules are the same as SimulatedState, but the state is kept
+    // in fixed arrays instead of card vectors, so a rollout doesnt allocate or search through zones, and the
+    // games share the turn bookkeeping. Lane loops are written without branches, each lane has a 0 or 1 mask for
+    // whether a step applies to it, and masked off lanes apply zero to card zero instead of being skipped. Only
+    // the random choices run lane by lane, since every lane draws from its own generator
+    // This only works for games without Lua hooks, since hooks can do
+    // anything to the state, so the AI falls back to SimulatedState when any card has them
+    class BatchSimulator
+    {
+    public:
+    
+        BatchSimulator();
+        
+        static bool IsHookFree( GameStateBase& Source );
+        
+        // Runs the same number of rollouts from the source state through both simulators, and checks the
+        // results agree within what the random choices can explain
+        static bool SelfTest( SimulatedState& Source, int Turns, int Runs );
+        
+        bool Load( SimulatedState& Source );
+        void Run( int MaxTurns );
+        void GetSummary( int Lane, SimulationSummary& Out ) const;
+        
+        inline int GetLaneCount() const { return SIM_BATCH_LANES; }
+    
+    protected:
+    
+        void PreTurn( PlayerTurn InState );
+        void Marshal();
+        void Attack();
+        void Block();
+        void Damage();
+        void PostTurn();
+        
+        void FinishLanes( const uint8_t* Mask, PlayerTurn Winner );
+        void Shuffle( int Side, int Lane );
+        
+        inline int GetActiveSide() const { return pState == PlayerTurn::LocalPlayer ? 0 : 1; }
+        inline int GetInactiveSide() const { return pState == PlayerTurn::LocalPlayer ? 1 : 0; }
+        
+        enum CardZone : uint8_t
+        {
+            ZONE_DECK,
+            ZONE_HAND,
+            ZONE_FIELD,
+            ZONE_GRAVEYARD
+        };
+        
+        // Shared between lanes
+        int CardCount;
+        uint32_t EntIds[ SIM_BATCH_MAX_CARDS ];
+        uint8_t Owner[ SIM_BATCH_MAX_CARDS ];
+        int16_t ManaCost[ SIM_BATCH_MAX_CARDS ];
+        
+        PlayerTurn pState;
+        PlayerTurn StartingPlayer;
+        TurnState tState;
+        int TurnNumber;
+        int FinalTurn;
+        int SimulationStart;
+        int RunningLanes;
+        
+        // Card state per lane
+        int16_t Power[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_LANES ];
+        int16_t Stamina[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_LANES ];
+        uint8_t Zone[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_LANES ];
+        
+        // Battle matrix per lane, blockers are stored in the order they were assigned
+        uint8_t Attacking[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_LANES ];
+        uint8_t BlockerCount[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_LANES ];
+        uint8_t Blockers[ SIM_BATCH_MAX_CARDS ][ SIM_BATCH_MAX_BLOCKERS ][ SIM_BATCH_LANES ];
+        
+        // Player state per lane, 0 = Local Player, 1 = Opponent
+        // Decks are stored with the top card at the back
+        uint8_t Deck[ 2 ][ SIM_BATCH_LANES ][ SIM_BATCH_MAX_CARDS ];
+        uint8_t DeckCount[ 2 ][ SIM_BATCH_LANES ];
+        int16_t Health[ 2 ][ SIM_BATCH_LANES ];
+        int16_t Mana[ 2 ][ SIM_BATCH_LANES ];
+        
+        // Results per lane
+        uint8_t bRunning[ SIM_BATCH_LANES ];
+        PlayerTurn Winner[ SIM_BATCH_LANES ];
+        int FinishedTurn[ SIM_BATCH_LANES ];
+        
+        // One generator per game, so the lanes dont share a sequence, and the rollout never touches the
+        // global generator the main thread uses
+        Math::Random Rng[ SIM_BATCH_LANES ];
+    };
+}
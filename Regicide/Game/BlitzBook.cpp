@@ -0,0 +1,249 @@
+//
+//	BlitzBook.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "BlitzBook.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+BlitzBook& BlitzBook::GetInstance()
+{
+    static BlitzBook Instance;
+    return Instance;
+}
+
+
+BlitzBook::BlitzBook()
+{
+}
+
+
+uint64_t BlitzBook::HashHand( const std::vector< CardState >& Hand, int Mana, bool bGoingFirst )
+{
+    std::vector< uint16_t > Ids;
+    Ids.reserve( Hand.size() );
+    
+    for( auto It = Hand.begin(); It != Hand.end(); It++ )
+        Ids.push_back( It->Id );
+    
+    std::sort( Ids.begin(), Ids.end() );
+    
+    // FNV-1a over the sorted ids, followed by the mana and turn order
+    uint64_t Hash = 14695981039346656037ULL;
+    auto Mix = [ &Hash ]( uint32_t Value, int Bytes )
+    {
+        for( int i = 0; i < Bytes; i++ )
+        {
+            Hash ^= ( Value >> ( i * 8 ) ) & 0xFF;
+            Hash *= 1099511628211ULL;
+        }
+    };
+    
+    Mix( (uint32_t) Ids.size(), 1 );
+    for( auto It = Ids.begin(); It != Ids.end(); It++ )
+        Mix( *It, 2 );
+    
+    Mix( (uint32_t) Mana, 4 );
+    Mix( bGoingFirst ? 1 : 0, 1 );
+    
+    return Hash;
+}
+
+
+std::vector< BlitzBook::Entry >::iterator BlitzBook::Find( uint64_t Key )
+{
+    auto It = std::lower_bound( Entries.begin(), Entries.end(), Key,
+                               []( const Entry& A, uint64_t B ) { return A.Key < B; } );
+    
+    if( It != Entries.end() && It->Key == Key )
+        return It;
+    
+    return Entries.end();
+}
+
+
+bool BlitzBook::Load( const std::string& FileName )
+{
+    auto file = cocos2d::FileUtils::getInstance();
+    if( !file || !file->isFileExist( FileName ) )
+    {
+        cocos2d::log( "[BlitzBook] No blitz book found, all blitz decisions will be searched" );
+        return false;
+    }
+    
+    auto data = file->getDataFromFile( FileName );
+    if( data.isNull() )
+    {
+        cocos2d::log( "[BlitzBook] Failed to read blitz book!" );
+        return false;
+    }
+    
+    const uint8_t* Bytes = data.getBytes();
+    size_t Size = (size_t) data.getSize();
+    size_t Pos = 0;
+    
+    auto Read = [ & ]( int Count, uint64_t& Out ) -> bool
+    {
+        if( Pos + Count > Size )
+            return false;
+        
+        Out = 0;
+        for( int i = 0; i < Count; i++ )
+            Out |= (uint64_t) Bytes[ Pos + i ] << ( i * 8 );
+        
+        Pos += Count;
+        return true;
+    };
+    
+    uint64_t Magic, Version, Reserved, EntryCount;
+    if( !Read( 4, Magic ) || !Read( 2, Version ) || !Read( 2, Reserved ) || !Read( 4, EntryCount ) ||
+        Magic != BLITZ_BOOK_MAGIC || Version != BLITZ_BOOK_VERSION )
+    {
+        cocos2d::log( "[BlitzBook] Blitz book has an invalid header!" );
+        return false;
+    }
+    
+    std::vector< Entry > NewEntries;
+    std::vector< uint16_t > NewPool;
+    NewEntries.reserve( (size_t) EntryCount );
+    
+    for( uint64_t i = 0; i < EntryCount; i++ )
+    {
+        uint64_t Key, Count;
+        if( !Read( 8, Key ) || !Read( 1, Count ) )
+        {
+            cocos2d::log( "[BlitzBook] Blitz book is truncated!" );
+            return false;
+        }
+        
+        Entry NewEntry;
+        NewEntry.Key = Key;
+        NewEntry.Offset = (uint32_t) NewPool.size();
+        NewEntry.Count = (uint8_t) Count;
+        
+        for( uint64_t j = 0; j < Count; j++ )
+        {
+            uint64_t Id;
+            if( !Read( 2, Id ) )
+            {
+                cocos2d::log( "[BlitzBook] Blitz book is truncated!" );
+                return false;
+            }
+            
+            NewPool.push_back( (uint16_t) Id );
+        }
+        
+        NewEntries.push_back( NewEntry );
+    }
+    
+    // The generator writes entries in order, but we dont want a bad file to break lookups
+    std::sort( NewEntries.begin(), NewEntries.end(), []( const Entry& A, const Entry& B ) { return A.Key < B.Key; } );
+    
+    std::lock_guard< std::mutex > Guard( Lock );
+    Entries = std::move( NewEntries );
+    Pool = std::move( NewPool );
+    
+    cocos2d::log( "[BlitzBook] Loaded %d blitz book entries", (int) Entries.size() );
+    return true;
+}
+
+
+bool BlitzBook::Lookup( uint64_t Key, std::vector< uint16_t >& Out )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    
+    Out.clear();
+    auto It = Find( Key );
+    if( It == Entries.end() )
+        return false;
+    
+    Out.assign( Pool.begin() + It->Offset, Pool.begin() + It->Offset + It->Count );
+    return true;
+}
+
+
+size_t BlitzBook::GetSize()
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    return Entries.size();
+}
+
+
+#ifdef AI_GENERATE_BLITZ_BOOK
+bool BlitzBook::Save( const std::string& FullPath )
+{
+    std::vector< uint8_t > Output;
+    auto Write = [ &Output ]( uint64_t Value, int Count )
+    {
+        for( int i = 0; i < Count; i++ )
+            Output.push_back( (uint8_t)( ( Value >> ( i * 8 ) ) & 0xFF ) );
+    };
+    
+    {
+        std::lock_guard< std::mutex > Guard( Lock );
+        
+        Write( BLITZ_BOOK_MAGIC, 4 );
+        Write( BLITZ_BOOK_VERSION, 2 );
+        Write( 0, 2 );
+        Write( Entries.size(), 4 );
+        
+        // Entries that were replaced leave their old ids in the pool, writing them out this way compacts it
+        for( auto It = Entries.begin(); It != Entries.end(); It++ )
+        {
+            Write( It->Key, 8 );
+            Write( It->Count, 1 );
+            
+            for( uint32_t i = 0; i < It->Count; i++ )
+                Write( Pool[ It->Offset + i ], 2 );
+        }
+    }
+    
+    cocos2d::Data FileData;
+    FileData.copy( Output.data(), (ssize_t) Output.size() );
+    
+    if( !cocos2d::FileUtils::getInstance()->writeDataToFile( FileData, FullPath ) )
+    {
+        cocos2d::log( "[BlitzBook] Failed to write blitz book to '%s'", FullPath.c_str() );
+        return false;
+    }
+    
+    return true;
+}
+
+
+void BlitzBook::Record( uint64_t Key, const std::vector< uint16_t >& Cards )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    
+    Entry NewEntry;
+    NewEntry.Key = Key;
+    NewEntry.Offset = (uint32_t) Pool.size();
+    NewEntry.Count = (uint8_t) std::min( Cards.size(), (size_t) 255 );
+    
+    Pool.insert( Pool.end(), Cards.begin(), Cards.begin() + NewEntry.Count );
+    
+    auto It = std::lower_bound( Entries.begin(), Entries.end(), Key,
+                               []( const Entry& A, uint64_t B ) { return A.Key < B; } );
+    
+    if( It != Entries.end() && It->Key == Key )
+        *It = NewEntry;
+    else
+        Entries.insert( It, NewEntry );
+}
+
+
+bool BlitzBook::Contains( uint64_t Key )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    return Find( Key ) != Entries.end();
+}
+#endif
@@ -0,0 +1,71 @@
+//
+//	BlitzBook.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "ObjectStates.hpp"
+#include <mutex>
+
+
+// Book file, written into Resource by the BlitzBook target (Server/BlitzBookMain.cpp), a missing book just means every lookup misses
+#define BLITZ_BOOK_FILE "BlitzBook.bin"
+#define BLITZ_BOOK_MAGIC 0x4B425252 // 'RRBK'
+#define BLITZ_BOOK_VERSION 1
+
+namespace Game
+{
+    // Precomputed blitz choices, keyed by the composition of the hand
+    // Hands are hashed as a sorted multiset of card ids, along with the mana available and who goes first,
+    // so the same hand always finds the same entry no matter what order the cards were drawn in.
+    // The stored choice is a list of card ids, since entity ids are different every match
+    //
+    // The game loads the book once and only reads from it. Recording and saving are only built into the
+    // offline generator, which defines AI_GENERATE_BLITZ_BOOK
+    //
+    // File Format (little endian)
+    //  uint32 Magic, uint16 Version, uint16 Reserved, uint32 EntryCount
+    //  EntryCount x { uint64 Key, uint8 CardCount, uint16 CardIds[ CardCount ] }
+    class BlitzBook
+    {
+    public:
+    
+        static BlitzBook& GetInstance();
+        
+        static uint64_t HashHand( const std::vector< CardState >& Hand, int Mana, bool bGoingFirst );
+        
+        bool Load( const std::string& FileName );
+        bool Lookup( uint64_t Key, std::vector< uint16_t >& Out );
+        size_t GetSize();
+        
+#ifdef AI_GENERATE_BLITZ_BOOK
+        bool Save( const std::string& FullPath );
+        void Record( uint64_t Key, const std::vector< uint16_t >& Cards );
+        bool Contains( uint64_t Key );
+#endif
+    
+    protected:
+    
+        BlitzBook();
+        
+        // Entries are kept sorted by key, and all of the card ids are packed into a single pool
+        struct Entry
+        {
+            uint64_t Key;
+            uint32_t Offset;
+            uint8_t Count;
+        };
+        
+        std::vector< Entry >::iterator Find( uint64_t Key );
+        
+        std::vector< Entry > Entries;
+        std::vector< uint16_t > Pool;
+        std::mutex Lock;
+    };
+}
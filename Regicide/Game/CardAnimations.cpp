@@ -3,183 +3,277 @@
 //    Regicide Mobile
 //
 //    Created: 11/12/18
-//    Updated: 11/20/18
+//    Updated: 12/14/18
 //
 //    © 2018 Zachary Berry, All Rights Reserved
 //
 
 #include "CardAnimations.hpp"
+#include "CardEntity.hpp"
+#include <algorithm>
+#include <cmath>
 
+using namespace Game;
 
-CardFlipX* CardFlipX::Create( float inTime, float inStart, float inEnd, float inDepth )
+
+TweenSystem& TweenSystem::GetInstance()
 {
-    // Create new animation
-    CardFlipX* newAnim = new (std::nothrow) CardFlipX();
-    newAnim->autorelease();
-    
-    // Init and return it
-    return newAnim->Init( inTime, inStart, inEnd, inDepth ) ? newAnim : nullptr;
+    static TweenSystem Singleton;
+    return Singleton;
 }
 
-bool CardFlipX::Init( float inTime, float inStart, float inEnd, float inDepth )
+TweenSystem::TweenSystem()
+: TimeScale( 1.f ), bInstant( false )
 {
-    if( RotateTo::initWithDuration( inTime, inEnd, inEnd ) )
-    {
-        Depth = inDepth;
-        Start = inStart;
-        End = inEnd;
-        
-        Target = nullptr;
-        
-        return true;
-    }
-    
-    return false;
+    // Runs through the same scheduler as the action manager, so tweens still pause along with the director
+    cocos2d::Director::getInstance()->getScheduler()->schedule( std::bind( &TweenSystem::Tick, this, std::placeholders::_1 ),
+                                                                this, 0.f, CC_REPEAT_FOREVER, 0.f, false, "TweenTick" );
 }
 
-void CardFlipX::startWithTarget( cocos2d::Node *inTarget )
+TweenSystem::Track& TweenSystem::Acquire( uint32& Slot, cocos2d::Sprite* Target )
 {
-    RotateTo::startWithTarget( inTarget) ;
-    Radius = inTarget->getContentSize().height / 2.0f;
+    if( Slot < Tracks.size() && Tracks[ Slot ].Target == Target )
+        return Tracks[ Slot ];
+    
+    // The slot might still point at a track for a sprite the owner has since swapped out
+    if( Slot < Tracks.size() )
+        Stop( Slot );
     
-    calculateAngles( Start, Diff, End );
+    Track NewTrack;
+    NewTrack.Target     = Target;
+    NewTrack.Slot       = &Slot;
+    NewTrack.Channels   = 0;
     
-    Target = dynamic_cast< cocos2d::Sprite* >( inTarget );
-    CC_ASSERT( Target );
+    Target->retain();
+    
+    Slot = (uint32) Tracks.size();
+    Tracks.push_back( NewTrack );
+    
+    return Tracks.back();
 }
 
-float CardFlipX::diffCalc( float Delta )
+void TweenSystem::Release( uint32 Index )
 {
-    return( ( Start + Diff * Delta ) * 0.0174532925f );
+    auto& Target = Tracks[ Index ];
+    *Target.Slot = TWEEN_SLOT_NONE;
+    Target.Target->release();
+    
+    // Swap the last track into the hole, and let its owner know where it went
+    if( Index + 1 < Tracks.size() )
+    {
+        Target = Tracks.back();
+        *Target.Slot = Index;
+    }
+    
+    Tracks.pop_back();
 }
 
-void CardFlipX::update( float Time )
+void TweenSystem::Move( uint32& Slot, cocos2d::Sprite* Target, const cocos2d::Vec2& To, float Time )
 {
-    cocos2d::PolygonInfo pi = Target->getPolygonInfo();
+    if( !Target )
+        return;
     
-    float rad = diffCalc( Time );
-    float width = Target->getContentSize().width;
+    auto& Output = Acquire( Slot, Target );
     
-    // Update sprite verts
-    pi.triangles.verts[0].vertices.y = cosf( -rad ) * Radius + Radius;
-    pi.triangles.verts[0].vertices.x = ( sinf( -rad ) * Radius ) / Depth;
+    Output.Channels     |= TWEEN_MOVE;
+    Output.MoveFrom     = Target->getPosition();
+    Output.MoveTo       = To;
+    Output.MoveTime     = Time;
+    Output.MoveElapsed  = 0.f;
+}
+
+void TweenSystem::Rotate( uint32& Slot, cocos2d::Sprite* Target, float To, float Time )
+{
+    if( !Target )
+        return;
     
-    pi.triangles.verts[1].vertices.y = cosf( M_PI - rad ) * Radius + Radius;
-    pi.triangles.verts[1].vertices.x = ( sinf( M_PI - rad ) * Radius ) / Depth;
+    auto& Output = Acquire( Slot, Target );
     
-    pi.triangles.verts[2].vertices.y = cosf( rad ) * Radius + Depth;
-    pi.triangles.verts[2].vertices.x = ( sinf( rad ) * Radius ) / Depth + width;
+    // Same as RotateTo, always take the short way around
+    float From = fmodf( Target->getRotation(), 360.f );
+    float Diff = To - From;
     
-    pi.triangles.verts[3].vertices.y = cosf( M_PI + rad ) * Radius + Radius;
-    pi.triangles.verts[3].vertices.x = ( sinf( M_PI + rad ) * Radius ) / Depth + width;
+    if( Diff > 180.f )
+        Diff -= 360.f;
+    if( Diff < -180.f )
+        Diff += 360.f;
     
-    Target->setPolygonInfo( pi );
+    Output.Channels         |= TWEEN_ROTATE;
+    Output.RotateFrom       = From;
+    Output.RotateDiff       = Diff;
+    Output.RotateTime       = Time;
+    Output.RotateElapsed    = 0.f;
 }
 
-// FakeRotateY
-
-CardFlipY* CardFlipY::Create( float inTime, float inStart, float inEnd, float inDepth )
+void TweenSystem::Flip( uint32& Slot, cocos2d::Sprite* Target, cocos2d::SpriteFrame* Frame, cocos2d::Texture2D* Texture, float Time,
+                       CardEntity* Card /* = nullptr */, TweenEvent OnFinish /* = TweenEvent::None */ )
 {
-    auto Output = new (std::nothrow) CardFlipY();
-    Output->autorelease();
+    if( !Target || ( !Frame && !Texture ) )
+        return;
+    
+    auto& Output = Acquire( Slot, Target );
     
-    return Output->Init( inTime, inStart, inEnd, inDepth ) ? Output : nullptr;
+    Output.Channels     |= TWEEN_FLIP;
+    Output.FlipFrame    = Frame;
+    Output.FlipTexture  = Texture;
+    Output.FlipCard     = Card;
+    Output.FlipEvent    = OnFinish;
+    Output.FlipTime     = Time;
+    Output.FlipElapsed  = 0.f;
+    Output.bFlipSwapped = false;
 }
 
-bool CardFlipY::Init( float inTime, float inStart, float inEnd, float inDepth )
+void TweenSystem::Stop( uint32& Slot )
 {
-    if( RotateTo::initWithDuration( inTime, inEnd, inEnd ) )
+    if( Slot >= Tracks.size() )
     {
-        Depth = inDepth;
-        Start = inStart;
-        End = inEnd;
-        
-        Target = nullptr;
-        
-        return true;
+        Slot = TWEEN_SLOT_NONE;
+        return;
     }
     
-    return false;
+    Release( Slot );
 }
 
-void CardFlipY::startWithTarget( cocos2d::Node* inTarget )
+bool TweenSystem::IsAnimating( uint32 Slot ) const
 {
-    RotateTo::startWithTarget( inTarget );
-    Radius = inTarget->getContentSize().width / 2.0;
-    
-    calculateAngles( Start, Diff, End );
-    
-    Target = dynamic_cast< cocos2d::Sprite* >( inTarget );
-    CC_ASSERT( Target );
+    return Slot < Tracks.size() && Tracks[ Slot ].Channels != 0;
 }
 
-float CardFlipY::diffCalc( float Delta )
+bool TweenSystem::IsMoving( uint32 Slot ) const
 {
-    return( ( Start + Diff * Delta ) * 0.0174532925f );
+    return Slot < Tracks.size() && ( Tracks[ Slot ].Channels & TWEEN_MOVE ) != 0;
 }
 
-void CardFlipY::update( float Time )
+float TweenSystem::Advance( float& Elapsed, float Time, float Delta ) const
 {
-    cocos2d::PolygonInfo pi = Target->getPolygonInfo();
+    Elapsed += Delta * TimeScale;
     
-    float rad = diffCalc( Time );
-    float height = Target->getContentSize().height;
-    
-    // Update verts
-    pi.triangles.verts[0].vertices.x = cosf( M_PI + rad ) * Radius + Radius;
-    pi.triangles.verts[0].vertices.y = ( sinf( M_PI + rad ) * Radius ) / Depth + height;
+    if( bInstant || Time <= 0.f )
+        return 1.f;
     
-    pi.triangles.verts[1].vertices.x = cosf( M_PI - rad ) * Radius + Radius;
-    pi.triangles.verts[1].vertices.y = ( sinf( M_PI - rad ) * Radius ) / Depth;
-    
-    pi.triangles.verts[2].vertices.x = cosf( rad ) * Radius + Radius;
-    pi.triangles.verts[2].vertices.y = ( sinf( rad ) * Radius ) / Depth + height;
-    
-    pi.triangles.verts[3].vertices.x = cosf( -rad ) * Radius + Radius;
-    pi.triangles.verts[3].vertices.y = ( sinf( -rad ) * Radius ) / Depth;
-    
-    Target->setPolygonInfo( pi );
+    return std::min( Elapsed / Time, 1.f );
 }
 
-
-
-CardFlipTex* CardFlipTex::Create( float inTime, cocos2d::Texture2D *newTexture )
+bool TweenSystem::IsFlipping( uint32 Slot ) const
 {
-    auto Output = new (std::nothrow) CardFlipTex();
-    Output->autorelease();
-    
-    return Output->Init( inTime, newTexture ) ? Output : nullptr;
+    return Slot < Tracks.size() && ( Tracks[ Slot ].Channels & TWEEN_FLIP ) != 0;
 }
 
-bool CardFlipTex::Init( float inTime, cocos2d::Texture2D* newTexture )
+void TweenSystem::Tick( float Delta )
 {
-    if( ActionInterval::initWithDuration( inTime ) )
+    size_t i = 0;
+    while( i < Tracks.size() )
     {
-        Time = inTime;
-        Texture = newTexture;
-        bFlipped = false;
-        Target = nullptr;
+        auto& Target = Tracks[ i ];
+        
+        if( Target.Channels & TWEEN_MOVE )
+        {
+            float T = Advance( Target.MoveElapsed, Target.MoveTime, Delta );
+            
+            Target.Target->setPosition( Target.MoveFrom + ( Target.MoveTo - Target.MoveFrom ) * T );
+            if( T >= 1.f )
+                Target.Channels &= ~TWEEN_MOVE;
+        }
         
-        return true;
+        if( Target.Channels & TWEEN_ROTATE )
+        {
+            float T = Advance( Target.RotateElapsed, Target.RotateTime, Delta );
+            
+            Target.Target->setRotation( Target.RotateFrom + Target.RotateDiff * T );
+            if( T >= 1.f )
+                Target.Channels &= ~TWEEN_ROTATE;
+        }
+        
+        if( Target.Channels & TWEEN_FLIP )
+        {
+            float T = Advance( Target.FlipElapsed, Target.FlipTime, Delta );
+            
+            // Turns edge on over the first half, then the other side turns back in from the opposite edge
+            if( T >= 0.5f && !Target.bFlipSwapped )
+            {
+                // The sprite might be coming from an atlas frame, so the rect has to cover the whole texture again
+                if( Target.FlipFrame )
+                {
+                    Target.Target->setSpriteFrame( Target.FlipFrame );
+                }
+                else
+                {
+                    auto Size = Target.FlipTexture->getContentSize();
+                    
+                    Target.Target->setTexture( Target.FlipTexture );
+                    Target.Target->setTextureRect( cocos2d::Rect( 0.f, 0.f, Size.width, Size.height ) );
+                }
+                
+                Target.bFlipSwapped = true;
+            }
+            
+            ApplyFlip( Target.Target, Target.bFlipSwapped ? 180.f * T - 180.f : 180.f * T );
+            
+            if( T >= 1.f )
+            {
+                Target.Channels &= ~TWEEN_FLIP;
+                
+                if( Target.FlipCard && Target.FlipEvent != TweenEvent::None )
+                {
+                    PendingEvent NewEvent;
+                    NewEvent.Card   = Target.FlipCard;
+                    NewEvent.Event  = Target.FlipEvent;
+                    
+                    Events.push_back( NewEvent );
+                }
+            }
+        }
+        
+        // Finished tracks are swapped out, so the one that takes its place still needs to be updated
+        if( Target.Channels == 0 )
+            Release( (uint32) i );
+        else
+            i++;
     }
     
-    return false;
+    // Events run once the pass is done, so they can safely start or stop animations
+    if( Events.empty() )
+        return;
+    
+    for( size_t j = 0; j < Events.size(); j++ )
+        SendEvent( Events[ j ] );
+    
+    Events.clear();
 }
 
-void CardFlipTex::startWithTarget( cocos2d::Node* inTarget )
+void TweenSystem::ApplyFlip( cocos2d::Sprite* Target, float Degrees )
 {
-    ActionInterval::startWithTarget( inTarget );
+    cocos2d::PolygonInfo pi = Target->getPolygonInfo();
+    
+    float rad       = Degrees * 0.0174532925f;
+    float Radius    = Target->getContentSize().width / 2.f;
+    float height    = Target->getContentSize().height;
+    
+    // Update verts
+    pi.triangles.verts[0].vertices.x = cosf( M_PI + rad ) * Radius + Radius;
+    pi.triangles.verts[0].vertices.y = ( sinf( M_PI + rad ) * Radius ) / CARD_FLIP_DEPTH + height;
+    
+    pi.triangles.verts[1].vertices.x = cosf( M_PI - rad ) * Radius + Radius;
+    pi.triangles.verts[1].vertices.y = ( sinf( M_PI - rad ) * Radius ) / CARD_FLIP_DEPTH;
+    
+    pi.triangles.verts[2].vertices.x = cosf( rad ) * Radius + Radius;
+    pi.triangles.verts[2].vertices.y = ( sinf( rad ) * Radius ) / CARD_FLIP_DEPTH + height;
     
-    Target = dynamic_cast< cocos2d::Sprite* >( inTarget );
-    CC_ASSERT( Target );
+    pi.triangles.verts[3].vertices.x = cosf( -rad ) * Radius + Radius;
+    pi.triangles.verts[3].vertices.y = ( sinf( -rad ) * Radius ) / CARD_FLIP_DEPTH;
+    
+    Target->setPolygonInfo( pi );
 }
 
-void CardFlipTex::update( float Time )
+void TweenSystem::SendEvent( const PendingEvent& In )
 {
-    // TODO: Fade between two textures
-    if( !bFlipped )
+    switch( In.Event )
     {
-        Target->setTexture( Texture );
-        bFlipped = true;
+        case TweenEvent::ShowPowerStamina:
+            In.Card->ShowPowerStamina();
+            break;
+        
+        default:
+            break;
     }
 }
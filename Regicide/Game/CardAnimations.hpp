@@ -3,88 +3,133 @@
 //    Regicide Mobile
 //
 //    Created: 11/12/18
-//    Updated: 11/20/18
+//    Updated: 12/14/18
 //
 //    © 2018 Zachary Berry, All Rights Reserved
 //
 
+#pragma once
+
+#include "Numeric.hpp"
 #include "cocos2d.h"
+#include <vector>
 
+// Card Flip
+// How far the far edge of a flipping card is pulled in, higher is a flatter flip
+#define CARD_FLIP_DEPTH 5.f
 
+// Invalid Tween Slot
+// Slot held by anything thats not animating
+#define TWEEN_SLOT_NONE 0xFFFFFFFF
 
-class CardFlipX : public cocos2d::RotateTo
+namespace Game
 {
-    
-public:
-    
-    static CardFlipX* Create( float inTime, float inStart, float inEnd, float inDepth = 5.0f );
-    bool Init( float inTime, float inStart, float inEnd, float inDepth );
-    
-    virtual ~CardFlipX() {}
-    
-protected:
-    
-    virtual void startWithTarget( cocos2d::Node *inTarget );
-    virtual void update( float Time ) ;
-    
-private:
-    
-    cocos2d::Sprite* Target;
-    
-    float Start;
-    float End;
-    float Diff;
-    float Radius;
-    float Depth;
-    
-    float diffCalc( float Delta );
-};
-
-class CardFlipY : public cocos2d::RotateTo
-{
-    
-public:
-    
-    static CardFlipY* Create( float inTime, float inStart, float inEnd, float inDepth = 5.0f );
-    bool Init( float inTime, float inStart, float inEnd, float inDepth );
-    
-    virtual ~CardFlipY() {}
-    
-protected:
-    
-    virtual void startWithTarget( cocos2d::Node* inTarget );
-    virtual void update( float Time );
-    
-private:
-    
-    cocos2d::Sprite* Target;
-    
-    float Start;
-    float End;
-    float Diff;
-    float Radius;
-    float Depth;
-    
-    float diffCalc( float Delta );
-};
-
-class CardFlipTex : public cocos2d::ActionInterval
-{
-    
-public:
-    
-    static CardFlipTex* Create( float inTime, cocos2d::Texture2D* newTexture );
-    bool Init( float inTime, cocos2d::Texture2D* newTexture );
-    
-    virtual ~CardFlipTex() {}
-    
-protected:
-    
-    virtual void startWithTarget( cocos2d::Node* inTarget );
-    virtual void update( float Time );
-    
-    float Time;
-    cocos2d::Texture2D* Texture;
-    cocos2d::Sprite* Target;
-    bool bFlipped;
-};
+    class CardEntity;
+    
+    // Tween Channels
+    // A sprite has one track, and each kind of animation is a channel on it. Starting an animation on a channel
+    // thats already running replaces it, the same way stopping a tagged action and running a new one did
+    enum TweenChannel : uint8_t
+    {
+        TWEEN_MOVE      = 1 << 0,
+        TWEEN_ROTATE    = 1 << 1,
+        TWEEN_FLIP      = 1 << 2
+    };
+    
+    // Run after a track finishes a channel, batched until the whole update pass is done
+    enum class TweenEvent : uint8_t
+    {
+        None,
+        ShowPowerStamina
+    };
+    
+    // Animates card sprites without cocos actions
+    //
+    // Every animating sprite is one entry in a single array, and the whole array is updated in one pass each frame.
+    // Starting an animation reuses the sprites entry if it has one, so nothing is allocated per animation once the
+    // array has grown to fit the board. The owner keeps the index of its entry in a slot, which is kept up to date
+    // when entries are moved around, and passes it back in to start or stop animations
+    class TweenSystem
+    {
+    public:
+    
+        static TweenSystem& GetInstance();
+        
+        void Move( uint32& Slot, cocos2d::Sprite* Target, const cocos2d::Vec2& To, float Time );
+        void Rotate( uint32& Slot, cocos2d::Sprite* Target, float To, float Time );
+        
+        // Turns the sprite over along its vertical axis, swapping to the frame if its set, or the texture if its not
+        // halfway through. The event is sent to the card once the flip is done
+        void Flip( uint32& Slot, cocos2d::Sprite* Target, cocos2d::SpriteFrame* Frame, cocos2d::Texture2D* Texture, float Time,
+                  CardEntity* Card = nullptr, TweenEvent OnFinish = TweenEvent::None );
+        
+        // Stops every channel where it is, without sending events
+        void Stop( uint32& Slot );
+        
+        bool IsAnimating( uint32 Slot ) const;
+        bool IsMoving( uint32 Slot ) const;
+        bool IsFlipping( uint32 Slot ) const;
+        
+        inline size_t GetActiveCount() const { return Tracks.size(); }
+        
+        // Playback speed for every tween, including ones already running. Instant playback jumps each tween
+        // straight to its end on the next update
+        inline void SetTimeScale( float In )    { TimeScale = In > 0.f ? In : 1.f; }
+        inline float GetTimeScale() const       { return TimeScale; }
+        inline void SetInstant( bool In )       { bInstant = In; }
+        inline bool IsInstant() const           { return bInstant; }
+        
+        // Converts a wait for an animation to finish into real time, at the current playback speed
+        inline float ScaleDelay( float In ) const { return bInstant ? 0.f : In / TimeScale; }
+    
+    protected:
+    
+        struct Track
+        {
+            cocos2d::Sprite* Target;
+            uint32* Slot;
+            uint8_t Channels;
+            
+            cocos2d::Vec2 MoveFrom;
+            cocos2d::Vec2 MoveTo;
+            float MoveTime;
+            float MoveElapsed;
+            
+            float RotateFrom;
+            float RotateDiff;
+            float RotateTime;
+            float RotateElapsed;
+            
+            cocos2d::SpriteFrame* FlipFrame;
+            cocos2d::Texture2D* FlipTexture;
+            CardEntity* FlipCard;
+            TweenEvent FlipEvent;
+            float FlipTime;
+            float FlipElapsed;
+            bool bFlipSwapped;
+        };
+        
+        struct PendingEvent
+        {
+            CardEntity* Card;
+            TweenEvent Event;
+        };
+        
+        TweenSystem();
+        TweenSystem( const TweenSystem& Other ) = delete;
+        TweenSystem& operator= ( const TweenSystem& Other ) = delete;
+        
+        Track& Acquire( uint32& Slot, cocos2d::Sprite* Target );
+        void Release( uint32 Index );
+        void Tick( float Delta );
+        float Advance( float& Elapsed, float Time, float Delta ) const;
+        
+        static void ApplyFlip( cocos2d::Sprite* Target, float Degrees );
+        static void SendEvent( const PendingEvent& In );
+        
+        std::vector< Track > Tracks;
+        std::vector< PendingEvent > Events;
+        float TimeScale;
+        bool bInstant;
+    };
+}
@@ -14,21 +14,71 @@
 #include "ICardContainer.hpp"
 #include "World.hpp"
 #include "GameModeBase.hpp"
+#include "MatchContext.hpp"
+#include "CMS/TextureAtlas.hpp"
+#include "TexturePreloader.hpp"
 
 using namespace Game;
 
 
 CardManager& CardManager::GetInstance()
 {
+    // Hooks are bound to the Lua state they were loaded in, so each match context keeps its own cache
+    auto Context = MatchContext::GetCurrent();
+    if( Context )
+        return Context->GetCards();
+    
     static CardManager Singleton;
     return Singleton;
 }
 
 CardManager::~CardManager()
 {
+    ClearPool();
     CachedCards.clear();
 }
 
+void CardManager::SetPoolLimit( size_t inLimit )
+{
+    PoolLimit = inLimit;
+    
+    if( Pool.size() > PoolLimit )
+        Pool.resize( PoolLimit );
+}
+
+void CardManager::ClearPool()
+{
+    Pool.clear();
+}
+
+CardEntity* CardManager::AcquireCard( uint32_t EntId )
+{
+    auto& Entities = IEntityManager::GetInstance();
+    
+    if( Pool.empty() )
+        return EntId == 0 ? Entities.CreateEntity< CardEntity >() : Entities.CreateEntity< CardEntity >( EntId );
+    
+    auto Output = Pool.back();
+    Pool.pop_back();
+    
+    Entities.Adopt( EntId, Output );
+    return Output.get();
+}
+
+bool CardManager::ReleaseCard( std::shared_ptr< EntityBase >& In )
+{
+    if( !In || Pool.size() >= PoolLimit )
+        return false;
+    
+    auto Card = std::static_pointer_cast< CardEntity >( In );
+    In.reset();
+    
+    Card->Recycle();
+    Pool.push_back( Card );
+    
+    return true;
+}
+
 CardInfo* CardManager::GetInfoAddress( uint16_t inId )
 {
     CardInfo Temp;
@@ -157,7 +207,7 @@ CardEntity* CardManager::CreateCard( CardState& State, Player* inOwner, bool bPr
         return nullptr;
     }
     
-    auto Output = IEntityManager::GetInstance().CreateEntity< CardEntity >( State.EntId );
+    auto Output = AcquireCard( State.EntId );
     if( !Output )
     {
         cocos2d::log( "[CardManager] Failed to create new card.. entity couldnt be created" );
@@ -175,22 +225,28 @@ CardEntity* CardManager::CreateCard( CardState& State, Player* inOwner, bool bPr
     Output->Stamina         = State.Stamina;
     Output->Info            = Info;
     Output->OwningPlayer    = inOwner;
-    Output->_bIsCard        = true;
     
     if( bPreloadTextures )
     {
-        Output->RequireTexture( Info->FrontTexture, [ = ]( cocos2d::Texture2D* t )
-                               {
-                                   if( !t )
-                                   {
-                                       cocos2d::log( "[CardManager] Failed to load front texture for card '%s'", Info->DisplayName.c_str() );
-                                       Output->FrontTexture = nullptr;
-                                   }
-                                   else
+        // Art thats in the card atlas is already loaded, so only whats missing from it is loaded on its own
+        Output->FrontFrame  = Regicide::TextureAtlas::GetFrame( Info->FrontTexture );
+        Output->BackFrame   = Regicide::TextureAtlas::GetFrame( inOwner->GetBackTexture() );
+        
+        if( !Output->FrontFrame )
+        {
+            Output->RequireTexture( Info->FrontTexture, [ = ]( cocos2d::Texture2D* t )
                                    {
-                                       Output->FrontTexture = t;
-                                   }
-                               } );
+                                       if( !t )
+                                       {
+                                           cocos2d::log( "[CardManager] Failed to load front texture for card '%s'", Info->DisplayName.c_str() );
+                                           Output->FrontTexture = nullptr;
+                                       }
+                                       else
+                                       {
+                                           Output->FrontTexture = t;
+                                       }
+                                   } );
+        }
         
         Output->RequireTexture( Info->FullTexture, [ = ]( cocos2d::Texture2D* t )
                                {
@@ -205,18 +261,21 @@ CardEntity* CardManager::CreateCard( CardState& State, Player* inOwner, bool bPr
                                    }
                                } );
         
-        Output->RequireTexture( inOwner->GetBackTexture(), [ = ]( cocos2d::Texture2D* t )
-                               {
-                                   if( !t )
-                                   {
-                                       cocos2d::log( "[CardManager] Failed to load back texture for card '%s'", Info->DisplayName.c_str() );
-                                       Output->BackTexture = nullptr;
-                                   }
-                                   else
+        if( !Output->BackFrame )
+        {
+            Output->RequireTexture( inOwner->GetBackTexture(), [ = ]( cocos2d::Texture2D* t )
                                    {
-                                       Output->BackTexture = t;
-                                   }
-                               } );
+                                       if( !t )
+                                       {
+                                           cocos2d::log( "[CardManager] Failed to load back texture for card '%s'", Info->DisplayName.c_str() );
+                                           Output->BackTexture = nullptr;
+                                       }
+                                       else
+                                       {
+                                           Output->BackTexture = t;
+                                       }
+                                   } );
+        }
     }
     
     return Output;
@@ -235,7 +294,7 @@ CardEntity* CardManager::CreateCard( uint16_t inId, Player *inOwner, bool bPrelo
     if( GetInfo( inId, thisInfo ) )
     {
         
-        auto Output = IEntityManager::GetInstance().CreateEntity< CardEntity >();
+        auto Output = AcquireCard( 0 );
         if( !Output )
         {
             cocos2d::log( "[CardManager] Failed to create new card.. entity couldnt be allocated" );
@@ -259,21 +318,27 @@ CardEntity* CardManager::CreateCard( uint16_t inId, Player *inOwner, bool bPrelo
         
         Output->OwningPlayer = inOwner;
         
-        // Setup preload textures
+        // Setup preload textures, art thats in the card atlas is already loaded
         if( bPreloadTextures )
         {
-            Output->RequireTexture( thisInfo.FrontTexture, [ = ]( cocos2d::Texture2D* t )
-                                   {
-                                       if( !t )
-                                       {
-                                           cocos2d::log( "[CardManager] Failed to load front texture for card '%s'", thisInfo.DisplayName.c_str() );
-                                           Output->FrontTexture = nullptr;
-                                       }
-                                       else
+            Output->FrontFrame  = Regicide::TextureAtlas::GetFrame( thisInfo.FrontTexture );
+            Output->BackFrame   = Regicide::TextureAtlas::GetFrame( inOwner->GetBackTexture() );
+            
+            if( !Output->FrontFrame )
+            {
+                Output->RequireTexture( thisInfo.FrontTexture, [ = ]( cocos2d::Texture2D* t )
                                        {
-                                           Output->FrontTexture = t;
-                                       }
-                                   } );
+                                           if( !t )
+                                           {
+                                               cocos2d::log( "[CardManager] Failed to load front texture for card '%s'", thisInfo.DisplayName.c_str() );
+                                               Output->FrontTexture = nullptr;
+                                           }
+                                           else
+                                           {
+                                               Output->FrontTexture = t;
+                                           }
+                                       } );
+            }
             
             Output->RequireTexture( thisInfo.FullTexture, [ = ]( cocos2d::Texture2D* t )
                                    {
@@ -288,18 +353,21 @@ CardEntity* CardManager::CreateCard( uint16_t inId, Player *inOwner, bool bPrelo
                                        }
                                    } );
             
-            Output->RequireTexture( inOwner->GetBackTexture(), [ = ]( cocos2d::Texture2D* t )
-                                   {
-                                       if( !t )
-                                       {
-                                           cocos2d::log( "[CardManager] Failed to load back texture for card '%s'", thisInfo.DisplayName.c_str() );
-                                           Output->BackTexture = nullptr;
-                                       }
-                                       else
+            if( !Output->BackFrame )
+            {
+                Output->RequireTexture( inOwner->GetBackTexture(), [ = ]( cocos2d::Texture2D* t )
                                        {
-                                           Output->BackTexture = t;
-                                       }
-                                   } );
+                                           if( !t )
+                                           {
+                                               cocos2d::log( "[CardManager] Failed to load back texture for card '%s'", thisInfo.DisplayName.c_str() );
+                                               Output->BackTexture = nullptr;
+                                           }
+                                           else
+                                           {
+                                               Output->BackTexture = t;
+                                           }
+                                       } );
+            }
         }
         
         return Output;
@@ -315,14 +383,15 @@ CardEntity* CardManager::CreateCard( uint16_t inId, Player *inOwner, bool bPrelo
 
 
 CardEntity::CardEntity()
-    : EntityBase( "card" )
+    : EntityBase( "card", EntityKind::Card )
 {
     lastMoveId  = 0;
     
     _bDragging  = false;
     bSceneInit  = false;
-    _bIsCard    = true;
     bAttacking  = false;
+    bSpriteRetained = false;
+    TweenSlot       = TWEEN_SLOT_NONE;
     
     Sprite              = nullptr;
     OwningPlayer        = nullptr;
@@ -330,6 +399,8 @@ CardEntity::CardEntity()
     FullSizedTexture    = nullptr;
     FrontTexture        = nullptr;
     BackTexture         = nullptr;
+    FrontFrame          = nullptr;
+    BackFrame           = nullptr;
     Highlight           = nullptr;
     Overlay             = nullptr;
     StaminaLabel        = nullptr;
@@ -339,10 +410,19 @@ CardEntity::CardEntity()
 
 CardEntity::~CardEntity()
 {
+    CardManager::GetInstance().GetGrid().Remove( this );
+    CardManager::GetInstance().GetRenderCache().Remove( this );
+    TweenSystem::GetInstance().Stop( TweenSlot );
+    
     // Children nodes will be freed automatically
     if( Sprite )
+    {
         Sprite->removeFromParent();
     
+        if( bSpriteRetained )
+            Sprite->release();
+    }
+    
     OwningPlayer        = nullptr;
     Container           = nullptr;
     FrontTexture        = nullptr;
@@ -361,6 +441,66 @@ void CardEntity::Cleanup()
     EntityBase::Cleanup();
 }
 
+void CardEntity::Recycle()
+{
+    TweenSystem::GetInstance().Stop( TweenSlot );
+    ResetEntity();
+    
+    lastMoveId  = 0;
+    
+    _bDragging  = false;
+    bSceneInit  = false;
+    bAttacking  = false;
+    
+    OwningPlayer        = nullptr;
+    Container           = nullptr;
+    FullSizedTexture    = nullptr;
+    FrontTexture        = nullptr;
+    BackTexture         = nullptr;
+    FrontFrame          = nullptr;
+    BackFrame           = nullptr;
+    Info                = nullptr;
+    MoveTarget          = cocos2d::Vec2::ZERO;
+    
+    Id          = 0;
+    Power       = 0;
+    Stamina     = 0;
+    ManaCost    = 0;
+    FaceUp      = false;
+    Pos         = CardPos::NONE;
+    Owner       = 0;
+    
+    // The scene is going away, so the pool holds the sprite until the card is added to the next one
+    if( Sprite )
+    {
+        if( !bSpriteRetained )
+        {
+            Sprite->retain();
+            bSpriteRetained = true;
+        }
+        
+        Sprite->removeFromParentAndCleanup( true );
+    }
+    
+    DestroyOverlays();
+    
+    // Clearing the overlays invalidates the card, which would put it right back in the render cache,
+    // so the card only leaves the cache and the grid once nothing else is going to touch it
+    CardManager::GetInstance().GetGrid().Remove( this );
+    CardManager::GetInstance().GetRenderCache().Remove( this );
+}
+
+int CardEntity::GetLoadPriority() const
+{
+    // Cards in hand and on the field are on screen when the match opens, the deck wont be seen until its drawn from
+    if( InDeck() )
+        return PRELOAD_PRIORITY_DECK;
+    else if( InGrave() )
+        return PRELOAD_PRIORITY_GRAVE;
+    
+    return PRELOAD_PRIORITY_SCREEN;
+}
+
 bool CardEntity::InDeck() const
 {
     return Container && Container->GetTag() == TAG_DECK;
@@ -391,22 +531,46 @@ void CardEntity::AddToScene( cocos2d::Node* inNode )
     
     CC_ASSERT( inNode );
     
-    if( !BackTexture || !FrontTexture || !FullSizedTexture )
+    if( !( BackFrame || BackTexture ) || !( FrontFrame || FrontTexture ) || !FullSizedTexture )
     {
         cocos2d::log( "[Card] CRITICAL! Failed to add to scene! Missing needed textures" );
         return;
     }
     
-    // Create sprite
     // Defaults to back side visible
-    Sprite = cocos2d::Sprite::createWithTexture( BackTexture );
-    Sprite->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
-    Sprite->setName( "Card" );
-    Sprite->setCascadeOpacityEnabled( true );
+    if( Sprite )
+    {
+        // Pooled card, the sprite tree is already built. Setting the rect also undoes any flip that was cut off
+        SetFaceTexture( false );
+        
+        Sprite->setPosition( cocos2d::Vec2::ZERO );
+        Sprite->setRotation( 0.f );
+        Sprite->setScale( 1.f );
+        Sprite->setOpacity( 255 );
+        Sprite->setColor( cocos2d::Color3B::WHITE );
+        Sprite->setLocalZOrder( 0 );
+        Sprite->setVisible( true );
+    }
+    else
+    {
+        // Cards drawn from the atlas share its pages, so a hand or field full of them batches together
+        Sprite = BackFrame ? cocos2d::Sprite::createWithSpriteFrame( BackFrame ) : cocos2d::Sprite::createWithTexture( BackTexture );
+        Sprite->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
+        Sprite->setName( "Card" );
+        Sprite->setCascadeOpacityEnabled( true );
+    }
     
     FaceUp = false;
     
     inNode->addChild( Sprite );
+    
+    if( bSpriteRetained )
+    {
+        Sprite->release();
+        bSpriteRetained = false;
+    }
+    
+    CardManager::GetInstance().GetGrid().Insert( this );
 }
 
 void CardEntity::CreateOverlays()
@@ -417,6 +581,26 @@ void CardEntity::CreateOverlays()
         return;
     }
     
+    CardManager::GetInstance().GetRenderCache().Invalidate( this );
+    
+    // Already built, either earlier this match or before the card was pooled, so just show them again
+    if( Highlight && Overlay && InfoOverlay && PowerLabel && StaminaLabel )
+    {
+        Highlight->setOpacity( 0 );
+        Highlight->setColor( cocos2d::Color3B( 245, 25, 25 ) );
+        Overlay->setOpacity( 0 );
+        InfoOverlay->setOpacity( 255 );
+        PowerLabel->setString( "" );
+        StaminaLabel->setString( "" );
+        
+        Highlight->setVisible( true );
+        Overlay->setVisible( true );
+        InfoOverlay->setVisible( true );
+        PowerLabel->setVisible( true );
+        StaminaLabel->setVisible( true );
+        return;
+    }
+    
     if( Highlight )
     {
         Highlight->removeFromParent();
@@ -447,7 +631,7 @@ void CardEntity::CreateOverlays()
         StaminaLabel = nullptr;
     }
     
-    Highlight = cocos2d::Sprite::create( "CardHighlight.png" );
+    Highlight = Regicide::TextureAtlas::CreateSprite( "CardHighlight.png" );
     Highlight->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
     Highlight->setName( "Highlight" );
     Highlight->setPosition( Sprite->getContentSize() * 0.5f );
@@ -460,7 +644,7 @@ void CardEntity::CreateOverlays()
     Overlay->setPosition( Sprite->getContentSize() * 0.5f );
     Overlay->setOpacity( 0 );
     
-    InfoOverlay = cocos2d::Sprite::create( "SmallOverlay.png" );
+    InfoOverlay = Regicide::TextureAtlas::CreateSprite( "SmallOverlay.png" );
     InfoOverlay->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
     InfoOverlay->setName( "InfoOverlay" );
     InfoOverlay->setPosition( Sprite->getContentSize() * 0.5f );
@@ -487,35 +671,27 @@ void CardEntity::CreateOverlays()
 
 void CardEntity::DestroyOverlays()
 {
+    CardManager::GetInstance().GetRenderCache().Invalidate( this );
+    
+    // Kept on the sprite and hidden, the labels are expensive to build and the card can be drawn again
+    ClearHighlight();
+    ClearOverlay();
+    HidePowerStamina();
+    
     if( Highlight )
-    {
-        Highlight->removeFromParent();
-        Highlight = nullptr;
-    }
+        Highlight->setVisible( false );
     
     if( Overlay )
-    {
-        Overlay->removeFromParent();
-        Overlay = nullptr;
-    }
+        Overlay->setVisible( false );
     
     if( InfoOverlay )
-    {
-        InfoOverlay->removeFromParent();
-        InfoOverlay = nullptr;
-    }
+        InfoOverlay->setVisible( false );
     
     if( PowerLabel )
-    {
-        PowerLabel->removeFromParent();
-        PowerLabel = nullptr;
-    }
+        PowerLabel->setVisible( false );
     
     if( StaminaLabel )
-    {
-        StaminaLabel->removeFromParent();
-        StaminaLabel = nullptr;
-    }
+        StaminaLabel->setVisible( false );
 }
 
 void CardEntity::Invalidate()
@@ -526,14 +702,27 @@ void CardEntity::Invalidate()
     {
         Sprite->setPosition( GetAbsolutePosition() );
         Sprite->setRotation( GetAbsoluteRotation() );
+        
+        CardManager::GetInstance().GetGrid().MarkMoving( this );
     }
 }
 
+void CardEntity::SetIsDragging( bool In )
+{
+    _bDragging = In;
+    
+    // The game mode moves the sprite directly while its dragged
+    if( In )
+        CardManager::GetInstance().GetGrid().MarkMoving( this );
+}
+
 
 void CardEntity::SetHighlight( const cocos2d::Color3B& inColor, uint8_t inAlpha )
 {
-    if( Highlight )
+    if( Highlight && ( Highlight->getColor() != inColor || Highlight->getOpacity() != inAlpha ) )
     {
+        CardManager::GetInstance().GetRenderCache().Invalidate( this );
+        
         Highlight->setColor( inColor );
         Highlight->setOpacity( inAlpha );
     }
@@ -541,8 +730,9 @@ void CardEntity::SetHighlight( const cocos2d::Color3B& inColor, uint8_t inAlpha
 
 void CardEntity::ClearHighlight()
 {
-    if( Highlight )
+    if( Highlight && Highlight->getOpacity() != 0 )
     {
+        CardManager::GetInstance().GetRenderCache().Invalidate( this );
         Highlight->setOpacity( 0 );
     }
 }
@@ -551,7 +741,14 @@ void CardEntity::SetOverlay(const std::string &TextureName, uint8_t Opacity )
 {
     if( Sprite && Overlay )
     {
-        Overlay->setTexture( TextureName );
+        CardManager::GetInstance().GetRenderCache().Invalidate( this );
+        
+        auto Frame = Regicide::TextureAtlas::GetFrame( TextureName );
+        if( Frame )
+            Overlay->setSpriteFrame( Frame );
+        else
+            Overlay->setTexture( TextureName );
+        
         Overlay->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
         Overlay->setPosition( Sprite->getContentSize() * 0.5f );
         Overlay->setOpacity( Opacity );
@@ -560,8 +757,9 @@ void CardEntity::SetOverlay(const std::string &TextureName, uint8_t Opacity )
 
 void CardEntity::ClearOverlay()
 {
-    if( Overlay )
+    if( Overlay && Overlay->getOpacity() != 0 )
     {
+        CardManager::GetInstance().GetRenderCache().Invalidate( this );
         Overlay->setOpacity( 0 );
     }
 }
@@ -575,13 +773,11 @@ void CardEntity::MoveAnimation( const cocos2d::Vec2 &To, float Time )
         if( GetOwner() )
             FinalPosition += GetOwner()->GetAbsolutePosition();
         
-        auto moveAction = cocos2d::MoveTo::create( Time, FinalPosition );
-        moveAction->setTag( ACTION_TAG_MOVE );
+        // Replaces any move thats already running, the rotation and flip are left alone
+        TweenSystem::GetInstance().Move( TweenSlot, Sprite, FinalPosition, Time );
+        MoveTarget = FinalPosition;
         
-        // We cant just stop the move animation, incase theres a callback associated with it
-        // instead, were going to call the callback after cancelling the sequence
-        Sprite->stopActionByTag( ACTION_TAG_MOVE );
-        Sprite->runAction( moveAction );
+        CardManager::GetInstance().GetGrid().MarkMoving( this );
 
     }
     
@@ -589,15 +785,41 @@ void CardEntity::MoveAnimation( const cocos2d::Vec2 &To, float Time )
     Position = To;
 }
 
+bool CardEntity::NeedsMove( const cocos2d::Vec2& To ) const
+{
+    if( Position.distanceSquared( To ) > CARD_LAYOUT_TOLERANCE )
+        return true;
+    
+    if( !Sprite )
+        return false;
+    
+    // The container might have moved since the card was sent here, so check where the sprite is actually going
+    cocos2d::Vec2 Absolute = To;
+    if( GetOwner() )
+        Absolute += GetOwner()->GetAbsolutePosition();
+    
+    if( TweenSystem::GetInstance().IsMoving( TweenSlot ) )
+        return MoveTarget.distanceSquared( Absolute ) > CARD_LAYOUT_TOLERANCE;
+    
+    // Not moving, but it could have been left somewhere else, like after a drag thats dropped back
+    return Sprite->getPosition().distanceSquared( Absolute ) > CARD_LAYOUT_TOLERANCE;
+}
+
+bool CardEntity::IsAnimating() const
+{
+    if( !Sprite )
+        return false;
+    
+    return TweenSystem::GetInstance().IsAnimating( TweenSlot ) || Sprite->getNumberOfRunningActions() > 0;
+}
+
 void CardEntity::RotateAnimation( float GlobalRot, float Time )
 {
     if( Sprite )
     {
-        auto rotAction = cocos2d::RotateTo::create( Time, GlobalRot );
-        rotAction->setTag( ACTION_TAG_ROTATE );
+        TweenSystem::GetInstance().Rotate( TweenSlot, Sprite, GlobalRot, Time );
         
-        Sprite->stopActionByTag( ACTION_TAG_ROTATE );
-        Sprite->runAction( rotAction );
+        CardManager::GetInstance().GetGrid().MarkMoving( this );
     }
     
     // Update entity rotation
@@ -613,8 +835,9 @@ void CardEntity::Flip( bool bInFaceUp, float Time )
         return;
     
     // Load correct texture
-    auto desired = bInFaceUp ? FrontTexture : BackTexture ;
-    if( !desired )
+    auto desired        = bInFaceUp ? FrontTexture : BackTexture ;
+    auto DesiredFrame   = bInFaceUp ? FrontFrame : BackFrame;
+    if( !desired && !DesiredFrame )
     {
         cocos2d::log( "[Card] ERROR: Failed to flip card properly.. couldnt load texture" );
         return;
@@ -623,16 +846,13 @@ void CardEntity::Flip( bool bInFaceUp, float Time )
     ClearHighlight();
     ClearOverlay();
     
-    if( Sprite && desired )
+    // The bake is of the side thats showing now, so the live sprite has to be back before the flip swaps it
+    CardManager::GetInstance().GetRenderCache().Invalidate( this );
+    
+    if( Sprite )
     {
-        if( bInFaceUp )
-        {
-            Sprite->runAction( cocos2d::Sequence::create( CardFlipY::Create( Time / 2.f, 0.f, 90.f ), CardFlipTex::Create( 0.f, desired ), CardFlipY::Create( Time / 2.f, -90.f, 0.f ), cocos2d::CallFunc::create( std::bind( &CardEntity::ShowPowerStamina, this ) ), NULL ) );
-        }
-        else
-        {
-            Sprite->runAction( cocos2d::Sequence::create( CardFlipY::Create( Time / 2.f, 0.f, 90.f ), CardFlipTex::Create( 0.f, desired ), CardFlipY::Create( Time / 2.f, -90.f, 0.f ), NULL ) );
-        }
+        TweenSystem::GetInstance().Flip( TweenSlot, Sprite, DesiredFrame, DesiredFrame ? nullptr : desired, Time,
+                                         this, bInFaceUp ? TweenEvent::ShowPowerStamina : TweenEvent::None );
     }
     
     FaceUp = bInFaceUp;
@@ -649,34 +869,56 @@ void CardEntity::SetZ( int In )
 
 void CardEntity::UpdatePower( int inPower )
 {
-    if( PowerLabel )
-        PowerLabel->setString( std::to_string( inPower ) );
+    SetStatLabel( PowerLabel, std::to_string( inPower ) );
     
     Power = inPower;
 }
 
 void CardEntity::UpdateStamina( int inStamina )
 {
-    if( StaminaLabel )
-        StaminaLabel->setString( std::to_string( inStamina ) );
+    SetStatLabel( StaminaLabel, std::to_string( inStamina ) );
     
     Stamina = inStamina;
 }
 
 void CardEntity::ShowPowerStamina()
 {
-    if( StaminaLabel )
-        StaminaLabel->setString( std::to_string( Stamina ) );
-    
-    if( PowerLabel )
-        PowerLabel->setString( std::to_string( Power ) );
+    SetStatLabel( StaminaLabel, std::to_string( Stamina ) );
+    SetStatLabel( PowerLabel, std::to_string( Power ) );
 }
 
 void CardEntity::HidePowerStamina()
 {
-    if( StaminaLabel )
-        StaminaLabel->setString( "" );
+    SetStatLabel( StaminaLabel, "" );
+    SetStatLabel( PowerLabel, "" );
+}
+
+void CardEntity::SetStatLabel( cocos2d::Label* Target, const std::string& In )
+{
+    if( !Target || Target->getString() == In )
+        return;
     
-    if( PowerLabel )
-        PowerLabel->setString( "" );
+    CardManager::GetInstance().GetRenderCache().Invalidate( this );
+    Target->setString( In );
+}
+
+void CardEntity::SetFaceTexture( bool bFront )
+{
+    auto Frame      = bFront ? FrontFrame : BackFrame;
+    auto Texture    = bFront ? FrontTexture : BackTexture;
+    
+    if( !Sprite )
+        return;
+    
+    if( Frame )
+    {
+        Sprite->setSpriteFrame( Frame );
+    }
+    else if( Texture )
+    {
+        auto Size = Texture->getContentSize();
+        
+        Sprite->setTexture( Texture );
+        Sprite->setTextureRect( cocos2d::Rect( 0.f, 0.f, Size.width, Size.height ) );
+    }
 }
@@ -16,11 +16,8 @@
 #include "LuaEngine.hpp"    // For luabridge::LuaRef
 #include "Actions.hpp"
 #include "ObjectStates.hpp"
-
-// Action Tags
-// These are assigned to cocos2d 'actions' to be able to cancel the animation if needed
-#define ACTION_TAG_MOVE 1212
-#define ACTION_TAG_ROTATE 2323
+#include "CardGrid.hpp"
+#include "CardRenderCache.hpp"
 
 // Play Errors
 // Errors returned by the Game Authority when unable to play a card
@@ -34,6 +31,14 @@
 // to have a fixed time, as opposed to a fixed speed
 #define CARD_DEFAULT_MOVE_TIME 0.35f
 
+// Layout Tolerance
+// Squared distance a card can be off from its place in a container before its moved again
+#define CARD_LAYOUT_TOLERANCE 0.25f
+
+// Card Pool Size
+// Most cards kept built between matches, a match uses around 140
+#define CARD_POOL_LIMIT 160
+
 
 namespace Game
 {
@@ -99,17 +104,44 @@ namespace Game
         CardEntity* CreateCard( uint16_t inId, Player* inOwner, bool bPreloadTextures = false );
         CardEntity* CreateCard( CardState& State, Player* inOwner, bool bPreloadTextures = false );
         
+        // Card pooling, off until a limit is set. Destroyed cards keep their sprite tree and wait in the pool,
+        // and CreateCard re-skins one of those before building a new card
+        void SetPoolLimit( size_t inLimit );
+        void ClearPool();
+        inline size_t GetPoolSize() const { return Pool.size(); }
+        
+        // Bounds of the cards in the scene, for touch tracing
+        inline CardGrid& GetGrid() { return Grid; }
+        
+        // Baked textures of face up cards, so a settled card is drawn as a single quad
+        inline CardRenderCache& GetRenderCache() { return RenderCache; }
+        
         ~CardManager();
         
     protected:
         
         std::map< uint16_t, CardInfo > CachedCards;
         
+        std::vector< std::shared_ptr< CardEntity > > Pool;
+        size_t PoolLimit = 0;
+        
+        CardGrid Grid;
+        CardRenderCache RenderCache;
+        
+        // Takes a card from the pool, or creates one, and adds it to the entity manager. Zero allocates an id
+        CardEntity* AcquireCard( uint32_t EntId );
+        
+        // Called by the entity manager for destroyed cards, returns false when the card should be freed instead
+        bool ReleaseCard( std::shared_ptr< EntityBase >& In );
+    
     private:
         
         CardManager() {}
         CardManager( const CardManager& Other ) = delete;
         CardManager& operator= ( const CardManager& Other ) = delete;
+        
+        friend class MatchContext;
+        friend class IEntityManager;
     };
     
     // Class Declaration
@@ -125,7 +157,13 @@ namespace Game
         // Public Methods
         void MoveAnimation( const cocos2d::Vec2& To, float Time );
         void RotateAnimation( float GlobalRot, float Time );
+        
+        // False when the card is already at this position, or animating towards it
+        bool NeedsMove( const cocos2d::Vec2& To ) const;
         void Flip( bool bFaceUp, float Time );
+        
+        // True while the card is tweening, or the sprite has any other actions running
+        bool IsAnimating() const;
         bool InDeck() const;
         bool InHand() const;
         bool InGrave() const;
@@ -140,7 +178,7 @@ namespace Game
         inline int GetZ() const                 { if( Sprite ) return Sprite->getGlobalZOrder(); return 0; }
         void SetZ( int In ); 
         inline float GetWidth() const           { if( Sprite ) { return Sprite->getContentSize().width; } else return 0.f; }
-        inline void SetIsDragging( bool In )    { _bDragging = In; }
+        void SetIsDragging( bool In );
         inline bool GetIsDragging() const       { return _bDragging; }
         inline ICardContainer* GetContainer()   { return Container; }
         
@@ -148,6 +186,7 @@ namespace Game
         virtual void AddToScene( cocos2d::Node* inNode ) override;
         virtual void Invalidate() override;
         
+        // Overlays are built once per sprite, destroying them only hides them until theyre created again
         void CreateOverlays();
         void DestroyOverlays();
         
@@ -156,6 +195,9 @@ namespace Game
         
         void ShowPowerStamina();
         void HidePowerStamina();
+        
+        // Shows the front or back without flipping, from the atlas frame if the card has one
+        void SetFaceTexture( bool bFront );
 
         // Getters for Lua
         int _lua_GetCardId() const { return Id; }
@@ -178,6 +220,10 @@ namespace Game
         cocos2d::Texture2D* BackTexture;
         cocos2d::Texture2D* FullSizedTexture;
         
+        // Set instead of the front and back textures when those are in the card atlas
+        cocos2d::SpriteFrame* FrontFrame;
+        cocos2d::SpriteFrame* BackFrame;
+        
         inline CardInfo* GetInfo() { return Info; }
         
         uint16_t Id;
@@ -192,6 +238,13 @@ namespace Game
         
         // EntityBase Overrides (Protected)
         virtual void Cleanup() override;
+        virtual int GetLoadPriority() const override;
+        
+        // Clears the card for the pool, the sprite tree is kept out of the scene until the card is added again
+        void Recycle();
+        
+        // Only touches the label, and the render cache, when the text actually changes
+        void SetStatLabel( cocos2d::Label* Target, const std::string& In );
         
         // Protected Members
         Player* OwningPlayer;
@@ -200,6 +253,15 @@ namespace Game
         bool bSceneInit;
         bool _bDragging;
         
+        // Set while the sprite is held by the pool instead of a parent node
+        bool bSpriteRetained;
+        
+        // Absolute position the last move animation was sent to
+        cocos2d::Vec2 MoveTarget;
+        
+        // Index of the sprites track in the tween system, kept up to date by the tween system
+        uint32 TweenSlot;
+        
         uint32_t lastMoveId;
         
         CardInfo* Info;
@@ -207,6 +269,7 @@ namespace Game
         // Fiend Class Declarations
         friend class ICardContainer;
         friend class CardManager;
+        friend class CardRenderCache;
     };
     
     // Card Container Iterator Typedef
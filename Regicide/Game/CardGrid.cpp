@@ -0,0 +1,179 @@
+//
+//    CardGrid.cpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "CardGrid.hpp"
+#include "CardEntity.hpp"
+#include <algorithm>
+
+using namespace Game;
+
+
+void CardGrid::Insert( CardEntity* In )
+{
+    if( !In || !In->Sprite || Entries.count( In ) > 0 )
+        return;
+    
+    Entry NewEntry;
+    NewEntry.bMoving    = false;
+    NewEntry.bPlaced    = false;
+    
+    auto& Target = Entries[ In ] = NewEntry;
+    Place( In, Target );
+    
+    // Cards usually go in right before theyre moved into a container
+    MarkMoving( In );
+}
+
+
+void CardGrid::Remove( CardEntity* In )
+{
+    auto It = Entries.find( In );
+    if( It == Entries.end() )
+        return;
+    
+    Unplace( In, It->second );
+    
+    if( It->second.bMoving )
+        Moving.erase( std::remove( Moving.begin(), Moving.end(), In ), Moving.end() );
+    
+    Entries.erase( It );
+}
+
+
+void CardGrid::Clear()
+{
+    Entries.clear();
+    Cells.clear();
+    Moving.clear();
+}
+
+
+void CardGrid::MarkMoving( CardEntity* In )
+{
+    auto It = Entries.find( In );
+    if( It == Entries.end() || It->second.bMoving )
+        return;
+    
+    It->second.bMoving = true;
+    Moving.push_back( In );
+}
+
+
+void CardGrid::Refresh()
+{
+    // Cards keep getting re-bucketed until theyve settled, after that they stay put until theyre moved again
+    size_t Kept = 0;
+    for( size_t i = 0; i < Moving.size(); i++ )
+    {
+        auto* Card = Moving[ i ];
+        auto& Target = Entries[ Card ];
+        
+        Unplace( Card, Target );
+        Place( Card, Target );
+        
+        bool bSettled = !Card->Sprite || ( !Card->IsAnimating() && !Card->GetIsDragging() );
+        if( bSettled )
+            Target.bMoving = false;
+        else
+            Moving[ Kept++ ] = Card;
+    }
+    
+    Moving.resize( Kept );
+}
+
+
+void CardGrid::Place( CardEntity* In, Entry& Target )
+{
+    if( !In->Sprite )
+        return;
+    
+    auto Bounds = In->Sprite->getBoundingBox();
+    
+    Target.MinX     = ToCell( Bounds.getMinX() );
+    Target.MinY     = ToCell( Bounds.getMinY() );
+    Target.MaxX     = ToCell( Bounds.getMaxX() );
+    Target.MaxY     = ToCell( Bounds.getMaxY() );
+    Target.bPlaced  = true;
+    
+    for( int X = Target.MinX; X <= Target.MaxX; X++ )
+    {
+        for( int Y = Target.MinY; Y <= Target.MaxY; Y++ )
+            Cells[ CellKey( X, Y ) ].push_back( In );
+    }
+}
+
+
+void CardGrid::Unplace( CardEntity* In, Entry& Target )
+{
+    if( !Target.bPlaced )
+        return;
+    
+    for( int X = Target.MinX; X <= Target.MaxX; X++ )
+    {
+        for( int Y = Target.MinY; Y <= Target.MaxY; Y++ )
+        {
+            auto Cell = Cells.find( CellKey( X, Y ) );
+            if( Cell == Cells.end() )
+                continue;
+            
+            auto& List = Cell->second;
+            auto Found = std::find( List.begin(), List.end(), In );
+            if( Found != List.end() )
+            {
+                *Found = List.back();
+                List.pop_back();
+            }
+            
+            if( List.empty() )
+                Cells.erase( Cell );
+        }
+    }
+    
+    Target.bPlaced = false;
+}
+
+
+CardEntity* CardGrid::Trace( const cocos2d::Vec2& inPos, Player* Owner /* = nullptr */ )
+{
+    Refresh();
+    
+    auto Cell = Cells.find( CellKey( ToCell( inPos.x ), ToCell( inPos.y ) ) );
+    if( Cell == Cells.end() )
+        return nullptr;
+    
+    CardEntity* Output = nullptr;
+    float TopZ = 0.f;
+    int TopLocalZ = 0;
+    
+    for( auto It = Cell->second.begin(); It != Cell->second.end(); It++ )
+    {
+        auto* Card = *It;
+        if( !Card->Sprite || !Card->GetContainer() )
+            continue;
+        
+        if( Owner && Card->GetOwningPlayer() != Owner )
+            continue;
+        
+        if( !Card->Sprite->getBoundingBox().containsPoint( inPos ) )
+            continue;
+        
+        float Z = Card->Sprite->getGlobalZOrder();
+        int LocalZ = Card->Sprite->getLocalZOrder();
+        
+        if( !Output || Z > TopZ || ( Z == TopZ && LocalZ > TopLocalZ ) )
+        {
+            Output      = Card;
+            TopZ        = Z;
+            TopLocalZ   = LocalZ;
+        }
+    }
+    
+    return Output;
+}
@@ -0,0 +1,71 @@
+//
+//    CardGrid.hpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Numeric.hpp"
+#include "cocos2d.h"
+#include <unordered_map>
+#include <vector>
+
+// Card Grid Cell Size
+// A bit smaller than a card, so a card covers a handful of cells and a cell only holds the cards stacked on it
+#define CARD_GRID_CELL_SIZE 128.f
+
+namespace Game
+{
+    class CardEntity;
+    class Player;
+    
+    // Uniform grid over the bounds of every card in the scene, used to find which card a touch landed on
+    //
+    // Cards are bucketed into the cells their bounding box covers. Cards that are animating or being dragged are
+    // re-bucketed before each trace, until theyve stopped animating, so nothing is walked that isnt near
+    // the touch. The bounds are still checked exactly, and the card with the highest z order wins
+    class CardGrid
+    {
+    public:
+    
+        void Insert( CardEntity* In );
+        void Remove( CardEntity* In );
+        void Clear();
+        
+        // Call whenever a cards sprite is about to move, rotate or scale
+        void MarkMoving( CardEntity* In );
+        
+        // Topmost card in a container under the point, optionally only cards owned by the given player
+        CardEntity* Trace( const cocos2d::Vec2& inPos, Player* Owner = nullptr );
+        
+        inline size_t GetCardCount() const { return Entries.size(); }
+    
+    protected:
+    
+        struct Entry
+        {
+            int MinX;
+            int MinY;
+            int MaxX;
+            int MaxY;
+            bool bMoving;
+            bool bPlaced;
+        };
+        
+        void Refresh();
+        void Place( CardEntity* In, Entry& Target );
+        void Unplace( CardEntity* In, Entry& Target );
+        
+        static inline int ToCell( float In ) { return (int) floorf( In / CARD_GRID_CELL_SIZE ); }
+        static inline uint64 CellKey( int X, int Y ) { return ( (uint64)(uint32) X << 32 ) | (uint64)(uint32) Y; }
+        
+        std::unordered_map< CardEntity*, Entry > Entries;
+        std::unordered_map< uint64, std::vector< CardEntity* > > Cells;
+        std::vector< CardEntity* > Moving;
+    };
+}
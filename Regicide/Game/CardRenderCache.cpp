@@ -0,0 +1,309 @@
+//
+//    CardRenderCache.cpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "CardRenderCache.hpp"
+#include "CardEntity.hpp"
+#include "CardAnimations.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace Game;
+
+
+CardRenderCache::CardRenderCache()
+: BakedCount( 0 ), bEnabled( CARD_RENDER_CACHE_ENABLED )
+{
+}
+
+
+CardRenderCache::~CardRenderCache()
+{
+    Clear();
+}
+
+
+void CardRenderCache::Invalidate( CardEntity* In )
+{
+    if( !bEnabled || !In )
+        return;
+    
+    auto It = Entries.find( In );
+    if( It == Entries.end() )
+    {
+        Entry NewEntry;
+        NewEntry.Target     = nullptr;
+        NewEntry.Frame      = nullptr;
+        NewEntry.State      = EntryState::Live;
+        
+        It = Entries.insert( std::make_pair( In, NewEntry ) ).first;
+    }
+    
+    auto& Target = It->second;
+    
+    if( Target.State == EntryState::Baked )
+        ShowLive( In, Target );
+    
+    if( Target.State == EntryState::Live )
+        Waiting.push_back( In );
+    
+    // Anything rendered already is out of date
+    Target.State = EntryState::Pending;
+}
+
+
+void CardRenderCache::Remove( CardEntity* In )
+{
+    auto It = Entries.find( In );
+    if( It == Entries.end() )
+        return;
+    
+    auto& Target = It->second;
+    
+    if( Target.State == EntryState::Baked )
+        ShowLive( In, Target );
+    else if( Target.State != EntryState::Live )
+        Waiting.erase( std::remove( Waiting.begin(), Waiting.end(), In ), Waiting.end() );
+    
+    if( Target.Target )
+        Target.Target->release();
+    
+    if( Target.Frame )
+        Target.Frame->release();
+    
+    Entries.erase( It );
+}
+
+
+void CardRenderCache::Clear()
+{
+    // Cards still showing a bake keep their texture and frame alive, so theyre left as they are
+    for( auto It = Entries.begin(); It != Entries.end(); It++ )
+    {
+        if( It->second.Target )
+            It->second.Target->release();
+        
+        if( It->second.Frame )
+            It->second.Frame->release();
+    }
+    
+    Entries.clear();
+    Waiting.clear();
+    BakedCount = 0;
+}
+
+
+void CardRenderCache::SetEnabled( bool In )
+{
+    if( In == bEnabled )
+        return;
+    
+    bEnabled = In;
+    
+    for( auto It = Entries.begin(); It != Entries.end(); It++ )
+    {
+        auto& Target = It->second;
+        
+        if( !bEnabled )
+        {
+            if( Target.State == EntryState::Baked )
+                ShowLive( It->first, Target );
+            
+            Target.State = EntryState::Live;
+        }
+        else
+        {
+            // Every card thats been seen gets another look, the ones that cant be baked are dropped on the next flush
+            Target.State = EntryState::Pending;
+            Waiting.push_back( It->first );
+        }
+    }
+    
+    if( !bEnabled )
+        Waiting.clear();
+}
+
+
+void CardRenderCache::Flush()
+{
+    if( Waiting.empty() )
+        return;
+    
+    int Bakes = 0;
+    size_t Kept = 0;
+    
+    for( size_t i = 0; i < Waiting.size(); i++ )
+    {
+        auto* Card      = Waiting[ i ];
+        auto& Target    = Entries[ Card ];
+        
+        if( !CanBake( Card ) )
+        {
+            Target.State = EntryState::Live;
+            continue;
+        }
+        
+        // Rendered along with the last frame, so the texture is ready as long as the card hasnt started fading since
+        if( Target.State == EntryState::Rendered )
+        {
+            if( IsSettled( Card ) )
+            {
+                ShowBaked( Card, Target );
+                continue;
+            }
+            
+            Target.State = EntryState::Pending;
+        }
+        
+        if( Bakes < CARD_RENDER_BAKES_PER_FRAME && IsSettled( Card ) )
+        {
+            Bakes++;
+            
+            if( !Render( Card, Target ) )
+            {
+                Target.State = EntryState::Live;
+                continue;
+            }
+            
+            Target.State = EntryState::Rendered;
+        }
+        
+        Waiting[ Kept++ ] = Card;
+    }
+    
+    Waiting.resize( Kept );
+}
+
+
+bool CardRenderCache::CanBake( CardEntity* In ) const
+{
+    if( !In->Sprite || !In->Sprite->getParent() || !In->FaceUp )
+        return false;
+    
+    // Overlays are all shown or all hidden together, theres nothing to gain from baking a card without them
+    return In->Highlight && In->Overlay && In->PowerLabel && In->StaminaLabel && In->InfoOverlay && In->InfoOverlay->isVisible();
+}
+
+
+bool CardRenderCache::IsSettled( CardEntity* In ) const
+{
+    // A fade would be baked in, and a flip changes the texture halfway through
+    return In->Sprite->getDisplayedOpacity() == 255 &&
+           In->Sprite->getNumberOfRunningActions() == 0 &&
+           !TweenSystem::GetInstance().IsFlipping( In->TweenSlot );
+}
+
+
+bool CardRenderCache::Render( CardEntity* In, Entry& Target )
+{
+    auto* Sprite    = In->Sprite;
+    auto Size       = Sprite->getContentSize();
+    
+    if( !Target.Target || !Target.Frame || !Target.Size.equals( Size ) )
+    {
+        if( Target.Target )
+            Target.Target->release();
+        
+        if( Target.Frame )
+            Target.Frame->release();
+        
+        Target.Target   = nullptr;
+        Target.Frame    = nullptr;
+        
+        int Width   = (int) ceilf( Size.width + CARD_RENDER_MARGIN * 2.f );
+        int Height  = (int) ceilf( Size.height + CARD_RENDER_MARGIN * 2.f );
+        
+        Target.Target = cocos2d::RenderTexture::create( Width, Height, cocos2d::Texture2D::PixelFormat::RGBA8888 );
+        if( !Target.Target )
+        {
+            cocos2d::log( "[Card] Failed to create render texture for card cache!" );
+            return false;
+        }
+        
+        Target.Target->retain();
+        
+        // The quad is bigger than the card by the margin on each side, with the same content size, so the card is laid
+        // out and traced exactly the same while its showing the bake
+        Target.Frame = cocos2d::SpriteFrame::createWithTexture( Target.Target->getSprite()->getTexture(), cocos2d::Rect( 0.f, 0.f, (float) Width, (float) Height ),
+                                                                false, cocos2d::Vec2::ZERO, Size );
+        Target.Frame->retain();
+        Target.Size = Size;
+    }
+    
+    // Only the transform is changed for the bake, the draw commands copy it when theyre queued
+    auto Position   = Sprite->getPosition();
+    float Rotation  = Sprite->getRotation();
+    float ScaleX    = Sprite->getScaleX();
+    float ScaleY    = Sprite->getScaleY();
+    
+    Sprite->setPosition( Sprite->getAnchorPointInPoints() + cocos2d::Vec2( CARD_RENDER_MARGIN, CARD_RENDER_MARGIN ) );
+    Sprite->setRotation( 0.f );
+    Sprite->setScale( 1.f );
+    
+    Target.Target->beginWithClear( 0.f, 0.f, 0.f, 0.f );
+    Sprite->visit();
+    Target.Target->end();
+    
+    Sprite->setPosition( Position );
+    Sprite->setRotation( Rotation );
+    Sprite->setScaleX( ScaleX );
+    Sprite->setScaleY( ScaleY );
+    
+    return true;
+}
+
+
+void CardRenderCache::ShowBaked( CardEntity* In, Entry& Target )
+{
+    SetChildrenVisible( In, false );
+    
+    // Render textures come out upside down, and with the alpha already multiplied in
+    In->Sprite->setSpriteFrame( Target.Frame );
+    In->Sprite->setFlippedY( true );
+    In->Sprite->setBlendFunc( cocos2d::BlendFunc::ALPHA_PREMULTIPLIED );
+    In->Sprite->setOpacityModifyRGB( true );
+    
+    Target.State = EntryState::Baked;
+    BakedCount++;
+}
+
+
+void CardRenderCache::ShowLive( CardEntity* In, Entry& Target )
+{
+    // Switching back to the cards own texture resets the blend mode as well
+    if( In->Sprite )
+    {
+        In->Sprite->setFlippedY( false );
+        In->SetFaceTexture( In->FaceUp );
+    }
+    
+    SetChildrenVisible( In, true );
+    
+    Target.State = EntryState::Live;
+    BakedCount--;
+}
+
+
+void CardRenderCache::SetChildrenVisible( CardEntity* In, bool bVisible )
+{
+    if( In->Highlight )
+        In->Highlight->setVisible( bVisible );
+    
+    if( In->Overlay )
+        In->Overlay->setVisible( bVisible );
+    
+    if( In->InfoOverlay )
+        In->InfoOverlay->setVisible( bVisible );
+    
+    if( In->PowerLabel )
+        In->PowerLabel->setVisible( bVisible );
+    
+    if( In->StaminaLabel )
+        In->StaminaLabel->setVisible( bVisible );
+}
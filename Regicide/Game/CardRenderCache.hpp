@@ -0,0 +1,98 @@
+//
+//    CardRenderCache.hpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Numeric.hpp"
+#include "cocos2d.h"
+#include <unordered_map>
+#include <vector>
+
+// Card Render Cache
+// Whether face up cards are baked into a single texture by default, can be changed at runtime
+#define CARD_RENDER_CACHE_ENABLED true
+
+// Space around the card in the baked texture, the highlight and info overlay are a little bigger than the card
+#define CARD_RENDER_MARGIN 8.f
+
+// Baking draws the whole card again, so only a few are done each frame when a lot change at once
+#define CARD_RENDER_BAKES_PER_FRAME 4
+
+namespace Game
+{
+    class CardEntity;
+    
+    // Bakes the composite look of face up cards into one texture each
+    //
+    // A face up card is the card sprite, with the highlight, overlay, info overlay and both stat labels drawn on top.
+    // Once a card has settled, all of that is drawn into a render texture, and the card sprite shows the render texture
+    // with the children hidden, so the card is a single quad until something on it changes again. Changing the stats,
+    // highlight, overlay or flipping the card puts the live nodes back right away, and the card is baked again once
+    // its not flipping or fading anymore
+    //
+    // The render texture is drawn by the renderer along with the next frame, so the card switches over on the tick after
+    // its baked, that way nothing the bake draws from is changed before its drawn
+    class CardRenderCache
+    {
+    public:
+    
+        CardRenderCache();
+        ~CardRenderCache();
+        
+        // Call before anything on the card thats drawn changes, the card is baked again once it settles
+        void Invalidate( CardEntity* In );
+        
+        // Puts the live nodes back and frees the cards render texture
+        void Remove( CardEntity* In );
+        void Clear();
+        
+        // Bakes and swaps in waiting cards, called once per tick
+        void Flush();
+        
+        void SetEnabled( bool In );
+        inline bool IsEnabled() const { return bEnabled; }
+        
+        inline size_t GetBakedCount() const { return BakedCount; }
+    
+    protected:
+    
+        enum class EntryState : uint8_t
+        {
+            Live,
+            Pending,
+            Rendered,
+            Baked
+        };
+        
+        struct Entry
+        {
+            cocos2d::RenderTexture* Target;
+            cocos2d::SpriteFrame* Frame;
+            cocos2d::Size Size;
+            EntryState State;
+        };
+        
+        // False when the card cant be baked as it is now, so it stops waiting until its invalidated again
+        bool CanBake( CardEntity* In ) const;
+        
+        // Bake has to wait for the card to finish animating
+        bool IsSettled( CardEntity* In ) const;
+        
+        bool Render( CardEntity* In, Entry& Target );
+        void ShowBaked( CardEntity* In, Entry& Target );
+        void ShowLive( CardEntity* In, Entry& Target );
+        void SetChildrenVisible( CardEntity* In, bool bVisible );
+        
+        std::unordered_map< CardEntity*, Entry > Entries;
+        std::vector< CardEntity* > Waiting;
+        size_t BakedCount;
+        bool bEnabled;
+    };
+}
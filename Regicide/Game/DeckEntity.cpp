@@ -14,7 +14,7 @@ using namespace Game;
 
 
 DeckEntity::DeckEntity()
-    : EntityBase( "Deck" ), Counter( nullptr )
+    : EntityBase( "Deck", EntityKind::Container ), Counter( nullptr )
 {
     SetTag( TAG_DECK );
     bAddedToScene = false;
@@ -329,7 +329,7 @@ void DeckEntity::Invalidate()
     }
 }
 
-void DeckEntity::InvalidateCards( CardEntity* Ignore )
+void DeckEntity::LayoutCards( CardEntity* Ignore )
 {
     int Index = 0;
     for( auto It = Begin(); It != End(); It++ )
@@ -337,8 +337,12 @@ void DeckEntity::InvalidateCards( CardEntity* Ignore )
         float Offset = Index * 0.1f;
         if( *It && *It != Ignore && !(*It)->GetIsDragging() )
         {
-            (*It)->SetPosition( GetPosition() - cocos2d::Vec2( Offset, 0.f ) );
-            (*It)->SetRotation( 0.f );
+            auto Target = GetPosition() - cocos2d::Vec2( Offset, 0.f );
+            if( (*It)->NeedsMove( Target ) || (*It)->GetRotation() != 0.f )
+            {
+                (*It)->SetPosition( Target );
+                (*It)->SetRotation( 0.f );
+            }
         }
         
         Index++;
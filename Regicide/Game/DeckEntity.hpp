@@ -58,7 +58,6 @@ namespace Game
         inline uint32 GetDeckId() const { return DeckId; }
         
         virtual void Invalidate() override;
-        virtual void InvalidateCards( CardEntity* Ignore = nullptr ) override;
         void InvalidateZOrder();
         
         virtual void AddToScene( cocos2d::Node* In ) override;
@@ -72,6 +71,8 @@ namespace Game
         std::string DisplayName;
         uint32 DeckId;
         
+        virtual void LayoutCards( CardEntity* Ignore ) override;
+        
         void MoveCard( CardEntity* inCard, std::function< void() > Callback );
         
         cocos2d::Label* Counter;
@@ -13,13 +13,71 @@
 #include "World.hpp"
 #include "Actions.hpp"
 #include "CardEntity.hpp"
+#include "MatchContext.hpp"
+#include "TexturePreloader.hpp"
+#include "CardAnimations.hpp"
 
 using namespace Game;
 
 
 bool IEntityManager::EntityExists( uint32 EntityId )
 {
-    return EntityStore.count( EntityId ) > 0;
+    return SlotLookup.count( EntityId ) > 0;
+}
+
+/*=================================================================================================
+    IEntityManager::Insert( uint32_t (ENT ID), Entity ) [INTERNAL]
+     -> Places a newly created entity into a free slot, and into the list for its kind.
+        Freed slots are reused first, so the slot table only grows to the most entities alive
+        at any one time. INTERNAL METHOD
+ =================================================================================================*/
+void IEntityManager::Insert( uint32 EntityId, std::shared_ptr< EntityBase >&& In )
+{
+    CC_ASSERT( In );
+    
+    uint32_t Index = 0;
+    if( !FreeSlots.empty() )
+    {
+        Index = FreeSlots.back();
+        FreeSlots.pop_back();
+    }
+    else
+    {
+        Index = (uint32_t) Slots.size();
+        Slots.push_back( Slot() );
+        Slots.back().Generation = 1;
+    }
+    
+    auto& Target = Slots[ Index ];
+    auto& List = Kinds[ (size_t) In->Kind ];
+    
+    Target.KindIndex = (uint32_t) List.size();
+    List.push_back( In.get() );
+    
+    In->EID                 = EntityId;
+    In->Handle.Index        = Index;
+    In->Handle.Generation   = Target.Generation;
+    
+    Target.Entity = std::move( In );
+    SlotLookup[ EntityId ] = Index;
+}
+
+/*=================================================================================================
+    IEntityManager::Adopt( uint32_t (ENT ID), Entity ) [INTERNAL]
+     -> Inserts an entity that was built before, and kept alive outside of the manager since. A
+        zero id allocates a new one. Used by the card pool. INTERNAL METHOD
+ =================================================================================================*/
+void IEntityManager::Adopt( uint32 EntityId, std::shared_ptr< EntityBase >&& In )
+{
+    if( EntityId == 0 )
+        EntityId = AllocateIdentifier();
+    
+    CCASSERT( SlotLookup.count( EntityId ) == 0, "Attempt to adopt entity with in-use Id!" );
+    
+    Insert( EntityId, std::move( In ) );
+    
+    if( EntityId > HighestEntityId )
+        HighestEntityId = EntityId;
 }
 
 /*=================================================================================================
@@ -42,31 +100,54 @@ void IEntityManager::CallCleanup( EntityBase* In )
 }
 
 /*=================================================================================================
-     IEntityManager::DoDestroy( unit32_t (ENT ID) ) [INTERNAL]
+     IEntityManager::DoDestroy( Entity ) [INTERNAL]
      -> Destroys an entity and all of its children. Children are always destroyed before
-        the parent gets destroyed. INTERNAL METHOD. DO NOT CALL
+        the parent gets destroyed. The slot is freed with its generation bumped, so any
+        handles still pointing at it stop resolving. INTERNAL METHOD. DO NOT CALL
  =================================================================================================*/
-void IEntityManager::DoDestroy( std::map< uint32, std::shared_ptr< EntityBase > >::iterator Iter ) 
+void IEntityManager::DoDestroy( EntityBase* In )
 {
-    if( Iter == EntityStore.end() )
+    if( !In || SlotLookup.count( In->EID ) == 0 )
         return;
     
-    if( Iter->second )
+    // Recursivley destroy child entities
+    for( auto It = In->ChildBegin(); It != In->ChildEnd(); It++ )
     {
-        // Recursivley destroy child entities
-        for( auto It = Iter->second->ChildBegin(); It != Iter->second->ChildEnd(); It++ )
-        {
-            if( *It )
-            {
-                DoDestroy( EntityStore.find( (*It)->EID ) );
-            }
-        }
-        
-        // Destroy this entity and clear entry in master list
-        Iter->second.reset();
+        if( *It )
+            DoDestroy( *It );
     }
     
-    EntityStore.erase( Iter );
+    auto Lookup = SlotLookup.find( In->EID );
+    if( Lookup == SlotLookup.end() )
+        return;
+    
+    uint32_t Index = Lookup->second;
+    SlotLookup.erase( Lookup );
+    
+    // Swap the last entity of this kind into the gap
+    auto& Target = Slots[ Index ];
+    auto& List = Kinds[ (size_t) In->Kind ];
+    
+    EntityBase* Moved = List.back();
+    List[ Target.KindIndex ] = Moved;
+    Slots[ Moved->Handle.Index ].KindIndex = Target.KindIndex;
+    List.pop_back();
+    
+    // Generation zero is reserved for null handles
+    Target.Generation++;
+    if( Target.Generation == 0 )
+        Target.Generation = 1;
+    
+    FreeSlots.push_back( Index );
+    
+    // Destroy this entity, once its out of the tables. Cards can go back to the card pool instead
+    auto Entity = std::move( Target.Entity );
+    Entity->Handle = EntityHandle();
+    
+    if( Entity->Kind == EntityKind::Card && CardManager::GetInstance().ReleaseCard( Entity ) )
+        return;
+    
+    Entity.reset();
 }
 
 /*=================================================================================================
@@ -77,27 +158,27 @@ void IEntityManager::DoDestroy( std::map< uint32, std::shared_ptr< EntityBase >
  =================================================================================================*/
 bool IEntityManager::DestroyEntity( uint32 EntityId )
 {
-    // Lookup Entity in master list
-    auto Result = EntityStore.find( EntityId );
-    if( Result == EntityStore.end() )
+    // Lookup Entity in the slot table
+    auto Result = SlotLookup.find( EntityId );
+    if( Result == SlotLookup.end() )
     {
         return false;
     }
     
-    if( Result->second )
+    // Held until the tree is gone, so cleanup cant destroy it out from under us
+    auto Target = Slots[ Result->second ].Entity;
+    if( Target )
     {
-        auto Target = Result->second;
-        
         // Cleanup Entity Tree
         CallCleanup( Target.get() );
         
         // Remove from parent
-        auto Parent = Result->second->GetOwner();
+        auto Parent = Target->GetOwner();
         if( Parent )
-            Parent->RemoveChild( Result->second.get(), false );
+            Parent->RemoveChild( Target.get(), false );
         
         // Destroy Entity Tree
-        DoDestroy( Result );
+        DoDestroy( Target.get() );
     }
     
     return true;
@@ -116,32 +197,60 @@ bool IEntityManager::DestroyEntity( EntityBase *EntityRef )
 
 /*=================================================================================================
      IEntityManager::GetEntity( uint32 EntityId )
-     -> Looks up an Entity in the master list. Returns nullptr if not found
+     -> Looks up an Entity in the slot table. Returns nullptr if not found
  =================================================================================================*/
 EntityBase* IEntityManager::GetEntity( uint32 EntityId )
 {
-    auto Result = EntityStore.find( EntityId );
-    if( Result == EntityStore.end() )
+    auto Result = SlotLookup.find( EntityId );
+    if( Result == SlotLookup.end() )
     {
         return nullptr;
     }
     
-    if( Result->second )
+    return Slots[ Result->second ].Entity.get();
+}
+
+/*=================================================================================================
+     IEntityManager::Resolve( EntityHandle )
+     -> Looks up an Entity by handle, a single array index and generation compare.
+        Returns nullptr if the entity was destroyed, even if its slot was reused since
+ =================================================================================================*/
+EntityBase* IEntityManager::Resolve( const EntityHandle& In )
+{
+    if( In.Index >= Slots.size() || Slots[ In.Index ].Generation != In.Generation )
+        return nullptr;
+    
+    return Slots[ In.Index ].Entity.get();
+}
+
+/*=================================================================================================
+     IEntityManager::ForEachEntity( Func )
+     -> Calls Func for every live entity. Goes by slot index, so Func is free to create
+        entities, which are visited as well
+ =================================================================================================*/
+void IEntityManager::ForEachEntity( const std::function< void( EntityBase* ) >& Func )
+{
+    for( size_t i = 0; i < Slots.size(); i++ )
     {
-        return Result->second.get();
+        EntityBase* Target = Slots[ i ].Entity.get();
+        if( Target )
+            Func( Target );
     }
-    
-    return nullptr;
 }
 
 
 /*=================================================================================================
     static IEntityManager::GetInstance()
     -> Returns a reference to the EntityManager singleton. Ensure return type is explicitly
-       stated as a reference, the copy constructor is deleted, so you will get an error
+       stated as a reference, the copy constructor is deleted, so you will get an error.
+       Inside a match context, this is the manager that belongs to that match instead
  =================================================================================================*/
 IEntityManager& IEntityManager::GetInstance()
 {
+    auto Context = MatchContext::GetCurrent();
+    if( Context )
+        return Context->GetEntities();
+    
     static IEntityManager Singleton;
     return Singleton;
 }
@@ -153,31 +262,33 @@ IEntityManager& IEntityManager::GetInstance()
 IEntityManager::~IEntityManager()
 {
     // Cleanup all entities and delete them
-    for( auto It = EntityStore.begin(); It != EntityStore.end(); It++ )
+    for( auto It = Slots.begin(); It != Slots.end(); It++ )
     {
-        if( It->second )
+        if( It->Entity )
         {
-            It->second->Cleanup();
-            It->second.reset();
+            It->Entity->Cleanup();
+            It->Entity.reset();
         }
     }
     
-    EntityStore.clear();
+    Slots.clear();
+    FreeSlots.clear();
+    SlotLookup.clear();
+    
+    for( auto It = Kinds.begin(); It != Kinds.end(); It++ )
+        It->clear();
 }
 
 std::vector< CardEntity* > IEntityManager::GetAllCards()
 {
+    // Only cards are in this list, so theres nothing to check
+    auto& Cards = Kinds[ (size_t) EntityKind::Card ];
+    
     std::vector< CardEntity* > Output;
+    Output.reserve( Cards.size() );
     
-    for( auto It = Begin(); It != End(); It++ )
-    {
-        if( It->second && It->second->IsCard() )
-        {
-            auto Card = dynamic_cast< CardEntity* >( It->second.get() );
-            if( Card )
-                Output.push_back( Card );
-        }
-    }
+    for( auto It = Cards.begin(); It != Cards.end(); It++ )
+        Output.push_back( static_cast< CardEntity* >( *It ) );
     
     return Output;
 }
@@ -186,9 +297,22 @@ uint32_t IEntityManager::AllocateIdentifier()
 {
     // Increments and returns the next entity Id
     NextEntityId++;
+    
+    if( NextEntityId > HighestEntityId )
+        HighestEntityId = NextEntityId;
+    
     return NextEntityId;
 }
 
+void IEntityManager::ReserveIdentifiers( uint32_t Base )
+{
+    if( NextEntityId < Base )
+        NextEntityId = Base;
+    
+    if( NextEntityId > HighestEntityId )
+        HighestEntityId = NextEntityId;
+}
+
 
 /*=====================================================================================================
  ======================================================================================================
@@ -208,11 +332,13 @@ void EntityBase::Cleanup()
 }
 
 /*=================================================================================================
-    EntityBase::EntityBase( string )
+    EntityBase::EntityBase( string, EntityKind )
     -> Constructor for the EntityBase class. Be sure to call this on construction of any derived
-       entities. Pass in an 'Entity Name'. Doesnt have to be unique
+       entities. Pass in an 'Entity Name'. Doesnt have to be unique. Cards, containers and players
+       pass their kind, so the entity manager can keep them in their own lists
  =================================================================================================*/
-EntityBase::EntityBase( const std::string& Name )
+EntityBase::EntityBase( const std::string& Name, EntityKind InKind /* = EntityKind::Other */ )
+: Kind( InKind )
 {
     EName = Name;
     
@@ -231,6 +357,23 @@ EntityBase::~EntityBase()
     EName.clear();
 }
 
+/*=================================================================================================
+    EntityBase::ResetEntity()
+    -> Puts the base entity state back to how the constructor left it. Called on pooled entities
+       after theyre out of the manager, so the entity tree and resources dont carry over
+ =================================================================================================*/
+void EntityBase::ResetEntity()
+{
+    Position = cocos2d::Vec2::ZERO;
+    Rotation = 0.f;
+    LinkedScene = nullptr;
+    LastActionCallback = 0;
+    
+    ResourceList.clear();
+    Children.clear();
+    Owner = nullptr;
+}
+
 /*=================================================================================================
     EntityBase::AddChild( Entity )
      -> Adds a child entity to this entity. Child Entities are cleaned and destroyed along with the
@@ -441,44 +584,30 @@ void EntityBase::Invalidate()
 }
 
 /*=================================================================================================
-    EntityBase::LoadResources( function( void ) Callback ) -> int
+    EntityBase::LoadResources( TexturePreloader Preloader )
     -> Method is called when resources can be preloaded
-    -> IMPORTANT: Call the 'Callback' whenever a resource is done loading (regardless of success)
-       and be sure to return the number of times 'Callback' will be called by this Entity
-    -> If the returned int, and number of Callbacks dont match, it could cause loading to hang
+    -> Add every texture this entity needs to the preloader, textures other entities need as well
+       are only loaded once, and each callback is run on the main thread when its texture is ready
+    -> GetLoadPriority decides how soon this entities textures are loaded, see PRELOAD_PRIORITY_*
  =================================================================================================*/
 void EntityBase::RequireTexture( const std::string& InTex, std::function< void( cocos2d::Texture2D* ) > Callback )
 {
     ResourceList[ InTex ] = Callback;
 }
 
-int EntityBase::LoadResources( const std::function<void ()> &Callback )
+void EntityBase::LoadResources( TexturePreloader& Preloader )
 {
-    int Output = 0;
-    auto Cache = cocos2d::Director::getInstance()->getTextureCache();
-    
-    CC_ASSERT( Cache );
+    int Priority = GetLoadPriority();
     
     for( auto It = ResourceList.begin(); It != ResourceList.end(); It++ )
     {
-        auto UserCallback = It->second;
-        
-        Cache->addImageAsync( It->first, [ = ]( cocos2d::Texture2D* Texture )
-        {
-            // Run the callback provided by user
-            if( UserCallback )
-                UserCallback( Texture );
-            
-            // Run the callback for the loading system
-            if( Callback )
-                Callback();
-            
-        } );
-        
-        Output++;
+        Preloader.Add( It->first, Priority, It->second );
     }
-    
-    return Output;
+}
+
+int EntityBase::GetLoadPriority() const
+{
+    return PRELOAD_PRIORITY_SCREEN;
 }
 
 /*=================================================================================================
@@ -501,6 +630,9 @@ void EntityBase::FinishAction( std::function< void () > Callback, float Delay /*
     }
     else
     {
+        // Delays wait on animations, so they follow the tween playback speed. Skipped delays still go through the
+        // scheduler, otherwise a long action queue would run through entirely inside this call
+        Delay = TweenSystem::GetInstance().ScaleDelay( Delay );
         cocos2d::Director::getInstance()->getScheduler()->schedule( [=]( float f ) { if( Callback ) Callback(); }, this, Delay, 0, 0.f, false, "ActionFinish_" + std::to_string( LastActionCallback++ ) );
     }
 }
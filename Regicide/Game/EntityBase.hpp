@@ -12,12 +12,41 @@
 
 #include "Numeric.hpp"
 #include <vector>
+#include <array>
+#include <unordered_map>
 #include <future>
 
 namespace Game
 {
     class World;
     class Action;
+    class TexturePreloader;
+    
+    // Entities are stored in a separate list per kind, so systems that only care about one kind never touch the rest
+    enum class EntityKind : uint8_t
+    {
+        Other,
+        Card,
+        Container,
+        Player,
+        Count
+    };
+    
+    // Refers to an entity by its slot in the manager. Slots are reused, but every reuse bumps the generation,
+    // so a handle to a destroyed entity never resolves to whatever took its slot
+    struct EntityHandle
+    {
+        uint32_t Index;
+        uint32_t Generation;
+        
+        EntityHandle()
+        : Index( 0 ), Generation( 0 )
+        {}
+        
+        inline bool IsNull() const { return Generation == 0; }
+        inline bool operator== ( const EntityHandle& Other ) const { return Index == Other.Index && Generation == Other.Generation; }
+        inline bool operator!= ( const EntityHandle& Other ) const { return !( *this == Other ); }
+    };
     
     class EntityBase
     {
@@ -53,28 +82,33 @@ namespace Game
         float GetAbsoluteRotation() const;
         
         virtual void Invalidate();
-        inline bool IsCard() const { return _bIsCard; }
+        inline bool IsCard() const { return Kind == EntityKind::Card; }
+        inline EntityKind GetKind() const { return Kind; }
+        inline EntityHandle GetHandle() const { return Handle; }
         void RequireTexture( const std::string& InTex, std::function< void( cocos2d::Texture2D* ) > Callback );
         
     protected:
         
         virtual void Cleanup();
-        EntityBase( const std::string& Name );
+        EntityBase( const std::string& Name, EntityKind InKind = EntityKind::Other );
         virtual ~EntityBase();
         
+        // Puts the base state back to how it was after construction, for entities that get pooled
+        void ResetEntity();
+        
         cocos2d::Scene* LinkedScene;
         
         // Relative to parent
         cocos2d::Vec2 Position;
         float Rotation;
         
-        virtual int LoadResources( const std::function< void() >& Callback );
+        virtual void LoadResources( TexturePreloader& Preloader );
+        virtual int GetLoadPriority() const;
         
         std::vector< EntityBase* >::iterator ChildBegin() { return Children.begin(); }
         std::vector< EntityBase* >::iterator ChildEnd() { return Children.end(); }
         
         World* GetWorld() const;
-        bool _bIsCard;
         
         std::map< std::string, std::function< void( cocos2d::Texture2D* ) > > ResourceList;
         
@@ -84,6 +118,8 @@ namespace Game
     private:
         
         uint32 EID;
+        EntityHandle Handle;
+        const EntityKind Kind;
         std::string EName;
         std::vector< EntityBase* > Children;
         EntityBase* Owner = nullptr;
@@ -95,10 +131,11 @@ namespace Game
     };
     
     
-    typedef std::map< uint32, std::shared_ptr< EntityBase > >::iterator EntityIter;
-    typedef std::map< uint32, std::shared_ptr< EntityBase > >::const_iterator ConstEntityIter;
     class CardEntity;
     
+    // Entities live in a slot map. Each slot holds the entity and its generation, ids map to slots through a hash
+    // table, and each kind has a packed list of its entities, so looking up an id, checking a handle, and walking
+    // every card are all flat array work, with no tree walks and no dynamic casts
     class IEntityManager
     {
         
@@ -118,14 +155,21 @@ namespace Game
         bool DestroyEntity( EntityBase* EntityRef );
         EntityBase* GetEntity( uint32 EntityId );
         
-        inline EntityIter Begin() { return EntityStore.begin(); }
-        inline EntityIter End() { return EntityStore.end(); }
+        template< typename T >
+        T* GetEntity( uint32 EntityId );
         
-        inline ConstEntityIter Begin() const { return EntityStore.begin(); }
-        inline ConstEntityIter End() const { return EntityStore.end(); }
+        // Null if the entity this handle pointed to is gone
+        EntityBase* Resolve( const EntityHandle& In );
         
         template< typename T >
-        T* GetEntity( uint32 EntityId );
+        T* Resolve( const EntityHandle& In );
+        
+        // Every live entity of one kind, in no particular order. Creating or destroying entities changes the list,
+        // so copy it first when doing either while iterating
+        inline const std::vector< EntityBase* >& GetEntities( EntityKind Kind ) const { return Kinds[ (size_t) Kind ]; }
+        
+        // Calls Func for every live entity, entities created by Func are visited too
+        void ForEachEntity( const std::function< void( EntityBase* ) >& Func );
         
         static IEntityManager& GetInstance();
         
@@ -135,19 +179,45 @@ namespace Game
         
         uint32_t AllocateIdentifier();
         
+        // Moves the id counter up to Base, so ids allocated from here on never fall below it
+        void ReserveIdentifiers( uint32_t Base );
+        
     private:
         
-        std::map< uint32, std::shared_ptr< EntityBase > > EntityStore;
+        struct Slot
+        {
+            std::shared_ptr< EntityBase > Entity;
+            uint32_t Generation = 0;
+            
+            // Position in the kind list, so removal is a swap with the last entry
+            uint32_t KindIndex = 0;
+        };
+        
+        std::vector< Slot > Slots;
+        std::vector< uint32_t > FreeSlots;
+        std::unordered_map< uint32, uint32_t > SlotLookup;
+        std::array< std::vector< EntityBase* >, (size_t) EntityKind::Count > Kinds;
         
         // Explicitly disallow copying
         IEntityManager() {}
         IEntityManager( const IEntityManager& Other ) = delete;
         IEntityManager& operator= ( const IEntityManager& Other ) = delete;
         
+        void Insert( uint32 EntityId, std::shared_ptr< EntityBase >&& In );
+        
+        // Inserts an entity that was built earlier and kept around, like a pooled card
+        void Adopt( uint32 EntityId, std::shared_ptr< EntityBase >&& In );
+        
         void CallCleanup( EntityBase* In );
-        void DoDestroy( std::map< uint32, std::shared_ptr< EntityBase > >::iterator Iter );
+        void DoDestroy( EntityBase* In );
+        
+        friend class MatchContext;
+        friend class CardManager;
         
         uint32_t NextEntityId = 0;
+        
+        // Ids can also come from the server, so this can be higher than the counter
+        uint32_t HighestEntityId = 0;
     };
     
     template< typename T >
@@ -157,11 +227,13 @@ namespace Game
         
         // Create the entity
         uint32 EntId = AllocateIdentifier();
-        EntityStore[ EntId ] = std::make_shared< T >();
-        EntityStore[ EntId ]->EID = EntId;
+        auto Entity = std::make_shared< T >();
+        T* Output = Entity.get();
+        
+        Insert( EntId, std::move( Entity ) );
         
         // Return pointer to the entity
-        return static_cast<T*>( EntityStore[ EntId ].get() );
+        return Output;
     }
     
     template< typename T >
@@ -170,12 +242,17 @@ namespace Game
         static_assert( std::is_base_of< EntityBase, T >::value, "Attempt to create Entity with non-entity type" );
         
         // Check if this Id is already in use
-        CCASSERT( EntityStore.count( AllocatedId ) == 0, "Attempt to create entity with in-use Id!" );
+        CCASSERT( SlotLookup.count( AllocatedId ) == 0, "Attempt to create entity with in-use Id!" );
+        
+        auto Entity = std::make_shared< T >();
+        T* Output = Entity.get();
         
-        EntityStore[ AllocatedId ] = std::make_shared< T >();
-        EntityStore[ AllocatedId ]->EID = AllocatedId;
+        Insert( AllocatedId, std::move( Entity ) );
         
-        return static_cast< T* >( EntityStore[ AllocatedId ].get() ); 
+        if( AllocatedId > HighestEntityId )
+            HighestEntityId = AllocatedId;
+        
+        return Output;
     }
     
     // Adds entity directly to scene, this should be used at game runtime
@@ -200,20 +277,18 @@ namespace Game
     {
         static_assert( std::is_base_of< EntityBase, T >::value, "Attempt to get entity casted to a non-entity type!" );
         
-        // We can check if the Id is out of range without calling into the map
-        if( EntityId > NextEntityId || EntityId <= 0 )
+        // We can check if the Id is out of range without calling into the table
+        if( EntityId > HighestEntityId || EntityId <= 0 )
             return nullptr;
         
-        auto Result = EntityStore.find( EntityId );
-        if( Result == EntityStore.end() )
-            return nullptr;
-        
-        if( Result->second )
-        {
-            return static_cast< T* >( Result->second.get() );
-        }
-        
-        return nullptr;
+        return static_cast< T* >( GetEntity( EntityId ) );
+    }
+    
+    template< typename T >
+    T* IEntityManager::Resolve( const EntityHandle& In )
+    {
+        static_assert( std::is_base_of< EntityBase, T >::value, "Attempt to resolve entity casted to a non-entity type!" );
+        return static_cast< T* >( Resolve( In ) );
     }
     
 }
@@ -17,7 +17,7 @@
 using namespace Game;
 
 FieldEntity::FieldEntity()
-: EntityBase( "Field" )
+: EntityBase( "Field", EntityKind::Container )
 {
     SetTag( TAG_FIELD );
 }
@@ -261,7 +261,7 @@ bool FieldEntity::RemoveRandom( bool bDestroy /* = false */ )
     return true;
 }
 
-void FieldEntity::InvalidateCards( CardEntity* Ignore /* = nullptr */ )
+void FieldEntity::LayoutCards( CardEntity* Ignore )
 {
     if( _bInvalidatePaused )
         return;
@@ -274,7 +274,9 @@ void FieldEntity::InvalidateCards( CardEntity* Ignore /* = nullptr */ )
     {
         if( (*It) && *It != Ignore && !(*It)->GetIsDragging() )
         {
-            (*It)->MoveAnimation( CalcPos( Index, 0 ), 0.3f );
+            auto Target = CalcPos( Index, 0 );
+            if( (*It)->NeedsMove( Target ) )
+                (*It)->MoveAnimation( Target, 0.3f );
         }
         
         Index++;
@@ -302,7 +304,7 @@ cocos2d::Vec2 FieldEntity::CalcPos( int Index, int CardDelta )
     if( Cards.empty() || !Cards.front() )
         return GetPosition();
     
-    auto size = cocos2d::Director::getInstance()->getVisibleSize();
+    auto& size = GetLayoutSize();
     
     auto ct = (int)Count() - 1;
     float CardWidth = Cards.front()->GetWidth();
@@ -52,7 +52,6 @@ namespace Game
         virtual void Invalidate() override;
         
         void InvalidateZOrder();
-        virtual void InvalidateCards( CardEntity* Ignore = nullptr ) override;
         
         int AttemptDrop( CardEntity* inCard, const cocos2d::Vec2& inPos );
         void PauseInvalidate();
@@ -65,6 +64,8 @@ namespace Game
         
         std::deque< CardEntity* > Cards;
         
+        virtual void LayoutCards( CardEntity* Ignore ) override;
+        
         void MoveCard( CardEntity* inCard, const cocos2d::Vec2& AbsPos, std::function< void() > Callback );
         cocos2d::Vec2 CalcPos( int Index, int CardDelta = 0 );
         
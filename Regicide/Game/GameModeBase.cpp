@@ -18,6 +18,7 @@
 #include "KingEntity.hpp"
 #include "Scenes/GameScene.hpp"
 #include "SingleplayerAuthority.hpp"
+#include "CardAnimations.hpp"
 
 using namespace Game;
 
@@ -27,27 +28,27 @@ GameModeBase::GameModeBase()
 {
     using namespace std::placeholders;
     
-    AddAction( "PlayCard",      std::bind( &GameModeBase::OnCardPlay,       this, _1, _2 ) );
-    AddAction( "UpdateMana",    std::bind( &GameModeBase::OnManaUpdate,     this, _1, _2 ) );
-    AddAction( "DrawCard",      std::bind( &GameModeBase::OnCardDraw,       this, _1, _2 ) );
-    AddAction( "CoinFlip",      std::bind( &GameModeBase::OnCoinFlip,       this, _1, _2 ) );
-    AddAction( "BlitzStart",    std::bind( &GameModeBase::OnBlitzStart,     this, _1, _2 ) );
-    AddAction( "BlitzQuery",    std::bind( &GameModeBase::OnBlitzQuery,     this, _1, _2 ) );
-    AddAction( "BlitzError",    std::bind( &GameModeBase::OnBlitzError,     this, _1, _2 ) );
-    AddAction( "BlitzSuccess",  std::bind( &GameModeBase::OnBlitzSuccess,   this, _1, _2 ) );
-    AddAction( "AttackError",   std::bind( &GameModeBase::OnAttackError,    this, _1, _2 ) );
-    AddAction( "MatchStart",    std::bind( &GameModeBase::OnMatchStart,     this, _1, _2 ) );
-    AddAction( "TurnStart",     std::bind( &GameModeBase::OnTurnStart,      this, _1, _2 ) );
-    AddAction( "MarshalStart",  std::bind( &GameModeBase::OnMarshalStart,   this, _1, _2 ) );
-    AddAction( "AttackStart",   std::bind( &GameModeBase::OnAttackStart,    this, _1, _2 ) );
-    AddAction( "BlockStart",    std::bind( &GameModeBase::OnBlockStart,     this, _1, _2 ) );
-    AddAction( "TurnFinish",    std::bind( &GameModeBase::OnTurnFinish,     this, _1, _2 ) );
-    AddAction( "DamageStart",   std::bind( &GameModeBase::OnDamageStart,    this, _1, _2 ) );
-    AddAction( "Damage",        std::bind( &GameModeBase::OnDamage,         this, _1, _2 ) );
-    AddAction( "Combat",        std::bind( &GameModeBase::OnCombat,         this, _1, _2 ) );
-    AddAction( "UpdateStamina", std::bind( &GameModeBase::OnStaminaUpdate,  this, _1, _2 ) );
-    AddAction( "CleanupBoard",  std::bind( &GameModeBase::OnBoardCleanup,   this, _1, _2 ) );
-    AddAction( "BattleMatrix",  std::bind( &GameModeBase::OnMatrixUpdate,   this, _1, _2 ) );
+    AddAction( ActionId::PlayCard,      std::bind( &GameModeBase::OnCardPlay,       this, _1, _2 ) );
+    AddAction( ActionId::UpdateMana,    std::bind( &GameModeBase::OnManaUpdate,     this, _1, _2 ) );
+    AddAction( ActionId::DrawCard,      std::bind( &GameModeBase::OnCardDraw,       this, _1, _2 ) );
+    AddAction( ActionId::CoinFlip,      std::bind( &GameModeBase::OnCoinFlip,       this, _1, _2 ) );
+    AddAction( ActionId::BlitzStart,    std::bind( &GameModeBase::OnBlitzStart,     this, _1, _2 ) );
+    AddAction( ActionId::BlitzQuery,    std::bind( &GameModeBase::OnBlitzQuery,     this, _1, _2 ) );
+    AddAction( ActionId::BlitzError,    std::bind( &GameModeBase::OnBlitzError,     this, _1, _2 ) );
+    AddAction( ActionId::BlitzSuccess,  std::bind( &GameModeBase::OnBlitzSuccess,   this, _1, _2 ) );
+    AddAction( ActionId::AttackError,   std::bind( &GameModeBase::OnAttackError,    this, _1, _2 ) );
+    AddAction( ActionId::MatchStart,    std::bind( &GameModeBase::OnMatchStart,     this, _1, _2 ) );
+    AddAction( ActionId::TurnStart,     std::bind( &GameModeBase::OnTurnStart,      this, _1, _2 ) );
+    AddAction( ActionId::MarshalStart,  std::bind( &GameModeBase::OnMarshalStart,   this, _1, _2 ) );
+    AddAction( ActionId::AttackStart,   std::bind( &GameModeBase::OnAttackStart,    this, _1, _2 ) );
+    AddAction( ActionId::BlockStart,    std::bind( &GameModeBase::OnBlockStart,     this, _1, _2 ) );
+    AddAction( ActionId::TurnFinish,    std::bind( &GameModeBase::OnTurnFinish,     this, _1, _2 ) );
+    AddAction( ActionId::DamageStart,   std::bind( &GameModeBase::OnDamageStart,    this, _1, _2 ) );
+    AddAction( ActionId::Damage,        std::bind( &GameModeBase::OnDamage,         this, _1, _2 ) );
+    AddAction( ActionId::Combat,        std::bind( &GameModeBase::OnCombat,         this, _1, _2 ) );
+    AddAction( ActionId::UpdateStamina, std::bind( &GameModeBase::OnStaminaUpdate,  this, _1, _2 ) );
+    AddAction( ActionId::CleanupBoard,  std::bind( &GameModeBase::OnBoardCleanup,   this, _1, _2 ) );
+    AddAction( ActionId::BattleMatrix,  std::bind( &GameModeBase::OnMatrixUpdate,   this, _1, _2 ) );
     
     State.mState = MatchState::PreMatch;
     State.pState = PlayerTurn::None;
@@ -94,6 +95,15 @@ void GameModeBase::Cleanup()
     
     ActiveQueues.clear();
     
+    auto& Tweens = TweenSystem::GetInstance();
+    Tweens.SetTimeScale( 1.f );
+    Tweens.SetInstant( false );
+    
+#ifdef ACTION_STREAM_FILE
+    if( !Recorder.IsEmpty() )
+        Recorder.Save( cocos2d::FileUtils::getInstance()->getWritablePath() + ACTION_STREAM_FILE );
+#endif
+    
     _DoCloseViewer();
     CloseGraveyardViewer();
 }
@@ -106,6 +116,10 @@ void GameModeBase::TouchBegan( cocos2d::Touch *inTouch, CardEntity *inCard )
 {
     if( !_bSelectionEnabled )
     {
+        // Tapping while actions are playing skips to the end of them
+        if( !ActiveQueues.empty() )
+            SkipPlayback();
+        
         _bDrag = false;
         if( _touchedCard )
             _touchedCard->SetIsDragging( false );
@@ -607,6 +621,9 @@ void GameModeBase::OnActionQueue()
 void GameModeBase::EnableSelection()
 {
     _bSelectionEnabled = true;
+    
+    // The player has control again, so anything after this plays normally
+    TweenSystem::GetInstance().SetInstant( false );
 }
 
 void GameModeBase::DisableSelection()
@@ -791,26 +808,26 @@ void GameModeBase::PostInit()
     cocos2d::Director::getInstance()->getScheduler()->schedule( std::bind( &GameModeBase::Tick, this, std::placeholders::_1 ), this, 0.f, CC_REPEAT_FOREVER, 0.f, false, "GMTick" );
 }
 
-void GameModeBase::AddAction( const std::string& In, std::function< void( Action*, std::function< void() > ) > Handler )
+void GameModeBase::AddAction( ActionId In, std::function< void( Action*, std::function< void() > ) > Handler )
 {
-    ActionHandlers[ In ] = Handler;
+    if( In >= ActionId::Count )
+        return;
+    
+    ActionHandlers[ (size_t) In ] = Handler;
 }
 
 void GameModeBase::RunAction( Action& Target, std::function< void() > Callback )
 {
-    // Check if a callback exists for this action name
-    if( ActionHandlers.count( Target.Name ) <= 0 )
+    // Check if a callback exists for this action id
+    if( Target.Id >= ActionId::Count || !ActionHandlers[ (size_t) Target.Id ] )
     {
-        cocos2d::log( "[GM] No action handler bound to '%s'", Target.Name.c_str() );
+        cocos2d::log( "[GM] No action handler bound to '%s'", Target.GetName() );
         Callback();
         return;
     }
     
-    auto& Func = ActionHandlers[ Target.Name ];
-    if( Func )
-    {
-        Func( &Target, Callback );
-    }
+    InvalidateActionTargets( Target );
+    ActionHandlers[ (size_t) Target.Id ]( &Target, Callback );
 }
 
 void GameModeBase::PopQueue( ActionQueue& Target )
@@ -835,24 +852,19 @@ void GameModeBase::PopQueue( ActionQueue& Target )
         if( ActiveQueues.empty() )
         {
             _bCheckPossibleActions = true;
+            TweenSystem::GetInstance().SetTimeScale( 1.f );
             EnableSelection();
         }
         
         return;
     }
     
-    if( Target.Actions[ Target.Position ]->Name == "Parallel" )
+    UpdatePlayback();
+    
+    if( Target.Actions[ Target.Position ]->Type == ActionType::Parallel )
     {
         // Parallel Actions!
-        ParallelAction* Parallel = dynamic_cast< ParallelAction* >( Target.Actions[ Target.Position ].get() );
-        if( !Parallel )
-        {
-            cocos2d::log( "[GM] Invalid parallel action in queue!" );
-            
-            Target.Position++;
-            PopQueue( Target );
-            return;
-        }
+        ParallelAction* Parallel = static_cast< ParallelAction* >( Target.Actions[ Target.Position ] );
         
         for( auto It = Parallel->Actions.begin(); It != Parallel->Actions.end(); It++ )
         {
@@ -884,6 +896,65 @@ void GameModeBase::PopQueue( ActionQueue& Target )
     }
 }
 
+void GameModeBase::CollapseQueue( ActionQueue& Target )
+{
+    size_t Kept = 0;
+    for( size_t i = 0; i < Target.Actions.size(); i++ )
+    {
+        auto* Current   = Target.Actions[ i ];
+        auto* Next      = i + 1 < Target.Actions.size() ? Target.Actions[ i + 1 ] : nullptr;
+        
+        // Mana and stamina updates carry the final amount, so only the last one in a row for the same target matters
+        // A stamina update that kills the card still has to play, since it sends the card to the grave
+        auto* Mana      = ActionCast< UpdateManaAction >( Current );
+        auto* NextMana  = ActionCast< UpdateManaAction >( Next );
+        
+        if( Mana && NextMana && Mana->TargetPlayer == NextMana->TargetPlayer )
+            continue;
+        
+        auto* Stamina       = ActionCast< UpdateStaminaAction >( Current );
+        auto* NextStamina   = ActionCast< UpdateStaminaAction >( Next );
+        
+        if( Stamina && NextStamina && Stamina->Target == NextStamina->Target && Stamina->UpdatedAmount > 0 )
+            continue;
+        
+        Target.Actions[ Kept++ ] = Current;
+    }
+    
+    // The arena still owns the dropped actions, theyre freed along with the queue
+    if( Kept < Target.Actions.size() )
+    {
+        cocos2d::log( "[GM] Collapsed %d redundant actions from queue", (int)( Target.Actions.size() - Kept ) );
+        Target.Actions.resize( Kept );
+    }
+}
+
+void GameModeBase::UpdatePlayback()
+{
+    size_t Depth = 0;
+    for( auto It = ActiveQueues.begin(); It != ActiveQueues.end(); It++ )
+    {
+        if( It->second.Position < It->second.Actions.size() )
+            Depth += It->second.Actions.size() - It->second.Position;
+    }
+    
+    float Scale = 1.f;
+    if( Depth > PLAYBACK_TURBO_DEPTH )
+        Scale = std::min( 1.f + (float)( Depth - PLAYBACK_TURBO_DEPTH ) * PLAYBACK_TURBO_STEP, PLAYBACK_TURBO_MAX );
+    
+    TweenSystem::GetInstance().SetTimeScale( Scale );
+}
+
+void GameModeBase::SkipPlayback()
+{
+    auto& Tweens = TweenSystem::GetInstance();
+    if( Tweens.IsInstant() )
+        return;
+    
+    cocos2d::log( "[GM] Skipping to the end of %d active action queues", (int) ActiveQueues.size() );
+    Tweens.SetInstant( true );
+}
+
 void GameModeBase::RunActionQueue( ActionQueue&& In )
 {
     if( State.mState == MatchState::PostMatch )
@@ -908,6 +979,13 @@ void GameModeBase::RunActionQueue( ActionQueue&& In )
         return;
     }
     
+#ifdef ACTION_STREAM_FILE
+    auto Auth = GetAuthority< AuthorityBase >();
+    Recorder.RecordQueue( In, Auth ? std::addressof( Auth->GetState() ) : nullptr );
+#endif
+    
+    CollapseQueue( In );
+    
     // Create new entry
     auto Entry = ActiveQueues.insert( std::make_pair( In.Identifier, std::move( In ) ) );
     
@@ -1002,11 +1080,11 @@ bool GameModeBase::CanCardBlock( CardEntity *In, CardEntity *Target )
 
 bool GameModeBase::CanTriggerAbility( CardEntity* In )
 {
-    // Check if any abilities can be activated
+    // Check if any abilities can be activated, abilities are paid for by the cards owner
     if( !In )
         return false;
     
-    auto Player = GetPlayer();
+    auto Player = In->GetOwningPlayer();
     if( !Player )
         return false;
     
@@ -1059,6 +1137,146 @@ bool GameModeBase::CanTriggerAbility( CardEntity* In, uint8_t AbilityId )
     return true;
 }
 
+bool GameModeBase::CanTriggerAbilityCached( CardEntity* In )
+{
+    if( !In )
+        return false;
+    
+    // The result depends on the owners mana, not the local players, or opponent cards would be cached against the wrong pool
+    auto Owner = In->GetOwningPlayer();
+    if( !Owner )
+        return false;
+    
+    // Checks can look at the opposing field (Blind Smite only triggers when theres something to hit)
+    auto Other = Owner == GetOpponent() ? GetPlayer() : GetOpponent();
+    auto OtherField = Other ? Other->GetField() : nullptr;
+    
+    AbilityCheck Key;
+    Key.Owner         = Owner->GetEntityId();
+    Key.OpponentField = OtherField ? OtherField->GetRevision() : 0;
+    Key.Container     = In->GetContainer();
+    Key.Mana          = Owner->GetMana();
+    Key.Stamina       = In->Stamina;
+    Key.tState        = State.tState;
+    Key.pState        = State.pState;
+    Key.bResult       = false;
+    
+    auto Entry = AbilityChecks.find( In->GetEntityId() );
+    if( Entry != AbilityChecks.end() )
+    {
+        auto& Cached = Entry->second;
+        if( Cached.Owner == Key.Owner && Cached.Container == Key.Container && Cached.Mana == Key.Mana &&
+           Cached.Stamina == Key.Stamina && Cached.tState == Key.tState && Cached.pState == Key.pState &&
+           Cached.OpponentField == Key.OpponentField )
+            return Cached.bResult;
+    }
+    
+    Key.bResult = CanTriggerAbility( In );
+    AbilityChecks[ In->GetEntityId() ] = Key;
+    
+    return Key.bResult;
+}
+
+void GameModeBase::InvalidateTarget( uint32_t EntId )
+{
+    auto Player     = GetPlayer();
+    auto Opponent   = GetOpponent();
+    
+    if( ( Player && Player->GetEntityId() == EntId ) || ( Opponent && Opponent->GetEntityId() == EntId ) )
+        InvalidatePlayer( EntId );
+    else
+        AbilityChecks.erase( EntId );
+}
+
+void GameModeBase::InvalidatePlayer( uint32_t PlayerId )
+{
+    for( auto It = AbilityChecks.begin(); It != AbilityChecks.end(); )
+    {
+        if( It->second.Owner == PlayerId )
+            It = AbilityChecks.erase( It );
+        else
+            It++;
+    }
+}
+
+void GameModeBase::InvalidateActionTargets( Action& In )
+{
+    switch( In.Type )
+    {
+        case ActionType::PlayCard:
+        {
+            auto Play = ActionCast< PlayCardAction >( std::addressof( In ) );
+            InvalidateTarget( Play->TargetCard );
+            InvalidatePlayer( Play->TargetPlayer );
+            break;
+        }
+        case ActionType::UpdateMana:
+            InvalidatePlayer( ActionCast< UpdateManaAction >( std::addressof( In ) )->TargetPlayer );
+            break;
+        case ActionType::DrawCard:
+        {
+            auto Draw = ActionCast< DrawCardAction >( std::addressof( In ) );
+            InvalidateTarget( Draw->TargetCard );
+            InvalidatePlayer( Draw->TargetPlayer );
+            break;
+        }
+        case ActionType::LoadCard:
+            InvalidateTarget( ActionCast< LoadCardAction >( std::addressof( In ) )->CardId );
+            break;
+        case ActionType::Damage:
+        {
+            auto Damage = ActionCast< DamageAction >( std::addressof( In ) );
+            InvalidateTarget( Damage->Target );
+            InvalidateTarget( Damage->Inflictor );
+            break;
+        }
+        case ActionType::UpdateStamina:
+        {
+            auto Stamina = ActionCast< UpdateStaminaAction >( std::addressof( In ) );
+            InvalidateTarget( Stamina->Target );
+            InvalidateTarget( Stamina->Inflictor );
+            break;
+        }
+        case ActionType::Combat:
+        {
+            auto Combat = ActionCast< CombatAction >( std::addressof( In ) );
+            InvalidateTarget( Combat->Attacker );
+            InvalidateTarget( Combat->Blocker );
+            break;
+        }
+        case ActionType::PlayerEvent:
+            InvalidatePlayer( ActionCast< PlayerEventAction >( std::addressof( In ) )->Player );
+            break;
+        case ActionType::CardList:
+        {
+            auto List = ActionCast< CardListEvent >( std::addressof( In ) );
+            for( auto It = List->Cards.begin(); It != List->Cards.end(); It++ )
+                InvalidateTarget( *It );
+            break;
+        }
+        case ActionType::BattleMatrix:
+        {
+            auto Matrix = ActionCast< BattleMatrixAction >( std::addressof( In ) );
+            for( auto It = Matrix->Matrix.begin(); It != Matrix->Matrix.end(); It++ )
+            {
+                InvalidateTarget( It->first );
+                for( auto Blocker = It->second.begin(); Blocker != It->second.end(); Blocker++ )
+                    InvalidateTarget( *Blocker );
+            }
+            break;
+        }
+        case ActionType::CoinFlip:
+        case ActionType::TurnStart:
+        case ActionType::Win:
+            // Abilities can be limited per turn, so a new turn starts with nothing cached
+            AbilityChecks.clear();
+            break;
+        default:
+            // Events, queries and errors dont change the state
+            break;
+    }
+}
+
 bool GameModeBase::TriggerAbility( CardEntity *Target, uint8_t AbilityId )
 {
     if( !Target )
@@ -1174,8 +1392,35 @@ void GameModeBase::FinishTurn()
 }
 
 
+void GameModeBase::FlushLayouts()
+{
+    Player* Players[] = { GetPlayer(), GetOpponent() };
+    
+    for( auto* Pl : Players )
+    {
+        if( !Pl )
+            continue;
+        
+        if( Pl->GetDeck() )
+            Pl->GetDeck()->FlushLayout();
+        if( Pl->GetHand() )
+            Pl->GetHand()->FlushLayout();
+        if( Pl->GetField() )
+            Pl->GetField()->FlushLayout();
+        if( Pl->GetGraveyard() )
+            Pl->GetGraveyard()->FlushLayout();
+    }
+}
+
+
 void GameModeBase::Tick( float Delta )
 {
+    // Containers can be invalidated many times in a frame, the cards are only moved once
+    FlushLayouts();
+    
+    // Bakes cards that changed and have settled, and swaps in the ones baked last tick
+    CardManager::GetInstance().GetRenderCache().Flush();
+    
     if( _bCheckPossibleActions )
     {
         _bCheckPossibleActions = false;
@@ -1197,7 +1442,7 @@ void GameModeBase::Tick( float Delta )
                     {
                         for( auto It = Hand->Begin(); It != Hand->End(); It++ )
                         {
-                            if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1213,7 +1458,7 @@ void GameModeBase::Tick( float Delta )
                     {
                         for( auto It = Field->Begin(); It != Field->End(); It++ )
                         {
-                            if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1233,7 +1478,7 @@ void GameModeBase::Tick( float Delta )
                             {
                                 ActionableCards.push_back( *It );
                             }
-                            else if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            else if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1246,7 +1491,7 @@ void GameModeBase::Tick( float Delta )
                     {
                         for( auto It = Hand->Begin(); It != Hand->End(); It++ )
                         {
-                            if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1269,7 +1514,7 @@ void GameModeBase::Tick( float Delta )
                             {
                                 ActionableCards.push_back( *It );
                             }
-                            else if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            else if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1281,7 +1526,7 @@ void GameModeBase::Tick( float Delta )
                     {
                         for( auto It = Hand->Begin(); It != Hand->End(); It++ )
                         {
-                            if( *It && CanTriggerAbility( *It ) && !TurnFinished )
+                            if( *It && !TurnFinished && CanTriggerAbilityCached( *It ) )
                             {
                                 AbilityCards.push_back( *It );
                             }
@@ -1388,7 +1633,7 @@ void GameModeBase::OnCardDied( CardEntity *Target )
 
 void GameModeBase::OnCardPlay( Action* In, std::function< void() > Callback )
 {
-    PlayCardAction* PlayAction = dynamic_cast< PlayCardAction* >( In );
+    PlayCardAction* PlayAction = ActionCast< PlayCardAction >( In );
     if( !PlayAction )
     {
         cocos2d::log( "[GM] Invalid Action! Attempt to run 'PlayCardAction' with invalid action" );
@@ -1448,7 +1693,7 @@ void GameModeBase::OnCardPlay( Action* In, std::function< void() > Callback )
 
 void GameModeBase::OnManaUpdate( Action *In, std::function<void ()> Callback )
 {
-    UpdateManaAction* Update = dynamic_cast< UpdateManaAction* >( In );
+    UpdateManaAction* Update = ActionCast< UpdateManaAction >( In );
     if( !Update )
     {
         cocos2d::log( "[GM] Invalid Action! Couldnt cast to UpdateManaAction!" );
@@ -1471,7 +1716,7 @@ void GameModeBase::OnManaUpdate( Action *In, std::function<void ()> Callback )
 
 void GameModeBase::OnCardDraw( Action *In, std::function< void () > Callback )
 {
-    DrawCardAction* Draw = dynamic_cast< DrawCardAction* >( In );
+    DrawCardAction* Draw = ActionCast< DrawCardAction >( In );
     if( !Draw )
     {
         cocos2d::log( "[GM] Invalid Action! Couldnt cast to DrawCardAction" );
@@ -1507,7 +1752,7 @@ void GameModeBase::OnCardDraw( Action *In, std::function< void () > Callback )
 
 void GameModeBase::OnCoinFlip( Action* In, std::function< void() > Callback )
 {
-    CoinFlipAction* CoinFlip = dynamic_cast< CoinFlipAction* >( In );
+    CoinFlipAction* CoinFlip = ActionCast< CoinFlipAction >( In );
     if( !CoinFlip )
     {
         cocos2d::log( "[GM] Invalid Coin Flip Action! Cast Failed!" );
@@ -1533,7 +1778,7 @@ void GameModeBase::OnBlitzStart( Action* In, std::function< void() > Callback )
 
 void GameModeBase::OnBlitzQuery( Action* In, std::function< void() > Callback )
 {
-    TimedQueryAction* Query = dynamic_cast< TimedQueryAction* >( In );
+    TimedQueryAction* Query = ActionCast< TimedQueryAction >( In );
     if( !Query )
     {
         cocos2d::log( "[GM] Invalid Blitz Query! Cast Failed!" );
@@ -1557,7 +1802,7 @@ void GameModeBase::OnBlitzQuery( Action* In, std::function< void() > Callback )
 
 void GameModeBase::OnBlitzError( Action* In, std::function< void() > Callback )
 {
-    CardErrorAction* Err = dynamic_cast< CardErrorAction* >( In );
+    CardErrorAction* Err = ActionCast< CardErrorAction >( In );
     if( !Err )
     {
         cocos2d::log( "[GM] Invalid Blitz Error! Cast Failed" );
@@ -1595,7 +1840,7 @@ void GameModeBase::OnBlitzError( Action* In, std::function< void() > Callback )
 void GameModeBase::OnBlitzSuccess( Action *In, std::function<void ()> Callback )
 {
     // Check which player finished selecting blitz cards
-    PlayerEventAction* Event = dynamic_cast< PlayerEventAction* >( In );
+    PlayerEventAction* Event = ActionCast< PlayerEventAction >( In );
     if( !Event )
     {
         cocos2d::log( "[GM] Invalid Blitz Success! Cast Failed!" );
@@ -1634,7 +1879,7 @@ void GameModeBase::OnBlitzSuccess( Action *In, std::function<void ()> Callback )
 
 void GameModeBase::OnAttackError( Action* In, std::function< void() > Callback )
 {
-    CardErrorAction* Err = dynamic_cast< CardErrorAction* >( In ); 
+    CardErrorAction* Err = ActionCast< CardErrorAction >( In ); 
     if( !Err )
     {
         cocos2d::log( "[GM] Invalid Attack Error! Cast Failed!" );
@@ -1677,7 +1922,7 @@ void GameModeBase::OnMatchStart( Action* In, std::function< void() > Callback )
 
 void GameModeBase::OnTurnStart( Action* In, std::function< void() > Callback )
 {
-    TurnStartAction* TurnStart = dynamic_cast< TurnStartAction* >( In );
+    TurnStartAction* TurnStart = ActionCast< TurnStartAction >( In );
     if( !TurnStart )
     {
         cocos2d::log( "[GM] Invalid Turn Start! Cast Failed!" );
@@ -1799,7 +2044,7 @@ void GameModeBase::OnDamageStart( Action* In, std::function< void() > Callback )
 
 void GameModeBase::OnDamage( Action *In, std::function<void ()> Callback )
 {
-    DamageAction* Damage = dynamic_cast< DamageAction* >( In );
+    DamageAction* Damage = ActionCast< DamageAction >( In );
     if( !Damage )
     {
         cocos2d::log( "[GM] Invalid Card Damage Action! Cast Failed!" );
@@ -1863,7 +2108,7 @@ void GameModeBase::OnDamage( Action *In, std::function<void ()> Callback )
 
 void GameModeBase::OnCombat( Action *In, std::function< void() > Callback )
 {
-    CombatAction* Combat = dynamic_cast< CombatAction* >( In );
+    CombatAction* Combat = ActionCast< CombatAction >( In );
     if( !Combat )
     {
         cocos2d::log( "[GM] Invalid Combat Action! Cast Failed!" );
@@ -1937,7 +2182,7 @@ void GameModeBase::OnCombat( Action *In, std::function< void() > Callback )
 
 void GameModeBase::OnStaminaUpdate( Action* In, std::function< void() > Callback )
 {
-    UpdateStaminaAction* Update = dynamic_cast< UpdateStaminaAction* >( In );
+    UpdateStaminaAction* Update = ActionCast< UpdateStaminaAction >( In );
     if( !Update )
     {
         cocos2d::log( "[GM] Invalid Stamina Update! Cast Failed!" );
@@ -1998,7 +2243,7 @@ void GameModeBase::OnBoardCleanup( Action* In, std::function< void() > Callback
 
 void GameModeBase::OnMatrixUpdate( Action *In, std::function<void ()> Callback )
 {
-    BattleMatrixAction* Update = dynamic_cast< BattleMatrixAction* >( In );
+    BattleMatrixAction* Update = ActionCast< BattleMatrixAction >( In );
     if( !Update )
     {
         cocos2d::log( "[GM] Invalid 'BattleMatrix' event received! Cast Failed!" );
@@ -18,6 +18,14 @@
 #include "UI/CardViewer.hpp"
 #include "UI/CardSelector.hpp"
 #include "ClientState.hpp"
+#include "ActionStream.hpp"
+#include <array>
+
+// Turbo Playback
+// Once more actions than this are waiting to play, animations speed up a step for each extra action, up to the max
+#define PLAYBACK_TURBO_DEPTH 3
+#define PLAYBACK_TURBO_STEP 0.25f
+#define PLAYBACK_TURBO_MAX 3.f
 
 namespace Game
 {
@@ -116,10 +124,24 @@ namespace Game
         
         void RunAction( Action& Target, std::function< void() > Callback );
         void PopQueue( ActionQueue& Target );
-        void AddAction( const std::string& Name, std::function< void( Action*, std::function< void() > ) > Handler );
+        
+        // Drops updates that are overwritten by the very next action, before the queue starts playing
+        void CollapseQueue( ActionQueue& Target );
+        
+        // Speeds animations up with the number of actions still waiting, across every active queue
+        void UpdatePlayback();
+        
+        // Plays the rest of the active queues without waiting on animations, until the player has control again
+        void SkipPlayback();
+        void AddAction( ActionId In, std::function< void( Action*, std::function< void() > ) > Handler );
         
         std::map< uint32_t, ActionQueue > ActiveQueues;
-        std::map< std::string, std::function< void( Action*, std::function< void() > ) > > ActionHandlers;
+        std::array< std::function< void( Action*, std::function< void() > ) >, (size_t) ActionId::Count > ActionHandlers;
+        
+#ifdef ACTION_STREAM_FILE
+        // Every queue this game mode runs, for replays and bug reports
+        ActionRecorder Recorder;
+#endif
         
         void UpdateMatchState( MatchState In );
         void UpdateTurnState( TurnState In );
@@ -127,6 +149,31 @@ namespace Game
         
         void Tick( float Delta );
         bool _bCheckPossibleActions = false;
+        
+        // Lays out every container that was invalidated since the last tick
+        void FlushLayouts();
+        
+        // Ability checks run Lua, so the results are cached per card, and reused until an action targets the card
+        // or its owner, or one of the values the check always looks at changes. Checks are assumed to only depend
+        // on the card, the player that owns it, and which cards are on the opposing field
+        struct AbilityCheck
+        {
+            uint32_t Owner;
+            uint32_t OpponentField;
+            ICardContainer* Container;
+            int Mana;
+            int Stamina;
+            TurnState tState;
+            PlayerTurn pState;
+            bool bResult;
+        };
+        
+        std::map< uint32_t, AbilityCheck > AbilityChecks;
+        
+        bool CanTriggerAbilityCached( CardEntity* In );
+        void InvalidateActionTargets( Action& In );
+        void InvalidateTarget( uint32_t EntId );
+        void InvalidatePlayer( uint32_t PlayerId );
         bool _bFinishCalled = false;
         uint32_t lastDamageId;
         uint32_t lastDrainId;
@@ -10,10 +10,13 @@
 
 #include "GameStateBase.hpp"
 #include "CardEntity.hpp"
+#include "MatchContext.hpp"
 
 using namespace Game;
 
 
+static thread_local Math::Random* SeedSource = nullptr;
+
 
 GameStateBase::GameStateBase()
 {
@@ -23,6 +26,28 @@ GameStateBase::GameStateBase()
     
     LocalPlayer.DisplayName = "Unnamed Player";
     Opponent.DisplayName    = "Unnmaed Opponent";
+    
+    IndexBase = 0;
+    
+    // States created for a match draw their seeds from its context, so a context with a fixed seed replays the same match
+    auto Context = MatchContext::GetCurrent();
+    if( SeedSource )
+        Rng.Seed( SeedSource->Next() );
+    else if( Context )
+        Rng.Seed( Context->GetRandom().Next() );
+}
+
+
+GameStateBase::SeedScope::SeedScope( Math::Random* In )
+: Previous( SeedSource )
+{
+    SeedSource = In;
+}
+
+
+GameStateBase::SeedScope::~SeedScope()
+{
+    SeedSource = Previous;
 }
 
 // Copy from this to parameter
@@ -31,11 +56,15 @@ void GameStateBase::CopyFrom( GameStateBase &Other )
     mState = Other.mState;
     pState = Other.pState;
     tState = Other.tState;
+    StartingPlayer = Other.StartingPlayer;
     
     LocalPlayer = Other.LocalPlayer;
     Opponent    = Other.Opponent;
     
     TurnNumber = Other.TurnNumber;
+    
+    CardIndex = Other.CardIndex;
+    IndexBase = Other.IndexBase;
 }
 
 void GameStateBase::OnCardKilled( CardState* Target )
@@ -43,30 +72,17 @@ void GameStateBase::OnCardKilled( CardState* Target )
     if( !Target )
         return;
     
-    // Find card owner
-    PlayerState& Owner = Target->Owner == LocalPlayer.EntId ? LocalPlayer : Opponent;
-    
     // Find this card
-    std::vector< CardState >::iterator Position = Owner.Field.end();
-    for( auto It = Owner.Field.begin(); It != Owner.Field.end(); It++ )
-    {
-        if( It->EntId == Target->EntId )
-        {
-            Position = It;
-            break;
-        }
-    }
-    
-    if( Position == Owner.Field.end() )
+    CardLocation Location;
+    if( !LookupCard( Target->EntId, Location ) || Location.Zone != (uint8_t) CardPos::FIELD )
     {
         // Failed to find card
         cocos2d::log( "[GameState] Failed to kill card.. card couldnt be found on owners field!" );
         return;
     }
     
-    Position->Position = CardPos::GRAVEYARD;
-    Owner.Graveyard.push_back( *Position );
-    Owner.Field.erase( Position );
+    PlayerState& Owner = Location.Player == 0 ? LocalPlayer : Opponent;
+    MoveCard( std::addressof( Owner ), CardPos::FIELD, Location.Slot, CardPos::GRAVEYARD );
 }
 
 
@@ -76,22 +92,12 @@ void GameStateBase::ShuffleDeck( PlayerState* Target )
     if( !Target )
         return;
     
-    // Create new vector
-    std::vector< CardState > NewDeck;
-    
-    // Add cards into new deck in random order
-    while( !Target->Deck.empty() )
-    {
-        auto Index = Target->Deck.size() > 1 ? cocos2d::random( 0, (int)Target->Deck.size() - 1 ) : 0;
-        auto It = Target->Deck.begin();
-        std::advance( It, Index );
-        
-        NewDeck.push_back( *It );
-        Target->Deck.erase( It );
-    }
+    // Fisher-Yates, in place
+    auto& Deck = Target->Deck;
+    for( int i = (int) Deck.size() - 1; i > 0; i-- )
+        std::swap( Deck[ i ], Deck[ Rng.Range( 0, i ) ] );
     
-    // Assign new deck to player
-    Target->Deck = NewDeck;
+    IndexZone( Target, CardPos::DECK );
 }
 
 void GameStateBase::DrawCard( PlayerState* Target, uint32_t Count )
@@ -107,13 +113,10 @@ void GameStateBase::DrawCard( PlayerState* Target, uint32_t Count )
             return;
         }
 
-        auto It = Target->Deck.begin();
-        
-        It->Position    = CardPos::HAND;
-        It->FaceUp      = false;
-        
-        Target->Hand.push_back( *It );
-        Target->Deck.erase( It );
+        // The top of the deck is the back of the vector
+        auto Card = MoveCard( Target, CardPos::DECK, Target->Deck.size() - 1, CardPos::HAND );
+        if( Card )
+            Card->FaceUp = false;
     }
 }
 
@@ -231,29 +234,21 @@ bool GameStateBase::PlayCard( PlayerState* Player, uint32_t Target )
     if( !Player )
         return false;
     
-    auto Card = Player->Hand.end();
-    for( auto It = Player->Hand.begin(); It != Player->Hand.end(); It++ )
-    {
-        if( It->EntId == Target )
-        {
-            Card = It;
-            break;
-        }
-    }
+    if( Player != std::addressof( LocalPlayer ) && Player != std::addressof( Opponent ) )
+        return false;
     
-    if( Card == Player->Hand.end() )
+    CardLocation Location;
+    auto Card = LookupCard( Target, Location );
+    if( !Card || Location.Player != ( Player == std::addressof( Opponent ) ? 1 : 0 ) || Location.Zone != (uint8_t) CardPos::HAND )
         return false;
     
     if( Card->ManaCost > Player->Mana )
         return false;
     
-    Card->Position = CardPos::FIELD;
-    Card->FaceUp = true;
-    
     Player->Mana -= Card->ManaCost;
     
-    Player->Field.push_back( *Card );
-    Player->Hand.erase( Card );
+    Card = MoveCard( Player, CardPos::HAND, Location.Slot, CardPos::FIELD );
+    Card->FaceUp = true;
     
     return true;
 }
@@ -263,16 +258,10 @@ uint32_t GameStateBase::DrawSingle( PlayerState* Target )
     if( !Target || Target->Deck.size() <= 0 )
         return 0;
     
-    auto It = Target->Deck.begin();
-    auto Output = It->EntId;
-    
-    It->Position = CardPos::HAND;
-    It->FaceUp = false;
+    auto Card = MoveCard( Target, CardPos::DECK, Target->Deck.size() - 1, CardPos::HAND );
+    Card->FaceUp = false;
     
-    Target->Hand.push_back( *It );
-    Target->Deck.erase( It );
-    
-    return Output;
+    return Card->EntId;
 }
 
 void GameStateBase::SetStartingPlayer( PlayerTurn In )
@@ -301,13 +290,13 @@ PlayerTurn GameStateBase::SwitchPlayerTurn()
 
 bool GameStateBase::FindCard( uint32_t Id, CardState*& Out )
 {
-    // Check both players, starting with local player
-    if( FindCard( Id, &LocalPlayer, Out ) )
-        return true;
-    if( FindCard( Id, &Opponent, Out ) )
-        return true;
+    CardLocation Location;
+    auto Card = LookupCard( Id, Location );
+    if( !Card )
+        return false;
     
-    return false;
+    Out = Card;
+    return true;
 }
 
 bool CheckContainer( uint32_t In, std::vector< CardState >& Container, CardState*& Out )
@@ -365,6 +354,20 @@ bool GameStateBase::FindCard( uint32_t In, PlayerState* Owner, CardState*& Out,
     if( !Owner )
         return false;
     
+    // Index lookup, as long as the owner is one of our players
+    if( Owner == std::addressof( LocalPlayer ) || Owner == std::addressof( Opponent ) )
+    {
+        CardLocation Location;
+        auto Card = LookupCard( In, Location );
+        if( !Card || Location.Player != ( Owner == std::addressof( Opponent ) ? 1 : 0 ) )
+            return false;
+        if( bFieldOnly && Location.Zone != (uint8_t) CardPos::FIELD )
+            return false;
+        
+        Out = Card;
+        return true;
+    }
+    
     if( CheckContainer( In, Owner->Field, Out ) )
         return true;
     if( bFieldOnly )
@@ -490,3 +493,128 @@ void GameStateBase::CallHook( const std::string& HookName )
     
     PostHook();
 }
+
+
+std::vector< CardState >* GameStateBase::GetZone( PlayerState* Owner, CardPos Zone )
+{
+    if( !Owner )
+        return nullptr;
+    
+    switch( Zone )
+    {
+        case CardPos::DECK:
+            return std::addressof( Owner->Deck );
+        case CardPos::HAND:
+            return std::addressof( Owner->Hand );
+        case CardPos::FIELD:
+            return std::addressof( Owner->Field );
+        case CardPos::GRAVEYARD:
+            return std::addressof( Owner->Graveyard );
+        default:
+            return nullptr;
+    }
+}
+
+
+CardState* GameStateBase::MoveCard( PlayerState* Owner, CardPos From, size_t Slot, CardPos To )
+{
+    auto Source = GetZone( Owner, From );
+    auto Dest = GetZone( Owner, To );
+    
+    if( !Source || !Dest || Slot >= Source->size() )
+        return nullptr;
+    
+    auto Card = ( *Source )[ Slot ];
+    Card.Position = To;
+    
+    // Cards after the removed one shift down a slot
+    Source->erase( Source->begin() + Slot );
+    IndexZone( Owner, From, Slot );
+    
+    Dest->push_back( Card );
+    IndexZone( Owner, To, Dest->size() - 1 );
+    
+    return std::addressof( Dest->back() );
+}
+
+
+void GameStateBase::IndexZone( PlayerState* Owner, CardPos Zone, size_t From /* = 0 */ )
+{
+    auto Cards = GetZone( Owner, Zone );
+    if( !Cards )
+        return;
+    
+    uint8_t PlayerIndex = Owner == std::addressof( Opponent ) ? 1 : 0;
+    for( size_t i = From; i < Cards->size(); i++ )
+    {
+        uint32_t EntId = ( *Cards )[ i ].EntId;
+        
+        // Card ids are allocated in a block when players load, so anything outside the range means the
+        // players were rebuilt without updating the index
+        if( EntId < IndexBase || CardIndex.empty() )
+        {
+            RebuildIndex();
+            return;
+        }
+        
+        if( EntId - IndexBase >= CardIndex.size() )
+            CardIndex.resize( EntId - IndexBase + 1, CardLocation{ 0xFF, 0, 0 } );
+        
+        CardIndex[ EntId - IndexBase ] = CardLocation{ PlayerIndex, (uint8_t) Zone, (uint16_t) i };
+    }
+}
+
+
+void GameStateBase::RebuildIndex()
+{
+    uint32_t Min = UINT32_MAX;
+    uint32_t Max = 0;
+    
+    ExecuteOnCards( [ & ]( CardState* Card )
+    {
+        Min = Card->EntId < Min ? Card->EntId : Min;
+        Max = Card->EntId > Max ? Card->EntId : Max;
+    } );
+    
+    CardIndex.clear();
+    if( Min > Max )
+    {
+        IndexBase = 0;
+        return;
+    }
+    
+    IndexBase = Min;
+    CardIndex.resize( Max - Min + 1, CardLocation{ 0xFF, 0, 0 } );
+    
+    static const CardPos Zones[] = { CardPos::DECK, CardPos::HAND, CardPos::FIELD, CardPos::GRAVEYARD };
+    for( auto Zone : Zones )
+    {
+        IndexZone( std::addressof( LocalPlayer ), Zone );
+        IndexZone( std::addressof( Opponent ), Zone );
+    }
+}
+
+
+CardState* GameStateBase::ResolveCard( uint32_t EntId, CardLocation& Location )
+{
+    if( EntId < IndexBase || EntId - IndexBase >= CardIndex.size() )
+        return nullptr;
+    
+    Location = CardIndex[ EntId - IndexBase ];
+    if( Location.Player > 1 )
+        return nullptr;
+    
+    auto Cards = GetZone( Location.Player == 0 ? std::addressof( LocalPlayer ) : std::addressof( Opponent ), (CardPos) Location.Zone );
+    if( !Cards || Location.Slot >= Cards->size() || ( *Cards )[ Location.Slot ].EntId != EntId )
+        return nullptr;
+    
+    return std::addressof( ( *Cards )[ Location.Slot ] );
+}
+
+
+CardState* GameStateBase::LookupCard( uint32_t EntId, CardLocation& Location )
+{
+    // MoveCard and everything that changes zones directly keeps the index up to date, so a miss means
+    // the card isnt in any zone (kings, stale ids from the client, cards from another state)
+    return ResolveCard( EntId, Location );
+}
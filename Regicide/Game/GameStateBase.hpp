@@ -14,13 +14,20 @@
 #include "ObjectStates.hpp"
 #include "RegicideAPI/Account.hpp"
 #include "CardEntity.hpp"
+#include "Numeric.hpp"
 
 
 namespace Game
 {
     class Player;
     
-
+    // Where a card is in the state, Player is 0 for the local player and 1 for the opponent
+    struct CardLocation
+    {
+        uint8_t Player;
+        uint8_t Zone;
+        uint16_t Slot;
+    };
     
     class GameStateBase
     {
@@ -69,10 +76,20 @@ namespace Game
         virtual PlayerTurn SwitchPlayerTurn();
         
         void SetStartingPlayer( PlayerTurn In );
+        inline PlayerTurn GetStartingPlayer() const { return StartingPlayer; }
         bool FindCard( uint32_t In, CardState*& Out );
         bool FindCard( uint32_t In, PlayerState* Owner, CardState*& Out, bool bFieldOnly = false );
         bool FindPlayer( uint32_t In, PlayerState*& Owner );
         
+        // Card Index
+        // Every card is indexed by EntId, so FindCard doesnt have to search through each zone. Pointers into the
+        // zones are only good until the next zone change, so hold on to the EntId and look the card up again instead.
+        // Zone changes should go through MoveCard, after changing zones directly call RebuildIndex, lookups
+        // never rebuild the index on their own, so a card thats missing from it is treated as not found
+        CardState* MoveCard( PlayerState* Owner, CardPos From, size_t Slot, CardPos To );
+        std::vector< CardState >* GetZone( PlayerState* Owner, CardPos Zone );
+        void RebuildIndex();
+        
         bool IsPlayerTurn( uint32_t Target );
         
         // Lua Specific Interface
@@ -80,6 +97,25 @@ namespace Game
         PlayerState* GetCardOpponent( CardState* Card );
         PlayerState* GetOtherPlayer( PlayerState* Target );
         
+        inline Math::Random& GetRandom() { return Rng; }
+        
+        // States created on this thread draw their seeds from the given generator instead of the match context
+        // The context stream is only safe to use from the match thread, so other threads bring their own
+        class SeedScope
+        {
+        public:
+        
+            explicit SeedScope( Math::Random* In );
+            ~SeedScope();
+            
+            SeedScope( const SeedScope& Other ) = delete;
+            SeedScope& operator= ( const SeedScope& Other ) = delete;
+        
+        private:
+        
+            Math::Random* Previous;
+        };
+        
         MatchState mState;
         PlayerTurn pState;
         TurnState tState;
@@ -110,6 +146,17 @@ namespace Game
         void ExecuteOnPlayerCards( PlayerState* Target, std::function< void( CardState* ) > Func );
         void ExecuteOnCards( std::function< void( CardState* ) > Func );
         
+        std::vector< CardLocation > CardIndex;
+        uint32_t IndexBase;
+        
+        // Each state has its own random stream, its not copied in CopyFrom, so simulations
+        // that start from the same state dont all play out the same way
+        Math::Random Rng;
+        
+        CardState* LookupCard( uint32_t EntId, CardLocation& Location );
+        CardState* ResolveCard( uint32_t EntId, CardLocation& Location );
+        void IndexZone( PlayerState* Owner, CardPos Zone, size_t From = 0 );
+        
     };
     
     template< typename T1 >
@@ -14,7 +14,7 @@
 using namespace Game;
 
 GraveyardEntity::GraveyardEntity()
-: EntityBase( "Graveyard" )
+: EntityBase( "Graveyard", EntityKind::Container )
 {
     SetTag( TAG_GRAVE );
 }
@@ -275,7 +275,7 @@ void GraveyardEntity::Invalidate()
     InvalidateCards();
 }
 
-void GraveyardEntity::InvalidateCards( CardEntity* inCard )
+void GraveyardEntity::LayoutCards( CardEntity* inCard )
 {
     int Index = 0;
     for( auto It = Begin(); It != End(); It++ )
@@ -283,8 +283,12 @@ void GraveyardEntity::InvalidateCards( CardEntity* inCard )
         float Offset = Index * 0.1f;
         if( *It && *It != inCard && !(*It)->GetIsDragging() )
         {
-            (*It)->SetPosition( GetPosition() - cocos2d::Vec2( Offset, 0.f ) );
-            (*It)->SetRotation( 0.f );
+            auto Target = GetPosition() - cocos2d::Vec2( Offset, 0.f );
+            if( (*It)->NeedsMove( Target ) || (*It)->GetRotation() != 0.f )
+            {
+                (*It)->SetPosition( Target );
+                (*It)->SetRotation( 0.f );
+            }
         }
         
         Index++;
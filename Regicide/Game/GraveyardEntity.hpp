@@ -49,7 +49,6 @@ namespace Game
         inline size_t Count() const override { return Cards.size(); }
         
         virtual void Invalidate() override;
-        virtual void InvalidateCards( CardEntity* inCard = nullptr ) override;
         void InvalidateZOrder();
         
         void Clear();
@@ -58,6 +57,8 @@ namespace Game
         
         std::deque< CardEntity* > Cards;
         
+        virtual void LayoutCards( CardEntity* inCard ) override;
+        
         void MoveCard( CardEntity* inCard, std::function< void() > Callback );
         
     };
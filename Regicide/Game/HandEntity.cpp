@@ -18,7 +18,7 @@ using namespace Game;
 
 
 HandEntity::HandEntity()
-: EntityBase( "Hand" ), Selector( nullptr )
+: EntityBase( "Hand", EntityKind::Container ), Selector( nullptr )
 {
     SetTag( TAG_HAND );
     
@@ -264,7 +264,7 @@ bool HandEntity::RemoveRandom( bool bDestroy /* = false */ )
     return true;
 }
 
-void HandEntity::InvalidateCards( CardEntity* Ignore )
+void HandEntity::LayoutCards( CardEntity* Ignore )
 {
     int Index = 0;
     
@@ -274,7 +274,9 @@ void HandEntity::InvalidateCards( CardEntity* Ignore )
     {
         if( (*It) && *It != Ignore && !(*It)->GetIsDragging() )
         {
-            (*It)->MoveAnimation( CalcPos( Index, 0 ), CARD_DEFAULT_MOVE_TIME );
+            auto Target = CalcPos( Index, 0 );
+            if( (*It)->NeedsMove( Target ) )
+                (*It)->MoveAnimation( Target, CARD_DEFAULT_MOVE_TIME );
         }
         
         Index++;
@@ -299,8 +301,7 @@ cocos2d::Vec2 HandEntity::CalcPos( int Index, int CardDelta )
     float Spacing = CardWidth - Overlap;
     float TotalWidth = ct * Spacing;
     
-    auto dir = cocos2d::Director::getInstance();
-    auto size = dir->getVisibleSize();
+    auto& size = GetLayoutSize();
     
     return GetPosition() + cocos2d::Vec2( ( -TotalWidth / 2.f ) + Index * Spacing, bExpanded ? size.height * 0.15f : 0.f );
 }
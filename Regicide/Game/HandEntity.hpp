@@ -57,7 +57,6 @@ namespace Game
         inline bool IsExpanded() const { return bExpanded; }
         
         void SetExpanded( bool bExpand );
-        virtual void InvalidateCards( CardEntity* Ignore = nullptr ) override;
         
         bool AttemptDrop( CardEntity* inCard, const cocos2d::Vec2& inPos );
         
@@ -75,6 +74,8 @@ namespace Game
         bool bExpanded;
         bool bBlitzMode;
         
+        virtual void LayoutCards( CardEntity* Ignore ) override;
+        
         void MoveCard( CardEntity* inCard, const cocos2d::Vec2& AbsPos, std::function< void() > Callback );
         cocos2d::Vec2 CalcPos( int Index, int CardDelta = 0 );
         
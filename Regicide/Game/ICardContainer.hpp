@@ -45,10 +45,55 @@ namespace Game
         
         inline int GetTag() const { return i_Tag; }
         
-        virtual void InvalidateCards( CardEntity* IgnoredCard = nullptr ) = 0;
+        // Changes every time cards are added or removed, so anything that depends on whats in the container
+        // can tell when its out of date
+        inline uint32 GetRevision() const { return Revision; }
+        
+        // Marks the layout as dirty, the cards are laid out once on the next game mode tick, no matter how many
+        // times this was called before then. The ignored card is only skipped if every call this frame ignored it
+        void InvalidateCards( CardEntity* IgnoredCard = nullptr )
+        {
+            Revision++;
+            
+            if( !bLayoutDirty )
+            {
+                bLayoutDirty = true;
+                LayoutIgnore = IgnoredCard;
+            }
+            else if( LayoutIgnore != IgnoredCard )
+            {
+                LayoutIgnore = nullptr;
+            }
+        }
+        
+        // Runs the pending layout, if there is one
+        void FlushLayout()
+        {
+            if( !bLayoutDirty )
+                return;
+            
+            auto Ignore = LayoutIgnore;
+            
+            bLayoutDirty = false;
+            LayoutIgnore = nullptr;
+            
+            LayoutCards( Ignore );
+        }
         
     protected:
         
+        // Moves every card to its place in the container, cards already there, or on their way there, are left alone
+        virtual void LayoutCards( CardEntity* IgnoredCard ) = 0;
+        
+        // Visible size only changes with the window, so its looked up once instead of for every card
+        const cocos2d::Size& GetLayoutSize()
+        {
+            if( LayoutSize.width <= 0.f )
+                LayoutSize = cocos2d::Director::getInstance()->getVisibleSize();
+            
+            return LayoutSize;
+        }
+        
         void SetCardContainer( CardEntity* inCard )
         {
             inCard->Container = this;
@@ -81,5 +126,10 @@ namespace Game
         
         int i_Tag;
         
+        bool bLayoutDirty = false;
+        CardEntity* LayoutIgnore = nullptr;
+        uint32 Revision = 0;
+        cocos2d::Size LayoutSize;
+        
     };
 }
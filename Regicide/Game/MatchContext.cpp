@@ -0,0 +1,70 @@
+//
+//	MatchContext.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "MatchContext.hpp"
+#include "EntityBase.hpp"
+#include "CardEntity.hpp"
+#include "LuaEngine.hpp"
+
+using namespace Game;
+
+
+static thread_local MatchContext* CurrentContext = nullptr;
+
+
+MatchContext::MatchContext()
+: MatchContext( Math::Random::NewSeed() )
+{
+}
+
+
+MatchContext::MatchContext( uint64_t Seed )
+: Lua( new Regicide::LuaEngine() ), Entities( new IEntityManager() ), Cards( new CardManager() ), Rng( Seed ), WorldInstance( nullptr )
+{
+}
+
+
+MatchContext::~MatchContext()
+{
+    // Entities can run script code while cleaning up, so they go with the context entered
+    Scope Enter( this );
+    
+    Cards.reset();
+    Entities.reset();
+    Lua.reset();
+}
+
+
+bool MatchContext::Init()
+{
+    Scope Enter( this );
+    
+    Lua->Init();
+    return Lua->State() != nullptr;
+}
+
+
+MatchContext* MatchContext::GetCurrent()
+{
+    return CurrentContext;
+}
+
+
+MatchContext::Scope::Scope( MatchContext* In )
+: Previous( CurrentContext )
+{
+    CurrentContext = In;
+}
+
+
+MatchContext::Scope::~Scope()
+{
+    CurrentContext = Previous;
+}
@@ -0,0 +1,85 @@
+//
+//	MatchContext.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Numeric.hpp"
+#include <memory>
+
+
+namespace Regicide
+{
+    class LuaEngine;
+}
+
+namespace Game
+{
+    class World;
+    class IEntityManager;
+    class CardManager;
+    
+    // Everything one match would otherwise share with every other match in the process
+    // The Lua state, the entity manager, the card cache (its hooks live in the Lua state) and the random stream
+    //
+    // The singletons look up the context entered on the calling thread, and fall back to the process wide
+    // instance when there is none. The client never enters one, so nothing changes there. The server enters
+    // the match context around all of its work, so matches dont share anything and can run on any thread
+    class MatchContext
+    {
+    public:
+    
+        MatchContext();
+        explicit MatchContext( uint64_t Seed );
+        ~MatchContext();
+        
+        // Creates the Lua state and runs the entry script, cards and kings are loaded as needed after that
+        bool Init();
+        
+        inline Regicide::LuaEngine* GetLua() { return Lua.get(); }
+        inline IEntityManager& GetEntities() { return *Entities; }
+        inline CardManager& GetCards() { return *Cards; }
+        inline Math::Random& GetRandom() { return Rng; }
+        inline World* GetWorld() { return WorldInstance; }
+        
+        // Context entered on this thread, or null
+        static MatchContext* GetCurrent();
+        
+        // Enters a context for as long as it exists, scopes can be nested
+        class Scope
+        {
+        public:
+        
+            explicit Scope( MatchContext* In );
+            ~Scope();
+            
+            Scope( const Scope& Other ) = delete;
+            Scope& operator= ( const Scope& Other ) = delete;
+        
+        private:
+        
+            MatchContext* Previous;
+        };
+    
+    protected:
+    
+        // Declared in this order so cards and entities, which hold Lua references, go before the Lua state
+        std::unique_ptr< Regicide::LuaEngine > Lua;
+        std::unique_ptr< IEntityManager > Entities;
+        std::unique_ptr< CardManager > Cards;
+        
+        Math::Random Rng;
+        World* WorldInstance;
+        
+        MatchContext( const MatchContext& Other ) = delete;
+        MatchContext& operator= ( const MatchContext& Other ) = delete;
+        
+        friend class World;
+    };
+}
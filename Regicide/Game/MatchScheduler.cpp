@@ -0,0 +1,313 @@
+//
+//	MatchScheduler.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "MatchScheduler.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+/*=========================================================================================
+    Cocos Scheduler
+ =========================================================================================*/
+CocosScheduler::CocosScheduler( void* InTarget )
+: Target( InTarget ), Start( std::chrono::steady_clock::now() )
+{
+}
+
+
+CocosScheduler::~CocosScheduler()
+{
+    UnscheduleAll();
+}
+
+
+double CocosScheduler::GetTime() const
+{
+    return std::chrono::duration< double >( std::chrono::steady_clock::now() - Start ).count();
+}
+
+
+void CocosScheduler::Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func )
+{
+    auto sch = cocos2d::Director::getInstance()->getScheduler();
+    if( sch )
+        sch->schedule( Func, Target, Delay, 0, 0.f, false, Key );
+}
+
+
+void CocosScheduler::ScheduleTick( const std::string& Key, std::function< void( float ) > Func )
+{
+    auto sch = cocos2d::Director::getInstance()->getScheduler();
+    if( sch )
+        sch->schedule( Func, Target, 0.f, CC_REPEAT_FOREVER, 0.f, false, Key );
+}
+
+
+void CocosScheduler::Unschedule( const std::string& Key )
+{
+    auto sch = cocos2d::Director::getInstance()->getScheduler();
+    if( sch )
+        sch->unschedule( Key, Target );
+}
+
+
+void CocosScheduler::UnscheduleAll()
+{
+    auto dir = cocos2d::Director::getInstance();
+    auto sch = dir ? dir->getScheduler() : nullptr;
+    
+    if( sch )
+        sch->unscheduleAllForTarget( Target );
+}
+
+
+void CocosScheduler::Dispatch( std::function< void() > Func )
+{
+    auto dir = cocos2d::Director::getInstance();
+    auto sch = dir ? dir->getScheduler() : nullptr;
+    
+    if( !sch )
+    {
+        cocos2d::log( "[Scheduler] Failed to dispatch work! Couldnt get scheduler!" );
+        return;
+    }
+    
+    sch->performFunctionInCocosThread( Func );
+}
+
+
+/*=========================================================================================
+    Virtual Scheduler
+ =========================================================================================*/
+VirtualScheduler::VirtualScheduler()
+: Time( 0.0 ), NextOrder( 0 ), bRunningTicks( false )
+{
+}
+
+
+void VirtualScheduler::Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func )
+{
+    if( !Func )
+        return;
+    
+    Timer& Target = Timers[ Key ];
+    Target.Due      = Time + std::max( Delay, 0.f );
+    Target.Order    = NextOrder++;
+    Target.Func     = Func;
+}
+
+
+void VirtualScheduler::ScheduleTick( const std::string& Key, std::function< void( float ) > Func )
+{
+    if( !Func )
+        return;
+    
+    if( bRunningTicks )
+    {
+        AddedTicks[ Key ] = Func;
+        return;
+    }
+    
+    Tick& Target = Ticks[ Key ];
+    Target.Func     = Func;
+    Target.bRemoved = false;
+}
+
+
+void VirtualScheduler::Unschedule( const std::string& Key )
+{
+    Timers.erase( Key );
+    AddedTicks.erase( Key );
+    
+    if( !bRunningTicks )
+    {
+        Ticks.erase( Key );
+        return;
+    }
+    
+    auto Entry = Ticks.find( Key );
+    if( Entry != Ticks.end() )
+        Entry->second.bRemoved = true;
+}
+
+
+void VirtualScheduler::UnscheduleAll()
+{
+    Timers.clear();
+    AddedTicks.clear();
+    
+    if( !bRunningTicks )
+    {
+        Ticks.clear();
+        return;
+    }
+    
+    for( auto It = Ticks.begin(); It != Ticks.end(); It++ )
+        It->second.bRemoved = true;
+}
+
+
+void VirtualScheduler::Dispatch( std::function< void() > Func )
+{
+    if( !Func )
+        return;
+    
+    {
+        std::lock_guard< std::mutex > Guard( InboxLock );
+        Inbox.push_back( Func );
+    }
+    
+    InboxSignal.notify_one();
+}
+
+
+bool VirtualScheduler::RunDispatched()
+{
+    std::vector< std::function< void() > > Work;
+    {
+        std::lock_guard< std::mutex > Guard( InboxLock );
+        Work.swap( Inbox );
+    }
+    
+    // Anything dispatched while this runs waits for the next step
+    for( auto It = Work.begin(); It != Work.end(); It++ )
+        ( *It )();
+    
+    return !Work.empty();
+}
+
+
+std::map< std::string, VirtualScheduler::Timer >::iterator VirtualScheduler::NextTimer()
+{
+    // Earliest due, ties go to whichever was scheduled first
+    auto Output = Timers.end();
+    for( auto It = Timers.begin(); It != Timers.end(); It++ )
+    {
+        if( Output == Timers.end() || It->second.Due < Output->second.Due ||
+           ( It->second.Due == Output->second.Due && It->second.Order < Output->second.Order ) )
+            Output = It;
+    }
+    
+    return Output;
+}
+
+
+void VirtualScheduler::RunTimer( std::map< std::string, Timer >::iterator Target )
+{
+    // Removed before running, the timer is allowed to schedule itself again
+    auto Func = Target->second.Func;
+    Timers.erase( Target );
+    
+    Func( 0.f );
+}
+
+
+void VirtualScheduler::RunTicks( float Delta )
+{
+    // A tick can unschedule itself or others, nothing is erased until they have all run
+    bRunningTicks = true;
+    for( auto It = Ticks.begin(); It != Ticks.end(); It++ )
+    {
+        if( !It->second.bRemoved )
+            It->second.Func( Delta );
+    }
+    
+    bRunningTicks = false;
+    
+    for( auto It = Ticks.begin(); It != Ticks.end(); )
+    {
+        if( It->second.bRemoved )
+            It = Ticks.erase( It );
+        else
+            It++;
+    }
+    
+    // Scheduled while running, so these start on the next step
+    for( auto It = AddedTicks.begin(); It != AddedTicks.end(); It++ )
+    {
+        Tick& Target = Ticks[ It->first ];
+        Target.Func     = std::move( It->second );
+        Target.bRemoved = false;
+    }
+    
+    AddedTicks.clear();
+}
+
+
+bool VirtualScheduler::Step()
+{
+    if( RunDispatched() )
+    {
+        RunTicks( 0.f );
+        return true;
+    }
+    
+    auto Next = NextTimer();
+    if( Next == Timers.end() )
+        return false;
+    
+    double Delta = std::max( Next->second.Due - Time, 0.0 );
+    Time += Delta;
+    
+    RunTimer( Next );
+    RunTicks( (float) Delta );
+    
+    return true;
+}
+
+
+void VirtualScheduler::Advance( float Seconds )
+{
+    double End = Time + std::max( Seconds, 0.f );
+    
+    while( true )
+    {
+        RunDispatched();
+        
+        auto Next = NextTimer();
+        if( Next == Timers.end() || Next->second.Due > End )
+            break;
+        
+        double Delta = std::max( Next->second.Due - Time, 0.0 );
+        Time += Delta;
+        
+        RunTimer( Next );
+        RunTicks( (float) Delta );
+    }
+    
+    RunTicks( (float)( End - Time ) );
+    Time = End;
+}
+
+
+int VirtualScheduler::RunUntilIdle( double MaxTime, int WaitMs /* = 0 */ )
+{
+    int Steps = 0;
+    while( Time <= MaxTime )
+    {
+        if( Step() )
+        {
+            Steps++;
+            continue;
+        }
+        
+        if( WaitMs <= 0 )
+            break;
+        
+        // Nothing left on this thread, give other threads a chance to hand us work
+        std::unique_lock< std::mutex > Guard( InboxLock );
+        if( !InboxSignal.wait_for( Guard, std::chrono::milliseconds( WaitMs ), [ this ]() { return !Inbox.empty(); } ) )
+            break;
+    }
+    
+    return Steps;
+}
@@ -0,0 +1,135 @@
+//
+//	MatchScheduler.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+
+namespace Game
+{
+    // Clock and timers used by the authority to drive the match
+    // Nothing in the match logic should talk to the cocos scheduler directly, so the same logic can run
+    // headless, where time only moves when the host steps the scheduler
+    class MatchScheduler
+    {
+    public:
+    
+        virtual ~MatchScheduler() {}
+        
+        // Seconds since the scheduler was created
+        virtual double GetTime() const = 0;
+        
+        // Runs Func once after Delay seconds, scheduling a key thats already pending replaces it
+        virtual void Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func ) = 0;
+        
+        // Runs Func every frame with the time since the last frame
+        virtual void ScheduleTick( const std::string& Key, std::function< void( float ) > Func ) = 0;
+        
+        virtual void Unschedule( const std::string& Key ) = 0;
+        virtual void UnscheduleAll() = 0;
+        
+        // Runs Func on the game thread as soon as possible, safe to call from any thread
+        virtual void Dispatch( std::function< void() > Func ) = 0;
+        
+        // Headless schedulers have no renderer, so there is no game mode to play action queues
+        virtual bool IsHeadless() const { return false; }
+    };
+    
+    // Real time scheduler, timers run on the cocos scheduler under the given target
+    class CocosScheduler : public MatchScheduler
+    {
+    public:
+    
+        CocosScheduler( void* InTarget );
+        ~CocosScheduler();
+        
+        virtual double GetTime() const override;
+        virtual void Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func ) override;
+        virtual void ScheduleTick( const std::string& Key, std::function< void( float ) > Func ) override;
+        virtual void Unschedule( const std::string& Key ) override;
+        virtual void UnscheduleAll() override;
+        virtual void Dispatch( std::function< void() > Func ) override;
+    
+    protected:
+    
+        void* Target;
+        std::chrono::steady_clock::time_point Start;
+    };
+    
+    // Virtual clock for running matches without a renderer
+    // Time only moves when stepped, and each step jumps straight to the next timer, so a match runs as fast as
+    // the logic allows. Ticks run once per step with the amount of time that step skipped
+    class VirtualScheduler : public MatchScheduler
+    {
+    public:
+    
+        VirtualScheduler();
+        
+        virtual double GetTime() const override { return Time; }
+        virtual void Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func ) override;
+        virtual void ScheduleTick( const std::string& Key, std::function< void( float ) > Func ) override;
+        virtual void Unschedule( const std::string& Key ) override;
+        virtual void UnscheduleAll() override;
+        virtual void Dispatch( std::function< void() > Func ) override;
+        virtual bool IsHeadless() const override { return true; }
+        
+        // Runs dispatched work, or if there is none, moves the clock to the next timer and runs it
+        // Returns false when there was nothing to do
+        bool Step();
+        
+        // Runs everything due in the next Seconds, and leaves the clock at the end of that time
+        void Advance( float Seconds );
+        
+        // Steps until theres nothing left to run, or the clock passes MaxTime. Work can come from other threads (the AI),
+        // so when idle, this waits up to WaitMs of real time for something to be dispatched before giving up
+        int RunUntilIdle( double MaxTime, int WaitMs = 0 );
+    
+    protected:
+    
+        struct Timer
+        {
+            double Due;
+            uint64_t Order;
+            std::function< void( float ) > Func;
+        };
+        
+        // Ticks cant be erased or replaced while they run, so changes made from inside one are deferred until
+        // every tick has run, removed ticks are only marked, and new ones wait in AddedTicks
+        struct Tick
+        {
+            std::function< void( float ) > Func;
+            bool bRemoved;
+        };
+        
+        bool RunDispatched();
+        void RunTimer( std::map< std::string, Timer >::iterator Target );
+        void RunTicks( float Delta );
+        std::map< std::string, Timer >::iterator NextTimer();
+        
+        double Time;
+        uint64_t NextOrder;
+        
+        std::map< std::string, Timer > Timers;
+        std::map< std::string, Tick > Ticks;
+        std::map< std::string, std::function< void( float ) > > AddedTicks;
+        bool bRunningTicks;
+        
+        std::vector< std::function< void() > > Inbox;
+        std::mutex InboxLock;
+        std::condition_variable InboxSignal;
+    };
+}
@@ -0,0 +1,335 @@
+//
+//	NetworkAuthority.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "NetworkAuthority.hpp"
+#include "ActionStream.hpp"
+
+using namespace Game;
+
+
+static PlayerTurn FlipTurn( PlayerTurn In )
+{
+    if( In == PlayerTurn::LocalPlayer )
+        return PlayerTurn::Opponent;
+    else if( In == PlayerTurn::Opponent )
+        return PlayerTurn::LocalPlayer;
+    else
+        return In;
+}
+
+
+NetworkAuthority::NetworkAuthority()
+: AuthorityBase(), ServerSide( PlayerTurn::None ), bInMatch( false )
+{
+}
+
+
+NetworkAuthority::~NetworkAuthority()
+{
+    Disconnect();
+}
+
+
+void NetworkAuthority::Cleanup()
+{
+    Disconnect();
+    AuthorityBase::Cleanup();
+}
+
+
+void NetworkAuthority::Connect( const std::string& Host, uint16_t Port, const std::string& PlayerName, const Regicide::Deck& PlayerDeck )
+{
+    Disconnect();
+    
+    NetHello Hello;
+    Hello.Name = PlayerName;
+    Hello.Deck = PlayerDeck;
+    
+    Client = std::make_shared< NetworkClient >();
+    
+    // Messages arrive on the network thread, the client is checked again on the game thread since
+    // we could have disconnected while the message was waiting
+    std::weak_ptr< NetworkClient > Weak = Client;
+    auto Target = Scheduler;
+    
+    Client->Connect( Host, Port, Hello,
+    [ this, Weak, Target ]( NetMessage Type, std::vector< uint8_t >&& Frame )
+    {
+        auto Shared = std::make_shared< std::vector< uint8_t > >( std::move( Frame ) );
+        Target->Dispatch( [ this, Weak, Type, Shared ]()
+        {
+            if( !Weak.expired() )
+                HandleMessage( Type, *Shared );
+        } );
+    },
+    [ this, Weak, Target ]( const std::string& Reason )
+    {
+        Target->Dispatch( [ this, Weak, Reason ]()
+        {
+            if( !Weak.expired() && OnError )
+                OnError( Reason );
+        } );
+    } );
+}
+
+
+void NetworkAuthority::Disconnect()
+{
+    if( Client )
+    {
+        Client->Close();
+        Client.reset();
+    }
+    
+    bInMatch = false;
+}
+
+
+void NetworkAuthority::HandleMessage( NetMessage Type, const std::vector< uint8_t >& Frame )
+{
+    StreamReader Reader = OpenPayload( Frame );
+    
+    switch( Type )
+    {
+        case NetMessage::Welcome:
+        {
+            // The server turns away clients on another version, but an older server wouldnt know about us
+            uint32_t Version = (uint32_t) Reader.ReadVarint();
+            if( Version != NET_PROTOCOL_VERSION )
+            {
+                cocos2d::log( "[Network] Server is running protocol v%d, we need v%d!", (int) Version, NET_PROTOCOL_VERSION );
+                Disconnect();
+                
+                if( OnError )
+                    OnError( "Server version mismatch" );
+                return;
+            }
+            
+            cocos2d::log( "[Network] Joined lobby (Protocol v%d)", (int) Version );
+            break;
+        }
+        case NetMessage::MatchStart:
+        {
+            if( !ReadMatchStart( Reader ) )
+            {
+                cocos2d::log( "[Network] Received invalid match snapshot!" );
+                Disconnect();
+                
+                if( OnError )
+                    OnError( "Received invalid match snapshot" );
+                return;
+            }
+            
+            bInMatch = true;
+            if( OnMatchStart )
+                OnMatchStart();
+            break;
+        }
+        case NetMessage::Queue:
+        {
+            auto Queue = ActionQueue();
+            if( !ReadActionQueue( Reader, Queue ) )
+            {
+                // Our copy of the state missed this queue, so ask for a full snapshot instead of waiting for the next turn
+                cocos2d::log( "[Network] Received invalid action queue!" );
+                SendSnapshotAck( 0 );
+                return;
+            }
+            
+            // Keep our copy of the state in sync before the game mode starts playing the queue
+            ActionReplay::ApplyQueue( Queue, State );
+            RunQueue( std::move( Queue ) );
+            break;
+        }
+        case NetMessage::Snapshot:
+        {
+            // Only sent mid match, when it doesnt apply the server follows up with a full snapshot
+            if( bInMatch && !ReadSnapshot( Reader ) )
+                cocos2d::log( "[Network] Couldnt apply state snapshot, waiting for a full one" );
+            
+            break;
+        }
+        case NetMessage::Error:
+        {
+            std::string Reason = Reader.ReadString();
+            cocos2d::log( "[Network] Server error: %s", Reason.c_str() );
+            
+            if( OnError )
+                OnError( Reason );
+            break;
+        }
+        default:
+        {
+            cocos2d::log( "[Network] Received unknown message type %d", (int) Type );
+            break;
+        }
+    }
+}
+
+
+bool NetworkAuthority::ReadMatchStart( StreamReader& In )
+{
+    ServerSide = (PlayerTurn) In.ReadByte();
+    if( !In.IsValid() || ( ServerSide != PlayerTurn::LocalPlayer && ServerSide != PlayerTurn::Opponent ) )
+        return false;
+    
+    Snapshots.Reset();
+    return ReadSnapshot( In );
+}
+
+
+void NetworkAuthority::SendSnapshotAck( uint32_t Sequence )
+{
+    StreamWriter Ack;
+    BeginFrame( Ack, NetMessage::SnapshotAck );
+    Ack.WriteVarint( Sequence );
+    FinishFrame( Ack );
+    
+    if( Client )
+        Client->Send( std::move( Ack.Buffer ) );
+}
+
+
+bool NetworkAuthority::ReadSnapshot( StreamReader& In )
+{
+    // The kings display info and hooks come from the local scripts, so keep them when the king didnt change
+    KingState Kings[] = { State.GetPlayer()->King, State.GetOpponent()->King };
+    
+    uint32_t Sequence = 0;
+    bool bResult = Snapshots.ReadUpdate( In, State, Sequence );
+    
+    // Always acknowledged, zero tells the server to start over with a full snapshot
+    SendSnapshotAck( Sequence );
+    
+    if( !bResult )
+        return false;
+    
+    // When were the servers opponent, flip everything around so our player is always the local player
+    if( ServerSide == PlayerTurn::Opponent )
+    {
+        std::swap( *State.GetPlayer(), *State.GetOpponent() );
+        
+        PlayerTurn Turn = FlipTurn( State.pState );
+        int TurnNumber  = State.TurnNumber;
+        
+        State.SetStartingPlayer( FlipTurn( State.GetStartingPlayer() ) );
+        State.pState        = Turn;
+        State.TurnNumber    = TurnNumber;
+        
+        State.RebuildIndex();
+    }
+    
+    PlayerState* Players[] = { State.GetPlayer(), State.GetOpponent() };
+    for( int i = 0; i < 2; i++ )
+    {
+        auto& King = Players[ i ]->King;
+        if( Kings[ i ].Hooks && Kings[ i ].Id == King.Id && Kings[ i ].Owner == King.Owner )
+        {
+            King = Kings[ i ];
+        }
+        else if( !LoadKing( King.Id, Players[ i ]->EntId, King ) )
+        {
+            cocos2d::log( "[Network] Failed to load kings for match!" );
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+void NetworkAuthority::SendCommand( const NetCommand& In )
+{
+    if( !Client || !bInMatch )
+    {
+        cocos2d::log( "[Network] Attempt to send command while not in a match!" );
+        return;
+    }
+    
+    StreamWriter Frame;
+    BeginFrame( Frame, In.Type );
+    In.Write( Frame );
+    FinishFrame( Frame );
+    
+    Client->Send( std::move( Frame.Buffer ) );
+}
+
+
+/*=========================================================================================
+    Authority Calls
+ =========================================================================================*/
+void NetworkAuthority::SetReady()
+{
+    NetCommand Command;
+    Command.Type = NetMessage::SetReady;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::SetBlitzCards( const std::vector< uint32_t >& Cards )
+{
+    NetCommand Command;
+    Command.Type    = NetMessage::SetBlitzCards;
+    Command.Cards   = Cards;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::PlayCard( uint32_t In, int Index )
+{
+    NetCommand Command;
+    Command.Type    = NetMessage::PlayCard;
+    Command.Card    = In;
+    Command.Index   = Index;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::FinishTurn()
+{
+    NetCommand Command;
+    Command.Type = NetMessage::FinishTurn;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::SetAttackers( const std::vector< uint32_t >& Cards )
+{
+    NetCommand Command;
+    Command.Type    = NetMessage::SetAttackers;
+    Command.Cards   = Cards;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::SetBlockers( const std::map< uint32_t, uint32_t >& Cards )
+{
+    NetCommand Command;
+    Command.Type        = NetMessage::SetBlockers;
+    Command.Blockers    = Cards;
+    
+    SendCommand( Command );
+}
+
+
+void NetworkAuthority::TriggerAbility( uint32_t Card, uint8_t AbilityId )
+{
+    NetCommand Command;
+    Command.Type    = NetMessage::TriggerAbility;
+    Command.Card    = Card;
+    Command.Ability = AbilityId;
+    
+    SendCommand( Command );
+}
@@ -0,0 +1,68 @@
+//
+//	NetworkAuthority.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "AuthorityBase.hpp"
+#include "NetworkClient.hpp"
+#include "StateSnapshot.hpp"
+
+
+namespace Game
+{
+    // Client side authority for online matches. The real authority runs on the match server, so every
+    // call is sent over the network, and the action queues the server sends back are played by the game mode
+    // The local copy of the state is kept up to date by applying each queue, and resynced from the snapshots the
+    // server sends each turn. Our player is always State.GetPlayer(), whichever side of the servers state we ended up on
+    class NetworkAuthority : public AuthorityBase
+    {
+    public:
+    
+        NetworkAuthority();
+        ~NetworkAuthority();
+        
+        // Connects to the match server, and joins the lobby with this deck
+        void Connect( const std::string& Host, uint16_t Port, const std::string& PlayerName, const Regicide::Deck& PlayerDeck );
+        void Disconnect();
+        
+        // Called on the game thread once the server put us in a match, State holds the starting snapshot at that point
+        inline void ListenForMatch( const std::function< void() >& Callback ) { OnMatchStart = Callback; }
+        inline void ListenForError( const std::function< void( std::string ) >& Callback ) { OnError = Callback; }
+        
+        virtual void SetReady() override;
+        virtual void SetBlitzCards( const std::vector< uint32_t >& Cards ) override;
+        virtual void PlayCard( uint32_t In, int Index ) override;
+        virtual void FinishTurn() override;
+        virtual void SetAttackers( const std::vector< uint32_t >& Cards ) override;
+        virtual void SetBlockers( const std::map< uint32_t, uint32_t >& Cards ) override;
+        virtual void TriggerAbility( uint32_t Card, uint8_t AbilityId ) override;
+        
+        inline bool IsInMatch() const { return bInMatch; }
+        inline PlayerTurn GetServerSide() const { return ServerSide; }
+    
+    protected:
+    
+        virtual void Cleanup() override;
+        
+        void SendCommand( const NetCommand& In );
+        void HandleMessage( NetMessage Type, const std::vector< uint8_t >& Frame );
+        bool ReadMatchStart( StreamReader& In );
+        bool ReadSnapshot( StreamReader& In );
+        void SendSnapshotAck( uint32_t Sequence );
+        
+        std::shared_ptr< NetworkClient > Client;
+        SnapshotReceiver Snapshots;
+        std::function< void() > OnMatchStart;
+        std::function< void( std::string ) > OnError;
+        
+        PlayerTurn ServerSide;
+        bool bInMatch;
+    };
+}
@@ -0,0 +1,203 @@
+//
+//	NetworkClient.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "NetworkClient.hpp"
+#include "cocos2d.h"
+
+using namespace Game;
+
+
+NetworkClient::NetworkClient()
+: Socket( Context ), Resolver( Context ), bConnected( false ), bClosed( false )
+{
+}
+
+
+NetworkClient::~NetworkClient()
+{
+    Close();
+}
+
+
+void NetworkClient::Connect( const std::string& Host, uint16_t Port, const NetHello& Hello, MessageCallback InMessage, ClosedCallback InClosed )
+{
+    if( Thread.joinable() )
+    {
+        cocos2d::log( "[Network] Attempt to connect while already connected!" );
+        return;
+    }
+    
+    OnMessage   = InMessage;
+    OnClosed    = InClosed;
+    bClosed     = false;
+    
+    StreamWriter Frame;
+    BeginFrame( Frame, NetMessage::Hello );
+    Hello.Write( Frame );
+    FinishFrame( Frame );
+    
+    Outbox.clear();
+    Outbox.push_back( std::move( Frame.Buffer ) );
+    
+    Resolver.async_resolve( Host, std::to_string( Port ), [ this ]( const asio::error_code& Error, asio::ip::tcp::resolver::results_type Results )
+    {
+        if( Error )
+        {
+            Fail( "Failed to resolve server address! " + Error.message() );
+            return;
+        }
+        
+        asio::async_connect( Socket, Results, [ this ]( const asio::error_code& Error, const asio::ip::tcp::endpoint& )
+        {
+            if( Error )
+            {
+                Fail( "Failed to connect to server! " + Error.message() );
+                return;
+            }
+            
+            // Nagle would hold back the small command frames, but the connection still works without it
+            asio::error_code OptionError;
+            Socket.set_option( asio::ip::tcp::no_delay( true ), OptionError );
+            if( OptionError )
+                cocos2d::log( "[Network] Failed to disable nagle! %s", OptionError.message().c_str() );
+            
+            bConnected = true;
+            
+            ReadHeader();
+            WriteNext();
+        } );
+    } );
+    
+    Context.restart();
+    Thread = std::thread( [ this ]() { Context.run(); } );
+}
+
+
+void NetworkClient::Close()
+{
+    if( !Thread.joinable() )
+        return;
+    
+    asio::post( Context, [ this ]() { Fail( "Connection closed" ); } );
+    
+    // From a callback on the network thread, the shutdown is only posted, and the thread is joined
+    // when the owner calls Close (or destroys the client) from its own thread
+    if( Thread.get_id() == std::this_thread::get_id() )
+        return;
+    
+    Thread.join();
+}
+
+
+void NetworkClient::Send( std::vector< uint8_t >&& Frame )
+{
+    auto Shared = std::make_shared< std::vector< uint8_t > >( std::move( Frame ) );
+    asio::post( Context, [ this, Shared ]()
+    {
+        if( bClosed )
+            return;
+        
+        bool bIdle = Outbox.empty();
+        Outbox.push_back( std::move( *Shared ) );
+        
+        if( bIdle && bConnected )
+            WriteNext();
+    } );
+}
+
+
+void NetworkClient::ReadHeader()
+{
+    asio::async_read( Socket, asio::buffer( Header, NET_FRAME_HEADER_SIZE ), [ this ]( const asio::error_code& Error, size_t )
+    {
+        if( Error )
+        {
+            Fail( "Lost connection to server! " + Error.message() );
+            return;
+        }
+        
+        uint32_t Size = ReadFrameSize( Header );
+        if( Size == 0 || Size > NET_MAX_FRAME_SIZE )
+        {
+            Fail( "Server sent an invalid frame!" );
+            return;
+        }
+        
+        ReadBody( Size );
+    } );
+}
+
+
+void NetworkClient::ReadBody( uint32_t Size )
+{
+    Body.resize( Size );
+    asio::async_read( Socket, asio::buffer( Body ), [ this ]( const asio::error_code& Error, size_t )
+    {
+        if( Error )
+        {
+            Fail( "Lost connection to server! " + Error.message() );
+            return;
+        }
+        
+        // The frame is handed off without copying it, and the next read gets a new buffer
+        NetMessage Type = (NetMessage) Body[ 0 ];
+        
+        if( OnMessage )
+            OnMessage( Type, std::move( Body ) );
+        
+        Body.clear();
+        
+        if( !bClosed )
+            ReadHeader();
+    } );
+}
+
+
+void NetworkClient::WriteNext()
+{
+    if( Outbox.empty() || bClosed )
+        return;
+    
+    asio::async_write( Socket, asio::buffer( Outbox.front() ), [ this ]( const asio::error_code& Error, size_t )
+    {
+        if( bClosed )
+            return;
+        
+        if( Error )
+        {
+            Fail( "Failed to send to server! " + Error.message() );
+            return;
+        }
+        
+        Outbox.pop_front();
+        WriteNext();
+    } );
+}
+
+
+void NetworkClient::Fail( const std::string& Reason )
+{
+    if( bClosed )
+        return;
+    
+    bClosed     = true;
+    bConnected  = false;
+    
+    asio::error_code Ignored;
+    Resolver.cancel();
+    Socket.shutdown( asio::ip::tcp::socket::shutdown_both, Ignored );
+    Socket.close( Ignored );
+    
+    // The outbox is left alone, a write might still be in flight using the front frame
+    cocos2d::log( "[Network] %s", Reason.c_str() );
+    
+    if( OnClosed )
+        OnClosed( Reason );
+}
@@ -0,0 +1,69 @@
+//
+//	NetworkClient.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "NetworkProtocol.hpp"
+#include "asio.hpp"
+#include <deque>
+#include <thread>
+#include <memory>
+
+
+namespace Game
+{
+    // TCP connection to a match server, running on its own network thread
+    // Frames are read and written asynchronously, and received frames are handed to the message callback
+    // on the network thread, so the owner is responsible for moving them onto the game thread
+    // The callback takes ownership of the whole frame, use OpenPayload to read it
+    class NetworkClient
+    {
+    public:
+    
+        typedef std::function< void( NetMessage, std::vector< uint8_t >&& ) > MessageCallback;
+        typedef std::function< void( const std::string& ) > ClosedCallback;
+        
+        NetworkClient();
+        ~NetworkClient();
+        
+        // Starts connecting in the background, Hello is sent once the connection is open
+        void Connect( const std::string& Host, uint16_t Port, const NetHello& Hello, MessageCallback OnMessage, ClosedCallback OnClosed );
+        
+        // Has to be called from the owners thread to join the network thread, calling it from a callback only starts the shutdown
+        void Close();
+        
+        // Takes a frame built with BeginFrame/FinishFrame, safe to call from any thread
+        void Send( std::vector< uint8_t >&& Frame );
+        
+        inline bool IsConnected() const { return bConnected; }
+    
+    protected:
+    
+        void ReadHeader();
+        void ReadBody( uint32_t Size );
+        void WriteNext();
+        void Fail( const std::string& Reason );
+        
+        asio::io_context Context;
+        asio::ip::tcp::socket Socket;
+        asio::ip::tcp::resolver Resolver;
+        std::thread Thread;
+        
+        uint8_t Header[ NET_FRAME_HEADER_SIZE ];
+        std::vector< uint8_t > Body;
+        std::deque< std::vector< uint8_t > > Outbox;
+        
+        MessageCallback OnMessage;
+        ClosedCallback OnClosed;
+        
+        std::atomic< bool > bConnected;
+        bool bClosed;
+    };
+}
@@ -0,0 +1,132 @@
+//
+//	NetworkProtocol.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "NetworkProtocol.hpp"
+#include "WireSchema.hpp"
+
+using namespace Game;
+
+
+/*=========================================================================================
+    Framing
+ =========================================================================================*/
+void Game::BeginFrame( StreamWriter& Out, NetMessage Type )
+{
+    Out.Buffer.clear();
+    Out.WriteFixed( 0, NET_FRAME_HEADER_SIZE );
+    Out.WriteByte( (uint8_t) Type );
+}
+
+
+void Game::FinishFrame( StreamWriter& Out )
+{
+    uint32_t Size = (uint32_t)( Out.Buffer.size() - NET_FRAME_HEADER_SIZE );
+    for( int i = 0; i < NET_FRAME_HEADER_SIZE; i++ )
+        Out.Buffer[ i ] = (uint8_t)( ( Size >> ( i * 8 ) ) & 0xFF );
+}
+
+
+uint32_t Game::ReadFrameSize( const uint8_t* Header )
+{
+    uint32_t Output = 0;
+    for( int i = 0; i < NET_FRAME_HEADER_SIZE; i++ )
+        Output |= (uint32_t) Header[ i ] << ( i * 8 );
+    
+    return Output;
+}
+
+
+/*=========================================================================================
+    Messages
+ =========================================================================================*/
+template< typename S >
+void NetHello::Schema( S& Stream )
+{
+    // The version always comes first, so a mismatched client can still be told to update
+    Stream.Unsigned( Version );
+    Stream.String( Name );
+    Stream.Unsigned( Deck.KingId );
+    Stream.Count( Deck.Cards );
+    
+    for( auto It = Deck.Cards.begin(); It != Deck.Cards.end() && Stream.IsValid(); It++ )
+    {
+        Stream.Unsigned( It->Id );
+        Stream.Unsigned( It->Ct );
+    }
+}
+
+
+void NetHello::Write( StreamWriter& Out ) const
+{
+    // Writing never changes the fields, the schema just isnt const so it can be shared with Read
+    SchemaWriter Stream( Out );
+    const_cast< NetHello* >( this )->Schema( Stream );
+}
+
+
+bool NetHello::Read( StreamReader& In )
+{
+    SchemaReader Stream( In );
+    Schema( Stream );
+    
+    return Stream.IsValid();
+}
+
+
+bool NetCommand::IsCommand( NetMessage Type )
+{
+    return Type >= NetMessage::SetReady && Type <= NetMessage::TriggerAbility;
+}
+
+
+// Only the fields used by the command type are encoded
+template< typename S >
+void NetCommand::Schema( S& Stream )
+{
+    switch( Type )
+    {
+        case NetMessage::SetBlitzCards:
+        case NetMessage::SetAttackers:
+            Stream.List( Cards );
+            break;
+        case NetMessage::SetBlockers:
+            Stream.Map( Blockers );
+            break;
+        case NetMessage::PlayCard:
+            Stream.Unsigned( Card );
+            Stream.Signed( Index );
+            break;
+        case NetMessage::TriggerAbility:
+            Stream.Unsigned( Card );
+            Stream.Byte( Ability );
+            break;
+        default:
+            break;
+    }
+}
+
+
+void NetCommand::Write( StreamWriter& Out ) const
+{
+    SchemaWriter Stream( Out );
+    const_cast< NetCommand* >( this )->Schema( Stream );
+}
+
+
+bool NetCommand::Read( StreamReader& In )
+{
+    Cards.clear();
+    Blockers.clear();
+    
+    SchemaReader Stream( In );
+    Schema( Stream );
+    
+    return Stream.IsValid();
+}
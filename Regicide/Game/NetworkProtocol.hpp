@@ -0,0 +1,97 @@
+//
+//	NetworkProtocol.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "ActionStream.hpp"
+#include "RegicideAPI/Account.hpp"
+#include <map>
+
+
+// Both sides have to be on the same version, the server broadcasts one encoding of each queue to both players
+// v2: Messages and queues are encoded with wire schema v2
+// v3: Match start and resyncs are state snapshots, redacted for each player
+#define NET_PROTOCOL_VERSION 3
+#define NET_DEFAULT_PORT 27015
+
+// Frames larger than this are treated as a protocol error, and the connection is dropped
+#define NET_MAX_FRAME_SIZE ( 256 * 1024 )
+#define NET_FRAME_HEADER_SIZE 4
+
+// Entity ids allocated by the server start here, so they never collide with the entities the client creates for itself
+#define NET_ENTITY_ID_BASE 0x40000000
+
+namespace Game
+{
+    // Every frame is a uint32 payload size (little endian), followed by the payload
+    // The payload starts with the message type, the rest is encoded with StreamWriter
+    enum class NetMessage : uint8_t
+    {
+        // Client -> Server
+        Hello           = 1,
+        SetReady        = 2,
+        SetBlitzCards   = 3,
+        PlayCard        = 4,
+        FinishTurn      = 5,
+        SetAttackers    = 6,
+        SetBlockers     = 7,
+        TriggerAbility  = 8,
+        SnapshotAck     = 9,
+        
+        // Server -> Client
+        Welcome         = 64,
+        MatchStart      = 65,
+        Queue           = 66,
+        Error           = 67,
+        Snapshot        = 68
+    };
+    
+    // Writes the frame header and message type, the size is filled in by FinishFrame
+    void BeginFrame( StreamWriter& Out, NetMessage Type );
+    void FinishFrame( StreamWriter& Out );
+    uint32_t ReadFrameSize( const uint8_t* Header );
+    
+    // Received frames are handed around whole, without the size header, and read in place past the message type
+    inline StreamReader OpenPayload( const std::vector< uint8_t >& Frame ) { return Frame.empty() ? StreamReader( nullptr, 0 ) : StreamReader( Frame.data() + 1, Frame.size() - 1 ); }
+    
+    // Sent by the client as soon as it connects, the server puts the player in the lobby once its received
+    struct NetHello
+    {
+        uint32_t Version = NET_PROTOCOL_VERSION;
+        std::string Name;
+        Regicide::Deck Deck;
+        
+        void Write( StreamWriter& Out ) const;
+        bool Read( StreamReader& In );
+        
+        template< typename S >
+        void Schema( S& Stream );
+    };
+    
+    // AuthorityBase calls sent from the client to the server. Only the fields used by the message type are encoded
+    struct NetCommand
+    {
+        NetMessage Type = NetMessage::SetReady;
+        
+        std::vector< uint32_t > Cards;
+        std::map< uint32_t, uint32_t > Blockers;
+        uint32_t Card = 0;
+        int32_t Index = 0;
+        uint8_t Ability = 0;
+        
+        void Write( StreamWriter& Out ) const;
+        bool Read( StreamReader& In );
+        
+        template< typename S >
+        void Schema( S& Stream );
+        
+        static bool IsCommand( NetMessage Type );
+    };
+}
@@ -93,7 +93,7 @@ namespace Game
         int Mana;
         int Health;
         
-        std::vector< CardState > Deck;
+        std::vector< CardState > Deck; // Top card is at the back
         std::vector< CardState > Hand;
         std::vector< CardState > Field;
         std::vector< CardState > Graveyard;
@@ -102,7 +102,8 @@ namespace Game
         
     private:
         
-        luabridge::LuaRef _lua_BuildTable( std::vector< CardState >::iterator Begin, std::vector< CardState >::iterator End )
+        template< typename Iterator >
+        luabridge::LuaRef _lua_BuildTable( Iterator Begin, Iterator End )
         {
             auto Engine = Regicide::LuaEngine::GetInstance();
             auto L = Engine ? Engine->State() : nullptr;
@@ -113,7 +114,7 @@ namespace Game
             
             int Index = 1;
             for( auto It = Begin; It != End; It++ )
-                Output[ Index ] = std::addressof( *It );
+                Output[ Index++ ] = std::addressof( *It );
             
             return Output;
         }
@@ -122,7 +123,8 @@ namespace Game
         
         luabridge::LuaRef _lua_GetDeck()
         {
-            return _lua_BuildTable( Deck.begin(), Deck.end() );
+            // Scripts expect the top card first, and its stored at the back
+            return _lua_BuildTable( Deck.rbegin(), Deck.rend() );
         }
         
         luabridge::LuaRef _lua_GetHand()
@@ -22,7 +22,7 @@ using namespace Game;
 
 
 Player::Player()
-: EntityBase( "Player" )
+: EntityBase( "Player", EntityKind::Player )
 {
     Mana                = 10;
     CardBackTexture     = "CardBack.png";
@@ -87,45 +87,8 @@ std::vector< CardEntity* > Player::GetAllCards()
 
 CardEntity* Player::PerformTouchTrace( const cocos2d::Vec2 &inPos )
 {
-    // Instead of building a vector of all cards, we can perform the
-    // lookup in this class, and return the result back to the touch layer
-    if( Hand )
-    {
-        auto ret = _Impl_TraceTouch( Hand->Begin(), Hand->End(), inPos );
-        if( ret )
-            return ret;
-    }
-    if( Field )
-    {
-        auto ret = _Impl_TraceTouch( Field->Begin(), Field->End(), inPos );
-        if( ret )
-            return ret;
-    }
-    if( Graveyard )
-    {
-        auto ret = _Impl_TraceTouch( Graveyard->Begin(), Graveyard->End(), inPos );
-        if( ret )
-            return ret;
-    }
-    if( Deck )
-    {
-        auto ret = _Impl_TraceTouch( Deck->Begin(), Deck->End(), inPos );
-        if( ret )
-            return ret;
-    }
-    
-    return nullptr;
-}
-
-CardEntity* Player::_Impl_TraceTouch( std::deque< CardEntity* >::iterator Begin, std::deque< CardEntity* >::iterator End, const cocos2d::Vec2 &inPos )
-{
-    for( auto It = Begin; It != End; It++ )
-    {
-        if( *It && (*It)->Sprite && (*It)->Sprite->getBoundingBox().containsPoint( inPos ) )
-            return *It;
-    }
-    
-    return nullptr;
+    // Only the cards near the touch are checked, and the topmost one wins
+    return CardManager::GetInstance().GetGrid().Trace( inPos, this );
 }
 
 
@@ -76,8 +76,6 @@ namespace Game
         
     private:
         
-        CardEntity* _Impl_TraceTouch( std::deque< CardEntity* >::iterator Begin, std::deque< CardEntity* >::iterator End, const cocos2d::Vec2& inPos );
-        
         bool _bIsTurn = false;
         
         // Friend the State
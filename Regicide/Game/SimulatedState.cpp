@@ -15,6 +15,7 @@
 #include "DeckEntity.hpp"
 #include "World.hpp"
 #include "SingleplayerAuthority.hpp"
+#include "AITelemetry.hpp"
 
 using namespace Game;
 
@@ -59,18 +60,58 @@ bool SimulatedState::CanPlayCard( PlayerState *Owner, CardState *Card )
     return false;
 }
 
+bool SimulatedState::TriggerAbility( PlayerState* Owner, uint32_t Card, uint8_t AbilityId )
+{
+    // Same checks and costs as the authority, without building any actions
+    CardState* Target = nullptr;
+    if( !Owner || !FindCard( Card, Owner, Target ) || !Target )
+        return false;
+    
+    auto Info = CardManager::GetInstance().GetInfoAddress( Target->Id );
+    if( !Info || Info->Abilities.count( AbilityId ) <= 0 )
+        return false;
+    
+    auto& Ability = Info->Abilities.at( AbilityId );
+    if( Ability.ManaCost > Owner->Mana || Ability.StaminaCost > Target->Stamina )
+        return false;
+    
+    if( !Ability.MainFunc || !Ability.MainFunc->isFunction() )
+        return false;
+    
+    // The main function is where the ability does its work, so its tracked with the rest of the Lua time
+    bool bCanRun = false;
+    {
+        AIPhaseScope Scope( AIPhase::Hooks );
+        
+        try
+        {
+            bCanRun = ( *Ability.MainFunc )( static_cast< GameStateBase* >( this ), *Target );
+        }
+        catch( std::exception& e )
+        {
+            cocos2d::log( "[Sim] An exception was thrown in an ability function! %s", e.what() );
+            bCanRun = false;
+        }
+    }
+    
+    if( !bCanRun )
+        return false;
+    
+    Owner->Mana         -= Ability.ManaCost;
+    Target->Stamina     -= Ability.StaminaCost;
+    
+    CallHook( "AbilityTriggered", Owner, *Target, Ability );
+    return true;
+}
+
 void SimulatedState::PrepareSimulation()
 {
     // We need to put cards in local players hand back into deck, shuffle both decks
     // and have the local player redraw the same number of cards
     auto HandSize = LocalPlayer.Hand.size();
-    for( auto It = LocalPlayer.Hand.begin(); It != LocalPlayer.Hand.end(); It++ )
-    {
-        It->Position = CardPos::DECK;
-        LocalPlayer.Deck.push_back( *It );
-    }
+    while( !LocalPlayer.Hand.empty() )
+        MoveCard( std::addressof( LocalPlayer ), CardPos::HAND, LocalPlayer.Hand.size() - 1, CardPos::DECK );
     
-    LocalPlayer.Hand.clear();
     ShuffleDeck( std::addressof( LocalPlayer ) );
     ShuffleDeck( std::addressof( Opponent ) );
     
@@ -82,13 +123,8 @@ void SimulatedState::PrepareSimulation()
             return;
         }
         
-        // Get random index
-        int Index = cocos2d::random( 0, (int) LocalPlayer.Deck.size() - 1 );
-        auto It = LocalPlayer.Deck.begin();
-        std::advance( It, Index );
-        It->Position = CardPos::HAND;
-        LocalPlayer.Hand.push_back( *It );
-        LocalPlayer.Deck.erase( It );
+        // Deck was just shuffled, so drawing off the top is already random
+        MoveCard( std::addressof( LocalPlayer ), CardPos::DECK, LocalPlayer.Deck.size() - 1, CardPos::HAND );
     }
 }
 
@@ -104,7 +140,8 @@ void SimulatedState::SimulatePlayerBlitz()
     if( TargetMax < MinMana )
         TargetMax = LocalPlayer.Mana;
     
-    std::vector< CardState* > Selection;
+    // Selections are kept as EntIds, pointers into the hand wont survive playing the first card
+    std::vector< uint32_t > Selection;
     std::vector< CardState* > Hand;
     
     for( auto It = LocalPlayer.Hand.begin(); It != LocalPlayer.Hand.end(); It++ )
@@ -121,31 +158,15 @@ void SimulatedState::SimulatePlayerBlitz()
         if( *It && (*It)->ManaCost + UsedMana <= TargetMax )
         {
             UsedMana += (*It)->ManaCost;
-            Selection.push_back( *It );
+            Selection.push_back( (*It)->EntId );
             Hand.erase( It );
         }
     }
     
     for( auto It = Selection.begin(); It != Selection.end(); It++ )
     {
-        for( auto j = LocalPlayer.Hand.begin(); j != LocalPlayer.Hand.end(); j++ )
-        {
-            if( std::addressof( *j ) == *It )
-            {
-                int NewMana = LocalPlayer.Mana - j->ManaCost;
-                if( NewMana < 0 )
-                {
-                    cocos2d::log( "[AI] SIM ERROR: Not enough mana for local player blitz" );
-                    continue;
-                }
-                
-                LocalPlayer.Mana = NewMana;
-                j->Position = CardPos::FIELD;
-                LocalPlayer.Field.push_back( *j );
-                LocalPlayer.Hand.erase( j );
-                break;
-            }
-        }
+        if( !PlayCard( std::addressof( LocalPlayer ), *It ) )
+            cocos2d::log( "[AI] SIM ERROR: Not enough mana for local player blitz" );
     }
 }
 
@@ -187,10 +208,7 @@ void SimulatedState::PreTurn( PlayerTurn InState )
         return;
     }
     
-    auto It = Player.Deck.begin();
-    It->Position = CardPos::HAND;
-    Player.Hand.push_back( *It );
-    Player.Deck.erase( It );
+    MoveCard( std::addressof( Player ), CardPos::DECK, Player.Deck.size() - 1, CardPos::HAND );
     
     auto NewCard = Player.Hand.back();
     CallHook( "OnDraw", std::addressof( Player ), std::addressof( NewCard ) );
@@ -556,10 +574,55 @@ void SimulatedState::RunSimulation( int MaxTurns )
 void SimulatedState::OnSimulationFinished( PlayerState* Winner )
 {
     WinningPlayer = Winner;
+}
+
+
+bool SimulatedState::PreHook( const std::string& HookName )
+{
+    if( !GameStateBase::PreHook( HookName ) )
+        return false;
     
-    if( Winner )
-        cocos2d::log( "[Sim] Simulated game won by %s", Winner->DisplayName.c_str() );
-    else
-        cocos2d::log( "[Sim] Simulated game resulted in a draw/not finished" );
-     
+    // Hook time is tracked seperately from the rest of the rollout in AI telemetry
+    if( auto Telemetry = AITelemetry::GetCurrent() )
+        Telemetry->BeginPhase( AIPhase::Hooks );
+    return true;
+}
+
+
+void SimulatedState::PostHook()
+{
+    if( auto Telemetry = AITelemetry::GetCurrent() )
+        Telemetry->EndPhase();
+    
+    GameStateBase::PostHook();
+}
+
+
+void SimulatedState::Summarize( SimulationSummary& Out )
+{
+    Out.SimulatedTurns  = GetSimulatedTurns();
+    Out.Winner          = PlayerTurn::None;
+    
+    if( WinningPlayer == std::addressof( LocalPlayer ) )
+        Out.Winner = PlayerTurn::LocalPlayer;
+    else if( WinningPlayer == std::addressof( Opponent ) )
+        Out.Winner = PlayerTurn::Opponent;
+    
+    Out.LocalDeck       = (int) LocalPlayer.Deck.size();
+    Out.LocalField      = (int) LocalPlayer.Field.size();
+    Out.LocalHealth     = LocalPlayer.Health;
+    Out.LocalMana       = LocalPlayer.Mana;
+    Out.LocalPower      = 0;
+    
+    for( auto It = LocalPlayer.Field.begin(); It != LocalPlayer.Field.end(); It++ )
+        Out.LocalPower += It->Power;
+    
+    Out.OpponentDeck    = (int) Opponent.Deck.size();
+    Out.OpponentField   = (int) Opponent.Field.size();
+    Out.OpponentHealth  = Opponent.Health;
+    Out.OpponentMana    = Opponent.Mana;
+    Out.OpponentPower   = 0;
+    
+    for( auto It = Opponent.Field.begin(); It != Opponent.Field.end(); It++ )
+        Out.OpponentPower += It->Power;
 }
@@ -16,6 +16,26 @@
 
 namespace Game
 {
+    // The values the AI uses to rate a finished simulation, this lets the scalar
+    // simulator and the batch simulator share the same reward calculation
+    struct SimulationSummary
+    {
+        int SimulatedTurns;
+        PlayerTurn Winner;
+        
+        int LocalDeck;
+        int LocalField;
+        int LocalPower;
+        int LocalHealth;
+        int LocalMana;
+        
+        int OpponentDeck;
+        int OpponentField;
+        int OpponentPower;
+        int OpponentHealth;
+        int OpponentMana;
+    };
+    
     class SimulatedState : public GameStateBase
     {
         
@@ -24,6 +44,7 @@ namespace Game
         SimulatedState();
         
         bool CanPlayCard( PlayerState* Owner, CardState* Card );
+        bool TriggerAbility( PlayerState* Owner, uint32_t Card, uint8_t AbilityId );
         void PrepareSimulation();
         void SimulatePlayerBlitz();
         void FinishBlitz();
@@ -40,6 +61,7 @@ namespace Game
         
         inline PlayerState* GetWinner() { return WinningPlayer; }
         inline int GetSimulatedTurns() const { return TurnNumber - SimulationStart; }
+        void Summarize( SimulationSummary& Out );
         
     protected:
         
@@ -50,9 +72,13 @@ namespace Game
         
         PlayerState* WinningPlayer;
         
+        virtual bool PreHook( const std::string& HookName ) override;
+        virtual void PostHook() override;
+        
         std::map< uint32_t, std::vector< uint32_t > > BattleMatrix;
         
         friend class AIController;
+        friend class BatchSimulator;
     };
     
 }
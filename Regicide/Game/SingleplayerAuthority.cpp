@@ -23,9 +23,19 @@
 using namespace Game;
 
 SingleplayerAuthority::SingleplayerAuthority()
-: AuthorityBase()
+: AuthorityBase(), EmptySeatTimeout( 0.f ), AI( nullptr )
 {
-    _bBlitzComplete = false;
+    _bBlitzComplete     = false;
+    _bPlayerBlitzSet    = false;
+    _bOpponentBlitzSet  = false;
+}
+
+SingleplayerAuthority::SingleplayerAuthority( std::shared_ptr< MatchScheduler > InScheduler )
+: AuthorityBase( InScheduler ), EmptySeatTimeout( 0.f ), AI( nullptr )
+{
+    _bBlitzComplete     = false;
+    _bPlayerBlitzSet    = false;
+    _bOpponentBlitzSet  = false;
 }
 
 SingleplayerAuthority::~SingleplayerAuthority()
@@ -50,7 +60,7 @@ void SingleplayerAuthority::PostInit()
     WaitOnPlayer( std::bind( &SingleplayerAuthority::StartGame, this, _1, _2 ), 4.f );
     
     // Setup Tick
-    cocos2d::Director::getInstance()->getScheduler()->schedule( std::bind( &SingleplayerAuthority::Tick, this, _1 ), this, 0.f, CC_REPEAT_FOREVER, 0.f, false, "SingleplayerAuthTick" );
+    Scheduler->ScheduleTick( "SingleplayerAuthTick", std::bind( &SingleplayerAuthority::Tick, this, _1 ) );
 }
 
 void SingleplayerAuthority::SceneInit( cocos2d::Scene *inScene )
@@ -71,22 +81,22 @@ void SingleplayerAuthority::SetReady()
     if( _fWaitCallback )
     {
         // Calc how long it took for the player to call this function
-        float Delta = std::chrono::duration_cast< std::chrono::seconds >( std::chrono::steady_clock::now() - _tWaitStart ).count();
+        float Delta = (float)( Scheduler->GetTime() - _tWaitStart );
         _fWaitCallback( Delta, false );
     }
     
     // Kill timeout timer
-    cocos2d::Director::getInstance()->getScheduler()->unschedule( "WaitOnTimeout", this );
+    Scheduler->Unschedule( "WaitOnTimeout" );
 }
 
 
 void SingleplayerAuthority::WaitOnPlayer( std::function< void( float, bool ) > OnReady, float Timeout )
 {
     _fWaitCallback = OnReady;
-    _tWaitStart = std::chrono::steady_clock::now();
+    _tWaitStart = Scheduler->GetTime();
     
     // Start timeout timer
-    cocos2d::Director::getInstance()->getScheduler()->schedule( std::bind( OnReady, std::placeholders::_1, true ), this, Timeout, 0, 0.f, false, "WaitOnTimeout" );
+    Scheduler->Schedule( "WaitOnTimeout", Timeout, std::bind( OnReady, std::placeholders::_1, true ) );
 }
 
 
@@ -96,7 +106,7 @@ void SingleplayerAuthority::StartGame( float Delay, bool bTimeout )
     State.mState = MatchState::CoinFlip;
     
     // Choose Player
-    int RandIndex = cocos2d::random( 0, 1 );
+    int RandIndex = State.GetRandom().Range( 0, 1 );
     if( RandIndex <= 0 )
         State.SetStartingPlayer( PlayerTurn::LocalPlayer );
     else
@@ -106,10 +116,9 @@ void SingleplayerAuthority::StartGame( float Delay, bool bTimeout )
     State.SetStartingPlayer( PlayerTurn::LocalPlayer );
     
     // Run Action
-    auto GM = GetGameMode< GameModeBase >();
     auto Player = GetActivePlayer();
 
-    CC_ASSERT( GM && Player );
+    CC_ASSERT( Player );
     
     auto Queue = ActionQueue();
     Queue.Callback = std::bind( &SingleplayerAuthority::CoinFlipFinish, this );
@@ -117,22 +126,19 @@ void SingleplayerAuthority::StartGame( float Delay, bool bTimeout )
     auto Flip = Queue.CreateAction< CoinFlipAction >();
     Flip->Player = Player->EntId;
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 
 void SingleplayerAuthority::CoinFlipFinish()
 {
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     // Update Match State
     State.mState = MatchState::Blitz;
     
     // Create Event Action
     auto Queue = ActionQueue();
     auto Blitz = Queue.CreateAction< EventAction >();
-    Blitz->Name = "BlitzStart";
+    Blitz->Id = ActionId::BlitzStart;
     
     auto Parallel = Queue.CreateAction< ParallelAction >();
     
@@ -153,20 +159,15 @@ void SingleplayerAuthority::CoinFlipFinish()
         return;
     }
     
-    // Draw the top X cards
+    // Draw the top X cards, the top of the deck is the back of the vector
     for( int i = 0; i < GAME_INITDRAW_COUNT; i++ )
     {
-        auto PlayerCard = LocalPlayer->Deck.begin();
-        auto OpponentCard = Opponent->Deck.begin();
+        auto PlayerCard = State.MoveCard( LocalPlayer, CardPos::DECK, LocalPlayer->Deck.size() - 1, CardPos::HAND );
+        auto OpponentCard = State.MoveCard( Opponent, CardPos::DECK, Opponent->Deck.size() - 1, CardPos::HAND );
         
-        PlayerCard->Position    = CardPos::HAND;
-        OpponentCard->Position  = CardPos::HAND;
         PlayerCard->FaceUp      = false;
         OpponentCard->FaceUp    = false;
         
-        LocalPlayer->Hand.push_back( *PlayerCard );
-        Opponent->Hand.push_back( *OpponentCard );
-        
         auto PlDraw = Parallel->CreateAction< DrawCardAction >();
         PlDraw->TargetPlayer = LocalPlayer->EntId;
         PlDraw->TargetCard = PlayerCard->EntId;
@@ -174,26 +175,25 @@ void SingleplayerAuthority::CoinFlipFinish()
         auto OpDraw = Parallel->CreateAction< DrawCardAction >();
         OpDraw->TargetPlayer = Opponent->EntId;
         OpDraw->TargetCard = OpponentCard->EntId;
-        
-        LocalPlayer->Deck.erase( PlayerCard );
-        Opponent->Deck.erase( OpponentCard );
     }
     
     // Add Query Action
     auto Query = Queue.CreateAction< TimedQueryAction >();
-    Query->Name = "BlitzQuery";
+    Query->Id = ActionId::BlitzQuery;
     Query->Deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 20 );
     
     PlayerBlitzSelection.clear();
     OpponentBlitzSelection.clear();
+    _bPlayerBlitzSet    = false;
+    _bOpponentBlitzSet  = false;
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
     
-    // Start AI
-    auto AI = GetAI();
-    CC_ASSERT( AI );
+    // Start AI, remote matches dont have one since both sides are players
+    if( AI )
+        AI->ChooseBlitz();
     
-    AI->ChooseBlitz();
+    WaitOnLocalSeat();
 }
 
 /*========================================================================================
@@ -207,7 +207,7 @@ void SingleplayerAuthority::AI_SetBlitz( const std::vector< uint32_t >& Cards )
         return;
     }
     
-    if( OpponentBlitzSelection.size() > 0 )
+    if( _bOpponentBlitzSet || _bBlitzComplete )
     {
         cocos2d::log( "[Authority] AI attempted to re-select blitz cards" );
         return;
@@ -264,13 +264,15 @@ void SingleplayerAuthority::AI_SetBlitz( const std::vector< uint32_t >& Cards )
         OpponentBlitzSelection.push_back( Target->EntId );
     }
     
+    _bOpponentBlitzSet = true;
+    
     /*
     auto GM = GetGameMode< GameModeBase >();
     CC_ASSERT( GM );
     
     auto Queue = ActionQueue();
     auto Success = Queue.CreateAction< PlayerEventAction >();
-    Success->Name = "BlitzSuccess";
+    Success->Id = ActionId::BlitzSuccess;
     Success->Player = Player->EntId;
     
     GM->RunActionQueue( Queue );
@@ -279,6 +281,12 @@ void SingleplayerAuthority::AI_SetBlitz( const std::vector< uint32_t >& Cards )
 
 
 void SingleplayerAuthority::SetBlitzCards( const std::vector< uint32_t >& Cards )
+{
+    DoSetBlitz( PlayerTurn::LocalPlayer, Cards );
+}
+
+
+void SingleplayerAuthority::DoSetBlitz( PlayerTurn Side, const std::vector< uint32_t >& Cards )
 {
     if( State.mState != MatchState::Blitz )
     {
@@ -287,7 +295,8 @@ void SingleplayerAuthority::SetBlitzCards( const std::vector< uint32_t >& Cards
     }
     
     // Check if blitz cards were already selected
-    if( PlayerBlitzSelection.size() > 0 )
+    auto& Selection = GetBlitzSelection( Side );
+    if( GetBlitzSet( Side ) || _bBlitzComplete )
     {
         cocos2d::log( "[Authority] Player attempted to re-select blitz cards!" );
         return;
@@ -295,7 +304,7 @@ void SingleplayerAuthority::SetBlitzCards( const std::vector< uint32_t >& Cards
     
     // We need to validate the selection
     std::map< uint32_t, uint8_t > Errors;
-    auto Player = State.GetPlayer();
+    auto Player = GetSidePlayer( Side );
     CC_ASSERT( Player );
 
     int ManaLeft = Player->Mana;
@@ -346,30 +355,42 @@ void SingleplayerAuthority::SetBlitzCards( const std::vector< uint32_t >& Cards
         }
         
         ManaLeft -= Target->ManaCost;
-        PlayerBlitzSelection.push_back( (*Target).EntId );
+        Selection.push_back( (*Target).EntId );
     }
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     
     // Check if there were errors
     if( !Errors.empty() )
     {
-        PlayerBlitzSelection.clear();
+        Selection.clear();
         
         auto Error = Queue.CreateAction< CardErrorAction >();
         Error->Errors = Errors;
     }
     else
     {
+        GetBlitzSet( Side ) = true;
+        
         auto Success    = Queue.CreateAction< PlayerEventAction >();
-        Success->Name   = "BlitzSuccess";
+        Success->Id     = ActionId::BlitzSuccess;
         Success->Player = Player->EntId;
     }
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
+}
+
+
+void SingleplayerAuthority::CompleteBlitz()
+{
+    if( _bBlitzComplete )
+        return;
+    
+    _bBlitzComplete     = true;
+    _bPlayerBlitzSet    = true;
+    _bOpponentBlitzSet  = true;
+    
+    FinishBlitz();
 }
 
 
@@ -377,9 +398,6 @@ void SingleplayerAuthority::FinishBlitz()
 {
     State.mState = MatchState::Main;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Player = State.GetPlayer();
     auto Opponent = State.GetOpponent();
     
@@ -432,7 +450,7 @@ void SingleplayerAuthority::FinishBlitz()
     State.CallHook( "BlitzFinish" );
     State.ClearActiveQueue();
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 void SingleplayerAuthority::StartMatch()
@@ -459,6 +477,62 @@ PlayerState* SingleplayerAuthority::GetInactivePlayer()
         return State.GetPlayer();
 }
 
+PlayerState* SingleplayerAuthority::GetSidePlayer( PlayerTurn Side )
+{
+    if( Side == PlayerTurn::LocalPlayer )
+        return State.GetPlayer();
+    else if( Side == PlayerTurn::Opponent )
+        return State.GetOpponent();
+    else
+        return nullptr;
+}
+
+PlayerTurn SingleplayerAuthority::GetOtherSide( PlayerTurn Side )
+{
+    if( Side == PlayerTurn::LocalPlayer )
+        return PlayerTurn::Opponent;
+    else if( Side == PlayerTurn::Opponent )
+        return PlayerTurn::LocalPlayer;
+    else
+        return PlayerTurn::None;
+}
+
+std::vector< uint32_t >& SingleplayerAuthority::GetBlitzSelection( PlayerTurn Side )
+{
+    return Side == PlayerTurn::Opponent ? OpponentBlitzSelection : PlayerBlitzSelection;
+}
+
+bool& SingleplayerAuthority::GetBlitzSet( PlayerTurn Side )
+{
+    return Side == PlayerTurn::Opponent ? _bOpponentBlitzSet : _bPlayerBlitzSet;
+}
+
+void SingleplayerAuthority::WaitOnLocalSeat()
+{
+    // Rescheduled at every decision, so an older timeout never carries into the next phase
+    if( EmptySeatTimeout > 0.f )
+        Scheduler->Schedule( "LocalSeatTimeout", EmptySeatTimeout, std::bind( &SingleplayerAuthority::OnLocalSeatTimeout, this, std::placeholders::_1 ) );
+}
+
+void SingleplayerAuthority::OnLocalSeatTimeout( float Delta )
+{
+    // The seat passes whatever it was asked for, the same as a player that never touches their cards
+    if( State.mState == MatchState::Blitz )
+    {
+        if( !_bPlayerBlitzSet )
+            DoSetBlitz( PlayerTurn::LocalPlayer, std::vector< uint32_t >() );
+    }
+    else if( State.mState == MatchState::Main )
+    {
+        if( State.pState == PlayerTurn::LocalPlayer && State.tState == TurnState::Marshal )
+            DoFinishTurn( PlayerTurn::LocalPlayer );
+        else if( State.pState == PlayerTurn::LocalPlayer && State.tState == TurnState::Attack )
+            DoSetAttackers( PlayerTurn::LocalPlayer, std::vector< uint32_t >() );
+        else if( State.pState == PlayerTurn::Opponent && State.tState == TurnState::Block )
+            DoSetBlockers( PlayerTurn::LocalPlayer, std::map< uint32_t, uint32_t >() );
+    }
+}
+
 void SingleplayerAuthority::PreTurn( PlayerTurn pTurn )
 {
     if( State.mState == MatchState::PostMatch )
@@ -470,8 +544,6 @@ void SingleplayerAuthority::PreTurn( PlayerTurn pTurn )
     State.tState = TurnState::PreTurn;
     
     // Perform Draw
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
     
     auto Player = GetActivePlayer();
     CC_ASSERT( Player );
@@ -511,7 +583,7 @@ void SingleplayerAuthority::PreTurn( PlayerTurn pTurn )
     
     // On callback, advance round state
     Queue.Callback = std::bind( &SingleplayerAuthority::Marshal, this );
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 
 }
 
@@ -526,28 +598,28 @@ void SingleplayerAuthority::Marshal()
     State.tState = TurnState::Marshal;
     State.mState = MatchState::Main;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     auto Update = Queue.CreateAction< EventAction >();
-    Update->Name = "MarshalStart";
+    Update->Id = ActionId::MarshalStart;
     
     // Call Hook
     State.SetActiveQueue( &Queue );
     State.CallHook( "MarshalStart", GetActivePlayer() );
     State.ClearActiveQueue();
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
     
     // Allow player to play cards, once the player is unable to perform
     // any actions, then the state will advance automatically
     
-    if( State.pState == PlayerTurn::Opponent )
+    if( State.pState == PlayerTurn::Opponent && AI )
     {
-        CC_ASSERT( AI );
         AI->PlayCards();
     }
+    else if( State.pState == PlayerTurn::LocalPlayer )
+    {
+        WaitOnLocalSeat();
+    }
     
 }
 
@@ -563,29 +635,29 @@ void SingleplayerAuthority::Attack()
     State.tState = TurnState::Attack;
     State.mState = MatchState::Main;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     auto Update = Queue.CreateAction< EventAction >();
-    Update->Name = "AttackStart";
+    Update->Id = ActionId::AttackStart;
     
     // Call Hook
     State.SetActiveQueue( &Queue );
     State.CallHook( "AttackStart", GetActivePlayer() );
     State.ClearActiveQueue();
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 
     
     // Allow player/opponent to select attackers, the player must call FinishTurn
     // to advance the round state
     
-    if( State.pState == PlayerTurn::Opponent )
+    if( State.pState == PlayerTurn::Opponent && AI )
     {
-        CC_ASSERT( AI );
         AI->ChooseAttackers();
     }
+    else if( State.pState == PlayerTurn::LocalPlayer )
+    {
+        WaitOnLocalSeat();
+    }
 }
 
 void SingleplayerAuthority::Block()
@@ -607,13 +679,10 @@ void SingleplayerAuthority::Block()
     State.tState = TurnState::Block;
     State.mState = MatchState::Main;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     
     auto Update = Queue.CreateAction< EventAction >();
-    Update->Name = "BlockStart";
+    Update->Id = ActionId::BlockStart;
     
     // Call Hook
     // Create a table of all attackers
@@ -642,20 +711,22 @@ void SingleplayerAuthority::Block()
         State.ClearActiveQueue();
     }
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
     
     // Allow player/opponent to select blockers, the player must call FinishTurn
     // to advance the round state
-    if( State.pState == PlayerTurn::LocalPlayer )
+    if( State.pState == PlayerTurn::LocalPlayer && AI )
     {
-        CC_ASSERT( AI );
-        
         std::vector< uint32_t > Attackers;
         for( auto It = BattleMatrix.begin(); It != BattleMatrix.end(); It++ )
             Attackers.push_back( It->first );
         
         AI->ChooseBlockers( Attackers );
     }
+    else if( State.pState == PlayerTurn::Opponent )
+    {
+        WaitOnLocalSeat();
+    }
     
 }
 
@@ -673,18 +744,15 @@ void SingleplayerAuthority::Damage()
     if( BattleMatrix.empty() )
     {
         cocos2d::log( "[Auth] No Attackers!" );
-        cocos2d::Director::getInstance()->getScheduler()->schedule( [=] ( float d ) { this->PostTurn(); }, this, 0.5f, 0, 0.f, false, "MoveToPost" );
+        Scheduler->Schedule( "MoveToPost", 0.5f, [=] ( float d ) { this->PostTurn(); } );
         return;
     }
     
     cocos2d::log( "[Auth] %d Attackers!", (int) BattleMatrix.size() );
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     auto Event = Queue.CreateAction< EventAction >();
-    Event->Name = "DamageStart";
+    Event->Id = ActionId::DamageStart;
     
     auto AttackingPlayer = GetActivePlayer();
     auto BlockingPlayer = GetInactivePlayer();
@@ -838,10 +906,10 @@ void SingleplayerAuthority::Damage()
     // TODO: Call Lua Hook
     
     auto Finish = Queue.CreateAction< EventAction >();
-    Finish->Name = "CleanupBoard";
+    Finish->Id = ActionId::CleanupBoard;
     
     Queue.Callback = std::bind( &SingleplayerAuthority::PostTurn, this );
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
     
     // Clear Battle Matrix
     BattleMatrix.clear();
@@ -856,8 +924,6 @@ void SingleplayerAuthority::AI_PlayCards( const std::vector< uint32_t >& Cards )
         return;
     }
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
     auto Player = State.GetOpponent();
     CC_ASSERT( Player );
     
@@ -898,7 +964,7 @@ void SingleplayerAuthority::AI_PlayCards( const std::vector< uint32_t >& Cards )
         
         if( Queue.Actions.size() > 0 )
         {
-            GM->RunActionQueue( std::move( Queue ) );
+            RunQueue( std::move( Queue ) );
             return;
         }
     }
@@ -909,30 +975,55 @@ void SingleplayerAuthority::AI_PlayCards( const std::vector< uint32_t >& Cards )
 
 void SingleplayerAuthority::AI_FinishPlay()
 {
-    // TODO: Make the AI choose abilities to trigger
     if( State.mState != MatchState::Main || State.tState != TurnState::Marshal || State.pState != PlayerTurn::Opponent )
     {
         cocos2d::log( "[Auth] AI Attempted to finish marshal phase outside of marshal phase!" );
         return;
     }
     
-    // DEBUG: Skip ability decision for now.. skip to attack
+    // The abilities were planned along with the plays, the AI hands them back through AI_TriggerAbilities
+    if( AI )
+    {
+        AI->TriggerAbilities();
+        return;
+    }
+    
+    Attack();
+}
+
+void SingleplayerAuthority::AI_TriggerAbilities( const std::vector< std::pair< uint32_t, uint8_t > >& Abilities )
+{
+    if( State.mState != MatchState::Main || State.tState != TurnState::Marshal || State.pState != PlayerTurn::Opponent )
+    {
+        cocos2d::log( "[Auth] AI attempted to trigger abilities outside of marshal phase!" );
+        return;
+    }
+    
+    // Each trigger is checked again against the real state, so an ability the board no longer allows is skipped
+    for( auto It = Abilities.begin(); It != Abilities.end(); It++ )
+    {
+        DoTriggerAbility( PlayerTurn::Opponent, It->first, It->second );
+    }
+    
     Attack();
 }
 
 
 void SingleplayerAuthority::PlayCard( uint32_t In, int Index )
 {
-    if( State.mState != MatchState::Main || State.tState != TurnState::Marshal || State.pState != PlayerTurn::LocalPlayer )
+    DoPlayCard( PlayerTurn::LocalPlayer, In, Index );
+}
+
+
+void SingleplayerAuthority::DoPlayCard( PlayerTurn Side, uint32_t In, int Index )
+{
+    if( State.mState != MatchState::Main || State.tState != TurnState::Marshal || State.pState != Side )
     {
         cocos2d::log( "[Auth] Player attempted to play card outside of proper marshal phase" );
         return;
     }
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
-    auto Player = State.GetPlayer();
+    auto Player = GetSidePlayer( Side );
     
     CC_ASSERT( Player );
     
@@ -963,7 +1054,7 @@ void SingleplayerAuthority::PlayCard( uint32_t In, int Index )
         cocos2d::log( "[Auth] Player attempted to play invalid card!" );
     }
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 void SingleplayerAuthority::PostTurn()
@@ -976,12 +1067,9 @@ void SingleplayerAuthority::PostTurn()
     State.tState = TurnState::PostTurn;
     State.mState = MatchState::Main;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     auto Event = Queue.CreateAction< EventAction >();
-    Event->Name = "TurnFinish";
+    Event->Id = ActionId::TurnFinish;
     
     State.SetActiveQueue( &Queue );
     State.CallHook( "PostTurn", GetActivePlayer() );
@@ -990,12 +1078,18 @@ void SingleplayerAuthority::PostTurn()
     PlayerTurn NextTurn = State.SwitchPlayerTurn();
     Queue.Callback = std::bind( &SingleplayerAuthority::PreTurn, this, NextTurn );
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 void SingleplayerAuthority::FinishTurn()
 {
-    if( State.pState == PlayerTurn::LocalPlayer )
+    DoFinishTurn( PlayerTurn::LocalPlayer );
+}
+
+
+void SingleplayerAuthority::DoFinishTurn( PlayerTurn Side )
+{
+    if( State.pState == Side )
     {
         if( State.tState == TurnState::Marshal )
             Attack();
@@ -1046,19 +1140,23 @@ void SingleplayerAuthority::AI_SetAttackers( const std::vector< uint32_t >& In )
     
     auto Queue = ActionQueue();
     Queue.Callback = std::bind( &SingleplayerAuthority::Block, this );
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
     
     auto Update = Queue.CreateAction< BattleMatrixAction >();
     Update->Matrix = BattleMatrix;
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 
 void SingleplayerAuthority::SetAttackers( const std::vector< uint32_t >& In )
 {
-    if( State.pState != PlayerTurn::LocalPlayer ||
+    DoSetAttackers( PlayerTurn::LocalPlayer, In );
+}
+
+
+void SingleplayerAuthority::DoSetAttackers( PlayerTurn Side, const std::vector< uint32_t >& In )
+{
+    if( State.pState != Side ||
        State.mState != MatchState::Main ||
        State.tState != TurnState::Attack )
     {
@@ -1067,11 +1165,10 @@ void SingleplayerAuthority::SetAttackers( const std::vector< uint32_t >& In )
     }
     
     BattleMatrix.clear();
-    auto Player = State.GetPlayer();
+    auto Player = GetSidePlayer( Side );
     bool bError = false;
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM && Player );
+    CC_ASSERT( Player );
     
     for( auto It = In.begin(); It != In.end(); It++ )
     {
@@ -1095,9 +1192,9 @@ void SingleplayerAuthority::SetAttackers( const std::vector< uint32_t >& In )
         
         auto Queue = ActionQueue();
         auto Err = Queue.CreateAction< CardErrorAction >();
-        Err->Name = "AttackError";
+        Err->Id = ActionId::AttackError;
         
-        GM->RunActionQueue( std::move( Queue ) );
+        RunQueue( std::move( Queue ) );
         return;
     }
     
@@ -1143,17 +1240,21 @@ void SingleplayerAuthority::AI_SetBlockers( const std::map< uint32_t, uint32_t >
             continue;
         }
         
-        BattleMatrix[ It->second ].push_back( It->first );
+        auto Entry = BattleMatrix.find( It->second );
+        if( Entry == BattleMatrix.end() )
+        {
+            cocos2d::log( "[Auth] AI Set Blockers: Bad attacker.. isnt attacking" );
+            continue;
+        }
+        
+        Entry->second.push_back( It->first );
     }
     
-    auto GM = GetGameMode< GameModeBase >();
-    CC_ASSERT( GM );
-    
     auto Queue = ActionQueue();
     auto Update = Queue.CreateAction< BattleMatrixAction >();
     Update->Matrix = BattleMatrix;
     
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
     
     Damage();
 }
@@ -1161,7 +1262,13 @@ void SingleplayerAuthority::AI_SetBlockers( const std::map< uint32_t, uint32_t >
 
 void SingleplayerAuthority::SetBlockers( const std::map< uint32_t, uint32_t >& Matrix )
 {
-    if( State.pState != PlayerTurn::Opponent ||
+    DoSetBlockers( PlayerTurn::LocalPlayer, Matrix );
+}
+
+
+void SingleplayerAuthority::DoSetBlockers( PlayerTurn Side, const std::map< uint32_t, uint32_t >& Matrix )
+{
+    if( State.pState != GetOtherSide( Side ) ||
         State.mState != MatchState::Main ||
         State.tState != TurnState::Block )
     {
@@ -1169,11 +1276,14 @@ void SingleplayerAuthority::SetBlockers( const std::map< uint32_t, uint32_t >& M
         return;
     }
     
-    auto AttackingPlayer = State.GetOpponent();
-    auto BlockingPlayer = State.GetPlayer();
+    auto AttackingPlayer = GetSidePlayer( GetOtherSide( Side ) );
+    auto BlockingPlayer = GetSidePlayer( Side );
     bool bError = false;
     CC_ASSERT( AttackingPlayer && BlockingPlayer );
     
+    // Blocks come from the client, so a bad one puts the matrix back exactly how the attacker declared it
+    auto Declared = BattleMatrix;
+    
     for( auto It = Matrix.begin(); It != Matrix.end(); It++ )
     {
         CardState* Attacker     = nullptr;
@@ -1200,14 +1310,21 @@ void SingleplayerAuthority::SetBlockers( const std::map< uint32_t, uint32_t >& M
             break;
         }
         
-        BattleMatrix[ It->second ].push_back( It->first );
+        // Only cards that were declared as attackers can be blocked, anything else would be pulled into combat
+        auto Entry = BattleMatrix.find( It->second );
+        if( Entry == BattleMatrix.end() )
+        {
+            cocos2d::log( "[Auth] Player Set Blockers: Attacking card isnt attacking!" );
+            bError = true;
+            break;
+        }
+        
+        Entry->second.push_back( It->first );
     }
     
     if( bError )
     {
-        for( auto It = BattleMatrix.begin(); It != BattleMatrix.end(); It++ )
-            It->second.clear();
-        
+        BattleMatrix = Declared;
         return;
     }
     
@@ -1217,12 +1334,17 @@ void SingleplayerAuthority::SetBlockers( const std::map< uint32_t, uint32_t >& M
 
 void SingleplayerAuthority::TriggerAbility( uint32_t Card, uint8_t AbilityId )
 {
-    // NOTE: For now, this is only for the local player
+    DoTriggerAbility( PlayerTurn::LocalPlayer, Card, AbilityId );
+}
+
+
+void SingleplayerAuthority::DoTriggerAbility( PlayerTurn Side, uint32_t Card, uint8_t AbilityId )
+{
+    // The AI triggers the abilities from its turn plan through here as well
     CardState* Target   = nullptr;
-    auto Player        = State.GetPlayer();
-    auto GM             = GetGameMode< GameModeBase >();
+    auto Player        = GetSidePlayer( Side );
     
-    CC_ASSERT( GM && Player );
+    CC_ASSERT( Player );
     
     if( !State.FindCard( Card, Player, Target ) || !Target )
     {
@@ -1321,10 +1443,9 @@ void SingleplayerAuthority::TriggerAbility( uint32_t Card, uint8_t AbilityId )
 void SingleplayerAuthority::OnGameWon( uint32_t Winner )
 {
     // Stop all timers
-    cocos2d::Director::getInstance()->getScheduler()->unscheduleAllForTarget( this );
+    Scheduler->UnscheduleAll();
     
     // Create Action
-    auto GM     = GetGameMode< GameModeBase >();
     auto Queue  = ActionQueue();
     auto Player = State.GetPlayer();
     auto Opponent = State.GetOpponent();
@@ -1347,7 +1468,7 @@ void SingleplayerAuthority::OnGameWon( uint32_t Winner )
     }
     
     State.mState = MatchState::PostMatch;
-    GM->RunActionQueue( std::move( Queue ) );
+    RunQueue( std::move( Queue ) );
 }
 
 
@@ -1372,44 +1493,11 @@ void SingleplayerAuthority::Tick( float Delta )
     else if( State.mState == MatchState::Blitz )
     {
         // Check for blitz completion
-        if( !_bBlitzComplete && PlayerBlitzSelection.size() > 0 && OpponentBlitzSelection.size() > 0 )
-        {
-            _bBlitzComplete = true;
-            FinishBlitz();
-        }
+        if( !_bBlitzComplete && _bPlayerBlitzSet && _bOpponentBlitzSet )
+            CompleteBlitz();
     }
 }
 
-bool LoadKing( uint16_t KingId, uint32_t Owner, KingState& Out )
-{
-    // Load lua file into the specified king state
-    auto Lua = Regicide::LuaEngine::GetInstance();
-    auto L = Lua ? Lua->State() : nullptr;
-    CC_ASSERT( L );
-    
-    auto Table = luabridge::newTable( L );
-    luabridge::setGlobal( L, Table, "KING" );
-    
-    if( Lua->RunScript( "kings/" + std::to_string( KingId ) + ".lua" ) )
-    {
-        // Validate King Table
-        if( Table.isTable() && Table[ "Name" ].isString() && Table[ "PlayerTexture" ].isString() &&
-           Table[ "OpponentTexture" ].isString() && Table[ "Hooks" ].isTable() )
-        {
-            Out.DisplayName = Table[ "Name" ].tostring();
-            Out.PlayerTexture = Table[ "PlayerTexture" ].tostring();
-            Out.OpponentTexture = Table[ "OpponentTexture" ].tostring();
-            Out.Id = KingId;
-            Out.Owner = Owner;
-            Out.Hooks = std::make_shared< luabridge::LuaRef >( Table[ "Hooks" ] );
-            
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 bool SingleplayerAuthority::DoLoad( PlayerState* Target, const std::string &Name, uint16_t Health, uint16_t Mana, const Regicide::Deck &Deck )
 {
     CC_ASSERT( Target );
@@ -1465,6 +1553,32 @@ bool SingleplayerAuthority::DoLoad( PlayerState* Target, const std::string &Name
     return true;
 }
 
+void SingleplayerAuthority::ScrambleCardIds()
+{
+    // Ids are allocated down the deck list, so every copy of a card would sit in one block of ids. Hidden cards
+    // still send their EntId, so one revealed card would give away its neighbours. Dealing the same ids back out
+    // in a random order, across both decks, leaves an id saying nothing about the card or who owns it
+    PlayerState* Players[] = { State.GetPlayer(), State.GetOpponent() };
+    std::vector< uint32_t > Ids;
+    
+    for( auto Target : Players )
+    {
+        for( auto It = Target->Deck.begin(); It != Target->Deck.end(); It++ )
+            Ids.push_back( It->EntId );
+    }
+    
+    auto& Rng = State.GetRandom();
+    for( int i = (int) Ids.size() - 1; i > 0; i-- )
+        std::swap( Ids[ i ], Ids[ Rng.Range( 0, i ) ] );
+    
+    size_t Next = 0;
+    for( auto Target : Players )
+    {
+        for( auto It = Target->Deck.begin(); It != Target->Deck.end(); It++ )
+            It->EntId = Ids[ Next++ ];
+    }
+}
+
 bool SingleplayerAuthority::LoadPlayers( const std::string &LocalPlayerName, uint16_t PlayerHealth, uint16_t PlayerMana, const Regicide::Deck &PlayerDeck, const std::string &OpponentName, uint16_t OpponentHealth, uint16_t OpponentMana, const Regicide::Deck &OpponentDeck )
 {
     auto Player     = State.GetPlayer();
@@ -1484,7 +1598,9 @@ bool SingleplayerAuthority::LoadPlayers( const std::string &LocalPlayerName, uin
         return false;
     }
     
-    // Shuffle Decks
+    // Index the new cards, then shuffle decks
+    ScrambleCardIds();
+    State.RebuildIndex();
     State.ShuffleDeck( Player );
     State.ShuffleDeck( Opponent );
     
@@ -8,6 +8,8 @@
 //    © 2018 Zachary Berry, All Rights Reserved
 //
 
+#pragma once
+
 #include "AuthorityBase.hpp"
 #include "GameModeBase.hpp"
 #include "CardEntity.hpp"
@@ -32,6 +34,7 @@ namespace Game
         virtual void SceneInit( cocos2d::Scene* inScene ) override;
         
         SingleplayerAuthority();
+        SingleplayerAuthority( std::shared_ptr< MatchScheduler > InScheduler );
         ~SingleplayerAuthority();
         
         virtual void SetReady() override;
@@ -45,11 +48,16 @@ namespace Game
         void AI_SetBlitz( const std::vector< uint32_t >& Cards );
         void AI_PlayCards( const std::vector< uint32_t >& Cards );
         void AI_FinishPlay();
+        void AI_TriggerAbilities( const std::vector< std::pair< uint32_t, uint8_t > >& Abilities );
         void AI_SetAttackers( const std::vector< uint32_t >& In );
         void AI_SetBlockers( const std::map< uint32_t, uint32_t >& Cards );
         
         std::map< uint32_t, std::vector< uint32_t > > BattleMatrix;
         
+        // When set, the local seat passes any decision it hasnt made after this many seconds, so matches with
+        // nobody in the seat (headless tools and tests) keep moving. Zero leaves the seat waiting on the player
+        float EmptySeatTimeout;
+        
         inline AIController* GetAI() { return AI; }
         
         void StartGame( float Delay, bool bTimeout );
@@ -61,6 +69,14 @@ namespace Game
         
         void WaitOnPlayer( std::function< void( float, bool ) > OnReady, float Timeout );
         
+        // Player input for either side, the public calls are always for the local player
+        void DoSetBlitz( PlayerTurn Side, const std::vector< uint32_t >& Cards );
+        void DoPlayCard( PlayerTurn Side, uint32_t In, int Index );
+        void DoFinishTurn( PlayerTurn Side );
+        void DoSetAttackers( PlayerTurn Side, const std::vector< uint32_t >& Cards );
+        void DoSetBlockers( PlayerTurn Side, const std::map< uint32_t, uint32_t >& Cards );
+        void DoTriggerAbility( PlayerTurn Side, uint32_t Card, uint8_t AbilityId );
+        
         std::vector< uint32_t > PlayerBlitzSelection;
         std::vector< uint32_t > OpponentBlitzSelection;
         
@@ -73,8 +89,18 @@ namespace Game
         void FinishBlitz();
         void StartMatch();
         
+        // Ends the blitz whether or not both sides have chosen, anyone who hasnt yet doesnt blitz any cards
+        void CompleteBlitz();
+        
         PlayerState* GetActivePlayer();
         PlayerState* GetInactivePlayer();
+        PlayerState* GetSidePlayer( PlayerTurn Side );
+        static PlayerTurn GetOtherSide( PlayerTurn Side );
+        std::vector< uint32_t >& GetBlitzSelection( PlayerTurn Side );
+        bool& GetBlitzSet( PlayerTurn Side );
+        
+        void WaitOnLocalSeat();
+        void OnLocalSeatTimeout( float Delta );
         
         void PreTurn( PlayerTurn pTurn );
         void Marshal();
@@ -91,12 +117,17 @@ namespace Game
     private:
         
         bool DoLoad( PlayerState* Target, const std::string& Name, uint16_t Mana, uint16_t Stamina, const Regicide::Deck& Deck );
+        void ScrambleCardIds();
         
-        std::chrono::steady_clock::time_point _tWaitStart;
+        double _tWaitStart;
         std::function< void( float, bool ) > _fWaitCallback;
         
         bool _bBlitzComplete;
         
+        // Passing the blitz leaves the selection empty, so whether each side has chosen is tracked on its own
+        bool _bPlayerBlitzSet;
+        bool _bOpponentBlitzSet;
+        
         friend class SingleplayerLauncher;
         
     };
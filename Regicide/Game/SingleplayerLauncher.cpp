@@ -23,6 +23,7 @@
 #include "AIController.hpp"
 #include "ClientState.hpp"
 #include "CardEntity.hpp"
+#include "TexturePreloader.hpp"
 
 
 using namespace Game;
@@ -52,8 +53,6 @@ void SingleplayerLauncher::Launch( const std::string& PlayerName, const std::str
     auto Cache = cocos2d::Director::getInstance()->getTextureCache();
     Cache->removeUnusedTextures();
     
-    TextureCount = 0;
-    
     // Launch game on background thread, progress and results reported through callbacks
     cocos2d::log( "[Launcher] Launch started! Loading entities..." );
     LauncherThread = std::make_shared< std::thread >( [ = ] ()
@@ -100,41 +99,31 @@ void SingleplayerLauncher::BeginLoadingTextures()
 {
     // Were going to begin loading textures asyncronously, to avoid blocking
     // the main thread, so the loading screen still animates
+    // Every entity adds what it needs to one plan, so textures shared between cards are only loaded once
     // We will wait for all textures to load (or fail) before finishing launch
-    TextureCount = 0;
-    LoadedTextures = 0;
-    bTexturesChecked = false;
+    Preloader = std::make_shared< TexturePreloader >();
     
     auto& EntManager = IEntityManager::GetInstance();
     
-    for( auto It = EntManager.Begin(); It != EntManager.End(); It++ )
+    EntManager.ForEachEntity( [ & ]( EntityBase* Entity )
     {
-        if( It->second )
-        {
-            int resCount = It->second->LoadResources( [ & ]()
-            {
-                LoadedTextures++;
-                
-                if( LoadedTextures >= TextureCount && bTexturesChecked )
-                {
-                    // All done loading!
-                    cocos2d::log( "[Launcher] Resources loaded! Creating scene.." );
-                    this->OnSuccess();
-                }
-            } );
-            
-            TextureCount += resCount;
-        }
-    }
+        Entity->LoadResources( *Preloader );
+    } );
     
-    bTexturesChecked = true;
-    
-    // Check if textures loaded already, shouldnt ever happen unless all textures are missing
-    if( LoadedTextures >= TextureCount )
+    Preloader->Start( [ this ]( float Percent )
     {
-        this->OnSuccess(); // TODO: Failure when too many textures fail or any?
-    }
-    
+        if( OnProgress )
+            OnProgress( Percent );
+    },
+    [ this ]()
+    {
+        // All done loading!
+        cocos2d::log( "[Launcher] Resources loaded! Creating scene.." );
+        Preloader.reset();
+        
+        if( OnSuccess )
+            OnSuccess(); // TODO: Failure when too many textures fail or any?
+    } );
 }
 
 void SingleplayerLauncher::Error( const std::string& Error )
@@ -13,6 +13,7 @@
 #include "RegicideAPI/Account.hpp"    // For Regicide::Card, Regicide::Deck
 #include "AppDelegate.hpp"
 #include <thread>
+#include <memory>
 
 
 namespace Game
@@ -24,6 +25,7 @@ namespace Game
     class GameModeBase;
     class AuthorityBase;
     class PlayerState;
+    class TexturePreloader;
     
     class SingleplayerLauncher
     {
@@ -61,9 +63,7 @@ namespace Game
         
         World* CreateWorld();
         void BeginLoadingTextures();
-        int TextureCount = 0;
-        int LoadedTextures = 0;
-        bool bTexturesChecked = false;
+        std::shared_ptr< TexturePreloader > Preloader;
         
         bool StreamPlayer( PlayerState* Source, Player* Target, bool bOpponent );
         bool StreamEntities( GameModeBase* Target, AuthorityBase* Source );
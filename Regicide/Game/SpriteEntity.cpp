@@ -9,6 +9,8 @@
 //
 
 #include "SpriteEntity.hpp"
+#include "CMS/TextureAtlas.hpp"
+#include "TexturePreloader.hpp"
 
 using namespace Game;
 
@@ -18,6 +20,7 @@ SpriteEntity::SpriteEntity( const std::string& inName, const std::string& baseTe
 : EntityBase( inName ), BaseTextureName( baseTexture )
 {
     BaseTexture     = nullptr;
+    BaseFrame       = nullptr;
     Sprite          = nullptr;
     ZOrder          = 1;
 }
@@ -25,6 +28,7 @@ SpriteEntity::SpriteEntity( const std::string& inName, const std::string& baseTe
 SpriteEntity::~SpriteEntity()
 {
     BaseTexture = nullptr;
+    BaseFrame   = nullptr;
     Sprite      = nullptr;
 }
 
@@ -37,9 +41,9 @@ void SpriteEntity::AddToScene( cocos2d::Node *inNode )
     if( Sprite )
         Sprite->removeFromParent();
     
-    if( BaseTexture )
+    if( BaseFrame || BaseTexture )
     {
-        Sprite = cocos2d::Sprite::createWithTexture( BaseTexture );
+        Sprite = BaseFrame ? cocos2d::Sprite::createWithSpriteFrame( BaseFrame ) : cocos2d::Sprite::createWithTexture( BaseTexture );
         Sprite->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
         Sprite->setName( "BaseSprite" );
         
@@ -76,62 +80,58 @@ void SpriteEntity::Cleanup()
     Sprite = nullptr;
 }
 
-int SpriteEntity::LoadResources( const std::function<void ()> &Callback )
+void SpriteEntity::LoadResources( TexturePreloader& Preloader )
 {
     if( BaseTextureName.empty() )
     {
         cocos2d::log( "[SpriteEntity] Warning: No texture set for entity! Entity Name: %s", GetEntityName().c_str() );
-        return 0;
+        return;
     }
     
-    auto Cache = cocos2d::Director::getInstance()->getTextureCache();
-    if( !Cache )
-    {
-        cocos2d::log( "[SpriteEntity] ERROR: Couldnt pre-load textures.. Texture Cache was null!" );
-        return 0;
-    }
+    int Priority = GetLoadPriority();
     
-    int TextureCount = 1;
-    Cache->addImageAsync( BaseTextureName, [ = ]( cocos2d::Texture2D* loadedTexture ) -> void
+    // Images in the atlas are loaded with it, so only the rest are given to the preloader
+    BaseFrame = Regicide::TextureAtlas::GetFrame( BaseTextureName );
+    if( !BaseFrame )
     {
-        if( !loadedTexture )
+        Preloader.Add( BaseTextureName, Priority, [ = ]( cocos2d::Texture2D* loadedTexture )
         {
-            cocos2d::log( "[SpriteEntity] Warning: Failed to load base texture for '%s'.. Texture Name: %s", this->GetEntityName().c_str(), this->BaseTextureName.c_str() );
-            this->BaseTexture = nullptr;
-        }
-        else
-        {
-            this->BaseTexture = loadedTexture;
-        }
-        
-        Callback();
-    } );
+            if( !loadedTexture )
+            {
+                cocos2d::log( "[SpriteEntity] Warning: Failed to load base texture for '%s'.. Texture Name: %s", this->GetEntityName().c_str(), this->BaseTextureName.c_str() );
+                this->BaseTexture = nullptr;
+            }
+            else
+            {
+                this->BaseTexture = loadedTexture;
+            }
+        } );
+    }
     
     // Load Overlay Textures
     for( auto It = Overlays.begin(); It != Overlays.end(); It++ )
     {
-        if( !It->second.TextureName.empty() )
+        if( It->second.TextureName.empty() )
+            continue;
+        
+        It->second.Frame = Regicide::TextureAtlas::GetFrame( It->second.TextureName );
+        if( !It->second.Frame )
         {
-            Cache->addImageAsync( It->second.TextureName, [ = ]( cocos2d::Texture2D* loadedTexture )
+            auto* Overlay = &It->second;
+            Preloader.Add( Overlay->TextureName, Priority, [ = ]( cocos2d::Texture2D* loadedTexture )
             {
                 if( !loadedTexture )
                 {
-                    cocos2d::log( "[SpriteEntity] Warning: Failed to load overlay texture for '%s'.. Texture Name: %s", this->GetEntityName().c_str(), It->second.TextureName.c_str() );
-                    It->second.Texture = nullptr;
+                    cocos2d::log( "[SpriteEntity] Warning: Failed to load overlay texture for '%s'.. Texture Name: %s", this->GetEntityName().c_str(), Overlay->TextureName.c_str() );
+                    Overlay->Texture = nullptr;
                 }
                 else
                 {
-                    It->second.Texture = loadedTexture;
+                    Overlay->Texture = loadedTexture;
                 }
-                
-                Callback();
             } );
-            
-            TextureCount++;
         }
     }
-    
-    return TextureCount;
 }
 
 bool SpriteEntity::ShowOverlay( const std::string &inId )
@@ -150,8 +150,11 @@ bool SpriteEntity::ShowOverlay( const std::string &inId )
         return false;
     }
     
-    // If the texture wasnt already loaded, then we will manually load it
-    if( !Overlay.Texture )
+    // If the texture wasnt already loaded, and isnt in the atlas, then we will manually load it
+    if( !Overlay.Frame )
+        Overlay.Frame = Regicide::TextureAtlas::GetFrame( Overlay.TextureName );
+    
+    if( !Overlay.Frame && !Overlay.Texture )
     {
         auto Cache = cocos2d::Director::getInstance()->getTextureCache();
         if( !Cache )
@@ -176,7 +179,7 @@ bool SpriteEntity::ShowOverlay( const std::string &inId )
     else
     {
         // Create the new sprite
-        Overlay.Sprite = cocos2d::Sprite::createWithTexture( Overlay.Texture );
+        Overlay.Sprite = Overlay.Frame ? cocos2d::Sprite::createWithSpriteFrame( Overlay.Frame ) : cocos2d::Sprite::createWithTexture( Overlay.Texture );
         Overlay.Sprite->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
         Overlay.Sprite->setPosition( Sprite->getContentSize() * 0.5f );
         Overlay.Sprite->setGlobalZOrder( Sprite->getGlobalZOrder() + Overlay.LocalZ );
@@ -224,6 +227,7 @@ void SpriteEntity::PreloadOverlay( const std::string &inId, const std::string &i
     
     Overlays[ inId ].TextureName    = inTexture;
     Overlays[ inId ].Texture        = nullptr;
+    Overlays[ inId ].Frame          = nullptr;
     Overlays[ inId ].Sprite         = nullptr;
     Overlays[ inId ].LocalZ         = LocalZ;
 }
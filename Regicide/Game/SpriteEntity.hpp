@@ -21,6 +21,7 @@ namespace Game
     {
         std::string TextureName;
         cocos2d::Texture2D* Texture;
+        cocos2d::SpriteFrame* Frame;
         cocos2d::Sprite* Sprite;
         int LocalZ;
     };
@@ -47,13 +48,16 @@ namespace Game
     protected:
         
         virtual void Cleanup() override;
-        virtual int LoadResources( const std::function< void() >& Callback ) override;
+        virtual void LoadResources( TexturePreloader& Preloader ) override;
         
         void PreloadOverlay( const std::string& inId, const std::string& inTexture, int LocalZ );
         
         std::string BaseTextureName;
         cocos2d::Texture2D* BaseTexture;
         
+        // Set instead of the texture when the image was packed into the card atlas
+        cocos2d::SpriteFrame* BaseFrame;
+        
         cocos2d::Sprite* Sprite;
         int ZOrder;
         
@@ -0,0 +1,414 @@
+//
+//	StateSnapshot.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "StateSnapshot.hpp"
+#include "GameStateBase.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+/*=========================================================================================
+    Images
+ =========================================================================================*/
+struct SnapshotCard
+{
+    uint8_t Side;
+    uint16_t Slot;
+    CardState State;
+};
+
+struct SnapshotPlayer
+{
+    uint32_t EntId;
+    int Mana;
+    int Health;
+    uint16_t KingId;
+    uint32_t KingOwner;
+    std::string Name;
+};
+
+
+bool StateSnapshot::CanSee( PlayerTurn Viewer, int Side, CardPos Zone )
+{
+    if( Zone == CardPos::DECK )
+        return false;
+    
+    if( Zone == CardPos::HAND )
+        return Viewer != PlayerTurn::None && (int) Viewer == Side;
+    
+    return true;
+}
+
+
+void StateSnapshot::Capture( GameStateBase& In, PlayerTurn Viewer, std::vector< uint8_t >& Out )
+{
+    StreamWriter Image;
+    Image.Buffer.swap( Out );
+    Image.Buffer.clear();
+    
+    Image.WriteByte( (uint8_t) In.mState );
+    Image.WriteByte( (uint8_t) In.pState );
+    Image.WriteByte( (uint8_t) In.tState );
+    Image.WriteByte( (uint8_t) In.GetStartingPlayer() );
+    Image.WriteFixed( (uint32_t) In.TurnNumber, 4 );
+    
+    PlayerState* Players[] = { In.GetPlayer(), In.GetOpponent() };
+    std::vector< SnapshotCard > Cards;
+    
+    for( int i = 0; i < 2; i++ )
+    {
+        auto Player = Players[ i ];
+        Image.WriteFixed( Player->EntId, 4 );
+        Image.WriteFixed( (uint32_t) Player->Mana, 4 );
+        Image.WriteFixed( (uint32_t) Player->Health, 4 );
+        Image.WriteFixed( Player->King.Id, 2 );
+        Image.WriteFixed( Player->King.Owner, 4 );
+        
+        std::vector< CardState >* Zones[] = { &Player->Deck, &Player->Hand, &Player->Field, &Player->Graveyard };
+        for( auto Zone : Zones )
+        {
+            for( size_t Slot = 0; Slot < Zone->size(); Slot++ )
+            {
+                SnapshotCard Card;
+                Card.Side   = (uint8_t) i;
+                Card.Slot   = (uint16_t) Slot;
+                Card.State  = ( *Zone )[ Slot ];
+                
+                // Hidden cards keep where they are, but nothing about what they are. Deck order is never sent
+                if( !CanSee( Viewer, i, Card.State.Position ) )
+                {
+                    Card.State.Id       = 0;
+                    Card.State.Power    = 0;
+                    Card.State.Stamina  = 0;
+                    Card.State.ManaCost = 0;
+                    Card.State.FaceUp   = false;
+                    
+                    if( Card.State.Position == CardPos::DECK )
+                        Card.Slot = 0;
+                }
+                
+                Cards.push_back( Card );
+            }
+        }
+    }
+    
+    std::sort( Cards.begin(), Cards.end(), []( const SnapshotCard& A, const SnapshotCard& B ) { return A.State.EntId < B.State.EntId; } );
+    
+    Image.WriteFixed( Cards.size(), 2 );
+    for( auto It = Cards.begin(); It != Cards.end(); It++ )
+    {
+        Image.WriteFixed( It->State.EntId, 4 );
+        Image.WriteByte( It->Side );
+        Image.WriteByte( (uint8_t) It->State.Position );
+        Image.WriteFixed( It->Slot, 2 );
+        Image.WriteFixed( It->State.Id, 2 );
+        Image.WriteFixed( (uint32_t) It->State.Power, 4 );
+        Image.WriteFixed( (uint32_t) It->State.Stamina, 4 );
+        Image.WriteFixed( (uint32_t) It->State.ManaCost, 4 );
+        Image.WriteByte( It->State.FaceUp ? 1 : 0 );
+        Image.WriteFixed( It->State.Owner, 4 );
+    }
+    
+    // Names go last, so they dont shift the rest of the image if they ever change
+    for( int i = 0; i < 2; i++ )
+    {
+        auto& Name = Players[ i ]->DisplayName;
+        size_t Length = std::min< size_t >( Name.size(), UINT16_MAX );
+        
+        Image.WriteFixed( Length, 2 );
+        Image.WriteBytes( (const uint8_t*) Name.data(), Length );
+    }
+    
+    Out.swap( Image.Buffer );
+}
+
+
+bool StateSnapshot::Restore( const std::vector< uint8_t >& In, GameStateBase& Out )
+{
+    StreamReader Image( In.data(), In.size() );
+    
+    // Everything is read and checked before the state is touched, so a bad image leaves it how it was
+    MatchState Match    = (MatchState) Image.ReadByte();
+    PlayerTurn Turn     = (PlayerTurn) Image.ReadByte();
+    TurnState Phase     = (TurnState) Image.ReadByte();
+    PlayerTurn Starting = (PlayerTurn) Image.ReadByte();
+    int TurnNumber      = (int)(int32_t) Image.ReadFixed( 4 );
+    
+    SnapshotPlayer Read[ 2 ];
+    for( int i = 0; i < 2; i++ )
+    {
+        Read[ i ].EntId     = (uint32_t) Image.ReadFixed( 4 );
+        Read[ i ].Mana      = (int)(int32_t) Image.ReadFixed( 4 );
+        Read[ i ].Health    = (int)(int32_t) Image.ReadFixed( 4 );
+        Read[ i ].KingId    = (uint16_t) Image.ReadFixed( 2 );
+        Read[ i ].KingOwner = (uint32_t) Image.ReadFixed( 4 );
+    }
+    
+    PlayerState* Players[] = { Out.GetPlayer(), Out.GetOpponent() };
+    size_t Count = (size_t) Image.ReadFixed( 2 );
+    std::vector< SnapshotCard > Cards;
+    
+    for( size_t i = 0; i < Count && Image.IsValid(); i++ )
+    {
+        SnapshotCard Card;
+        Card.State.EntId    = (uint32_t) Image.ReadFixed( 4 );
+        Card.Side           = Image.ReadByte();
+        Card.State.Position = (CardPos) Image.ReadByte();
+        Card.Slot           = (uint16_t) Image.ReadFixed( 2 );
+        Card.State.Id       = (uint16_t) Image.ReadFixed( 2 );
+        Card.State.Power    = (int)(int32_t) Image.ReadFixed( 4 );
+        Card.State.Stamina  = (int)(int32_t) Image.ReadFixed( 4 );
+        Card.State.ManaCost = (int)(int32_t) Image.ReadFixed( 4 );
+        Card.State.FaceUp   = Image.ReadByte() != 0;
+        Card.State.Owner    = (uint32_t) Image.ReadFixed( 4 );
+        
+        if( Card.Side > 1 || !Out.GetZone( Players[ Card.Side ], Card.State.Position ) )
+            return false;
+        
+        Cards.push_back( Card );
+    }
+    
+    for( int i = 0; i < 2 && Image.IsValid(); i++ )
+    {
+        size_t Length = (size_t) Image.ReadFixed( 2 );
+        const uint8_t* Name = Image.ReadView( Length );
+        
+        if( Name )
+            Read[ i ].Name.assign( (const char*) Name, Length );
+    }
+    
+    if( !Image.IsValid() )
+        return false;
+    
+    for( int i = 0; i < 2; i++ )
+    {
+        auto Player = Players[ i ];
+        Player->EntId       = Read[ i ].EntId;
+        Player->Mana        = Read[ i ].Mana;
+        Player->Health      = Read[ i ].Health;
+        Player->King.Id     = Read[ i ].KingId;
+        Player->King.Owner  = Read[ i ].KingOwner;
+        Player->DisplayName = Read[ i ].Name;
+        
+        Player->Deck.clear();
+        Player->Hand.clear();
+        Player->Field.clear();
+        Player->Graveyard.clear();
+    }
+    
+    // Cards are stored by EntId, put each zone back in slot order. Deck slots are all zero, so decks stay in EntId order
+    std::stable_sort( Cards.begin(), Cards.end(), []( const SnapshotCard& A, const SnapshotCard& B ) { return A.Slot < B.Slot; } );
+    for( auto It = Cards.begin(); It != Cards.end(); It++ )
+        Out.GetZone( Players[ It->Side ], It->State.Position )->push_back( It->State );
+    
+    // Starting player resets the turn state, so it goes first
+    Out.SetStartingPlayer( Starting );
+    Out.mState      = Match;
+    Out.pState      = Turn;
+    Out.tState      = Phase;
+    Out.TurnNumber  = TurnNumber;
+    
+    Out.RebuildIndex();
+    return true;
+}
+
+
+/*=========================================================================================
+    Deltas
+ =========================================================================================*/
+static inline uint8_t BaselineAt( const std::vector< uint8_t >& Baseline, size_t Index )
+{
+    return Index < Baseline.size() ? Baseline[ Index ] : 0;
+}
+
+
+void StateSnapshot::WriteDelta( const std::vector< uint8_t >& Baseline, const std::vector< uint8_t >& Current, StreamWriter& Out )
+{
+    Out.WriteVarint( Current.size() );
+    
+    size_t Index = 0;
+    while( Index < Current.size() )
+    {
+        size_t Start = Index;
+        while( Index < Current.size() && Current[ Index ] == BaselineAt( Baseline, Index ) )
+            Index++;
+        
+        Out.WriteVarint( Index - Start );
+        
+        // A single matching byte inside a changed run costs less to send than starting a new run
+        Start = Index;
+        while( Index < Current.size() )
+        {
+            if( Current[ Index ] == BaselineAt( Baseline, Index ) &&
+               ( Index + 1 >= Current.size() || Current[ Index + 1 ] == BaselineAt( Baseline, Index + 1 ) ) )
+                break;
+            
+            Index++;
+        }
+        
+        Out.WriteVarint( Index - Start );
+        for( size_t i = Start; i < Index; i++ )
+            Out.WriteByte( Current[ i ] ^ BaselineAt( Baseline, i ) );
+    }
+}
+
+
+bool StateSnapshot::ReadDelta( const std::vector< uint8_t >& Baseline, StreamReader& In, std::vector< uint8_t >& Out )
+{
+    uint64_t Size = In.ReadVarint();
+    if( !In.IsValid() || Size > SNAPSHOT_MAX_SIZE )
+        return false;
+    
+    Out.resize( (size_t) Size );
+    
+    size_t Index = 0;
+    while( Index < Out.size() )
+    {
+        uint64_t Unchanged = In.ReadVarint();
+        if( !In.IsValid() || Unchanged > Out.size() - Index )
+            return false;
+        
+        for( size_t End = Index + (size_t) Unchanged; Index < End; Index++ )
+            Out[ Index ] = BaselineAt( Baseline, Index );
+        
+        uint64_t Changed = In.ReadVarint();
+        if( !In.IsValid() || Changed > Out.size() - Index )
+            return false;
+        
+        for( size_t End = Index + (size_t) Changed; Index < End; Index++ )
+            Out[ Index ] = In.ReadByte() ^ BaselineAt( Baseline, Index );
+    }
+    
+    return In.IsValid();
+}
+
+
+/*=========================================================================================
+    History
+ =========================================================================================*/
+SnapshotHistory::SnapshotHistory()
+{
+    Reset();
+}
+
+
+void SnapshotHistory::Reset()
+{
+    Pending.clear();
+    AckedImage.clear();
+    AckedSequence   = 0;
+    NextSequence    = 1;
+}
+
+
+void SnapshotHistory::WriteUpdate( GameStateBase& In, PlayerTurn Viewer, StreamWriter& Out )
+{
+    Entry Snapshot;
+    Snapshot.Sequence = NextSequence++;
+    StateSnapshot::Capture( In, Viewer, Snapshot.Image );
+    
+    Out.WriteVarint( Snapshot.Sequence );
+    Out.WriteVarint( AckedSequence );
+    
+    if( AckedSequence == 0 )
+    {
+        Out.WriteVarint( Snapshot.Image.size() );
+        Out.WriteBytes( Snapshot.Image.data(), Snapshot.Image.size() );
+    }
+    else
+    {
+        StateSnapshot::WriteDelta( AckedImage, Snapshot.Image, Out );
+    }
+    
+    // A viewer that stopped acknowledging only holds the last few, so theres no point keeping more than that
+    Pending.push_back( std::move( Snapshot ) );
+    if( Pending.size() > SNAPSHOT_HISTORY_SIZE )
+        Pending.pop_front();
+}
+
+
+void SnapshotHistory::Acknowledge( uint32_t Sequence )
+{
+    if( Sequence == 0 )
+    {
+        Pending.clear();
+        AckedImage.clear();
+        AckedSequence = 0;
+        return;
+    }
+    
+    // Acks can arrive out of order, an older one than we already have is ignored
+    if( Sequence <= AckedSequence )
+        return;
+    
+    while( !Pending.empty() && Pending.front().Sequence < Sequence )
+        Pending.pop_front();
+    
+    if( Pending.empty() || Pending.front().Sequence != Sequence )
+        return;
+    
+    AckedImage.swap( Pending.front().Image );
+    AckedSequence = Sequence;
+    Pending.pop_front();
+}
+
+
+void SnapshotReceiver::Reset()
+{
+    Received.clear();
+}
+
+
+bool SnapshotReceiver::ReadUpdate( StreamReader& In, GameStateBase& Out, uint32_t& OutSequence )
+{
+    OutSequence = 0;
+    
+    Entry Snapshot;
+    Snapshot.Sequence   = (uint32_t) In.ReadVarint();
+    uint32_t Baseline   = (uint32_t) In.ReadVarint();
+    
+    if( !In.IsValid() || Snapshot.Sequence == 0 )
+        return false;
+    
+    if( Baseline == 0 )
+    {
+        uint64_t Size = In.ReadVarint();
+        const uint8_t* Image = Size <= SNAPSHOT_MAX_SIZE ? In.ReadView( (size_t) Size ) : nullptr;
+        if( !Image )
+            return false;
+        
+        Snapshot.Image.assign( Image, Image + Size );
+    }
+    else
+    {
+        auto Base = std::find_if( Received.begin(), Received.end(), [ Baseline ]( const Entry& E ) { return E.Sequence == Baseline; } );
+        if( Base == Received.end() )
+        {
+            cocos2d::log( "[Snapshot] Missing baseline %d, asking for a full snapshot", (int) Baseline );
+            return false;
+        }
+        
+        if( !StateSnapshot::ReadDelta( Base->Image, In, Snapshot.Image ) )
+            return false;
+    }
+    
+    if( !StateSnapshot::Restore( Snapshot.Image, Out ) )
+        return false;
+    
+    OutSequence = Snapshot.Sequence;
+    
+    Received.push_back( std::move( Snapshot ) );
+    if( Received.size() > SNAPSHOT_HISTORY_SIZE )
+        Received.pop_front();
+    
+    return true;
+}
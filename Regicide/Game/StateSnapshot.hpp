@@ -0,0 +1,110 @@
+//
+//	StateSnapshot.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "ActionStream.hpp"
+#include <deque>
+
+
+// Images larger than this are rejected when reading a delta, a full match is only a few kilobytes
+#define SNAPSHOT_MAX_SIZE ( 64 * 1024 )
+
+// How many received images the client holds on to, the server only ever builds deltas against one it acknowledged
+#define SNAPSHOT_HISTORY_SIZE 8
+
+namespace Game
+{
+    class GameStateBase;
+    
+    // Snapshots are a fixed layout image of the state, as seen by one viewer
+    // Cards are stored in one table sorted by EntId, instead of zone by zone, so a card moving between zones
+    // only changes its own row, and two images of the same match line up byte for byte. That way the XOR of two
+    // images is almost all zeros, and a delta is just the runs that changed
+    //
+    // Image Layout (little endian)
+    //  uint8 MatchState, uint8 PlayerTurn, uint8 TurnState, uint8 StartingPlayer, int32 TurnNumber
+    //  2x Player { uint32 EntId, int32 Mana, int32 Health, uint16 KingId, uint32 KingOwner }
+    //  uint16 CardCount, CardCount x Card { uint32 EntId, uint8 Side, uint8 Zone, uint16 Slot, uint16 Id,
+    //                                       int32 Power, int32 Stamina, int32 ManaCost, uint8 FaceUp, uint32 Owner }
+    //  2x Player Name { uint16 Length, Bytes }
+    //
+    // Cards the viewer cant see only keep their EntId, side and zone. That means both decks for everyone,
+    // and the opponents hand. Spectators (PlayerTurn::None) dont see either hand
+    class StateSnapshot
+    {
+    public:
+    
+        static void Capture( GameStateBase& In, PlayerTurn Viewer, std::vector< uint8_t >& Out );
+        
+        // Whether the viewer gets to see cards in this zone, for the side (0 = local player, 1 = opponent)
+        static bool CanSee( PlayerTurn Viewer, int Side, CardPos Zone );
+        static bool Restore( const std::vector< uint8_t >& In, GameStateBase& Out );
+        
+        // Delta Format: varint Size, then pairs of varint Unchanged, varint Changed, Changed x uint8 XOR
+        // until the whole image is covered. Bytes past the end of the baseline are XOR'd against zero
+        static void WriteDelta( const std::vector< uint8_t >& Baseline, const std::vector< uint8_t >& Current, StreamWriter& Out );
+        static bool ReadDelta( const std::vector< uint8_t >& Baseline, StreamReader& In, std::vector< uint8_t >& Out );
+    };
+    
+    // Server side, tracks what has been sent to one viewer. Updates are deltas against the newest snapshot the
+    // viewer acknowledged, and full snapshots until the first acknowledgement
+    //
+    // Update Format: varint Sequence, varint Baseline, then the full image when Baseline is 0, otherwise a delta
+    class SnapshotHistory
+    {
+    public:
+    
+        SnapshotHistory();
+        
+        void Reset();
+        void WriteUpdate( GameStateBase& In, PlayerTurn Viewer, StreamWriter& Out );
+        
+        // Acknowledging zero means the viewer lost its baselines, the next update will be a full snapshot
+        void Acknowledge( uint32_t Sequence );
+        
+        inline uint32_t GetAcknowledged() const { return AckedSequence; }
+    
+    protected:
+    
+        struct Entry
+        {
+            uint32_t Sequence;
+            std::vector< uint8_t > Image;
+        };
+        
+        std::deque< Entry > Pending;
+        std::vector< uint8_t > AckedImage;
+        uint32_t AckedSequence;
+        uint32_t NextSequence;
+    };
+    
+    // Client side, keeps the last few images so whichever one the server used as a baseline is still around
+    class SnapshotReceiver
+    {
+    public:
+    
+        void Reset();
+        
+        // Restores the update into the state, and returns the sequence to acknowledge. When the baseline is
+        // missing, this returns false and OutSequence is zero, so acknowledging it asks for a full snapshot
+        bool ReadUpdate( StreamReader& In, GameStateBase& Out, uint32_t& OutSequence );
+    
+    protected:
+    
+        struct Entry
+        {
+            uint32_t Sequence;
+            std::vector< uint8_t > Image;
+        };
+        
+        std::deque< Entry > Received;
+    };
+}
@@ -0,0 +1,218 @@
+//
+//    TexturePreloader.cpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "TexturePreloader.hpp"
+#include <algorithm>
+
+using namespace Game;
+
+
+TexturePreloader::TexturePreloader( unsigned int InThreadCount /* = PRELOAD_DECODE_THREADS */ )
+: CallbackCount( 0 ), ThreadCount( InThreadCount ), NextDecode( 0 ), TotalBytes( 0 ), LoadedBytes( 0 ), FinishedCount( 0 ), bStarted( false )
+{
+    if( ThreadCount == 0 )
+    {
+        auto Hardware = std::thread::hardware_concurrency();
+        ThreadCount = Hardware > 1 ? Hardware - 1 : 1;
+    }
+}
+
+
+TexturePreloader::~TexturePreloader()
+{
+    // The last reference can be dropped by a decode thread, which cant join itself
+    for( auto It = Threads.begin(); It != Threads.end(); It++ )
+    {
+        if( !It->joinable() )
+            continue;
+        
+        if( It->get_id() == std::this_thread::get_id() )
+            It->detach();
+        else
+            It->join();
+    }
+}
+
+
+void TexturePreloader::Add( const std::string& Path, int Priority, const std::function< void( cocos2d::Texture2D* ) >& Callback )
+{
+    if( bStarted )
+    {
+        cocos2d::log( "[Preloader] Attempt to add texture '%s' after loading started!", Path.c_str() );
+        return;
+    }
+    
+    if( Path.empty() )
+        return;
+    
+    auto Existing = Lookup.find( Path );
+    if( Existing == Lookup.end() )
+    {
+        Lookup[ Path ] = Requests.size();
+        
+        Request NewRequest;
+        NewRequest.Path         = Path;
+        NewRequest.Priority     = Priority;
+        NewRequest.Bytes        = 0;
+        
+        Requests.push_back( NewRequest );
+        Existing = Lookup.find( Path );
+    }
+    
+    auto& Target = Requests[ Existing->second ];
+    Target.Priority = std::min( Target.Priority, Priority );
+    
+    if( Callback )
+    {
+        Target.Callbacks.push_back( Callback );
+        CallbackCount++;
+    }
+}
+
+
+void TexturePreloader::Start( const std::function< void( float ) >& OnProgress, const std::function< void() >& OnComplete )
+{
+    if( bStarted )
+        return;
+    
+    bStarted            = true;
+    ProgressCallback    = OnProgress;
+    CompleteCallback    = OnComplete;
+    
+    if( Requests.empty() )
+    {
+        if( ProgressCallback )
+            ProgressCallback( 100.f );
+        if( CompleteCallback )
+            CompleteCallback();
+        
+        return;
+    }
+    
+    // Paths are resolved here, the file utils lookup cache isnt safe to use from the decode threads
+    auto Files = cocos2d::FileUtils::getInstance();
+    auto Cache = cocos2d::Director::getInstance()->getTextureCache();
+    
+    std::vector< size_t > Ready;
+    
+    for( size_t i = 0; i < Requests.size(); i++ )
+    {
+        auto& Target = Requests[ i ];
+        Target.FullPath = Files->fullPathForFilename( Target.Path );
+        
+        // Every texture moves the bar a little, even if we couldnt get its size
+        long Size       = Target.FullPath.empty() ? 0 : Files->getFileSize( Target.FullPath );
+        Target.Bytes    = Size > 0 ? (uint64) Size : 1;
+        TotalBytes      += Target.Bytes;
+        
+        if( Target.FullPath.empty() || Cache->getTextureForKey( Target.FullPath ) )
+            Ready.push_back( i );
+        else
+            DecodeOrder.push_back( i );
+    }
+    
+    std::stable_sort( DecodeOrder.begin(), DecodeOrder.end(), [ this ]( size_t A, size_t B )
+    {
+        return Requests[ A ].Priority < Requests[ B ].Priority;
+    } );
+    
+    cocos2d::log( "[Preloader] Loading %d unique textures for %d requests, %d already loaded", (int) Requests.size(), (int) CallbackCount, (int) Ready.size() );
+    
+    // No point in having threads sit around with nothing to decode
+    unsigned int Count = (unsigned int) std::min( (size_t) ThreadCount, DecodeOrder.size() );
+    for( unsigned int i = 0; i < Count; i++ )
+    {
+        auto Self = shared_from_this();
+        Threads.push_back( std::thread( [ Self ]() { Self->Decode(); } ) );
+    }
+    
+    // Decoded textures are handed back through the scheduler, so they cant finish before these do
+    for( auto It = Ready.begin(); It != Ready.end(); It++ )
+    {
+        auto& Target = Requests[ *It ];
+        if( Target.FullPath.empty() )
+            cocos2d::log( "[Preloader] Warning: Couldnt find texture '%s'", Target.Path.c_str() );
+        
+        Finish( *It, Target.FullPath.empty() ? nullptr : Cache->getTextureForKey( Target.FullPath ) );
+    }
+}
+
+
+void TexturePreloader::Decode()
+{
+    auto Scheduler = cocos2d::Director::getInstance()->getScheduler();
+    
+    // Threads take the next request in line, so the order is kept no matter which thread gets there first
+    while( true )
+    {
+        size_t Next = NextDecode++;
+        if( Next >= DecodeOrder.size() )
+            break;
+        
+        size_t Index    = DecodeOrder[ Next ];
+        auto* Decoded   = new (std::nothrow) cocos2d::Image();
+        
+        if( Decoded && !Decoded->initWithImageFile( Requests[ Index ].FullPath ) )
+        {
+            Decoded->release();
+            Decoded = nullptr;
+        }
+        
+        // Textures have to be created on the main thread
+        auto Self = shared_from_this();
+        Scheduler->performFunctionInCocosThread( [ Self, Index, Decoded ]()
+        {
+            cocos2d::Texture2D* Texture = nullptr;
+            if( Decoded )
+            {
+                Texture = cocos2d::Director::getInstance()->getTextureCache()->addImage( Decoded, Self->Requests[ Index ].FullPath );
+                Decoded->release();
+            }
+            else
+            {
+                cocos2d::log( "[Preloader] Warning: Failed to decode texture '%s'", Self->Requests[ Index ].Path.c_str() );
+            }
+            
+            Self->Finish( Index, Texture );
+        } );
+    }
+}
+
+
+void TexturePreloader::Finish( size_t Index, cocos2d::Texture2D* Texture )
+{
+    auto& Target = Requests[ Index ];
+    
+    for( auto It = Target.Callbacks.begin(); It != Target.Callbacks.end(); It++ )
+        ( *It )( Texture );
+    
+    Target.Callbacks.clear();
+    
+    LoadedBytes += Target.Bytes;
+    FinishedCount++;
+    
+    if( ProgressCallback )
+        ProgressCallback( TotalBytes > 0 ? (float)( (double) LoadedBytes / (double) TotalBytes * 100.0 ) : 100.f );
+    
+    if( FinishedCount < Requests.size() )
+        return;
+    
+    // Everything has been handed back, so the threads are on their way out
+    for( auto It = Threads.begin(); It != Threads.end(); It++ )
+    {
+        if( It->joinable() )
+            It->join();
+    }
+    
+    Threads.clear();
+    
+    if( CompleteCallback )
+        CompleteCallback();
+}
@@ -0,0 +1,88 @@
+//
+//    TexturePreloader.hpp
+//    Regicide Mobile
+//
+//    Created: 12/14/18
+//    Updated: 12/14/18
+//
+//    © 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "Numeric.hpp"
+#include "cocos2d.h"
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+// Load Order
+// Lower loads first, so whats on screen when the match opens is ready before whats hidden in the deck
+#define PRELOAD_PRIORITY_SCREEN 0
+#define PRELOAD_PRIORITY_GRAVE 1
+#define PRELOAD_PRIORITY_DECK 2
+
+// Zero uses one decode thread per hardware thread, minus one for the main thread
+#define PRELOAD_DECODE_THREADS 0
+
+namespace Game
+{
+    // Gathers the textures a match needs from every entity, and loads each unique one once
+    //
+    // Images are decoded on a pool of threads in priority order, and uploaded on the main thread as each one
+    // finishes. Every entity that asked for a texture is called back with it. Progress is weighted by the size
+    // of each image file, so one full sized card art counts for more than a handful of icons
+    class TexturePreloader : public std::enable_shared_from_this< TexturePreloader >
+    {
+    public:
+    
+        TexturePreloader( unsigned int InThreadCount = PRELOAD_DECODE_THREADS );
+        ~TexturePreloader();
+        
+        // Only valid before Start. The callback runs on the main thread once the texture is loaded, or null if it failed
+        // Asking for the same texture again only adds the callback, and keeps whichever priority is sooner
+        void Add( const std::string& Path, int Priority, const std::function< void( cocos2d::Texture2D* ) >& Callback );
+        
+        // Must be called on the main thread, progress is 0 to 100. Both callbacks are run on the main thread
+        void Start( const std::function< void( float ) >& OnProgress, const std::function< void() >& OnComplete );
+        
+        inline size_t GetUniqueCount() const { return Requests.size(); }
+        inline size_t GetRequestCount() const { return CallbackCount; }
+        inline uint64 GetTotalBytes() const { return TotalBytes; }
+    
+    protected:
+    
+        struct Request
+        {
+            std::string Path;
+            std::string FullPath;
+            int Priority;
+            uint64 Bytes;
+            std::vector< std::function< void( cocos2d::Texture2D* ) > > Callbacks;
+        };
+        
+        void Decode();
+        void Finish( size_t Index, cocos2d::Texture2D* Texture );
+        
+        std::vector< Request > Requests;
+        std::map< std::string, size_t > Lookup;
+        size_t CallbackCount;
+        
+        unsigned int ThreadCount;
+        std::vector< std::thread > Threads;
+        std::vector< size_t > DecodeOrder;
+        std::atomic< size_t > NextDecode;
+        
+        uint64 TotalBytes;
+        uint64 LoadedBytes;
+        size_t FinishedCount;
+        bool bStarted;
+        
+        std::function< void( float ) > ProgressCallback;
+        std::function< void() > CompleteCallback;
+    };
+}
@@ -0,0 +1,437 @@
+//
+//	WireSchema.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "ActionStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <type_traits>
+
+
+namespace Game
+{
+    // Schema functions list the fields of a type once, in order, and are run with either a SchemaWriter or a
+    // SchemaReader, so the encoder and decoder can never drift apart
+    // Unsigned fields are varints, signed fields are zigzag varints, and bools are packed into a bit field byte
+    // When a schema changes, bump WIRE_SCHEMA_VERSION and check Stream.Version around the new fields
+    class SchemaWriter
+    {
+    public:
+    
+        static constexpr bool bReading = false;
+        
+        SchemaWriter( StreamWriter& InOut, uint32_t InVersion = WIRE_SCHEMA_VERSION )
+        : Version( InVersion ), Out( InOut )
+        {}
+        
+        template< typename T >
+        void Unsigned( T& In )
+        {
+            static_assert( std::is_unsigned< T >::value, "Unsigned fields have to be an unsigned type" );
+            Out.WriteVarint( (uint64_t) In );
+        }
+        
+        template< typename T >
+        void Signed( T& In )
+        {
+            Out.WriteSigned( (int64_t) In );
+        }
+        
+        void Byte( uint8_t& In )
+        {
+            Out.WriteByte( In );
+        }
+        
+        template< typename... T >
+        void Flags( T&... In )
+        {
+            static_assert( sizeof...( T ) <= 8, "Too many flags for one byte" );
+            
+            bool* Fields[] = { &In... };
+            uint8_t Bits = 0;
+            
+            for( size_t i = 0; i < sizeof...( T ); i++ )
+            {
+                if( *Fields[ i ] )
+                    Bits |= (uint8_t)( 1 << i );
+            }
+            
+            Out.WriteByte( Bits );
+        }
+        
+        void String( std::string& In )
+        {
+            Out.WriteString( In );
+        }
+        
+        // Deadlines are stored as the milliseconds remaining when they were written
+        void Deadline( std::chrono::steady_clock::time_point& In )
+        {
+            int64_t Remaining = std::chrono::duration_cast< std::chrono::milliseconds >( In - std::chrono::steady_clock::now() ).count();
+            Out.WriteSigned( std::max< int64_t >( std::min< int64_t >( Remaining, std::numeric_limits< int32_t >::max() ), std::numeric_limits< int32_t >::min() ) );
+        }
+        
+        // Writes the element count, the caller then visits each element
+        template< typename T >
+        size_t Count( std::vector< T >& In )
+        {
+            Out.WriteVarint( In.size() );
+            return In.size();
+        }
+        
+        template< typename T >
+        void List( std::vector< T >& In )
+        {
+            Count( In );
+            for( auto It = In.begin(); It != In.end(); It++ )
+                Unsigned( *It );
+        }
+        
+        template< typename K, typename V >
+        void Map( std::map< K, V >& In )
+        {
+            Out.WriteVarint( In.size() );
+            for( auto It = In.begin(); It != In.end(); It++ )
+            {
+                K Key = It->first;
+                Unsigned( Key );
+                Value( It->second );
+            }
+        }
+        
+        inline bool IsValid() const { return true; }
+        
+        const uint32_t Version;
+    
+    protected:
+    
+        template< typename T >
+        void Value( T& In ) { Unsigned( In ); }
+        
+        template< typename T >
+        void Value( std::vector< T >& In ) { List( In ); }
+        
+        void Value( uint8_t& In ) { Byte( In ); }
+        
+        StreamWriter& Out;
+    };
+    
+    // Values that dont fit the field they are read into, and counts larger than the bytes left in the buffer,
+    // invalidate the reader, so a malformed or hostile frame can never cause a huge allocation
+    class SchemaReader
+    {
+    public:
+    
+        static constexpr bool bReading = true;
+        
+        SchemaReader( StreamReader& InIn, uint32_t InVersion = WIRE_SCHEMA_VERSION )
+        : Version( InVersion ), In( InIn )
+        {}
+        
+        template< typename T >
+        void Unsigned( T& Out )
+        {
+            static_assert( std::is_unsigned< T >::value, "Unsigned fields have to be an unsigned type" );
+            
+            uint64_t Value = In.ReadVarint();
+            if( Value > (uint64_t) std::numeric_limits< T >::max() )
+                In.Invalidate();
+            
+            Out = In.IsValid() ? (T) Value : T();
+        }
+        
+        template< typename T >
+        void Signed( T& Out )
+        {
+            int64_t Value = In.ReadSigned();
+            if( Value < (int64_t) std::numeric_limits< T >::min() || Value > (int64_t) std::numeric_limits< T >::max() )
+                In.Invalidate();
+            
+            Out = In.IsValid() ? (T) Value : T();
+        }
+        
+        void Byte( uint8_t& Out )
+        {
+            Out = In.ReadByte();
+        }
+        
+        template< typename... T >
+        void Flags( T&... Out )
+        {
+            bool* Fields[] = { &Out... };
+            uint8_t Bits = In.ReadByte();
+            
+            for( size_t i = 0; i < sizeof...( T ); i++ )
+                *Fields[ i ] = ( Bits & ( 1 << i ) ) != 0;
+        }
+        
+        void String( std::string& Out )
+        {
+            Out = In.ReadString();
+        }
+        
+        void Deadline( std::chrono::steady_clock::time_point& Out )
+        {
+            int32_t Remaining = 0;
+            Signed( Remaining );
+            
+            Out = std::chrono::steady_clock::now() + std::chrono::milliseconds( Remaining );
+        }
+        
+        template< typename T >
+        size_t Count( std::vector< T >& Out )
+        {
+            Out.clear();
+            Out.resize( ReadCount() );
+            return Out.size();
+        }
+        
+        template< typename T >
+        void List( std::vector< T >& Out )
+        {
+            Count( Out );
+            for( auto It = Out.begin(); It != Out.end(); It++ )
+                Unsigned( *It );
+        }
+        
+        template< typename K, typename V >
+        void Map( std::map< K, V >& Out )
+        {
+            Out.clear();
+            size_t Size = ReadCount();
+            
+            for( size_t i = 0; i < Size && In.IsValid(); i++ )
+            {
+                K Key;
+                Unsigned( Key );
+                Value( Out[ Key ] );
+            }
+        }
+        
+        inline bool IsValid() const { return In.IsValid(); }
+        inline void Invalidate() { In.Invalidate(); }
+        
+        const uint32_t Version;
+    
+    protected:
+    
+        // Every element takes at least one byte, so a count can never be larger than whats left
+        size_t ReadCount()
+        {
+            uint64_t Size = In.ReadVarint();
+            if( Size > In.GetRemaining() )
+                In.Invalidate();
+            
+            return In.IsValid() ? (size_t) Size : 0;
+        }
+        
+        template< typename T >
+        void Value( T& Out ) { Unsigned( Out ); }
+        
+        template< typename T >
+        void Value( std::vector< T >& Out ) { List( Out ); }
+        
+        void Value( uint8_t& Out ) { Byte( Out ); }
+        
+        StreamReader& In;
+    };
+    
+    
+    /*=====================================================================
+        Action Schemas
+     ====================================================================*/
+    template< typename S >
+    void ActionSchema( S& Stream, PlayCardAction& In )
+    {
+        Stream.Flags( In.bNeedsMove, In.bWasSuccessful );
+        Stream.Unsigned( In.TargetCard );
+        Stream.Signed( In.TargetIndex );
+        Stream.Unsigned( In.TargetPlayer );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, UpdateManaAction& In )
+    {
+        Stream.Unsigned( In.TargetPlayer );
+        Stream.Signed( In.Amount );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, DrawCardAction& In )
+    {
+        Stream.Unsigned( In.TargetPlayer );
+        Stream.Unsigned( In.TargetCard );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, LoadCardAction& In )
+    {
+        Stream.Unsigned( In.CardId );
+        Stream.Unsigned( In.Power );
+        Stream.Unsigned( In.Stamina );
+        Stream.String( In.Texture );
+        Stream.String( In.FullTexture );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, CoinFlipAction& In )
+    {
+        Stream.Unsigned( In.Player );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, TimedQueryAction& In )
+    {
+        Stream.Deadline( In.Deadline );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, EventAction& In )
+    {
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, CardErrorAction& In )
+    {
+        Stream.Map( In.Errors );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, TurnStartAction& In )
+    {
+        Stream.Unsigned( In.Player );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, DamageAction& In )
+    {
+        Stream.Unsigned( In.Target );
+        Stream.Unsigned( In.Inflictor );
+        Stream.Signed( In.UpdatedPower );
+        Stream.Unsigned( In.Damage );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, UpdateStaminaAction& In )
+    {
+        Stream.Unsigned( In.Target );
+        Stream.Unsigned( In.Inflictor );
+        Stream.Unsigned( In.Amount );
+        Stream.Signed( In.UpdatedAmount );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, WinAction& In )
+    {
+        Stream.Unsigned( In.Player );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, CombatAction& In )
+    {
+        Stream.Unsigned( In.Attacker );
+        Stream.Unsigned( In.Blocker );
+        Stream.Signed( In.AttackerPower );
+        Stream.Signed( In.BlockerPower );
+        Stream.Unsigned( In.Damage );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, PlayerEventAction& In )
+    {
+        Stream.Unsigned( In.Player );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, CardListEvent& In )
+    {
+        Stream.List( In.Cards );
+    }
+    
+    template< typename S >
+    void ActionSchema( S& Stream, BattleMatrixAction& In )
+    {
+        Stream.Map( In.Matrix );
+    }
+    
+    // Parallel actions are handled by the caller, since reading them has to create the child actions
+    template< typename S >
+    bool VisitAction( S& Stream, Action* In )
+    {
+        switch( In->Type )
+        {
+            case ActionType::PlayCard:      ActionSchema( Stream, *static_cast< PlayCardAction* >( In ) ); break;
+            case ActionType::UpdateMana:    ActionSchema( Stream, *static_cast< UpdateManaAction* >( In ) ); break;
+            case ActionType::DrawCard:      ActionSchema( Stream, *static_cast< DrawCardAction* >( In ) ); break;
+            case ActionType::LoadCard:      ActionSchema( Stream, *static_cast< LoadCardAction* >( In ) ); break;
+            case ActionType::CoinFlip:      ActionSchema( Stream, *static_cast< CoinFlipAction* >( In ) ); break;
+            case ActionType::TimedQuery:    ActionSchema( Stream, *static_cast< TimedQueryAction* >( In ) ); break;
+            case ActionType::Event:         ActionSchema( Stream, *static_cast< EventAction* >( In ) ); break;
+            case ActionType::CardError:     ActionSchema( Stream, *static_cast< CardErrorAction* >( In ) ); break;
+            case ActionType::TurnStart:     ActionSchema( Stream, *static_cast< TurnStartAction* >( In ) ); break;
+            case ActionType::Damage:        ActionSchema( Stream, *static_cast< DamageAction* >( In ) ); break;
+            case ActionType::UpdateStamina: ActionSchema( Stream, *static_cast< UpdateStaminaAction* >( In ) ); break;
+            case ActionType::Win:           ActionSchema( Stream, *static_cast< WinAction* >( In ) ); break;
+            case ActionType::Combat:        ActionSchema( Stream, *static_cast< CombatAction* >( In ) ); break;
+            case ActionType::PlayerEvent:   ActionSchema( Stream, *static_cast< PlayerEventAction* >( In ) ); break;
+            case ActionType::CardList:      ActionSchema( Stream, *static_cast< CardListEvent* >( In ) ); break;
+            case ActionType::BattleMatrix:  ActionSchema( Stream, *static_cast< BattleMatrixAction* >( In ) ); break;
+            default:                        return false;
+        }
+        
+        return Stream.IsValid();
+    }
+    
+    
+    /*=====================================================================
+        State Schemas
+     ====================================================================*/
+    template< typename S >
+    void CardSchema( S& Stream, CardState& In )
+    {
+        Stream.Unsigned( In.Id );
+        Stream.Unsigned( In.EntId );
+        Stream.Signed( In.Power );
+        Stream.Signed( In.Stamina );
+        Stream.Signed( In.ManaCost );
+        Stream.Flags( In.FaceUp );
+        Stream.Unsigned( In.Owner );
+    }
+    
+    // Zones are written deck, hand, field then graveyard. The position isnt encoded, since the zone implies it
+    template< typename S >
+    void PlayerSchema( S& Stream, PlayerState& In )
+    {
+        Stream.String( In.DisplayName );
+        Stream.Unsigned( In.EntId );
+        Stream.Signed( In.Mana );
+        Stream.Signed( In.Health );
+        Stream.Unsigned( In.King.Id );
+        Stream.Unsigned( In.King.Owner );
+        
+        std::vector< CardState >* Zones[] = { &In.Deck, &In.Hand, &In.Field, &In.Graveyard };
+        CardPos Positions[] = { CardPos::DECK, CardPos::HAND, CardPos::FIELD, CardPos::GRAVEYARD };
+        
+        for( int i = 0; i < 4; i++ )
+        {
+            Stream.Count( *Zones[ i ] );
+            for( auto It = Zones[ i ]->begin(); It != Zones[ i ]->end() && Stream.IsValid(); It++ )
+            {
+                CardSchema( Stream, *It );
+                
+                if( S::bReading )
+                    It->Position = Positions[ i ];
+            }
+        }
+    }
+}
@@ -10,6 +10,7 @@
 
 #include "World.hpp"
 #include "ClientState.hpp"
+#include "MatchContext.hpp"
 
 using namespace Game;
 
@@ -17,17 +18,21 @@ World* World::CurrentInstance( nullptr );
 
 
 World::World()
-: EntityBase( "World" )
+: EntityBase( "World" ), Context( MatchContext::GetCurrent() )
 {
-    CC_ASSERT( !CurrentInstance );
-    CurrentInstance = this;
+    World*& Instance = Context ? Context->WorldInstance : CurrentInstance;
+    
+    CC_ASSERT( !Instance );
+    Instance = this;
 }
 
 World::~World()
 {
-    CC_ASSERT( this == CurrentInstance );
+    World*& Instance = Context ? Context->WorldInstance : CurrentInstance;
+    
+    CC_ASSERT( this == Instance );
     
-    CurrentInstance     = nullptr;
+    Instance            = nullptr;
     GM                  = nullptr;
     Auth                = nullptr;
 }
@@ -40,5 +45,6 @@ void World::Cleanup()
 
 World* World::GetWorld()
 {
-    return CurrentInstance;
+    auto Context = MatchContext::GetCurrent();
+    return Context ? Context->GetWorld() : CurrentInstance;
 }
@@ -19,6 +19,7 @@ namespace Game
     class GameModeBase;
     class AuthorityBase;
     class ClientState;
+    class MatchContext;
     
     class World : public EntityBase
     {
@@ -46,6 +47,9 @@ namespace Game
         
         GameModeBase* GM;
         AuthorityBase* Auth;
+        
+        // Context the world was created in, worlds created outside of one are the process wide instance
+        MatchContext* Context;
 
         static World* CurrentInstance;
         friend class SingleplayerLauncher;
@@ -0,0 +1,129 @@
+//
+//	BlitzBookMain.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Entry point for the offline blitz book generator. This is built as its own executable, the same way as the
+//  match server, with AI_GENERATE_BLITZ_BOOK defined. Opening hands are dealt from the given deck and searched
+//  one at a time, and the results are added to the book at the output path. The BlitzBook target runs this with
+//  the practice deck and writes straight into Resource, where the game looks hands up
+//
+//  Usage: BlitzBookGen [Output] [Hands] [KingId] [CardId:Count]...
+//
+
+#include "MatchContext.hpp"
+#include "MatchScheduler.hpp"
+#include "SingleplayerAuthority.hpp"
+#include "AIController.hpp"
+#include "BlitzBook.hpp"
+#include "cocos2d.h"
+#include <cstdlib>
+#include <memory>
+
+using namespace Game;
+
+
+#ifdef AI_GENERATE_BLITZ_BOOK
+// Loading players is left to the authorities that run real matches, this one only has to get to the blitz
+class BookAuthority : public SingleplayerAuthority
+{
+public:
+    
+    BookAuthority( std::shared_ptr< MatchScheduler > InScheduler )
+    : SingleplayerAuthority( InScheduler )
+    {}
+    
+    bool LoadDeck( const Regicide::Deck& In )
+    {
+        return LoadPlayers( "Player", 20, 8, In, "AI", 20, 8, In );
+    }
+};
+#endif
+
+
+int main( int argc, char** argv )
+{
+#ifndef AI_GENERATE_BLITZ_BOOK
+    cocos2d::log( "[BlitzBook] Generator has to be built with AI_GENERATE_BLITZ_BOOK defined!" );
+    return 1;
+#else
+    if( argc < 5 )
+    {
+        cocos2d::log( "[BlitzBook] Usage: BlitzBookGen [Output] [Hands] [KingId] [CardId:Count]..." );
+        return 1;
+    }
+    
+    std::string Output  = argv[ 1 ];
+    int Hands           = std::atoi( argv[ 2 ] );
+    
+    Regicide::Deck Deck;
+    Deck.Name   = "Blitz Book";
+    Deck.KingId = (uint32) std::atoi( argv[ 3 ] );
+    
+    for( int i = 4; i < argc; i++ )
+    {
+        std::string Arg = argv[ i ];
+        auto Split = Arg.find( ':' );
+        if( Split == std::string::npos )
+        {
+            cocos2d::log( "[BlitzBook] Invalid card '%s', expected CardId:Count", Arg.c_str() );
+            return 1;
+        }
+        
+        Deck.Cards.push_back( Regicide::Card( (uint16) std::atoi( Arg.substr( 0, Split ).c_str() ), (uint16) std::atoi( Arg.substr( Split + 1 ).c_str() ) ) );
+    }
+    
+    // Card and king scripts are loaded the same way as the match server
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // Keep adding to an existing book, hands already in it are skipped
+    BlitzBook::GetInstance().Load( Output );
+    
+    MatchContext Context;
+    MatchContext::Scope Enter( std::addressof( Context ) );
+    
+    if( !Context.Init() )
+    {
+        cocos2d::log( "[BlitzBook] Failed to initialize match context!" );
+        return 1;
+    }
+    
+    // Runs a headless match up to the blitz, so the hands are dealt from a state loaded the same way as a real match
+    // Both sides use the same deck, the book only keys on the AI hand
+    auto Scheduler = std::make_shared< VirtualScheduler >();
+    std::unique_ptr< BookAuthority > Authority( new BookAuthority( Scheduler ) );
+    
+    if( !Authority->LoadDeck( Deck ) )
+    {
+        cocos2d::log( "[BlitzBook] Failed to load deck!" );
+        return 1;
+    }
+    
+    Authority->PostInit();
+    while( Authority->GetState().mState != MatchState::Blitz && Scheduler->Step() ) {}
+    
+    if( Authority->GetState().mState != MatchState::Blitz )
+    {
+        cocos2d::log( "[BlitzBook] Match never reached the blitz!" );
+        return 1;
+    }
+    
+    // Never initialized, so theres no think thread, the searches run right here
+    std::unique_ptr< AIController > Generator( new AIController() );
+    Generator->GenerateBlitzBook( Authority->GetState(), Hands, Output );
+    
+    Generator.reset();
+    Scheduler->UnscheduleAll();
+    Authority.reset();
+    
+    return 0;
+#endif
+}
@@ -0,0 +1,268 @@
+//
+//	MatchExecutor.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "MatchExecutor.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace Game;
+
+
+// Executor and worker index of the calling thread, so strands posted from a worker stay on that worker
+static thread_local MatchExecutor* CurrentExecutor = nullptr;
+static thread_local unsigned int CurrentWorker = 0;
+
+
+/*=========================================================================================
+    Match Strand
+ =========================================================================================*/
+MatchStrand::MatchStrand( MatchExecutor& InOwner, std::shared_ptr< MatchContext > InContext )
+: Owner( InOwner ), Context( InContext ), bQueued( false ), CpuNanoseconds( 0 ), TaskCount( 0 )
+{
+}
+
+
+void MatchStrand::Post( std::function< void() > Func )
+{
+    if( !Func )
+        return;
+    
+    bool bEnqueue = false;
+    {
+        std::lock_guard< std::mutex > Guard( Lock );
+        Tasks.push_back( std::move( Func ) );
+        
+        // Only the post that finds the strand idle queues it, after that its up to the worker running it
+        if( !bQueued )
+        {
+            bQueued     = true;
+            bEnqueue    = true;
+        }
+    }
+    
+    if( bEnqueue )
+        Owner.Enqueue( shared_from_this() );
+}
+
+
+bool MatchStrand::RunSlice()
+{
+    MatchContext::Scope Enter( Context.get() );
+    
+    auto Begin      = std::chrono::steady_clock::now();
+    auto Deadline   = Begin + std::chrono::microseconds( EXECUTOR_SLICE_MICROSECONDS );
+    auto Now        = Begin;
+    
+    int Count       = 0;
+    bool bMore      = false;
+    
+    while( true )
+    {
+        std::function< void() > Func;
+        {
+            std::lock_guard< std::mutex > Guard( Lock );
+            
+            if( Tasks.empty() )
+            {
+                bQueued = false;
+                break;
+            }
+            
+            // Out of time, leave the rest for the next slice. The strand stays marked as queued, so posts
+            // made before the worker requeues it dont queue it a second time
+            if( Count >= EXECUTOR_SLICE_TASKS || Now >= Deadline )
+            {
+                bMore = true;
+                break;
+            }
+            
+            Func = std::move( Tasks.front() );
+            Tasks.pop_front();
+        }
+        
+        Func();
+        Count++;
+        
+        Now = std::chrono::steady_clock::now();
+    }
+    
+    CpuNanoseconds  += (uint64_t) std::chrono::duration_cast< std::chrono::nanoseconds >( Now - Begin ).count();
+    TaskCount       += (uint64_t) Count;
+    
+    return bMore;
+}
+
+
+/*=========================================================================================
+    Match Executor
+ =========================================================================================*/
+MatchExecutor::MatchExecutor( unsigned int InThreadCount /* = 0 */ )
+: ThreadCount( InThreadCount ), bStopping( false ), ReadyCount( 0 ), SleepingCount( 0 ), NextWorker( 0 ), StealCount( 0 )
+{
+    if( ThreadCount == 0 )
+        ThreadCount = std::max( std::thread::hardware_concurrency(), 1u );
+    
+    // Workers exist before the threads do, so strands can be posted to before Start
+    for( unsigned int i = 0; i < ThreadCount; i++ )
+        Workers.push_back( std::unique_ptr< Worker >( new Worker() ) );
+}
+
+
+MatchExecutor::~MatchExecutor()
+{
+    Stop();
+    Wait();
+}
+
+
+std::shared_ptr< MatchStrand > MatchExecutor::CreateStrand( std::shared_ptr< MatchContext > Context )
+{
+    return std::make_shared< MatchStrand >( *this, Context );
+}
+
+
+void MatchExecutor::Start()
+{
+    bStopping = false;
+    
+    for( unsigned int i = 0; i < ThreadCount; i++ )
+    {
+        if( !Workers[ i ]->Thread.joinable() )
+            Workers[ i ]->Thread = std::thread( [ this, i ]() { Run( i ); } );
+    }
+}
+
+
+void MatchExecutor::Stop()
+{
+    {
+        std::lock_guard< std::mutex > Guard( SleepLock );
+        bStopping = true;
+    }
+    
+    SleepSignal.notify_all();
+}
+
+
+void MatchExecutor::Wait()
+{
+    for( auto It = Workers.begin(); It != Workers.end(); It++ )
+    {
+        if( ( *It )->Thread.joinable() )
+            ( *It )->Thread.join();
+    }
+    
+    // Whatever didnt get to run is dropped. Tasks usually hold on to their match, and the match holds its strand,
+    // so the tasks have to go for any of it to be freed
+    for( auto It = Workers.begin(); It != Workers.end(); It++ )
+    {
+        std::deque< std::shared_ptr< MatchStrand > > Left;
+        {
+            std::lock_guard< std::mutex > Guard( ( *It )->Lock );
+            Left.swap( ( *It )->Ready );
+        }
+        
+        for( auto Strand = Left.begin(); Strand != Left.end(); Strand++ )
+        {
+            std::deque< std::function< void() > > Dropped;
+            {
+                std::lock_guard< std::mutex > Guard( ( *Strand )->Lock );
+                Dropped.swap( ( *Strand )->Tasks );
+                ( *Strand )->bQueued = false;
+            }
+        }
+    }
+    
+    ReadyCount = 0;
+}
+
+
+void MatchExecutor::Enqueue( std::shared_ptr< MatchStrand > In )
+{
+    unsigned int Index = CurrentExecutor == this ? CurrentWorker : NextWorker++ % ThreadCount;
+    
+    // Counted before its in a line, so the count is never lower than whats actually waiting. Sleepers count
+    // themselves before checking it, so either they see this strand or we see them
+    ReadyCount++;
+    
+    {
+        std::lock_guard< std::mutex > Guard( Workers[ Index ]->Lock );
+        Workers[ Index ]->Ready.push_back( std::move( In ) );
+    }
+    
+    if( SleepingCount.load() > 0 )
+    {
+        std::lock_guard< std::mutex > Guard( SleepLock );
+        SleepSignal.notify_one();
+    }
+}
+
+
+std::shared_ptr< MatchStrand > MatchExecutor::Take( unsigned int Index )
+{
+    std::shared_ptr< MatchStrand > Output;
+    
+    {
+        auto& Own = *Workers[ Index ];
+        std::lock_guard< std::mutex > Guard( Own.Lock );
+        
+        if( !Own.Ready.empty() )
+        {
+            Output = std::move( Own.Ready.front() );
+            Own.Ready.pop_front();
+        }
+    }
+    
+    // Steal from the back, thats the strand the victim would get to last
+    for( unsigned int i = 1; !Output && i < ThreadCount; i++ )
+    {
+        auto& Victim = *Workers[ ( Index + i ) % ThreadCount ];
+        std::lock_guard< std::mutex > Guard( Victim.Lock );
+        
+        if( !Victim.Ready.empty() )
+        {
+            Output = std::move( Victim.Ready.back() );
+            Victim.Ready.pop_back();
+            StealCount++;
+        }
+    }
+    
+    if( Output )
+        ReadyCount--;
+    
+    return Output;
+}
+
+
+void MatchExecutor::Run( unsigned int Index )
+{
+    CurrentExecutor = this;
+    CurrentWorker   = Index;
+    
+    while( !bStopping )
+    {
+        auto Strand = Take( Index );
+        if( Strand )
+        {
+            if( Strand->RunSlice() )
+                Enqueue( Strand );
+            
+            continue;
+        }
+        
+        std::unique_lock< std::mutex > Guard( SleepLock );
+        SleepingCount++;
+        SleepSignal.wait( Guard, [ this ]() { return bStopping || ReadyCount.load() > 0; } );
+        SleepingCount--;
+    }
+    
+    CurrentExecutor = nullptr;
+}
@@ -0,0 +1,117 @@
+//
+//	MatchExecutor.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "MatchContext.hpp"
+#include <functional>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+
+// A strand runs at most this many tasks, or for this long, before going to the back of the line
+#define EXECUTOR_SLICE_TASKS 32
+#define EXECUTOR_SLICE_MICROSECONDS 2000
+
+namespace Game
+{
+    class MatchExecutor;
+    
+    // Runs posted work one task at a time and in order, never on two workers at once, with the match context entered
+    // Same guarantee as an asio strand, except the strand itself is what the executor queues and steals, so a match
+    // with a backlog only takes one slot in line, instead of one per task
+    class MatchStrand : public std::enable_shared_from_this< MatchStrand >
+    {
+    public:
+    
+        MatchStrand( MatchExecutor& InOwner, std::shared_ptr< MatchContext > InContext );
+        
+        // Safe to call from any thread
+        void Post( std::function< void() > Func );
+        
+        inline MatchContext* GetContext() { return Context.get(); }
+        
+        // Time spent running this strands work on the executor, and how many tasks it ran
+        inline double GetCpuTime() const { return (double) CpuNanoseconds.load() * 1e-9; }
+        inline uint64_t GetTaskCount() const { return TaskCount.load(); }
+    
+    protected:
+    
+        // Runs one slice, returns true when theres work left over and the strand needs to be queued again
+        bool RunSlice();
+        
+        MatchExecutor& Owner;
+        std::shared_ptr< MatchContext > Context;
+        
+        std::mutex Lock;
+        std::deque< std::function< void() > > Tasks;
+        bool bQueued;
+        
+        std::atomic< uint64_t > CpuNanoseconds;
+        std::atomic< uint64_t > TaskCount;
+        
+        friend class MatchExecutor;
+    };
+    
+    // Work stealing pool that runs match strands
+    // Each worker has its own line of strands that are ready to run, and takes from the front of it. Strands posted
+    // from a worker go to that workers line, so a match tends to stay on one core, and strands posted from anywhere
+    // else are dealt out round robin. A worker with nothing to do steals from the back of another workers line
+    // A strand that used up its slice goes to the back of the line, so one busy match cant starve the others
+    class MatchExecutor
+    {
+    public:
+    
+        // Zero threads uses one per hardware thread
+        MatchExecutor( unsigned int InThreadCount = 0 );
+        ~MatchExecutor();
+        
+        void Start();
+        void Stop();
+        void Wait();
+        
+        std::shared_ptr< MatchStrand > CreateStrand( std::shared_ptr< MatchContext > Context );
+        
+        inline unsigned int GetThreadCount() const { return ThreadCount; }
+        inline uint64_t GetStealCount() const { return StealCount.load(); }
+    
+    protected:
+    
+        struct Worker
+        {
+            std::mutex Lock;
+            std::deque< std::shared_ptr< MatchStrand > > Ready;
+            std::thread Thread;
+        };
+        
+        void Enqueue( std::shared_ptr< MatchStrand > In );
+        std::shared_ptr< MatchStrand > Take( unsigned int Index );
+        void Run( unsigned int Index );
+        
+        std::vector< std::unique_ptr< Worker > > Workers;
+        unsigned int ThreadCount;
+        
+        std::atomic< bool > bStopping;
+        std::atomic< size_t > ReadyCount;
+        std::atomic< unsigned int > SleepingCount;
+        std::atomic< unsigned int > NextWorker;
+        std::atomic< uint64_t > StealCount;
+        
+        std::mutex SleepLock;
+        std::condition_variable SleepSignal;
+        
+        friend class MatchStrand;
+    };
+}
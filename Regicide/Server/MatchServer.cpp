@@ -0,0 +1,178 @@
+//
+//	MatchServer.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "MatchServer.hpp"
+#include "ServerSession.hpp"
+#include "ServerMatch.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+MatchServer::MatchServer( unsigned int InThreadCount /* = 0 */ )
+: Work( asio::make_work_guard( Context ) ), Acceptor( Context ), Executor( InThreadCount ), BoundPort( 0 )
+{
+    ThreadCount = std::max( Executor.GetThreadCount() / SERVER_IO_THREAD_RATIO, 1u );
+}
+
+
+MatchServer::~MatchServer()
+{
+    Stop();
+    Wait();
+}
+
+
+bool MatchServer::Listen( uint16_t Port, const std::string& Address /* = "0.0.0.0" */ )
+{
+    asio::error_code Error;
+    asio::ip::tcp::endpoint Endpoint( asio::ip::make_address( Address, Error ), Port );
+    
+    if( !Error )
+        Acceptor.open( Endpoint.protocol(), Error );
+    if( !Error )
+        Acceptor.set_option( asio::ip::tcp::acceptor::reuse_address( true ), Error );
+    if( !Error )
+        Acceptor.bind( Endpoint, Error );
+    if( !Error )
+        Acceptor.listen( asio::socket_base::max_listen_connections, Error );
+    
+    if( Error )
+    {
+        cocos2d::log( "[Server] Failed to listen on %s:%d! %s", Address.c_str(), (int) Port, Error.message().c_str() );
+        return false;
+    }
+    
+    BoundPort = Acceptor.local_endpoint().port();
+    cocos2d::log( "[Server] Listening on %s:%d", Address.c_str(), (int) BoundPort );
+    
+    Accept();
+    return true;
+}
+
+
+void MatchServer::Start()
+{
+    if( !Threads.empty() )
+        return;
+    
+    Executor.Start();
+    
+    for( unsigned int i = 0; i < ThreadCount; i++ )
+        Threads.push_back( std::thread( [ this ]() { Context.run(); } ) );
+    
+    cocos2d::log( "[Server] Running with %d match threads and %d io threads", (int) Executor.GetThreadCount(), (int) ThreadCount );
+}
+
+
+void MatchServer::Stop()
+{
+    Work.reset();
+    Context.stop();
+    Executor.Stop();
+}
+
+
+void MatchServer::Wait()
+{
+    for( auto It = Threads.begin(); It != Threads.end(); It++ )
+    {
+        if( It->joinable() )
+            It->join();
+    }
+    
+    Threads.clear();
+    Executor.Wait();
+    
+    // Nothing else is running now, so its safe to touch the acceptor from here
+    asio::error_code Ignored;
+    Acceptor.close( Ignored );
+}
+
+
+void MatchServer::Accept()
+{
+    Acceptor.async_accept( [ this ]( const asio::error_code& Error, asio::ip::tcp::socket Socket )
+    {
+        if( Error )
+        {
+            if( Error == asio::error::operation_aborted || !Acceptor.is_open() )
+                return;
+            
+            cocos2d::log( "[Server] Failed to accept connection! %s", Error.message().c_str() );
+        }
+        else
+        {
+            std::make_shared< ServerSession >( std::move( Socket ), *this )->Start();
+        }
+        
+        Accept();
+    } );
+}
+
+
+size_t MatchServer::GetMatchCount()
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    return Matches.size();
+}
+
+
+size_t MatchServer::GetWaitingCount()
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    return Waiting ? 1 : 0;
+}
+
+
+/*=========================================================================================
+    Lobby
+ =========================================================================================*/
+void MatchServer::Enqueue( std::shared_ptr< ServerSession > In )
+{
+    std::shared_ptr< ServerSession > Opponent;
+    std::shared_ptr< ServerMatch > NewMatch;
+    
+    {
+        std::lock_guard< std::mutex > Guard( Lock );
+        
+        // First come first serve, theres no rating to match on yet
+        if( !Waiting || Waiting == In )
+        {
+            Waiting = In;
+            return;
+        }
+        
+        Opponent = Waiting;
+        Waiting.reset();
+        
+        NewMatch = std::make_shared< ServerMatch >( *this );
+        Matches.insert( NewMatch );
+    }
+    
+    NewMatch->Start( Opponent, In );
+}
+
+
+void MatchServer::Remove( std::shared_ptr< ServerSession > In )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    
+    if( Waiting == In )
+        Waiting.reset();
+}
+
+
+void MatchServer::OnMatchFinished( std::shared_ptr< ServerMatch > In )
+{
+    std::lock_guard< std::mutex > Guard( Lock );
+    Matches.erase( In );
+}
@@ -0,0 +1,79 @@
+//
+//	MatchServer.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "NetworkProtocol.hpp"
+#include "MatchExecutor.hpp"
+#include "asio.hpp"
+#include <set>
+#include <thread>
+#include <mutex>
+#include <memory>
+
+
+// One io thread for every this many executor threads, sockets only move frames around, so they need very little
+#define SERVER_IO_THREAD_RATIO 4
+
+namespace Game
+{
+    class ServerSession;
+    class ServerMatch;
+    
+    // Accepts players, pairs them up in the lobby, and runs their matches
+    // Sockets and timers run on one io_context, with a small pool of io threads, and each session has its own strand
+    // Matches run on the executor instead, a work stealing pool with a thread per core, each match on its own strand
+    class MatchServer
+    {
+    public:
+    
+        // Zero threads uses one executor thread per hardware thread
+        MatchServer( unsigned int InThreadCount = 0 );
+        ~MatchServer();
+        
+        // Port zero picks any free port, GetPort returns the one that was bound
+        bool Listen( uint16_t Port, const std::string& Address = "0.0.0.0" );
+        
+        void Start();
+        void Stop();
+        void Wait();
+        
+        inline asio::io_context& GetContext() { return Context; }
+        inline MatchExecutor& GetExecutor() { return Executor; }
+        inline uint16_t GetPort() const { return BoundPort; }
+        
+        size_t GetMatchCount();
+        size_t GetWaitingCount();
+        
+        // Called by sessions once they said hello, pairs them with whoever is waiting
+        void Enqueue( std::shared_ptr< ServerSession > In );
+        void Remove( std::shared_ptr< ServerSession > In );
+        void OnMatchFinished( std::shared_ptr< ServerMatch > In );
+    
+    protected:
+    
+        void Accept();
+        
+        asio::io_context Context;
+        asio::executor_work_guard< asio::io_context::executor_type > Work;
+        asio::ip::tcp::acceptor Acceptor;
+        
+        // Declared before the matches, since their strands belong to it
+        MatchExecutor Executor;
+        
+        std::vector< std::thread > Threads;
+        unsigned int ThreadCount;
+        uint16_t BoundPort;
+        
+        std::mutex Lock;
+        std::shared_ptr< ServerSession > Waiting;
+        std::set< std::shared_ptr< ServerMatch > > Matches;
+    };
+}
@@ -0,0 +1,241 @@
+//
+//	ServerAuthority.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "ServerAuthority.hpp"
+#include "ServerMatch.hpp"
+#include "CardEntity.hpp"
+#include <set>
+
+// Same starting values the singleplayer launcher uses
+#define SERVER_START_HEALTH 20
+#define SERVER_START_MANA 8
+
+// Limits for decks sent by clients
+#define SERVER_MIN_DECK_SIZE 20
+#define SERVER_MAX_DECK_SIZE 60
+#define SERVER_MAX_CARD_COPIES 12
+
+// Seconds a remote player has to choose their blitz cards, and to finish each phase of a turn
+#define SERVER_BLITZ_TIMEOUT 30.f
+#define SERVER_TURN_TIMEOUT 60.f
+
+using namespace Game;
+
+
+ServerAuthority::ServerAuthority( ServerMatch& InMatch, std::shared_ptr< MatchScheduler > InScheduler )
+: SingleplayerAuthority( InScheduler ), Match( InMatch )
+{
+    bSideReady[ 0 ] = false;
+    bSideReady[ 1 ] = false;
+    SnapshotTurn    = 0;
+    
+    TimerMatch      = MatchState::PreMatch;
+    TimerTurn       = TurnState::None;
+    TimerSide       = PlayerTurn::None;
+    TimerTurnNumber = 0;
+}
+
+
+bool ServerAuthority::Load( const NetHello& First, const NetHello& Second )
+{
+    if( !ValidateDeck( First ) || !ValidateDeck( Second ) )
+        return false;
+    
+    return LoadPlayers( First.Name, SERVER_START_HEALTH, SERVER_START_MANA, First.Deck,
+                       Second.Name, SERVER_START_HEALTH, SERVER_START_MANA, Second.Deck );
+}
+
+
+bool ServerAuthority::ValidateDeck( const NetHello& In )
+{
+    auto& CM = CardManager::GetInstance();
+    KingState King;
+    
+    // Kings ids are sent as 32 bits, but are only 16 bits in the content
+    if( In.Deck.KingId > UINT16_MAX || !LoadKing( (uint16_t) In.Deck.KingId, 0, King ) )
+    {
+        cocos2d::log( "[Server] Rejected deck from '%s'.. invalid king %u", In.Name.c_str(), (unsigned int) In.Deck.KingId );
+        return false;
+    }
+    
+    std::set< uint16_t > Seen;
+    int Total = 0;
+    
+    for( auto It = In.Deck.Cards.begin(); It != In.Deck.Cards.end(); It++ )
+    {
+        CardInfo Info;
+        if( !CM.GetInfo( It->Id, Info ) )
+        {
+            cocos2d::log( "[Server] Rejected deck from '%s'.. unknown card %d", In.Name.c_str(), (int) It->Id );
+            return false;
+        }
+        
+        if( It->Ct == 0 || It->Ct > SERVER_MAX_CARD_COPIES || !Seen.insert( It->Id ).second )
+        {
+            cocos2d::log( "[Server] Rejected deck from '%s'.. invalid count for card %d", In.Name.c_str(), (int) It->Id );
+            return false;
+        }
+        
+        Total += It->Ct;
+    }
+    
+    if( Total < SERVER_MIN_DECK_SIZE || Total > SERVER_MAX_DECK_SIZE )
+    {
+        cocos2d::log( "[Server] Rejected deck from '%s'.. %d cards", In.Name.c_str(), Total );
+        return false;
+    }
+    
+    return true;
+}
+
+
+void ServerAuthority::HandleCommand( PlayerTurn Side, const NetCommand& In )
+{
+    switch( In.Type )
+    {
+        case NetMessage::SetReady:
+        {
+            // The match only starts once both players have loaded in
+            bSideReady[ Side == PlayerTurn::Opponent ? 1 : 0 ] = true;
+            if( bSideReady[ 0 ] && bSideReady[ 1 ] && State.mState == MatchState::PreMatch )
+                SetReady();
+            break;
+        }
+        case NetMessage::SetBlitzCards:
+            DoSetBlitz( Side, In.Cards );
+            break;
+        case NetMessage::PlayCard:
+            DoPlayCard( Side, In.Card, In.Index );
+            break;
+        case NetMessage::FinishTurn:
+            DoFinishTurn( Side );
+            break;
+        case NetMessage::SetAttackers:
+            DoSetAttackers( Side, In.Cards );
+            break;
+        case NetMessage::SetBlockers:
+            DoSetBlockers( Side, In.Blockers );
+            break;
+        case NetMessage::TriggerAbility:
+            DoTriggerAbility( Side, In.Card, In.Ability );
+            break;
+        default:
+            cocos2d::log( "[Server] Unknown command type %d", (int) In.Type );
+            break;
+    }
+}
+
+
+void ServerAuthority::Forfeit( PlayerTurn Side )
+{
+    if( State.mState == MatchState::PostMatch )
+    {
+        Match.Finish();
+        return;
+    }
+    
+    auto Winner = GetSidePlayer( GetOtherSide( Side ) );
+    CC_ASSERT( Winner );
+    
+    OnGameWon( Winner->EntId );
+}
+
+
+void ServerAuthority::RunQueue( ActionQueue&& In )
+{
+    StreamWriter Frame;
+    BeginFrame( Frame, NetMessage::Queue );
+    WriteActionQueue( Frame, In );
+    FinishFrame( Frame );
+    
+    Match.Broadcast( std::move( Frame.Buffer ) );
+    
+    // Clients keep their own copy of the state by applying each queue, so theyre resynced at the start of every turn.
+    // Its a delta against what they already have, so it usually costs a few dozen bytes. In between, a player only
+    // gets one when the queue moved a card they couldnt see somewhere they can
+    if( State.TurnNumber != SnapshotTurn )
+    {
+        SnapshotTurn = State.TurnNumber;
+        Match.SendSnapshots();
+    }
+    else
+    {
+        Match.SendReveals();
+    }
+    
+    if( State.mState == MatchState::PostMatch )
+    {
+        Match.Finish();
+        return;
+    }
+    
+    UpdateTurnTimer();
+    
+    if( In.Callback )
+        Scheduler->Dispatch( In.Callback );
+}
+
+
+void ServerAuthority::UpdateTurnTimer()
+{
+    // Every state change goes out as a queue, so this restarts the timer whenever the match moves into a
+    // new decision, plays and failed commands within the same phase dont give the player more time
+    if( State.mState == TimerMatch && State.tState == TimerTurn && State.pState == TimerSide && State.TurnNumber == TimerTurnNumber )
+        return;
+    
+    TimerMatch      = State.mState;
+    TimerTurn       = State.tState;
+    TimerSide       = State.pState;
+    TimerTurnNumber = State.TurnNumber;
+    
+    Scheduler->Unschedule( "TurnTimeout" );
+    
+    if( State.mState == MatchState::Blitz )
+    {
+        Scheduler->Schedule( "TurnTimeout", SERVER_BLITZ_TIMEOUT, [ this ]( float ) { OnTurnTimeout(); } );
+    }
+    else if( State.mState == MatchState::Main &&
+            ( State.tState == TurnState::Marshal || State.tState == TurnState::Attack || State.tState == TurnState::Block ) )
+    {
+        Scheduler->Schedule( "TurnTimeout", SERVER_TURN_TIMEOUT, [ this ]( float ) { OnTurnTimeout(); } );
+    }
+}
+
+
+void ServerAuthority::OnTurnTimeout()
+{
+    if( State.mState == MatchState::Blitz )
+    {
+        // Whoever hasnt chosen yet doesnt blitz any cards
+        cocos2d::log( "[Server] Blitz timed out!" );
+        CompleteBlitz();
+        return;
+    }
+    
+    if( State.mState != MatchState::Main )
+        return;
+    
+    cocos2d::log( "[Server] Turn timed out!" );
+    
+    // The same as the waiting player finishing the phase, attacks and blocks that were never set dont happen
+    if( State.tState == TurnState::Marshal )
+    {
+        DoFinishTurn( State.pState );
+    }
+    else if( State.tState == TurnState::Attack )
+    {
+        BattleMatrix.clear();
+        DoFinishTurn( State.pState );
+    }
+    else if( State.tState == TurnState::Block )
+    {
+        DoFinishTurn( GetOtherSide( State.pState ) );
+    }
+}
@@ -0,0 +1,55 @@
+//
+//	ServerAuthority.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "SingleplayerAuthority.hpp"
+#include "NetworkProtocol.hpp"
+
+
+namespace Game
+{
+    class ServerMatch;
+    
+    // Runs the same match flow as singleplayer, except both sides are remote players instead of one being the AI
+    // Commands from either player go through the side aware calls, and every queue is sent to both players.
+    // Theres no game mode on the server, so queue callbacks run as soon as the queue is sent
+    class ServerAuthority : public SingleplayerAuthority
+    {
+    public:
+    
+        ServerAuthority( ServerMatch& InMatch, std::shared_ptr< MatchScheduler > InScheduler );
+        
+        bool Load( const NetHello& First, const NetHello& Second );
+        
+        void HandleCommand( PlayerTurn Side, const NetCommand& In );
+        void Forfeit( PlayerTurn Side );
+        
+        virtual void RunQueue( ActionQueue&& In ) override;
+    
+    protected:
+    
+        // Decks come from the client, so everything in them is checked against the loaded card content first
+        bool ValidateDeck( const NetHello& In );
+        
+        // Remote players get a set amount of time for each decision, once its up the match moves on without them
+        void UpdateTurnTimer();
+        void OnTurnTimeout();
+        
+        ServerMatch& Match;
+        bool bSideReady[ 2 ];
+        int SnapshotTurn;
+        
+        MatchState TimerMatch;
+        TurnState TimerTurn;
+        PlayerTurn TimerSide;
+        int TimerTurnNumber;
+    };
+}
@@ -0,0 +1,55 @@
+//
+//	ServerMain.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Entry point for the standalone match server. This is built as its own executable (RegicideServer, in the
+//  headless CMake targets), with the Server directory, the Game sources and the Lua/CMS libraries, against a headless cocos build.
+//  Needs ASIO_STANDALONE defined and Asio/include on the header search path, same as the client
+//
+//  Usage: RegicideServer [Port] [Threads], where Threads is the number of match threads
+//
+
+#include "MatchServer.hpp"
+#include "cocos2d.h"
+#include <csignal>
+#include <cstdlib>
+
+using namespace Game;
+
+
+int main( int argc, char** argv )
+{
+    uint16_t Port           = argc > 1 ? (uint16_t) std::atoi( argv[ 1 ] ) : NET_DEFAULT_PORT;
+    unsigned int Threads    = argc > 2 ? (unsigned int) std::atoi( argv[ 2 ] ) : 0;
+    
+    // Card and king scripts are loaded the same way as the client, except every match loads them into its own Lua state
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    MatchServer Server( Threads );
+    if( !Server.Listen( Port ) )
+        return 1;
+    
+    asio::signal_set Signals( Server.GetContext(), SIGINT, SIGTERM );
+    Signals.async_wait( [ &Server ]( const asio::error_code& Error, int )
+    {
+        if( !Error )
+        {
+            cocos2d::log( "[Server] Shutting down.." );
+            Server.Stop();
+        }
+    } );
+    
+    Server.Start();
+    Server.Wait();
+    
+    return 0;
+}
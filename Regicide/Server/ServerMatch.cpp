@@ -0,0 +1,381 @@
+//
+//	ServerMatch.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "ServerMatch.hpp"
+#include "ServerAuthority.hpp"
+#include "ServerSession.hpp"
+#include "MatchServer.hpp"
+#include "EntityBase.hpp"
+#include "cocos2d.h"
+#include <algorithm>
+
+using namespace Game;
+
+
+/*=========================================================================================
+    Strand Scheduler
+ =========================================================================================*/
+StrandScheduler::StrandScheduler( std::shared_ptr< MatchStrand > InStrand, asio::io_context& InContext )
+: Strand( InStrand ), Context( InContext ), NextSerial( 0 ), Start( std::chrono::steady_clock::now() )
+{
+}
+
+
+double StrandScheduler::GetTime() const
+{
+    return std::chrono::duration< double >( std::chrono::steady_clock::now() - Start ).count();
+}
+
+
+void StrandScheduler::Arm( const std::string& Key, float Delay, bool bRepeat, std::function< void( float ) > Func )
+{
+    // Each key keeps its timer, ticks rearm it every interval. Setting the expiry cancels a wait thats still pending
+    auto& Target = Timers[ Key ];
+    if( !Target.Handle )
+        Target.Handle = std::make_shared< asio::steady_timer >( Context );
+    
+    Target.Serial = NextSerial++;
+    Target.Handle->expires_after( std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< float >( Delay ) ) );
+    
+    // The handler holds the timer, so it stays alive until the wait finishes, and only holds the scheduler weakly,
+    // so a finished match can go away with timers still pending. Replaced timers are skipped by serial
+    // The wait finishes on an io thread, the timer map is only ever touched on the strand, so it hops over first
+    std::weak_ptr< StrandScheduler > Weak = shared_from_this();
+    std::weak_ptr< MatchStrand > WeakStrand = Strand;
+    auto Handle     = Target.Handle;
+    auto Serial     = Target.Serial;
+    double Armed    = GetTime();
+    
+    Handle->async_wait( [ Weak, WeakStrand, Handle, Key, Serial, Armed, Delay, bRepeat, Func ]( const asio::error_code& Error )
+    {
+        auto TargetStrand = WeakStrand.lock();
+        if( Error || !TargetStrand )
+            return;
+        
+        TargetStrand->Post( [ Weak, Key, Serial, Armed, Delay, bRepeat, Func ]()
+        {
+            auto Self = Weak.lock();
+            if( !Self )
+                return;
+            
+            auto Entry = Self->Timers.find( Key );
+            if( Entry == Self->Timers.end() || Entry->second.Serial != Serial )
+                return;
+            
+            // Rearmed before running, so the function is free to unschedule itself
+            if( bRepeat )
+                Self->Arm( Key, Delay, true, Func );
+            else
+                Self->Timers.erase( Entry );
+            
+            Func( (float)( Self->GetTime() - Armed ) );
+        } );
+    } );
+}
+
+
+void StrandScheduler::Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func )
+{
+    if( Func )
+        Arm( Key, std::max( Delay, 0.f ), false, Func );
+}
+
+
+void StrandScheduler::ScheduleTick( const std::string& Key, std::function< void( float ) > Func )
+{
+    if( Func )
+        Arm( Key, SERVER_TICK_INTERVAL, true, Func );
+}
+
+
+void StrandScheduler::Unschedule( const std::string& Key )
+{
+    auto Entry = Timers.find( Key );
+    if( Entry == Timers.end() )
+        return;
+    
+    Entry->second.Handle->cancel();
+    Timers.erase( Entry );
+}
+
+
+void StrandScheduler::UnscheduleAll()
+{
+    for( auto It = Timers.begin(); It != Timers.end(); It++ )
+        It->second.Handle->cancel();
+    
+    Timers.clear();
+}
+
+
+void StrandScheduler::Dispatch( std::function< void() > Func )
+{
+    if( !Func )
+        return;
+    
+    std::weak_ptr< StrandScheduler > Weak = shared_from_this();
+    Strand->Post( [ Weak, Func ]()
+    {
+        if( !Weak.expired() )
+            Func();
+    } );
+}
+
+
+/*=========================================================================================
+    Server Match
+ =========================================================================================*/
+ServerMatch::ServerMatch( MatchServer& InOwner )
+: Owner( InOwner ), Context( std::make_shared< MatchContext >() ), bFinished( false )
+{
+    Strand = InOwner.GetExecutor().CreateStrand( Context );
+}
+
+
+ServerMatch::~ServerMatch()
+{
+    // Usually gone already, unless the server stopped mid match
+    MatchContext::Scope Enter( Context.get() );
+    
+    Authority.reset();
+    Scheduler.reset();
+}
+
+
+std::shared_ptr< ServerSession >& ServerMatch::GetSession( PlayerTurn Side )
+{
+    return Side == PlayerTurn::Opponent ? Sessions[ 1 ] : Sessions[ 0 ];
+}
+
+
+void ServerMatch::Start( std::shared_ptr< ServerSession > First, std::shared_ptr< ServerSession > Second )
+{
+    Sessions[ 0 ] = First;
+    Sessions[ 1 ] = Second;
+    
+    auto Self = shared_from_this();
+    First->SetMatch( Self, PlayerTurn::LocalPlayer );
+    Second->SetMatch( Self, PlayerTurn::Opponent );
+    
+    Strand->Post( [ Self ]()
+    {
+        // Entity ids sent to clients start above anything the client allocates for itself
+        bool bLoaded = Self->Context->Init();
+        IEntityManager::GetInstance().ReserveIdentifiers( NET_ENTITY_ID_BASE );
+        
+        Self->Scheduler = std::make_shared< StrandScheduler >( Self->Strand, Self->Owner.GetContext() );
+        Self->Authority.reset( new ServerAuthority( *Self, Self->Scheduler ) );
+        
+        if( !bLoaded || !Self->Authority->Load( Self->Sessions[ 0 ]->GetHello(), Self->Sessions[ 1 ]->GetHello() ) )
+        {
+            cocos2d::log( "[Server] Failed to load match!" );
+            
+            Self->Sessions[ 0 ]->SendError( "Failed to load match" );
+            Self->Sessions[ 1 ]->SendError( "Failed to load match" );
+            Self->Finish();
+            return;
+        }
+        
+        Self->SendStart( PlayerTurn::LocalPlayer );
+        Self->SendStart( PlayerTurn::Opponent );
+        
+        Self->Authority->PostInit();
+    } );
+}
+
+
+void ServerMatch::SendStart( PlayerTurn Side )
+{
+    // Each player only gets what they can see, so nothing about the opponents hand or either deck order
+    auto& History = Snapshots[ Side == PlayerTurn::Opponent ? 1 : 0 ];
+    History.Reset();
+    
+    StreamWriter Frame;
+    BeginFrame( Frame, NetMessage::MatchStart );
+    Frame.WriteByte( (uint8_t) Side );
+    History.WriteUpdate( Authority->GetState(), Side, Frame );
+    FinishFrame( Frame );
+    UpdateHidden( Side );
+    
+    GetSession( Side )->Send( std::make_shared< const std::vector< uint8_t > >( std::move( Frame.Buffer ) ) );
+}
+
+
+void ServerMatch::SendSnapshot( PlayerTurn Side )
+{
+    auto& Session = GetSession( Side );
+    if( !Session )
+        return;
+    
+    StreamWriter Frame;
+    BeginFrame( Frame, NetMessage::Snapshot );
+    Snapshots[ Side == PlayerTurn::Opponent ? 1 : 0 ].WriteUpdate( Authority->GetState(), Side, Frame );
+    FinishFrame( Frame );
+    UpdateHidden( Side );
+    
+    Session->Send( std::make_shared< const std::vector< uint8_t > >( std::move( Frame.Buffer ) ) );
+}
+
+
+void ServerMatch::SendSnapshots()
+{
+    SendSnapshot( PlayerTurn::LocalPlayer );
+    SendSnapshot( PlayerTurn::Opponent );
+}
+
+
+void ServerMatch::SendReveals()
+{
+    PlayerTurn Sides[] = { PlayerTurn::LocalPlayer, PlayerTurn::Opponent };
+    
+    for( auto Side : Sides )
+    {
+        if( HasReveals( Side ) )
+            SendSnapshot( Side );
+    }
+}
+
+
+void ServerMatch::UpdateHidden( PlayerTurn Side )
+{
+    auto& Hidden = HiddenCards[ Side == PlayerTurn::Opponent ? 1 : 0 ];
+    auto& State = Authority->GetState();
+    Hidden.clear();
+    
+    PlayerState* Players[] = { State.GetPlayer(), State.GetOpponent() };
+    for( int i = 0; i < 2; i++ )
+    {
+        std::vector< CardState >* Zones[] = { &Players[ i ]->Deck, &Players[ i ]->Hand, &Players[ i ]->Field, &Players[ i ]->Graveyard };
+        for( auto Zone : Zones )
+        {
+            for( auto It = Zone->begin(); It != Zone->end(); It++ )
+            {
+                if( !StateSnapshot::CanSee( Side, i, It->Position ) )
+                    Hidden.insert( It->EntId );
+            }
+        }
+    }
+}
+
+
+bool ServerMatch::HasReveals( PlayerTurn Side )
+{
+    auto& Hidden = HiddenCards[ Side == PlayerTurn::Opponent ? 1 : 0 ];
+    if( Hidden.empty() || !GetSession( Side ) )
+        return false;
+    
+    // Decks are hidden from everyone, so only the hands and the cards that left them need checking
+    auto& State = Authority->GetState();
+    PlayerState* Players[] = { State.GetPlayer(), State.GetOpponent() };
+    
+    for( int i = 0; i < 2; i++ )
+    {
+        std::vector< CardState >* Zones[] = { &Players[ i ]->Hand, &Players[ i ]->Field, &Players[ i ]->Graveyard };
+        for( auto Zone : Zones )
+        {
+            for( auto It = Zone->begin(); It != Zone->end(); It++ )
+            {
+                if( StateSnapshot::CanSee( Side, i, It->Position ) && Hidden.count( It->EntId ) > 0 )
+                    return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+
+void ServerMatch::PostCommand( PlayerTurn Side, NetCommand&& In )
+{
+    auto Self = shared_from_this();
+    auto Command = std::make_shared< NetCommand >( std::move( In ) );
+    
+    Strand->Post( [ Self, Side, Command ]()
+    {
+        if( !Self->bFinished && Self->Authority )
+            Self->Authority->HandleCommand( Side, *Command );
+    } );
+}
+
+
+void ServerMatch::PostSnapshotAck( PlayerTurn Side, uint32_t Sequence )
+{
+    auto Self = shared_from_this();
+    Strand->Post( [ Self, Side, Sequence ]()
+    {
+        if( Self->bFinished )
+            return;
+        
+        Self->Snapshots[ Side == PlayerTurn::Opponent ? 1 : 0 ].Acknowledge( Sequence );
+        
+        // Zero means the player couldnt apply an update, so theyre sent a full snapshot right away
+        // instead of playing on out of sync until the next turn
+        if( Sequence == 0 && Self->Authority )
+            Self->SendSnapshot( Side );
+    } );
+}
+
+
+void ServerMatch::OnSessionClosed( PlayerTurn Side )
+{
+    auto Self = shared_from_this();
+    Strand->Post( [ Self, Side ]()
+    {
+        if( Self->bFinished || !Self->Authority )
+            return;
+        
+        cocos2d::log( "[Server] Player left the match, the other player wins" );
+        Self->Authority->Forfeit( Side );
+    } );
+}
+
+
+void ServerMatch::Broadcast( std::vector< uint8_t >&& Frame )
+{
+    auto Shared = std::make_shared< const std::vector< uint8_t > >( std::move( Frame ) );
+    
+    for( int i = 0; i < 2; i++ )
+    {
+        if( Sessions[ i ] )
+            Sessions[ i ]->Send( Shared );
+    }
+}
+
+
+void ServerMatch::Finish()
+{
+    if( bFinished )
+        return;
+    
+    bFinished = true;
+    
+    // This is usually called from inside the authority, so tear down once it returns
+    auto Self = shared_from_this();
+    Strand->Post( [ Self ]()
+    {
+        if( Self->Scheduler )
+            Self->Scheduler->UnscheduleAll();
+        
+        Self->Authority.reset();
+        Self->Scheduler.reset();
+        
+        cocos2d::log( "[Server] Match finished, %.2fms of cpu time over %d tasks", Self->Strand->GetCpuTime() * 1000.0, (int) Self->Strand->GetTaskCount() );
+        
+        for( int i = 0; i < 2; i++ )
+        {
+            if( Self->Sessions[ i ] )
+                Self->Sessions[ i ]->Close();
+            
+            Self->Sessions[ i ].reset();
+        }
+        
+        Self->Owner.OnMatchFinished( Self );
+    } );
+}
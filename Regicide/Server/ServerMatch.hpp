@@ -0,0 +1,119 @@
+//
+//	ServerMatch.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "MatchScheduler.hpp"
+#include "NetworkProtocol.hpp"
+#include "StateSnapshot.hpp"
+#include "MatchExecutor.hpp"
+#include "asio.hpp"
+#include <memory>
+#include <set>
+
+
+// How often the authority tick runs on the server, it only checks for wins and blitz completion
+#define SERVER_TICK_INTERVAL 0.1f
+
+namespace Game
+{
+    class MatchServer;
+    class ServerSession;
+    class ServerAuthority;
+    
+    // Match timers on asio steady timers, the timers wait on the io threads and run on the match strand
+    // The server never has a game mode, so this is headless, queue callbacks are dispatched as soon as the queue is sent
+    class StrandScheduler : public MatchScheduler, public std::enable_shared_from_this< StrandScheduler >
+    {
+    public:
+    
+        StrandScheduler( std::shared_ptr< MatchStrand > InStrand, asio::io_context& InContext );
+        
+        virtual double GetTime() const override;
+        virtual void Schedule( const std::string& Key, float Delay, std::function< void( float ) > Func ) override;
+        virtual void ScheduleTick( const std::string& Key, std::function< void( float ) > Func ) override;
+        virtual void Unschedule( const std::string& Key ) override;
+        virtual void UnscheduleAll() override;
+        virtual void Dispatch( std::function< void() > Func ) override;
+        virtual bool IsHeadless() const override { return true; }
+    
+    protected:
+    
+        struct Timer
+        {
+            std::shared_ptr< asio::steady_timer > Handle;
+            uint64_t Serial;
+        };
+        
+        void Arm( const std::string& Key, float Delay, bool bRepeat, std::function< void( float ) > Func );
+        
+        std::shared_ptr< MatchStrand > Strand;
+        asio::io_context& Context;
+        std::map< std::string, Timer > Timers;
+        uint64_t NextSerial;
+        std::chrono::steady_clock::time_point Start;
+    };
+    
+    // Two sessions playing against each other. The authority only ever runs on the match strand, so a match
+    // never needs its own locks. Each match has its own context, with its own Lua state and entity ids, so
+    // different matches dont share anything and run in parallel on the executor
+    class ServerMatch : public std::enable_shared_from_this< ServerMatch >
+    {
+    public:
+    
+        ServerMatch( MatchServer& InOwner );
+        ~ServerMatch();
+        
+        // Loads both decks, and sends each player the starting snapshot. The first session is the local player
+        // in the authority state, the second is the opponent
+        void Start( std::shared_ptr< ServerSession > First, std::shared_ptr< ServerSession > Second );
+        
+        void PostCommand( PlayerTurn Side, NetCommand&& In );
+        void PostSnapshotAck( PlayerTurn Side, uint32_t Sequence );
+        void OnSessionClosed( PlayerTurn Side );
+        
+        // Called on the strand by the authority
+        void Broadcast( std::vector< uint8_t >&& Frame );
+        void Finish();
+        
+        // Sends each player a snapshot of the authority state, as a delta against the last one they acknowledged
+        void SendSnapshots();
+        
+        // Queues only carry entity ids, so when a card comes out of a zone a player couldnt see, that
+        // player gets a snapshot right away to fill in what the card is
+        void SendReveals();
+        
+        inline MatchStrand& GetStrand() { return *Strand; }
+    
+    protected:
+    
+        std::shared_ptr< ServerSession >& GetSession( PlayerTurn Side );
+        void SendStart( PlayerTurn Side );
+        void SendSnapshot( PlayerTurn Side );
+        void UpdateHidden( PlayerTurn Side );
+        bool HasReveals( PlayerTurn Side );
+        
+        MatchServer& Owner;
+        
+        // The context is declared first, so its Lua state outlives everything holding references into it
+        std::shared_ptr< MatchContext > Context;
+        std::shared_ptr< MatchStrand > Strand;
+        
+        std::shared_ptr< StrandScheduler > Scheduler;
+        std::unique_ptr< ServerAuthority > Authority;
+        std::shared_ptr< ServerSession > Sessions[ 2 ];
+        SnapshotHistory Snapshots[ 2 ];
+        
+        // Cards each player couldnt see in the last snapshot they were sent
+        std::set< uint32_t > HiddenCards[ 2 ];
+        
+        bool bFinished;
+    };
+}
@@ -0,0 +1,271 @@
+//
+//	ServerSession.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#include "ServerSession.hpp"
+#include "MatchServer.hpp"
+#include "ServerMatch.hpp"
+#include "cocos2d.h"
+
+using namespace Game;
+
+
+ServerSession::ServerSession( asio::ip::tcp::socket&& InSocket, MatchServer& InOwner )
+: Socket( std::move( InSocket ) ), Strand( InOwner.GetContext() ), Owner( InOwner ), Side( PlayerTurn::None ),
+  bGreeted( false ), bClosing( false ), bClosed( false )
+{
+}
+
+
+void ServerSession::Start()
+{
+    auto Self = shared_from_this();
+    asio::post( Strand, [ Self ]()
+    {
+        asio::error_code Ignored;
+        Self->Socket.set_option( asio::ip::tcp::no_delay( true ), Ignored );
+        Self->ReadHeader();
+    } );
+}
+
+
+void ServerSession::SetMatch( std::shared_ptr< ServerMatch > InMatch, PlayerTurn InSide )
+{
+    auto Self = shared_from_this();
+    asio::post( Strand, [ Self, InMatch, InSide ]()
+    {
+        Self->Match = InMatch;
+        Self->Side  = InSide;
+    } );
+}
+
+
+/*=========================================================================================
+    Reading
+ =========================================================================================*/
+void ServerSession::ReadHeader()
+{
+    auto Self = shared_from_this();
+    asio::async_read( Socket, asio::buffer( Header, NET_FRAME_HEADER_SIZE ), asio::bind_executor( Strand,
+    [ Self ]( const asio::error_code& Error, size_t )
+    {
+        if( Error )
+        {
+            Self->Fail( "Connection lost: " + Error.message() );
+            return;
+        }
+        
+        uint32_t Size = ReadFrameSize( Self->Header );
+        if( Size == 0 || Size > NET_MAX_FRAME_SIZE )
+        {
+            Self->Fail( "Invalid frame size" );
+            return;
+        }
+        
+        Self->ReadBody( Size );
+    } ) );
+}
+
+
+void ServerSession::ReadBody( uint32_t Size )
+{
+    Body.resize( Size );
+    
+    auto Self = shared_from_this();
+    asio::async_read( Socket, asio::buffer( Body ), asio::bind_executor( Strand,
+    [ Self ]( const asio::error_code& Error, size_t )
+    {
+        if( Error )
+        {
+            Self->Fail( "Connection lost: " + Error.message() );
+            return;
+        }
+        
+        Self->HandleFrame();
+        
+        if( !Self->bClosed && !Self->bClosing )
+            Self->ReadHeader();
+    } ) );
+}
+
+
+void ServerSession::HandleFrame()
+{
+    NetMessage Type = (NetMessage) Body[ 0 ];
+    StreamReader Reader = OpenPayload( Body );
+    
+    // The first message has to be hello, everything after that has to be a command
+    if( !bGreeted )
+    {
+        if( Type != NetMessage::Hello || !Hello.Read( Reader ) )
+        {
+            Fail( "Expected hello" );
+            return;
+        }
+        
+        if( Hello.Version != NET_PROTOCOL_VERSION )
+        {
+            SendError( "Protocol version mismatch, please update the game" );
+            Close();
+            return;
+        }
+        
+        bGreeted = true;
+        
+        StreamWriter Welcome;
+        BeginFrame( Welcome, NetMessage::Welcome );
+        Welcome.WriteVarint( NET_PROTOCOL_VERSION );
+        FinishFrame( Welcome );
+        
+        Send( std::make_shared< const std::vector< uint8_t > >( std::move( Welcome.Buffer ) ) );
+        Owner.Enqueue( shared_from_this() );
+        return;
+    }
+    
+    auto Target = Match.lock();
+    
+    if( Type == NetMessage::SnapshotAck )
+    {
+        uint32_t Sequence = (uint32_t) Reader.ReadVarint();
+        if( !Reader.IsValid() )
+        {
+            Fail( "Malformed snapshot ack" );
+            return;
+        }
+        
+        if( Target )
+            Target->PostSnapshotAck( Side, Sequence );
+        
+        return;
+    }
+    
+    if( !NetCommand::IsCommand( Type ) )
+    {
+        Fail( "Unexpected message type" );
+        return;
+    }
+    
+    NetCommand Command;
+    Command.Type = Type;
+    
+    if( !Command.Read( Reader ) )
+    {
+        Fail( "Malformed command" );
+        return;
+    }
+    
+    if( !Target )
+    {
+        cocos2d::log( "[Server] Dropped command from a session thats not in a match" );
+        return;
+    }
+    
+    Target->PostCommand( Side, std::move( Command ) );
+}
+
+
+/*=========================================================================================
+    Writing
+ =========================================================================================*/
+void ServerSession::Send( std::shared_ptr< const std::vector< uint8_t > > Frame )
+{
+    auto Self = shared_from_this();
+    asio::post( Strand, [ Self, Frame ]()
+    {
+        if( Self->bClosed || Self->bClosing )
+            return;
+        
+        bool bIdle = Self->Outbox.empty();
+        Self->Outbox.push_back( Frame );
+        
+        if( bIdle )
+            Self->WriteNext();
+    } );
+}
+
+
+void ServerSession::SendError( const std::string& Reason )
+{
+    StreamWriter Frame;
+    BeginFrame( Frame, NetMessage::Error );
+    Frame.WriteString( Reason );
+    FinishFrame( Frame );
+    
+    Send( std::make_shared< const std::vector< uint8_t > >( std::move( Frame.Buffer ) ) );
+}
+
+
+void ServerSession::WriteNext()
+{
+    if( Outbox.empty() )
+    {
+        if( bClosing )
+            Fail( "Closed by server" );
+        
+        return;
+    }
+    
+    auto Self = shared_from_this();
+    asio::async_write( Socket, asio::buffer( *Outbox.front() ), asio::bind_executor( Strand,
+    [ Self ]( const asio::error_code& Error, size_t )
+    {
+        if( Self->bClosed )
+            return;
+        
+        if( Error )
+        {
+            Self->Fail( "Write failed: " + Error.message() );
+            return;
+        }
+        
+        Self->Outbox.pop_front();
+        Self->WriteNext();
+    } ) );
+}
+
+
+void ServerSession::Close()
+{
+    auto Self = shared_from_this();
+    asio::post( Strand, [ Self ]()
+    {
+        if( Self->bClosed || Self->bClosing )
+            return;
+        
+        Self->bClosing = true;
+        if( Self->Outbox.empty() )
+            Self->Fail( "Closed by server" );
+    } );
+}
+
+
+void ServerSession::Fail( const std::string& Reason )
+{
+    if( bClosed )
+        return;
+    
+    bClosed = true;
+    
+    asio::error_code Ignored;
+    Socket.shutdown( asio::ip::tcp::socket::shutdown_both, Ignored );
+    Socket.close( Ignored );
+    
+    auto Target = Match.lock();
+    if( Target )
+    {
+        Target->OnSessionClosed( Side );
+    }
+    else
+    {
+        if( bGreeted && !bClosing )
+            cocos2d::log( "[Server] Session left the lobby (%s)", Reason.c_str() );
+        
+        Owner.Remove( shared_from_this() );
+    }
+}
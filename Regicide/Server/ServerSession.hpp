@@ -0,0 +1,70 @@
+//
+//	ServerSession.hpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+
+#pragma once
+
+#include "NetworkProtocol.hpp"
+#include "asio.hpp"
+#include <deque>
+#include <memory>
+
+
+namespace Game
+{
+    class MatchServer;
+    class ServerMatch;
+    
+    // One connected client. Reads and writes are all async, and run on the sessions own strand, so
+    // the session never blocks a pool thread. Commands are handed to the match, which runs them on the match strand
+    class ServerSession : public std::enable_shared_from_this< ServerSession >
+    {
+    public:
+    
+        ServerSession( asio::ip::tcp::socket&& InSocket, MatchServer& InOwner );
+        
+        void Start();
+        
+        // Safe to call from any thread, frames are shared so a broadcast only encodes once
+        void Send( std::shared_ptr< const std::vector< uint8_t > > Frame );
+        void SendError( const std::string& Reason );
+        
+        // Closes once everything queued has been written
+        void Close();
+        
+        void SetMatch( std::shared_ptr< ServerMatch > InMatch, PlayerTurn InSide );
+        
+        // Only valid once the session has been put in the lobby
+        inline const NetHello& GetHello() const { return Hello; }
+    
+    protected:
+    
+        void ReadHeader();
+        void ReadBody( uint32_t Size );
+        void HandleFrame();
+        void WriteNext();
+        void Fail( const std::string& Reason );
+        
+        asio::ip::tcp::socket Socket;
+        asio::io_context::strand Strand;
+        MatchServer& Owner;
+        
+        uint8_t Header[ NET_FRAME_HEADER_SIZE ];
+        std::vector< uint8_t > Body;
+        std::deque< std::shared_ptr< const std::vector< uint8_t > > > Outbox;
+        
+        std::weak_ptr< ServerMatch > Match;
+        PlayerTurn Side;
+        NetHello Hello;
+        
+        bool bGreeted;
+        bool bClosing;
+        bool bClosed;
+    };
+}
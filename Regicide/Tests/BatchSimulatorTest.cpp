@@ -0,0 +1,158 @@
+//
+//	BatchSimulatorTest.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Checks the batch simulator against the scalar one on fixed boards built from the shipped card scripts
+//  Run from the Regicide directory, so the Lua scripts can be found
+//
+
+#include "MatchContext.hpp"
+#include "BatchSimulator.hpp"
+#include "cocos2d.h"
+#include <memory>
+
+using namespace Game;
+
+
+// The battle matrix is only reachable from inside the simulator, so the test board builds it from a subclass
+class TestBoard : public SimulatedState
+{
+public:
+    
+    bool Build( PlayerTurn Turn, TurnState Phase )
+    {
+        auto& CM = CardManager::GetInstance();
+        const uint16_t Ids[] = { 5, 6, 7, 8 };
+        uint32_t NextId = 10;
+        
+        PlayerState* Players[ 2 ] = { GetPlayer(), GetOpponent() };
+        for( int i = 0; i < 2; i++ )
+        {
+            auto Target = Players[ i ];
+            Target->EntId   = (uint32_t)( i + 1 );
+            Target->Health  = 20;
+            Target->Mana    = 4;
+            
+            // 24 cards each, two on the field and three in hand, the rest in the deck
+            for( int c = 0; c < 24; c++ )
+            {
+                CardInfo Info;
+                if( !CM.GetInfo( Ids[ c % 4 ], Info ) )
+                    return false;
+                
+                CardState Card;
+                Card.Id         = Info.Id;
+                Card.EntId      = NextId++;
+                Card.Power      = Info.Power;
+                Card.Stamina    = Info.Stamina;
+                Card.ManaCost   = Info.ManaCost;
+                Card.FaceUp     = c < 5;
+                Card.Owner      = Target->EntId;
+                Card.Position   = c < 2 ? CardPos::FIELD : ( c < 5 ? CardPos::HAND : CardPos::DECK );
+                
+                auto Zone = GetZone( Target, Card.Position );
+                Zone->push_back( Card );
+            }
+        }
+        
+        mState = MatchState::Main;
+        SetStartingPlayer( Turn );
+        tState = Phase;
+        
+        RebuildIndex();
+        return true;
+    }
+    
+    void AddAttacker( uint32_t EntId )
+    {
+        BattleMatrix[ EntId ] = std::vector< uint32_t >();
+    }
+};
+
+
+static bool RunBoard( const char* Name, TestBoard& Board, int Turns, int Runs )
+{
+    if( !BatchSimulator::IsHookFree( Board ) )
+    {
+        cocos2d::log( "[Test] %s: Board should be hook free!", Name );
+        return false;
+    }
+    
+    // A board the batch cant load would make the self test pass without running anything
+    std::unique_ptr< BatchSimulator > Batch( new BatchSimulator() );
+    if( !Batch->Load( Board ) )
+    {
+        cocos2d::log( "[Test] %s: Batch failed to load the board!", Name );
+        return false;
+    }
+    
+    if( !BatchSimulator::SelfTest( Board, Turns, Runs ) )
+    {
+        cocos2d::log( "[Test] %s: Failed!", Name );
+        return false;
+    }
+    
+    cocos2d::log( "[Test] %s: Passed", Name );
+    return true;
+}
+
+
+int main( int argc, char** argv )
+{
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // Fixed seed, so a failure can be run again
+    MatchContext Context( 1218 );
+    MatchContext::Scope Enter( std::addressof( Context ) );
+    
+    if( !Context.Init() )
+    {
+        cocos2d::log( "[Test] Failed to initialize match context!" );
+        return 1;
+    }
+    
+    int Failed = 0;
+    
+    // The AI deciding what to play, rollouts pick up from the attack
+    {
+        std::unique_ptr< TestBoard > Board( new TestBoard() );
+        if( !Board->Build( PlayerTurn::Opponent, TurnState::Marshal ) || !RunBoard( "Marshal", *Board, 8, 2048 ) )
+            Failed++;
+    }
+    
+    // The AI attacking with both field cards, rollouts pick up from the block
+    {
+        std::unique_ptr< TestBoard > Board( new TestBoard() );
+        if( !Board->Build( PlayerTurn::Opponent, TurnState::Attack ) )
+        {
+            Failed++;
+        }
+        else
+        {
+            auto Opponent = Board->GetOpponent();
+            for( auto It = Opponent->Field.begin(); It != Opponent->Field.end(); It++ )
+                Board->AddAttacker( It->EntId );
+            
+            if( !RunBoard( "Attack", *Board, 8, 2048 ) )
+                Failed++;
+        }
+    }
+    
+    // Long rollouts, so decks run out and lanes finish on different turns
+    {
+        std::unique_ptr< TestBoard > Board( new TestBoard() );
+        if( !Board->Build( PlayerTurn::LocalPlayer, TurnState::Marshal ) || !RunBoard( "Long", *Board, 40, 1024 ) )
+            Failed++;
+    }
+    
+    return Failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+//
+//	HeadlessMatchTest.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Plays a full match against the AI on the virtual scheduler, nobody sits in the local seat, so it passes every
+//  decision once the seat timeout runs out. Fails if the match stalls before someone wins
+//  Run from the Regicide directory, so the Lua scripts can be found
+//
+
+#include "MatchContext.hpp"
+#include "MatchScheduler.hpp"
+#include "SingleplayerAuthority.hpp"
+#include "AIController.hpp"
+#include "cocos2d.h"
+#include <chrono>
+#include <memory>
+
+using namespace Game;
+
+
+// Real time the whole match gets, the AI searches on its own thread against the wall clock
+#define TEST_MATCH_TIMEOUT 600
+
+
+// Loading players and seating the AI is usually done by the launcher, so the test does both from a subclass
+class TestAuthority : public SingleplayerAuthority
+{
+public:
+    
+    TestAuthority( std::shared_ptr< MatchScheduler > InScheduler )
+    : SingleplayerAuthority( InScheduler )
+    {}
+    
+    bool LoadDeck( const Regicide::Deck& In )
+    {
+        return LoadPlayers( "Player", 20, 8, In, "AI", 20, 8, In );
+    }
+    
+    void Seat( AIController* In )
+    {
+        AddChild( In );
+        AI = In;
+    }
+};
+
+
+int main( int argc, char** argv )
+{
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // Fixed seed, so a failure can be run again
+    MatchContext Context( 1218 );
+    MatchContext::Scope Enter( std::addressof( Context ) );
+    
+    if( !Context.Init() )
+    {
+        cocos2d::log( "[Test] Failed to initialize match context!" );
+        return 1;
+    }
+    
+    // Same deck the practice match uses, on both sides
+    Regicide::Deck Deck;
+    Deck.Name   = "Headless Match";
+    Deck.KingId = 1;
+    Deck.Cards.push_back( Regicide::Card( 5, 8 ) );
+    Deck.Cards.push_back( Regicide::Card( 6, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 7, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 8, 12 ) );
+    
+    auto Scheduler = std::make_shared< VirtualScheduler >();
+    std::unique_ptr< TestAuthority > Authority( new TestAuthority( Scheduler ) );
+    
+    if( !Authority->LoadDeck( Deck ) )
+    {
+        cocos2d::log( "[Test] Failed to load deck!" );
+        return 1;
+    }
+    
+    std::unique_ptr< AIController > AI( new AIController() );
+    Authority->Seat( AI.get() );
+    Authority->EmptySeatTimeout = 1.f;
+    
+    AI->Initialize();
+    Authority->PostInit();
+    
+    // The scheduler goes idle while the AI thinks, so keep waiting on it until the match ends or the time runs out
+    auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds( TEST_MATCH_TIMEOUT );
+    while( Authority->GetState().mState != MatchState::PostMatch && std::chrono::steady_clock::now() < Deadline )
+        Scheduler->RunUntilIdle( Scheduler->GetTime() + 60.0, 250 );
+    
+    bool bFinished = Authority->GetState().mState == MatchState::PostMatch;
+    double MatchTime = Scheduler->GetTime();
+    
+    AI->Cleanup();
+    Scheduler->UnscheduleAll();
+    
+    if( !bFinished )
+    {
+        cocos2d::log( "[Test] Match stalled! Stuck in match state %d, turn state %d", (int) Authority->GetState().mState, (int) Authority->GetState().tState );
+        return 1;
+    }
+    
+    cocos2d::log( "[Test] Match finished after %.1f seconds of match time", MatchTime );
+    return 0;
+}
@@ -0,0 +1,127 @@
+//
+//	ServerBlockersTest.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Sends block commands to a server authority the way a client would. Blocking a card that was never declared
+//  as an attacker has to be rejected, without leaving anything behind in the battle matrix
+//  Run from the Regicide directory, so the Lua scripts can be found
+//
+
+#include "MatchServer.hpp"
+#include "ServerMatch.hpp"
+#include "ServerAuthority.hpp"
+#include "MatchContext.hpp"
+#include "cocos2d.h"
+#include <memory>
+
+using namespace Game;
+
+
+// Puts the top card of a deck onto the field, ready for combat
+static uint32_t FieldCard( AuthState& State, PlayerState* Owner )
+{
+    auto Card = State.MoveCard( Owner, CardPos::DECK, Owner->Deck.size() - 1, CardPos::FIELD );
+    CC_ASSERT( Card );
+    
+    Card->FaceUp    = true;
+    Card->Power     = 2;
+    Card->Stamina   = 2;
+    
+    return Card->EntId;
+}
+
+
+int main( int argc, char** argv )
+{
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // The match is never started, so theres no sessions and nothing is sent anywhere
+    MatchServer Server( 1 );
+    auto Match = std::make_shared< ServerMatch >( Server );
+    
+    MatchContext Context( 1218 );
+    MatchContext::Scope Enter( std::addressof( Context ) );
+    
+    if( !Context.Init() )
+    {
+        cocos2d::log( "[Test] Failed to initialize match context!" );
+        return 1;
+    }
+    
+    // Same deck the practice match uses, on both sides
+    NetHello Hello;
+    Hello.Name          = "Blockers";
+    Hello.Deck.Name     = "Blockers";
+    Hello.Deck.KingId   = 1;
+    Hello.Deck.Cards.push_back( Regicide::Card( 5, 8 ) );
+    Hello.Deck.Cards.push_back( Regicide::Card( 6, 5 ) );
+    Hello.Deck.Cards.push_back( Regicide::Card( 7, 5 ) );
+    Hello.Deck.Cards.push_back( Regicide::Card( 8, 12 ) );
+    
+    auto Scheduler = std::make_shared< VirtualScheduler >();
+    std::unique_ptr< ServerAuthority > Authority( new ServerAuthority( *Match, Scheduler ) );
+    
+    if( !Authority->Load( Hello, Hello ) )
+    {
+        cocos2d::log( "[Test] Failed to load decks!" );
+        return 1;
+    }
+    
+    // The local player has two cards out and attacks with one, the opponent has one card to block with
+    auto& State         = Authority->GetState();
+    uint32_t Attacking  = FieldCard( State, State.GetPlayer() );
+    uint32_t Idle       = FieldCard( State, State.GetPlayer() );
+    uint32_t Blocking   = FieldCard( State, State.GetOpponent() );
+    
+    State.mState    = MatchState::Main;
+    State.tState    = TurnState::Block;
+    State.pState    = PlayerTurn::LocalPlayer;
+    
+    Authority->BattleMatrix.clear();
+    Authority->BattleMatrix[ Attacking ] = std::vector< uint32_t >();
+    
+    bool bPassed = true;
+    
+    NetCommand Command;
+    Command.Type = NetMessage::SetBlockers;
+    Command.Blockers[ Blocking ] = Idle;
+    Authority->HandleCommand( PlayerTurn::Opponent, Command );
+    
+    if( State.tState != TurnState::Block )
+    {
+        cocos2d::log( "[Test] Blocking a card that isnt attacking moved the turn on!" );
+        bPassed = false;
+    }
+    
+    if( Authority->BattleMatrix.size() != 1 || Authority->BattleMatrix.count( Idle ) > 0 || !Authority->BattleMatrix[ Attacking ].empty() )
+    {
+        cocos2d::log( "[Test] Rejected blocks were left in the battle matrix!" );
+        bPassed = false;
+    }
+    
+    // The same blocker against the real attacker still goes through
+    Command.Blockers.clear();
+    Command.Blockers[ Blocking ] = Attacking;
+    Authority->HandleCommand( PlayerTurn::Opponent, Command );
+    
+    if( State.tState == TurnState::Block )
+    {
+        cocos2d::log( "[Test] Valid block was rejected!" );
+        bPassed = false;
+    }
+    
+    Scheduler->UnscheduleAll();
+    Authority.reset();
+    
+    cocos2d::log( bPassed ? "[Test] Server blockers: Passed" : "[Test] Server blockers: Failed!" );
+    return bPassed ? 0 : 1;
+}
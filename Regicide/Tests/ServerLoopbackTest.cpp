@@ -0,0 +1,322 @@
+//
+//	ServerLoopbackTest.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Starts a real match server on localhost and connects two clients to it. They go through the lobby, the blitz
+//  and a full turn over the wire, then one of them leaves and the other has to be sent the win
+//  Run from the Regicide directory, so the Lua scripts can be found
+//
+
+#include "MatchServer.hpp"
+#include "NetworkClient.hpp"
+#include "NetworkProtocol.hpp"
+#include "StateSnapshot.hpp"
+#include "AuthState.hpp"
+#include "cocos2d.h"
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+using namespace Game;
+
+
+// Real time each client waits for the message it expects next, before the test counts it as lost
+#define TEST_WAIT_SECONDS 30
+
+
+static bool HasAction( const std::vector< Game::Action* >& In, ActionId Id )
+{
+    for( auto It = In.begin(); It != In.end(); It++ )
+    {
+        if( ( *It )->Id == Id )
+            return true;
+        
+        if( ( *It )->Type == ActionType::Parallel && HasAction( static_cast< ParallelAction* >( *It )->Actions, Id ) )
+            return true;
+    }
+    
+    return false;
+}
+
+
+// Talks to the server the same way NetworkAuthority does, without a game mode to play the queues
+// Frames arrive on the network thread, and are read on the test thread as it waits for them
+class TestClient
+{
+public:
+    
+    TestClient( const std::string& InName )
+    : Name( InName ), Side( PlayerTurn::None ), bClosed( false )
+    {}
+    
+    void Connect( uint16_t Port, const Regicide::Deck& Deck )
+    {
+        NetHello Hello;
+        Hello.Name = Name;
+        Hello.Deck = Deck;
+        
+        Client.Connect( "127.0.0.1", Port, Hello,
+        [ this ]( NetMessage Type, std::vector< uint8_t >&& Frame )
+        {
+            std::lock_guard< std::mutex > Guard( Lock );
+            Inbox.push_back( std::make_pair( Type, std::move( Frame ) ) );
+            Signal.notify_all();
+        },
+        [ this ]( const std::string& Reason )
+        {
+            std::lock_guard< std::mutex > Guard( Lock );
+            bClosed = true;
+            Signal.notify_all();
+        } );
+    }
+    
+    void Close()
+    {
+        Client.Close();
+    }
+    
+    void Send( NetMessage Type, const std::vector< uint32_t >& Cards = std::vector< uint32_t >() )
+    {
+        NetCommand Command;
+        Command.Type    = Type;
+        Command.Cards   = Cards;
+        
+        StreamWriter Frame;
+        BeginFrame( Frame, Command.Type );
+        Command.Write( Frame );
+        FinishFrame( Frame );
+        
+        Client.Send( std::move( Frame.Buffer ) );
+    }
+    
+    // Reads messages until one of the given type arrives, for queues, until one has an action with the given id
+    // Snapshots along the way are applied and acknowledged, so the server keeps sending deltas like it would to a player
+    bool WaitFor( NetMessage Type, ActionId Id = ActionId::Count )
+    {
+        auto Deadline = std::chrono::steady_clock::now() + std::chrono::seconds( TEST_WAIT_SECONDS );
+        
+        while( true )
+        {
+            std::pair< NetMessage, std::vector< uint8_t > > Next;
+            {
+                std::unique_lock< std::mutex > Guard( Lock );
+                if( !Signal.wait_until( Guard, Deadline, [ this ]() { return !Inbox.empty() || bClosed; } ) )
+                {
+                    cocos2d::log( "[Test] %s: Timed out waiting for message %d", Name.c_str(), (int) Type );
+                    return false;
+                }
+                
+                // Everything the server sent before closing is still read first
+                if( Inbox.empty() )
+                {
+                    cocos2d::log( "[Test] %s: Connection closed waiting for message %d", Name.c_str(), (int) Type );
+                    return false;
+                }
+                
+                Next = std::move( Inbox.front() );
+                Inbox.pop_front();
+            }
+            
+            bool bMatched = false;
+            if( !HandleMessage( Next.first, Next.second, Id, bMatched ) )
+                return false;
+            
+            if( Next.first == Type && ( Type != NetMessage::Queue || bMatched ) )
+                return true;
+        }
+    }
+    
+    inline PlayerTurn GetSide() const { return Side; }
+    inline const std::string& GetName() const { return Name; }
+    
+protected:
+    
+    bool HandleMessage( NetMessage Type, const std::vector< uint8_t >& Frame, ActionId Id, bool& bMatched )
+    {
+        StreamReader Reader = OpenPayload( Frame );
+        
+        switch( Type )
+        {
+            case NetMessage::Welcome:
+            {
+                uint32_t Version = (uint32_t) Reader.ReadVarint();
+                if( Version != NET_PROTOCOL_VERSION )
+                {
+                    cocos2d::log( "[Test] %s: Server is running protocol v%d!", Name.c_str(), (int) Version );
+                    return false;
+                }
+                
+                return true;
+            }
+            case NetMessage::MatchStart:
+            {
+                Side = (PlayerTurn) Reader.ReadByte();
+                if( !Reader.IsValid() || ( Side != PlayerTurn::LocalPlayer && Side != PlayerTurn::Opponent ) )
+                {
+                    cocos2d::log( "[Test] %s: Invalid side in match start!", Name.c_str() );
+                    return false;
+                }
+                
+                Snapshots.Reset();
+                return ReadSnapshot( Reader );
+            }
+            case NetMessage::Snapshot:
+            {
+                return ReadSnapshot( Reader );
+            }
+            case NetMessage::Queue:
+            {
+                auto Queue = ActionQueue();
+                if( !ReadActionQueue( Reader, Queue ) )
+                {
+                    cocos2d::log( "[Test] %s: Received invalid action queue!", Name.c_str() );
+                    return false;
+                }
+                
+                bMatched = HasAction( Queue.Actions, Id );
+                return true;
+            }
+            case NetMessage::Error:
+            {
+                std::string Reason = Reader.ReadString();
+                cocos2d::log( "[Test] %s: Server error: %s", Name.c_str(), Reason.c_str() );
+                return false;
+            }
+            default:
+            {
+                cocos2d::log( "[Test] %s: Received unknown message type %d", Name.c_str(), (int) Type );
+                return false;
+            }
+        }
+    }
+    
+    bool ReadSnapshot( StreamReader& In )
+    {
+        uint32_t Sequence = 0;
+        bool bResult = Snapshots.ReadUpdate( In, State, Sequence );
+        
+        StreamWriter Ack;
+        BeginFrame( Ack, NetMessage::SnapshotAck );
+        Ack.WriteVarint( Sequence );
+        FinishFrame( Ack );
+        Client.Send( std::move( Ack.Buffer ) );
+        
+        if( !bResult )
+            cocos2d::log( "[Test] %s: Couldnt apply state snapshot!", Name.c_str() );
+        
+        return bResult;
+    }
+    
+    std::string Name;
+    PlayerTurn Side;
+    
+    NetworkClient Client;
+    SnapshotReceiver Snapshots;
+    AuthState State;
+    
+    std::mutex Lock;
+    std::condition_variable Signal;
+    std::deque< std::pair< NetMessage, std::vector< uint8_t > > > Inbox;
+    bool bClosed;
+};
+
+
+static bool RunMatch( uint16_t Port )
+{
+    // Same deck the practice match uses, on both sides
+    Regicide::Deck Deck;
+    Deck.Name   = "Loopback";
+    Deck.KingId = 1;
+    Deck.Cards.push_back( Regicide::Card( 5, 8 ) );
+    Deck.Cards.push_back( Regicide::Card( 6, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 7, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 8, 12 ) );
+    
+    TestClient First( "First" );
+    TestClient Second( "Second" );
+    TestClient* Clients[] = { &First, &Second };
+    
+    First.Connect( Port, Deck );
+    Second.Connect( Port, Deck );
+    
+    bool bPassed = true;
+    
+    // Both get let into the lobby and paired up, on opposite sides
+    for( auto Client : Clients )
+        bPassed = bPassed && Client->WaitFor( NetMessage::Welcome ) && Client->WaitFor( NetMessage::MatchStart );
+    
+    if( bPassed && First.GetSide() == Second.GetSide() )
+    {
+        cocos2d::log( "[Test] Both players were put on the same side!" );
+        bPassed = false;
+    }
+    
+    // The match starts once both are ready, and both pass the blitz
+    for( auto Client : Clients )
+    {
+        if( bPassed )
+            Client->Send( NetMessage::SetReady );
+    }
+    
+    for( auto Client : Clients )
+        bPassed = bPassed && Client->WaitFor( NetMessage::Queue, ActionId::BlitzStart );
+    
+    for( auto Client : Clients )
+    {
+        if( bPassed )
+            Client->Send( NetMessage::SetBlitzCards );
+    }
+    
+    for( auto Client : Clients )
+        bPassed = bPassed && Client->WaitFor( NetMessage::Queue, ActionId::TurnStart );
+    
+    // The server always starts with its local player, that player finishes the marshal, and attacks with nothing
+    TestClient* Starting    = First.GetSide() == PlayerTurn::LocalPlayer ? &First : &Second;
+    TestClient* Waiting     = Starting == &First ? &Second : &First;
+    
+    if( bPassed )
+    {
+        Starting->Send( NetMessage::FinishTurn );
+        Starting->Send( NetMessage::FinishTurn );
+    }
+    
+    for( auto Client : Clients )
+        bPassed = bPassed && Client->WaitFor( NetMessage::Queue, ActionId::TurnStart );
+    
+    // Leaving mid match forfeits it
+    Starting->Close();
+    bPassed = bPassed && Waiting->WaitFor( NetMessage::Queue, ActionId::Win );
+    Waiting->Close();
+    
+    return bPassed;
+}
+
+
+int main( int argc, char** argv )
+{
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // Any free port, so the test can run next to a real server
+    MatchServer Server( 2 );
+    if( !Server.Listen( 0, "127.0.0.1" ) )
+        return 1;
+    
+    Server.Start();
+    bool bPassed = RunMatch( Server.GetPort() );
+    
+    Server.Stop();
+    Server.Wait();
+    
+    cocos2d::log( bPassed ? "[Test] Loopback match: Passed" : "[Test] Loopback match: Failed!" );
+    return bPassed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+//
+//	SnapshotRedactionTest.cpp
+//	Regicide Mobile
+//
+//	Created: 12/14/18
+//	Updated: 12/14/18
+//
+//	© 2018 Zachary Berry, All Rights Reserved
+//
+//  Loads a match the same way the server does, and checks what the local player gets sent about the opponents
+//  deck. Every row has to be hidden, and laid out in EntId order, the ids cant group copies of a card together
+//  Run from the Regicide directory, so the Lua scripts can be found
+//
+
+#include "MatchContext.hpp"
+#include "MatchScheduler.hpp"
+#include "SingleplayerAuthority.hpp"
+#include "StateSnapshot.hpp"
+#include "cocos2d.h"
+#include <map>
+#include <memory>
+
+using namespace Game;
+
+
+// Loading players is left to the authorities that run real matches, this one only needs the loaded state
+class TestAuthority : public SingleplayerAuthority
+{
+public:
+    
+    TestAuthority( std::shared_ptr< MatchScheduler > InScheduler )
+    : SingleplayerAuthority( InScheduler )
+    {}
+    
+    bool LoadDeck( const Regicide::Deck& In )
+    {
+        return LoadPlayers( "Player", 20, 8, In, "Opponent", 20, 8, In );
+    }
+};
+
+
+static bool CheckSeed( uint64_t Seed, const Regicide::Deck& Deck )
+{
+    MatchContext Context( Seed );
+    MatchContext::Scope Enter( std::addressof( Context ) );
+    
+    if( !Context.Init() )
+    {
+        cocos2d::log( "[Test] Failed to initialize match context!" );
+        return false;
+    }
+    
+    auto Scheduler = std::make_shared< VirtualScheduler >();
+    std::unique_ptr< TestAuthority > Authority( new TestAuthority( Scheduler ) );
+    
+    if( !Authority->LoadDeck( Deck ) )
+    {
+        cocos2d::log( "[Test] Failed to load deck!" );
+        return false;
+    }
+    
+    // What the card behind each id really is, only the authority knows this
+    auto& Source = Authority->GetState();
+    std::map< uint32_t, uint16_t > Real;
+    for( auto It = Source.GetOpponent()->Deck.begin(); It != Source.GetOpponent()->Deck.end(); It++ )
+        Real[ It->EntId ] = It->Id;
+    
+    std::vector< uint8_t > Image;
+    StateSnapshot::Capture( Source, PlayerTurn::LocalPlayer, Image );
+    
+    std::unique_ptr< GameStateBase > Viewer( new GameStateBase() );
+    if( !StateSnapshot::Restore( Image, *Viewer ) )
+    {
+        cocos2d::log( "[Test] Failed to restore the local players snapshot!" );
+        return false;
+    }
+    
+    auto& Rows = Viewer->GetOpponent()->Deck;
+    if( Rows.size() != Real.size() )
+    {
+        cocos2d::log( "[Test] Opponent deck has %d rows, expected %d", (int) Rows.size(), (int) Real.size() );
+        return false;
+    }
+    
+    // Neighbouring rows that are copies of the same card. Ids handed out down the deck list make nearly every pair
+    // match, a random order only matches as often as the deck makeup allows (about a quarter of pairs for this deck)
+    int Matches = 0;
+    for( size_t i = 0; i < Rows.size(); i++ )
+    {
+        if( Rows[ i ].Id != 0 || Rows[ i ].Power != 0 || Rows[ i ].FaceUp )
+        {
+            cocos2d::log( "[Test] Opponent deck row %d wasnt hidden!", (int) i );
+            return false;
+        }
+        
+        if( Real.count( Rows[ i ].EntId ) == 0 )
+        {
+            cocos2d::log( "[Test] Opponent deck row %d has an id the opponent doesnt own!", (int) i );
+            return false;
+        }
+        
+        if( i > 0 && Real[ Rows[ i ].EntId ] == Real[ Rows[ i - 1 ].EntId ] )
+            Matches++;
+    }
+    
+    int Pairs = (int) Rows.size() - 1;
+    if( Matches * 2 > Pairs )
+    {
+        cocos2d::log( "[Test] Seed %d: %d of %d neighbouring hidden rows are the same card!", (int) Seed, Matches, Pairs );
+        return false;
+    }
+    
+    Scheduler->UnscheduleAll();
+    return true;
+}
+
+
+int main( int argc, char** argv )
+{
+    auto File = cocos2d::FileUtils::getInstance();
+    std::vector< std::string > Paths;
+    Paths.push_back( "Resource" );
+    Paths.push_back( "LuaScripts" );
+    File->setSearchPaths( Paths );
+    
+    // Same deck the practice match uses, on both sides
+    Regicide::Deck Deck;
+    Deck.Name   = "Redaction";
+    Deck.KingId = 1;
+    Deck.Cards.push_back( Regicide::Card( 5, 8 ) );
+    Deck.Cards.push_back( Regicide::Card( 6, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 7, 5 ) );
+    Deck.Cards.push_back( Regicide::Card( 8, 12 ) );
+    
+    // Fixed seeds, so a failure can be run again
+    int Failed = 0;
+    for( uint64_t Seed = 1; Seed <= 16; Seed++ )
+    {
+        if( !CheckSeed( Seed, Deck ) )
+            Failed++;
+    }
+    
+    cocos2d::log( Failed > 0 ? "[Test] Snapshot redaction: Failed!" : "[Test] Snapshot redaction: Passed" );
+    return Failed > 0 ? 1 : 0;
+}
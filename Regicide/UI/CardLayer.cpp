@@ -55,29 +55,14 @@ bool CardLayer::init()
 =======================================================================================*/
 Game::CardEntity* CardLayer::TraceTouch( const cocos2d::Vec2 &inPos )
 {
-    // We need to trace through all cards in the game to check if
-    // the touch hit any of them. TODO: Find quicker way to trace touches?
+    // Both players cards are in the same grid, so one trace finds the topmost card
+    // under the touch, no matter which player owns it
     auto world = Game::World::GetWorld();
     auto GM = world ? world->GetGameMode() : nullptr;
     
     if( GM )
     {
-        auto pl = GM->GetState().GetPlayer();
-        auto op = GM->GetState().GetOpponent();
-        
-        if( pl )
-        {
-            auto ret = pl->PerformTouchTrace( inPos );
-            if( ret )
-                return ret;
-        }
-        
-        if( op )
-        {
-            auto ret = op->PerformTouchTrace( inPos );
-            if( ret )
-                return ret;
-        }
+        return Game::CardManager::GetInstance().GetGrid().Trace( inPos );
     }
     
     return nullptr;
@@ -3,12 +3,14 @@
 //    Regicide Mobile
 //
 //    Created: 11/20/18
-//    Updated: 11/20/18
+//    Updated: 12/14/18
 //
 //    © 2018 Zachary Berry, All Rights Reserved
 //
 
 #include "CardSelector.hpp"
+#include <algorithm>
+#include <cmath>
 
 
 CardSelector* CardSelector::Create( Game::CardIter Begin, Game::CardIter End )
@@ -48,8 +50,12 @@ bool CardSelector::init()
     ScrollPanel->setPosition( cocos2d::Vec2( Origin.x + Size.width * 0.5f, Origin.y + Size.height * 0.5f ) );
     ScrollPanel->setContentSize( cocos2d::Size( Size.width, Size.height * 0.6f + 50.f ) );
     ScrollPanel->setDirection( cocos2d::ui::ScrollView::Direction::HORIZONTAL );
-    ScrollPanel->setLayoutType( cocos2d::ui::Layout::Type::HORIZONTAL );
     ScrollPanel->setCascadeOpacityEnabled( true );
+    ScrollPanel->addEventListener( [=]( cocos2d::Ref* Caller, cocos2d::ui::ScrollView::EventType Type )
+    {
+        if( Type == cocos2d::ui::ScrollView::EventType::CONTAINER_MOVED )
+            this->UpdateVisible();
+    } );
     
     Confirm = cocos2d::ui::Button::create( "generic_button.png" );
     Confirm->setAnchorPoint( cocos2d::Vec2( 0.5f, 1.f ) );
@@ -85,17 +91,9 @@ void CardSelector::Lock()
     if( Confirm )
         Confirm->setEnabled( false );
     
-    if( ScrollPanel )
-    {
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
-        {
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button )
-                Button->setEnabled( false );
-        }
-
-    }
+    // Buttons bound later pick the lock up when theyre bound
+    for( auto It = Active.begin(); It != Active.end(); It++ )
+        It->second->setEnabled( false );
 }
 
 void CardSelector::UnLock()
@@ -105,16 +103,8 @@ void CardSelector::UnLock()
     if( Confirm )
         Confirm->setEnabled( true );
     
-    if( ScrollPanel )
-    {
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
-        {
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button )
-                Button->setEnabled( true );
-        }
-    }
+    for( auto It = Active.begin(); It != Active.end(); It++ )
+        It->second->setEnabled( true );
 }
 
 void CardSelector::SetConfirmLabel( const std::string& In )
@@ -126,23 +116,21 @@ void CardSelector::SetConfirmLabel( const std::string& In )
 void CardSelector::Invalidate()
 {
     std::vector< Game::CardEntity* > Output;
-    if( ScrollPanel && Draw )
+    if( Draw )
     {
         Draw->clear();
         
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
+        // Slots are at fixed positions, so cards that are scrolled out of view are outlined too
+        auto Delta = cocos2d::Vec2( CardSize.width, CardSize.height ) * CardScale * 0.5f;
+        for( size_t i = 0; i < Cards.size(); i++ )
         {
-            // Cast to CardButton
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button && Button->bSelected )
-            {
-                Output.push_back( Button->LinkedCard );
-                
-                auto Origin = Button->getPosition();
-                auto Delta = Button->getContentSize() * Button->getScale() * 0.5f;
-                Draw->drawSolidRect( Origin - Delta - cocos2d::Vec2( 4.f, 4.f ), Origin + Delta + cocos2d::Vec2( 4.f, 4.f ), cocos2d::Color4F( 1.f, 0.2f, 0.2f, 1.f ) );
-            }
+            if( !Selected[ i ] )
+                continue;
+            
+            Output.push_back( Cards[ i ] );
+            
+            auto Origin = GetSlotPosition( i );
+            Draw->drawSolidRect( Origin - Delta - cocos2d::Vec2( 4.f, 4.f ), Origin + Delta + cocos2d::Vec2( 4.f, 4.f ), cocos2d::Color4F( 1.f, 0.2f, 0.2f, 1.f ) );
         }
     }
     
@@ -156,18 +144,10 @@ std::vector< Game::CardEntity* > CardSelector::GetSelection()
 {
     std::vector< Game::CardEntity* > Output;
     
-    if( ScrollPanel )
+    for( size_t i = 0; i < Cards.size(); i++ )
     {
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
-        {
-            // Cast to CardButton
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button && Button->bSelected )
-            {
-                Output.push_back( Button->LinkedCard );
-            }
-        }
+        if( Selected[ i ] )
+            Output.push_back( Cards[ i ] );
     }
     
     return Output;
@@ -175,38 +155,19 @@ std::vector< Game::CardEntity* > CardSelector::GetSelection()
 
 void CardSelector::Deselect( Game::CardEntity *In )
 {
-    if( ScrollPanel )
+    for( size_t i = 0; i < Cards.size(); i++ )
     {
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
-        {
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button && Button->bSelected && Button->LinkedCard == In )
-            {
-                Button->bSelected = false;
-            }
-        }
-        
-        Invalidate();
+        if( Cards[ i ] == In )
+            Selected[ i ] = false;
     }
+    
+    Invalidate();
 }
 
 void CardSelector::DeselectAll()
 {
-    if( ScrollPanel )
-    {
-        auto Children = ScrollPanel->getChildren();
-        for( auto It = Children.begin(); It != Children.end(); It++ )
-        {
-            auto Button = dynamic_cast< CardButton* >( *It );
-            if( Button && Button->bSelected )
-            {
-                Button->bSelected = false;
-            }
-        }
-        
-        Invalidate();
-    }
+    std::fill( Selected.begin(), Selected.end(), false );
+    Invalidate();
 }
 
 void CardSelector::LoadCards( Game::CardIter Begin, Game::CardIter End )
@@ -214,54 +175,292 @@ void CardSelector::LoadCards( Game::CardIter Begin, Game::CardIter End )
     auto dir = cocos2d::Director::getInstance();
     auto Size = dir->getVisibleSize();
     
-    // Create Card Widgets, Add To Scroll Panel
-    float TotalWidth = Size.width * 0.01f;
+    // Anything already loaded goes back to the pool
+    for( auto It = Active.begin(); It != Active.end(); It++ )
+    {
+        It->second->Unbind();
+        Recycled.push_back( It->second );
+    }
+    
+    Active.clear();
+    Cards.clear();
     
     for( auto It = Begin; It != End; It++ )
     {
-        if( !(*It) )
+        if( !(*It) || !(*It)->GetInfo() )
         {
             cocos2d::log( "[Selector] Card was null" );
             continue;
         }
         
-        auto Card = CardButton::Create( *It );
-        auto defSize = Card->getContentSize();
-        
-        // We want to scale the card until the height is 0.25x the screen height
-        Card->setScale( ( Size.height * 0.6f ) / defSize.height );
-        TotalWidth += ( Card->getContentSize().width + Size.width * 0.01f );
+        Cards.push_back( *It );
+    }
+    
+    Selected.assign( Cards.size(), false );
+    
+    // Cards all share the same size, so the first one sizes every slot. Match cards already have their art loaded
+    if( !Cards.empty() )
+    {
+        auto First      = Cards.front();
+        auto Texture    = First->FullSizedTexture ? First->FullSizedTexture : dir->getTextureCache()->addImage( First->GetInfo()->FullTexture );
         
-        auto layoutParam = cocos2d::ui::LinearLayoutParameter::create();
-        layoutParam->setGravity( cocos2d::ui::LinearLayoutParameter::LinearGravity::CENTER_VERTICAL );
-        layoutParam->setMargin( cocos2d::ui::Margin( Size.width * 0.01f, 0.f, Size.width * 0.01f, 0.f ) );
-        Card->setLayoutParameter( layoutParam );
+        if( Texture )
+            CardSize = Texture->getContentSize();
+    }
+    
+    // We want to scale the card until the height is 0.6x the screen height
+    CardScale   = CardSize.height > 0.f ? ( Size.height * 0.6f ) / CardSize.height : 1.f;
+    Gap         = Size.width * 0.01f;
+    Pitch       = CardSize.width * CardScale + Gap * 2.f;
+    
+    float TotalWidth = Pitch * (float) Cards.size() + Gap * 2.f;
+    ScrollPanel->setInnerContainerSize( cocos2d::Size( TotalWidth, ScrollPanel->getContentSize().height ) );
+    
+    // Ensure were centered
+    auto ScrollSize = ScrollPanel->getContentSize();
+    ScrollPanel->setInnerContainerPosition( cocos2d::Vec2( ScrollSize.width / 2.f - TotalWidth / 2.f, 0.f ) );
+    
+    UpdateVisible();
+    Invalidate();
+}
+
+cocos2d::Vec2 CardSelector::GetSlotPosition( size_t Index ) const
+{
+    return cocos2d::Vec2( Gap * 2.f + Pitch * (float) Index + CardSize.width * CardScale * 0.5f, ScrollPanel->getContentSize().height * 0.5f );
+}
+
+void CardSelector::UpdateVisible()
+{
+    if( !ScrollPanel || Pitch <= 0.f )
+        return;
+    
+    // Range of slots overlapping the view, in inner container space
+    float Left  = -ScrollPanel->getInnerContainerPosition().x;
+    float Right = Left + ScrollPanel->getContentSize().width;
+    
+    int First   = (int) floorf( ( Left - Gap ) / Pitch ) - CARD_SELECTOR_OVERSCAN;
+    int Last    = (int) floorf( ( Right - Gap ) / Pitch ) + CARD_SELECTOR_OVERSCAN;
+    
+    First   = std::max( First, 0 );
+    Last    = std::min( Last, (int) Cards.size() - 1 );
+    
+    // Free everything that scrolled out first, so the buttons can be reused for whats scrolling in
+    for( auto It = Active.begin(); It != Active.end(); )
+    {
+        if( (int) It->first < First || (int) It->first > Last )
+        {
+            It->second->Unbind();
+            Recycled.push_back( It->second );
+            It = Active.erase( It );
+        }
+        else
+        {
+            It++;
+        }
+    }
+    
+    for( int i = First; i <= Last; i++ )
+    {
+        if( Active.count( (size_t) i ) > 0 )
+            continue;
         
-        Card->addTouchEventListener( [=]( cocos2d::Ref* Caller, cocos2d::ui::Widget::TouchEventType Type )
+        CardButton* Button = nullptr;
+        if( !Recycled.empty() )
+        {
+            Button = Recycled.back();
+            Recycled.pop_back();
+        }
+        else
         {
-            if( Type == cocos2d::ui::Widget::TouchEventType::ENDED )
+            Button = CardButton::Create( CardSize );
+            if( !Button )
             {
-                // If were attempting to select this card, check if were able to
-                if( Card->bSelected )
-                {
-                    Card->bSelected = false;
-                    this->Invalidate();
-                }
-                else if( !_fCanSelect || _fCanSelect( Card->LinkedCard ) )
-                {
-                    Card->bSelected = true;
-                    this->Invalidate();
-                }
+                cocos2d::log( "[Selector] Failed to create card button" );
+                return;
             }
             
-        } );
+            Button->setScale( CardScale );
+            Button->addTouchEventListener( [=]( cocos2d::Ref* Caller, cocos2d::ui::Widget::TouchEventType Type )
+            {
+                if( Type == cocos2d::ui::Widget::TouchEventType::ENDED )
+                    this->OnCardTouched( Button );
+            } );
+            
+            ScrollPanel->addChild( Button );
+        }
+        
+        Button->Bind( Cards[ i ], (size_t) i );
+        Button->setPosition( GetSlotPosition( (size_t) i ) );
+        Button->setEnabled( !_bLocked );
         
-        ScrollPanel->addChild( Card );
+        Active[ (size_t) i ] = Button;
     }
+}
+
+void CardSelector::OnCardTouched( CardButton* In )
+{
+    if( !In || !In->LinkedCard || In->Index >= Cards.size() )
+        return;
     
-    ScrollPanel->setInnerContainerSize( cocos2d::Size( TotalWidth, ScrollPanel->getContentSize().height ) );
+    // If were attempting to select this card, check if were able to
+    if( Selected[ In->Index ] )
+    {
+        Selected[ In->Index ] = false;
+        Invalidate();
+    }
+    else if( !_fCanSelect || _fCanSelect( In->LinkedCard ) )
+    {
+        Selected[ In->Index ] = true;
+        Invalidate();
+    }
+}
+
+/*=================================================================================================
+    CardButton
+ =================================================================================================*/
+bool CardButton::init( const cocos2d::Size& InCardSize )
+{
+    if( !Button::init() )
+    {
+        return false;
+    }
     
-    // Ensure were centered
-    auto ScrollSize = ScrollPanel->getContentSize();
-    ScrollPanel->setInnerContainerPosition( cocos2d::Vec2( ScrollSize.width / 2.f - TotalWidth / 2.f, 0.f ) );
+    // The art can arrive after the button is laid out, so the size cant come from the texture
+    CardSize = InCardSize;
+    ignoreContentAdaptWithSize( false );
+    setContentSize( CardSize );
+    setCascadeOpacityEnabled( true );
+    
+    Overlay = cocos2d::Sprite::create( "LargeOverlay.png" );
+    Overlay->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
+    Overlay->setScale( getScale() );
+    Overlay->setPosition( getContentSize() * 0.5f );
+    Overlay->setOpacity( 255 );
+    
+    // TODO: Create labels for manacost, attack and stamina
+    
+    // Create Scroll Panel
+    ScrollPanel = cocos2d::ui::ScrollView::create();
+    ScrollPanel->setBackGroundColorType( cocos2d::ui::Layout::BackGroundColorType::SOLID );
+    ScrollPanel->setBackGroundColor( cocos2d::Color3B( 20, 20, 20 ) );
+    ScrollPanel->setBackGroundColorOpacity( 255 );
+    ScrollPanel->setAnchorPoint( cocos2d::Vec2( 0.f, 0.f ) );
+    ScrollPanel->setPosition( cocos2d::Vec2( 12.f, 32.f ) );
+    ScrollPanel->setContentSize( cocos2d::Size( CardSize.width - 24.f, CardSize.height * 0.4f - 32.f ) );
+    ScrollPanel->setDirection( cocos2d::ui::ScrollView::Direction::VERTICAL );
+    ScrollPanel->setLayoutType( cocos2d::ui::Layout::Type::VERTICAL );
+    ScrollPanel->setCascadeOpacityEnabled( true );
+    addChild( ScrollPanel, 1 );
+    
+    return true;
+}
+
+void CardButton::Bind( Game::CardEntity* In, size_t InIndex )
+{
+    if( LinkedCard == In && Index == InIndex )
+        return;
+    
+    Unbind();
+    
+    auto Info = In ? In->GetInfo() : nullptr;
+    if( !Info )
+        return;
+    
+    LinkedCard  = In;
+    Index       = InIndex;
+    setVisible( true );
+    
+    BuildText( In );
+    
+    // Match cards already have their art, anything else is loaded as it scrolls into view
+    auto Cache = cocos2d::Director::getInstance()->getTextureCache();
+    auto Path  = cocos2d::FileUtils::getInstance()->fullPathForFilename( Info->FullTexture );
+    
+    if( In->FullSizedTexture || Cache->getTextureForKey( Path ) )
+    {
+        loadTextureNormal( Info->FullTexture, cocos2d::ui::Button::TextureResType::LOCAL );
+        return;
+    }
+    
+    // The button can be freed with the selector before the art arrives
+    auto Expected = BindCount;
+    auto Texture = Info->FullTexture;
+    retain();
+    
+    Cache->addImageAsync( Texture, [ this, Expected, Texture ]( cocos2d::Texture2D* Loaded )
+    {
+        if( Loaded && BindCount == Expected )
+            loadTextureNormal( Texture, cocos2d::ui::Button::TextureResType::LOCAL );
+        
+        release();
+    } );
+}
+
+void CardButton::Unbind()
+{
+    BindCount++;
+    
+    LinkedCard = nullptr;
+    setVisible( false );
+    
+    // Recycled buttons show the card back until the next cards art is loaded
+    loadTextureNormal( "CardBack.png", cocos2d::ui::Button::TextureResType::LOCAL );
+    
+    if( ScrollPanel )
+    {
+        ScrollPanel->removeAllChildren();
+        ScrollPanel->jumpToTop();
+    }
+    
+    Abilities.clear();
+}
+
+void CardButton::BuildText( Game::CardEntity* In )
+{
+    auto Info = In->GetInfo();
+    
+    bool bFirst = true;
+    bool bActuallyFirst = true;
+    float TotalHeight = 0.f;
+    
+    for( auto It = Info->Abilities.begin(); It != Info->Abilities.end(); It++ )
+    {
+        auto Text = AbilityText::Create( In, It->second, CardSize.width * 0.85f, !bFirst, 28, false );
+        Text->setCascadeOpacityEnabled( true );
+        Text->setContentSize( cocos2d::Size( CardSize.width * 0.85f, Text->GetDesiredHeight() ) );
+        //Text->setGlobalZOrder( 405 );
+        
+        // If this ability is triggerable, we dont want the next text to display a seperator
+        bFirst = Text->CanTrigger();
+        
+        auto Layout = cocos2d::ui::LinearLayoutParameter::create();
+        Layout->setGravity( cocos2d::ui::LinearLayoutParameter::LinearGravity::CENTER_HORIZONTAL );
+        Layout->setMargin( cocos2d::ui::Margin( 4.f,  bActuallyFirst ? 10.f : 4.f, 4.f, 4.f ) );
+        
+        Text->setLayoutParameter( Layout );
+        ScrollPanel->addChild( Text );
+        
+        TotalHeight += ( Text->getContentSize().height + ( bActuallyFirst ? 14.f : 8.f ) );
+        
+        Abilities[ It->first ] = Text;
+        bActuallyFirst = false;
+    }
+    
+    if( Info->Description.size() > 0 )
+    {
+        auto Description = DescriptionText::Create( Info->Description, CardSize.width * 0.85f, !bFirst );
+        Description->setCascadeOpacityEnabled( true );
+        Description->setContentSize( cocos2d::Size( CardSize.width * 0.8f, Description->GetDesiredHeight() ) );
+
+        auto Layout = cocos2d::ui::LinearLayoutParameter::create();
+        Layout->setGravity( cocos2d::ui::LinearLayoutParameter::LinearGravity::CENTER_HORIZONTAL );
+        Layout->setMargin( cocos2d::ui::Margin( 4.f, 4.f, 4.f, 4.f ) );
+        
+        Description->setLayoutParameter( Layout );
+        ScrollPanel->addChild( Description );
+        
+        TotalHeight += Description->getContentSize().height + 8.f;
+    }
+    
+    ScrollPanel->setInnerContainerSize( cocos2d::Size( CardSize.width - 24.f, TotalHeight + 10.f ) );
 }
@@ -3,7 +3,7 @@
 //    Regicide Mobile
 //
 //    Created: 11/20/18
-//    Updated: 11/20/18
+//    Updated: 12/14/18
 //
 //    © 2018 Zachary Berry, All Rights Reserved
 //
@@ -17,6 +17,17 @@
 #include "AbilityText.hpp"
 #include "DescriptionText.hpp"
 
+// Card Selector
+// Buttons are only built for the cards in view, plus this many on either side so a quick scroll doesnt show empty slots
+#define CARD_SELECTOR_OVERSCAN 1
+
+class CardButton;
+
+// Horizontal list of full sized cards to pick from
+//
+// Only the cards that are scrolled into view have a button, buttons that scroll out are rebound to the cards
+// scrolling in, so opening a graveyard with a few dozen cards costs the same as one with a handful. The selection
+// is kept here instead of on the buttons for the same reason
 class CardSelector : public cocos2d::Layer
 {
     
@@ -53,6 +64,22 @@ protected:
     
     void Invalidate();
     
+    // Binds buttons to the cards in view, and frees the ones that scrolled out
+    void UpdateVisible();
+    void OnCardTouched( CardButton* In );
+    cocos2d::Vec2 GetSlotPosition( size_t Index ) const;
+    
+    std::vector< Game::CardEntity* > Cards;
+    std::vector< bool > Selected;
+    std::map< size_t, CardButton* > Active;
+    std::vector< CardButton* > Recycled;
+    
+    // Every card is laid out in a slot the size of the first card
+    cocos2d::Size CardSize;
+    float CardScale = 1.f;
+    float Gap = 0.f;
+    float Pitch = 0.f;
+    
 };
 
 class CardButton : public cocos2d::ui::Button
@@ -62,13 +89,13 @@ public:
     cocos2d::ui::ScrollView* ScrollPanel;
     std::map< int, AbilityText* > Abilities;
     Game::CardEntity* LinkedCard;
-    bool bSelected;
+    size_t Index;
     cocos2d::Sprite* Overlay;
     
-    static CardButton* Create( Game::CardEntity* In )
+    static CardButton* Create( const cocos2d::Size& InCardSize )
     {
-        auto ret = new (std::nothrow) CardButton( In );
-        if( ret && ret->init( In ) )
+        auto ret = new (std::nothrow) CardButton();
+        if( ret && ret->init( InCardSize ) )
         {
             ret->autorelease();
             return ret;
@@ -81,94 +108,29 @@ public:
         }
     }
     
-    CardButton( Game::CardEntity* In )
+    CardButton()
     {
-        LinkedCard = In;
-        bSelected = false;
+        LinkedCard  = nullptr;
+        Index       = 0;
         ScrollPanel = nullptr;
         Overlay     = nullptr;
+        BindCount   = 0;
     }
     
-    virtual bool init( Game::CardEntity* In )
-    {
-        auto Info = In ? In->GetInfo() : nullptr;
-        if( !Info || !Button::init( Info->FullTexture, "", "", cocos2d::ui::Button::TextureResType::LOCAL ) )
-        {
-            return false;
-        }
-        
-        auto CardSize = getContentSize() * getScale();
-        setCascadeOpacityEnabled( true );
-        
-        Overlay = cocos2d::Sprite::create( "LargeOverlay.png" );
-        Overlay->setAnchorPoint( cocos2d::Vec2( 0.5f, 0.5f ) );
-        Overlay->setScale( getScale() );
-        Overlay->setPosition( getContentSize() * 0.5f );
-        Overlay->setOpacity( 255 );
-        
-        // TODO: Create labels for manacost, attack and stamina
-        
-        // Create Scroll Panel
-        ScrollPanel = cocos2d::ui::ScrollView::create();
-        ScrollPanel->setBackGroundColorType( cocos2d::ui::Layout::BackGroundColorType::SOLID );
-        ScrollPanel->setBackGroundColor( cocos2d::Color3B( 20, 20, 20 ) );
-        ScrollPanel->setBackGroundColorOpacity( 255 );
-        ScrollPanel->setAnchorPoint( cocos2d::Vec2( 0.f, 0.f ) );
-        ScrollPanel->setPosition( cocos2d::Vec2( 12.f, 32.f ) );
-        ScrollPanel->setContentSize( cocos2d::Size( CardSize.width - 24.f, CardSize.height * 0.4f - 32.f ) );
-        ScrollPanel->setDirection( cocos2d::ui::ScrollView::Direction::VERTICAL );
-        ScrollPanel->setLayoutType( cocos2d::ui::Layout::Type::VERTICAL );
-        ScrollPanel->setCascadeOpacityEnabled( true );
-        addChild( ScrollPanel, 1 );
-        
-        bool bFirst = true;
-        bool bActuallyFirst = true;
-        float TotalHeight = 0.f;
-        
-        for( auto It = Info->Abilities.begin(); It != Info->Abilities.end(); It++ )
-        {
-            auto Text = AbilityText::Create( In, It->second, CardSize.width * 0.85f, !bFirst, 28, false );
-            Text->setCascadeOpacityEnabled( true );
-            Text->setContentSize( cocos2d::Size( CardSize.width * 0.85f, Text->GetDesiredHeight() ) );
-            //Text->setGlobalZOrder( 405 );
-            
-            // If this ability is triggerable, we dont want the next text to display a seperator
-            bFirst = Text->CanTrigger();
-            
-            auto Layout = cocos2d::ui::LinearLayoutParameter::create();
-            Layout->setGravity( cocos2d::ui::LinearLayoutParameter::LinearGravity::CENTER_HORIZONTAL );
-            Layout->setMargin( cocos2d::ui::Margin( 4.f,  bActuallyFirst ? 10.f : 4.f, 4.f, 4.f ) );
-            
-            Text->setLayoutParameter( Layout );
-            ScrollPanel->addChild( Text );
-            
-            TotalHeight += ( Text->getContentSize().height + ( bActuallyFirst ? 14.f : 8.f ) );
-            
-            Abilities[ It->first ] = Text;
-            bActuallyFirst = false;
-        }
-        
-        if( Info->Description.size() > 0 )
-        {
-            auto Description = DescriptionText::Create( Info->Description, CardSize.width * 0.85f, !bFirst );
-            Description->setCascadeOpacityEnabled( true );
-            Description->setContentSize( cocos2d::Size( CardSize.width * 0.8f, Description->GetDesiredHeight() ) );
-
-            auto Layout = cocos2d::ui::LinearLayoutParameter::create();
-            Layout->setGravity( cocos2d::ui::LinearLayoutParameter::LinearGravity::CENTER_HORIZONTAL );
-            Layout->setMargin( cocos2d::ui::Margin( 4.f, 4.f, 4.f, 4.f ) );
-            
-            Description->setLayoutParameter( Layout );
-            ScrollPanel->addChild( Description );
-            
-            TotalHeight += Description->getContentSize().height + 8.f;
-        }
-        
-        ScrollPanel->setInnerContainerSize( cocos2d::Size( CardSize.width - 24.f, TotalHeight + 10.f ) );
-        
-        return true;
-    }
+    // Every card the button shows is drawn at this size, the art is stretched to fit if it doesnt match
+    virtual bool init( const cocos2d::Size& InCardSize );
+    
+    // Shows another card, the art is loaded in the background if it isnt already
+    void Bind( Game::CardEntity* In, size_t InIndex );
+    void Unbind();
+    
+protected:
+    
+    void BuildText( Game::CardEntity* In );
+    
+    cocos2d::Size CardSize;
+    
+    // Art thats still loading when the button is rebound is thrown away
+    uint32_t BindCount;
     
 };
-
-
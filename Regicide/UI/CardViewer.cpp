@@ -135,10 +135,14 @@ void CardViewer::SetTargetCard( Game::CardEntity *inCard, bool bAllowPlay )
     
     cocos2d::Texture2D* TargetTexture = inCard->FullSizedTexture ? inCard->FullSizedTexture : inCard->FrontTexture;
     
-    if( !TargetTexture )
+    // Small art packed into the card atlas doesnt have a texture of its own
+    if( TargetTexture )
+        CardImage = cocos2d::Sprite::createWithTexture( TargetTexture );
+    else if( inCard->FrontFrame )
+        CardImage = cocos2d::Sprite::createWithSpriteFrame( inCard->FrontFrame );
+    else
         return;
     
-    CardImage = cocos2d::Sprite::createWithTexture( TargetTexture );
     if( !CardImage )
     {
         cocos2d::log( "[CardViewer] ERROR! Invalid card texture" );
@@ -9,6 +9,7 @@
 //
 
 #include "IconCount.hpp"
+#include "CMS/TextureAtlas.hpp"
 
 
 IconCount* IconCount::Create( const std::string& inTexture, int inCount, int inFont )
@@ -45,7 +46,7 @@ bool IconCount::init( const std::string& inTexture, int inCount, int inFont )
     if( !Node::init() )
         return false;
     
-    Icon = cocos2d::Sprite::create( inTexture );
+    Icon = Regicide::TextureAtlas::CreateSprite( inTexture );
     Icon->setAnchorPoint( cocos2d::Vec2( 0.f, 0.5f ) );
     addChild( Icon, 1 );
     